@@ -15,6 +15,7 @@
 from absl import app
 import numpy as np
 from pyiree.tf.support import tf_test_utils
+from pyiree.tf.support import tf_utils
 import tensorflow.compat.v2 as tf
 
 
@@ -38,6 +39,24 @@ class FftModule(tf.Module):
     complex_out = tf.signal.fft(complex_in)
     return tf.math.imag(complex_out)
 
+  @tf.function(input_signature=[
+      tf.TensorSpec([3, 6], tf.float32),
+      tf.TensorSpec([3, 6], tf.float32)
+  ])
+  def ifft_real(self, real_array, imag_array):
+    complex_in = tf.complex(real_array, imag_array)
+    complex_out = tf.signal.ifft(complex_in)
+    return tf.math.real(complex_out)
+
+  @tf.function(input_signature=[
+      tf.TensorSpec([3, 6], tf.float32),
+      tf.TensorSpec([3, 6], tf.float32)
+  ])
+  def ifft_imag(self, real_array, imag_array):
+    complex_in = tf.complex(real_array, imag_array)
+    complex_out = tf.signal.ifft(complex_in)
+    return tf.math.imag(complex_out)
+
 
 class FftTest(tf_test_utils.TracedModuleTestCase):
 
@@ -63,6 +82,24 @@ class FftTest(tf_test_utils.TracedModuleTestCase):
 
     self.compare_backends(fft_imag, self._modules)
 
+  def test_ifft_real(self):
+
+    def ifft_real(module):
+      real_array = tf_utils.uniform((3, 6))
+      imag_array = tf_utils.uniform((3, 6))
+      module.ifft_real(real_array, imag_array)
+
+    self.compare_backends(ifft_real, self._modules)
+
+  def test_ifft_imag(self):
+
+    def ifft_imag(module):
+      real_array = tf_utils.uniform((3, 6))
+      imag_array = tf_utils.uniform((3, 6))
+      module.ifft_imag(real_array, imag_array)
+
+    self.compare_backends(ifft_imag, self._modules)
+
 
 def main(argv):
   del argv  # Unused
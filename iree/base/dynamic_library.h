@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 
@@ -53,6 +54,16 @@ class DynamicLibrary {
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
       absl::Span<const char* const> search_file_names);
 
+  // Loads the library from the in-memory shared object image |file_data|
+  // without writing it to the filesystem. |file_name| is used only for
+  // identification (such as in debuggers and profilers). |file_data| is copied
+  // and need not remain valid after the call returns.
+  //
+  // Returns UNIMPLEMENTED on platforms that cannot load libraries from memory;
+  // callers should fall back to writing the file and using |Load|.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> file_data);
+
   // Gets the name of the library file that is loaded.
   const std::string& file_name() const { return file_name_; }
 
@@ -21,6 +21,19 @@
     defined(IREE_PLATFORM_LINUX)
 
 #include <dlfcn.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+#include <sys/syscall.h>
+#if defined(SYS_memfd_create)
+#define IREE_HAVE_MEMFD_CREATE 1
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif  // !MFD_CLOEXEC
+#endif  // SYS_memfd_create
+#endif  // IREE_PLATFORM_ANDROID || IREE_PLATFORM_LINUX
 
 namespace iree {
 
@@ -31,6 +44,7 @@ class DynamicLibraryPosix : public DynamicLibrary {
     //   Sometimes closing the library can prevent proper symbolization on
     //   crashes or in sampling profilers.
     ::dlclose(library_);
+    if (memfd_ != -1) ::close(memfd_);
   }
 
   static StatusOr<std::unique_ptr<DynamicLibrary>> Load(
@@ -48,15 +62,67 @@ class DynamicLibraryPosix : public DynamicLibrary {
            << "Unable to open dynamic library:'" << dlerror() << "'";
   }
 
+#if defined(IREE_HAVE_MEMFD_CREATE)
+  // Loads the library by copying |file_data| into an anonymous memory-backed
+  // file and opening it through its /proc/self/fd/ path. Nothing touches the
+  // filesystem and the file is released once the library is closed.
+  static StatusOr<std::unique_ptr<DynamicLibrary>> LoadFromMemory(
+      absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+    IREE_TRACE_SCOPE0("DynamicLibraryPosix::LoadFromMemory");
+
+    // Called via syscall as older libcs lack the memfd_create wrapper.
+    std::string memfd_name(file_name);
+    int fd = static_cast<int>(
+        ::syscall(SYS_memfd_create, memfd_name.c_str(), MFD_CLOEXEC));
+    if (fd == -1) {
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "memfd_create failed: " << ::strerror(errno);
+    }
+
+    const uint8_t* data = file_data.data();
+    size_t remaining = file_data.size();
+    while (remaining > 0) {
+      ssize_t written = ::write(fd, data, remaining);
+      if (written == -1) {
+        if (errno == EINTR) continue;
+        int write_errno = errno;
+        ::close(fd);
+        return UnavailableErrorBuilder(IREE_LOC)
+               << "Failed to write library to memfd: "
+               << ::strerror(write_errno);
+      }
+      data += written;
+      remaining -= static_cast<size_t>(written);
+    }
+
+    // The loader identifies libraries by path and returns the existing handle
+    // when the same path is opened again. The descriptor is kept open for as
+    // long as the library is loaded so that its /proc/self/fd/ path cannot be
+    // reused by another in-memory library in the meantime.
+    std::string fd_path = "/proc/self/fd/" + std::to_string(fd);
+    void* library = ::dlopen(fd_path.c_str(), RTLD_LAZY | RTLD_LOCAL);
+    if (!library) {
+      ::close(fd);
+      return UnavailableErrorBuilder(IREE_LOC)
+             << "Unable to open in-memory dynamic library:'" << dlerror()
+             << "'";
+    }
+    return absl::WrapUnique(new DynamicLibraryPosix(memfd_name, library, fd));
+  }
+#endif  // IREE_HAVE_MEMFD_CREATE
+
   void* GetSymbol(const char* symbol_name) const override {
     return ::dlsym(library_, symbol_name);
   }
 
  private:
-  DynamicLibraryPosix(std::string file_name, void* library)
-      : DynamicLibrary(file_name), library_(library) {}
+  DynamicLibraryPosix(std::string file_name, void* library, int memfd = -1)
+      : DynamicLibrary(file_name), library_(library), memfd_(memfd) {}
 
   void* library_;
+  // Descriptor of the memfd backing an in-memory library or -1 if the library
+  // was loaded from a file. Closed after the library is.
+  int memfd_;
 };
 
 // static
@@ -65,6 +131,17 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryPosix::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+#if defined(IREE_HAVE_MEMFD_CREATE)
+  return DynamicLibraryPosix::LoadFromMemory(file_name, file_data);
+#else
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "In-memory dynamic library loading not supported on this platform";
+#endif  // IREE_HAVE_MEMFD_CREATE
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
@@ -96,5 +96,52 @@ TEST_F(DynamicLibraryTest, GetSymbolFailure) {
   EXPECT_EQ(nullptr, unknown_fn);
 }
 
+TEST_F(DynamicLibraryTest, LoadFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dynamic_library_test_library",
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc->data),
+                          file_toc->size));
+  if (IsUnimplemented(library_or.status())) {
+    GTEST_SKIP() << "In-memory loading not supported on this platform";
+  }
+  IREE_ASSERT_OK_AND_ASSIGN(auto library, std::move(library_or));
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+}
+
+// Tests that each in-memory library is loaded on its own even when loaded back
+// to back while the first is still open.
+TEST_F(DynamicLibraryTest, LoadTwoFromMemory) {
+  const auto* file_toc = dynamic_library_test_library_create();
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dynamic_library_test_library",
+      absl::MakeConstSpan(reinterpret_cast<const uint8_t*>(file_toc[0].data),
+                          file_toc[0].size));
+  if (IsUnimplemented(library_or.status())) {
+    GTEST_SKIP() << "In-memory loading not supported on this platform";
+  }
+  IREE_ASSERT_OK_AND_ASSIGN(auto library, std::move(library_or));
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto library_2,
+      DynamicLibrary::LoadFromMemory(
+          "dynamic_library_test_library_2",
+          absl::MakeConstSpan(
+              reinterpret_cast<const uint8_t*>(file_toc[1].data),
+              file_toc[1].size)));
+
+  auto times_two_fn = library->GetSymbol<int (*)(int)>("times_two");
+  ASSERT_NE(nullptr, times_two_fn);
+  EXPECT_EQ(246, times_two_fn(123));
+  EXPECT_EQ(nullptr, library->GetSymbol<int (*)(int)>("times_three"));
+
+  auto times_three_fn = library_2->GetSymbol<int (*)(int)>("times_three");
+  ASSERT_NE(nullptr, times_three_fn);
+  EXPECT_EQ(369, times_three_fn(123));
+  EXPECT_EQ(nullptr, library_2->GetSymbol<int (*)(int)>("times_two"));
+}
+
 }  // namespace
 }  // namespace iree
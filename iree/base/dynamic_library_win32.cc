@@ -152,6 +152,15 @@ StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::Load(
   return DynamicLibraryWin::Load(search_file_names);
 }
 
+// static
+StatusOr<std::unique_ptr<DynamicLibrary>> DynamicLibrary::LoadFromMemory(
+    absl::string_view file_name, absl::Span<const uint8_t> file_data) {
+  // LoadLibrary only accepts files; a manual PE loader would be required to
+  // load directly from memory and it would not integrate with dbghelp.
+  return UnimplementedErrorBuilder(IREE_LOC)
+         << "In-memory dynamic library loading not supported on Windows";
+}
+
 }  // namespace iree
 
 #endif  // IREE_PLATFORM_*
@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <limits>
+#include <utility>
+
 #include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
 #include "iree/compiler/Dialect/HAL/Conversion/FlowToHAL/ConvertFlowToHAL.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
@@ -23,6 +27,9 @@
 #include "iree/compiler/Dialect/IREE/IR/IREETypes.h"
 #include "iree/compiler/Dialect/Shape/IR/ShapeOps.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Dialect/StandardOps/IR/Ops.h"
 #include "mlir/IR/Attributes.h"
@@ -38,11 +45,35 @@ namespace mlir {
 namespace iree_compiler {
 namespace {
 
+static llvm::cl::opt<bool> clReusableCommandBuffers(
+    "iree-hal-reusable-command-buffers",
+    llvm::cl::desc("Experimental: records command buffers for streams with "
+                   "static shapes once and reuses them on every invocation. "
+                   "Stream inputs and outputs are copied through persistent "
+                   "staging buffers on every call, which may cost more than "
+                   "recording for large tensors"),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<int64_t> clReusableCommandBuffersMaxStagingBytes(
+    "iree-hal-reusable-command-buffers-max-staging-bytes",
+    llvm::cl::desc("Streams whose inputs and outputs require more staging "
+                   "than this many bytes are recorded on every invocation "
+                   "even with -iree-hal-reusable-command-buffers"),
+    llvm::cl::init(64 * 1024));
+
 struct BufferRange {
   BufferRange() = default;
-  explicit BufferRange(Value buffer) : buffer(buffer) {}
+  explicit BufferRange(Value buffer) : buffer(buffer), allocation(buffer) {}
+  BufferRange(Value buffer, Value allocation, unsigned slot)
+      : buffer(buffer), allocation(allocation), slot(slot) {}
 
+  // Buffer bound when accessing the range.
   Value buffer = nullptr;
+
+  // Allocation backing |buffer| and the slot within it that |buffer| covers.
+  // Ranges of the same allocation in different slots never overlap.
+  Value allocation = nullptr;
+  unsigned slot = 0;
 };
 
 // Allocated buffers used within the stream.
@@ -67,22 +98,35 @@ static bool isNoOp(Operation *op) { return isa<Shape::MakeRankedShapeOp>(op); }
 // identity.
 static bool isIdentityOp(Operation *op) { return isa<Shape::TieShapeOp>(op); }
 
-// Allocates a buffer for the given stream output value.
-// |streamValue| is the Value used within the stream region and
-// |externalValue| is the returned value from the stream region in the parent
-// block.
-static Value allocateOutputBuffer(Value streamValue, Value externalValue,
-                                  Value allocator,
-                                  ConversionPatternRewriter &rewriter) {
-  Location loc = externalValue.getLoc();
-  // TODO(benvanik): compute from SSA use-def chain uses.
-  IREE::HAL::MemoryTypeBitfield memoryTypes =
-      IREE::HAL::MemoryTypeBitfield::DeviceLocal |
-      IREE::HAL::MemoryTypeBitfield::HostVisible;
-  IREE::HAL::BufferUsageBitfield bufferUsage =
-      IREE::HAL::BufferUsageBitfield::All;
+// Returns true if |user| is the last use of the buffer storing |value| and
+// may overwrite it. Values from outside of the stream are never overwritten
+// as the caller may still use them.
+static bool isLastBufferUse(Value value, Operation *user) {
+  while (true) {
+    if (!value.hasOneUse() || *value.user_begin() != user) return false;
+    auto *definingOp = value.getDefiningOp();
+    if (!definingOp) return false;
+    if (!isIdentityOp(definingOp)) return true;
+    user = definingOp;
+    value = definingOp->getOperand(0);
+  }
+}
 
-  // Compute the allocation size for the value.
+// Returns the operand of |op| whose buffer also stores the op's result, if
+// any. Tensor updates write into their target buffer when nothing else uses
+// the target afterwards.
+static Value getTiedOperand(Operation *op) {
+  if (isIdentityOp(op)) return op->getOperand(0);
+  if (auto updateOp = dyn_cast<IREE::Flow::TensorUpdateOp>(op)) {
+    if (isLastBufferUse(updateOp.target(), op)) return updateOp.target();
+  }
+  return {};
+}
+
+// Returns the size in bytes of the buffer storing |streamValue|.
+static Value computeBufferSize(Location loc, Value streamValue,
+                               Value allocator,
+                               ConversionPatternRewriter &rewriter) {
   auto elementType = IREE::HAL::getElementTypeValue(
       streamValue.getType().cast<ShapedType>().getElementType());
   if (!elementType) {
@@ -92,32 +136,164 @@ static Value allocateOutputBuffer(Value streamValue, Value externalValue,
   if (!shape) {
     return {};
   }
-  auto allocationSize = rewriter
-                            .create<IREE::HAL::AllocatorComputeSizeOp>(
-                                loc, allocator, *shape, elementType.getValue())
-                            .getResult();
+  return rewriter
+      .create<IREE::HAL::AllocatorComputeSizeOp>(loc, allocator, *shape,
+                                                 elementType.getValue())
+      .getResult();
+}
 
-  auto buffer =
-      rewriter
-          .create<IREE::HAL::AllocatorAllocateOp>(loc, allocator, memoryTypes,
-                                                  bufferUsage, allocationSize)
-          .getResult();
+// Memory types and usage required of a buffer by the ops accessing it.
+struct BufferRequirements {
+  IREE::HAL::MemoryTypeBitfield memoryTypes =
+      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
+  IREE::HAL::BufferUsageBitfield bufferUsage =
+      IREE::HAL::BufferUsageBitfield::None;
+};
+
+// Returns how the command recorded for |op| uses the buffers it accesses.
+static IREE::HAL::BufferUsageBitfield getCommandBufferUsage(Operation *op) {
+  if (isa<IREE::Flow::DispatchOp>(op)) {
+    return IREE::HAL::BufferUsageBitfield::Dispatch;
+  } else if (isa<IREE::Flow::TensorUpdateOp>(op)) {
+    return IREE::HAL::BufferUsageBitfield::Transfer;
+  }
+  return IREE::HAL::BufferUsageBitfield::None;
+}
+
+// Returns how the commands within the stream use the buffer storing
+// |streamValue|, including any values sharing the buffer through identity ops
+// and tied updates.
+static IREE::HAL::BufferUsageBitfield computeStreamBufferUsage(
+    Value streamValue) {
+  auto bufferUsage = IREE::HAL::BufferUsageBitfield::None;
+  llvm::SmallDenseSet<Value, 8> visitedValues;
+  SmallVector<Value, 4> worklist{streamValue};
+  while (!worklist.empty()) {
+    auto value = worklist.pop_back_val();
+    if (!visitedValues.insert(value).second) continue;
+    if (auto *definingOp = value.getDefiningOp()) {
+      bufferUsage = bufferUsage | getCommandBufferUsage(definingOp);
+      if (auto tiedOperand = getTiedOperand(definingOp)) {
+        worklist.push_back(tiedOperand);
+      }
+    }
+    for (auto *user : value.getUsers()) {
+      bufferUsage = bufferUsage | getCommandBufferUsage(user);
+      if (getTiedOperand(user) == value) {
+        worklist.push_back(user->getResult(0));
+      }
+    }
+  }
+  return bufferUsage;
+}
+
+// Adds the requirements of the ops consuming the stream result
+// |externalValue| outside of the stream to |requirements|. Other streams only
+// access the buffer from the device while host tensor ops need to map it. Any
+// other use (such as returning the buffer from the function or storing it in
+// a variable) may access it in any way.
+static void addExternalBufferRequirements(Value externalValue,
+                                          BufferRequirements &requirements) {
+  auto addHostRequirements = [&]() {
+    requirements.memoryTypes =
+        requirements.memoryTypes | IREE::HAL::MemoryTypeBitfield::HostVisible;
+    requirements.bufferUsage =
+        requirements.bufferUsage | IREE::HAL::BufferUsageBitfield::Mapping;
+  };
+  SmallVector<Value, 4> worklist{externalValue};
+  while (!worklist.empty()) {
+    auto value = worklist.pop_back_val();
+    for (auto &use : value.getUses()) {
+      auto *user = use.getOwner();
+      if (isIdentityOp(user)) {
+        worklist.push_back(user->getResult(0));
+      } else if (auto streamOp =
+                     dyn_cast<IREE::Flow::ExStreamFragmentOp>(user)) {
+        auto arg = streamOp.body().front().getArgument(use.getOperandNumber());
+        requirements.bufferUsage =
+            requirements.bufferUsage | computeStreamBufferUsage(arg);
+        if (clReusableCommandBuffers) {
+          // Reusable streams may copy the input into a staging buffer.
+          requirements.bufferUsage = requirements.bufferUsage |
+                                     IREE::HAL::BufferUsageBitfield::Transfer;
+        }
+      } else if (isa<IREE::Flow::TensorLoadOp>(user) ||
+                 isa<IREE::Flow::TensorTraceOp>(user)) {
+        addHostRequirements();
+      } else if (auto storeOp = dyn_cast<IREE::Flow::TensorStoreOp>(user)) {
+        // Stores update the target buffer in place.
+        addHostRequirements();
+        worklist.push_back(storeOp.result());
+      } else {
+        requirements.memoryTypes = IREE::HAL::MemoryTypeBitfield::DeviceLocal |
+                                   IREE::HAL::MemoryTypeBitfield::HostVisible;
+        requirements.bufferUsage = IREE::HAL::BufferUsageBitfield::All;
+        return;
+      }
+    }
+  }
+}
+
+// Returns the requirements of the buffer storing the stream output
+// |streamValue| that is returned as |externalValue| to the parent block.
+static BufferRequirements computeOutputBufferRequirements(
+    Value streamValue, Value externalValue) {
+  BufferRequirements requirements;
+  requirements.bufferUsage = computeStreamBufferUsage(streamValue);
+  addExternalBufferRequirements(externalValue, requirements);
+  return requirements;
+}
+
+// Allocates a buffer for the given stream value meeting |requirements|.
+// |streamValue| is the Value used within the stream region.
+static Value allocateOutputBuffer(Location loc, Value streamValue,
+                                  BufferRequirements requirements,
+                                  Value allocator,
+                                  ConversionPatternRewriter &rewriter) {
+  // Buffers no command accesses (such as stream inputs returned unmodified)
+  // are at most copied.
+  if (requirements.bufferUsage == IREE::HAL::BufferUsageBitfield::None) {
+    requirements.bufferUsage = IREE::HAL::BufferUsageBitfield::Transfer;
+  }
+
+  // Compute the allocation size for the value.
+  auto allocationSize =
+      computeBufferSize(loc, streamValue, allocator, rewriter);
+  if (!allocationSize) {
+    return {};
+  }
+
+  auto buffer = rewriter
+                    .create<IREE::HAL::AllocatorAllocateOp>(
+                        loc, allocator, requirements.memoryTypes,
+                        requirements.bufferUsage, allocationSize)
+                    .getResult();
 
   return buffer;
 }
 
 // Allocates all output buffers for the stream and populates the |bufferSet|
-// with the new mappings.
+// with the new mappings. When |isStaging| is set the buffers are only copied
+// out of by the caller after the stream completes.
 static void allocateOutputBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
-                                  BufferSet &bufferSet,
+                                  BufferSet &bufferSet, bool isStaging,
                                   ConversionPatternRewriter &rewriter) {
   // Allocate output buffers and replace the original uses with the buffers.
   auto returnOp = cast<IREE::Flow::ReturnOp>(streamOp.body().front().back());
   for (auto result : llvm::enumerate(streamOp.getResults())) {
     auto streamValue = returnOp.getOperand(result.index());
     auto externalValue = result.value();
-    auto buffer = allocateOutputBuffer(streamValue, externalValue,
-                                       bufferSet.allocator, rewriter);
+    BufferRequirements requirements;
+    if (isStaging) {
+      requirements.bufferUsage = computeStreamBufferUsage(streamValue) |
+                                 IREE::HAL::BufferUsageBitfield::Transfer;
+    } else {
+      requirements =
+          computeOutputBufferRequirements(streamValue, externalValue);
+    }
+    auto buffer =
+        allocateOutputBuffer(externalValue.getLoc(), streamValue, requirements,
+                             bufferSet.allocator, rewriter);
     auto bufferRange = BufferRange{buffer};
     bufferSet.rangeMap[externalValue] = bufferRange;
     bufferSet.rangeMap[streamValue] = bufferRange;
@@ -125,46 +301,156 @@ static void allocateOutputBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   }
 }
 
-// Allocates a transient buffer for use entirely within the command buffer.
-static Value allocateTransientBuffer(Value streamValue, Value allocator,
-                                     ConversionPatternRewriter &rewriter) {
-  Location loc = streamValue.getLoc();
-  // TODO(benvanik): compute from SSA use-def chain uses.
-  IREE::HAL::MemoryTypeBitfield memoryTypes =
-      IREE::HAL::MemoryTypeBitfield::DeviceLocal;
-  IREE::HAL::BufferUsageBitfield bufferUsage =
-      IREE::HAL::BufferUsageBitfield::Dispatch |
-      IREE::HAL::BufferUsageBitfield::Transfer;
+// Alignment of each transient buffer packed into the shared transient
+// allocation. This satisfies the minimum storage buffer offset alignment of
+// the devices we target so that packed buffers can be bound directly.
+static constexpr uint64_t kTransientBufferAlignment = 256;
 
-  // Compute the allocation size for the value.
-  auto elementType = IREE::HAL::getElementTypeValue(
-      streamValue.getType().cast<ShapedType>().getElementType());
+// A value produced within the stream that requires a transient buffer.
+// Indices are the positions of ops within the stream block.
+struct TransientValue {
+  TransientValue(Value value, int definingIndex)
+      : value(value),
+        definingIndex(definingIndex),
+        lastUseIndex(definingIndex) {}
+
+  Value value;
+  // Op that writes the buffer.
+  int definingIndex;
+  // Last op that reads the buffer, including through identity ops.
+  int lastUseIndex;
+  // Size of the buffer in bytes and the same value if known statically.
+  Value allocationSize;
+  Optional<uint64_t> staticAllocationSize;
+  // Slot within the transient allocation the buffer is packed into.
+  unsigned slot = 0;
+};
+
+// A range of the transient allocation shared by transient values that are
+// never live at the same time.
+struct TransientSlot {
+  int lastUseIndex;
+  Value size;
+  Optional<uint64_t> staticSize;
+};
+
+// Returns max(|lhs|, |rhs|) for two device sizes.
+static Value createMaxSize(Location loc, Value lhs, Value rhs,
+                           ConversionPatternRewriter &rewriter) {
+  auto isGreater =
+      rewriter.createOrFold<CmpIOp>(loc, CmpIPredicate::ugt, lhs, rhs);
+  return rewriter.createOrFold<SelectOp>(loc, isGreater, lhs, rhs);
+}
+
+// Returns |value| rounded up to a multiple of |alignment|.
+static Value createAlignedSize(Location loc, Value value, uint64_t alignment,
+                               ConversionPatternRewriter &rewriter) {
+  auto mask = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, alignment - 1);
+  auto invertedMask =
+      rewriter.createOrFold<mlir::ConstantIndexOp>(loc, ~(alignment - 1));
+  return rewriter.createOrFold<AndOp>(
+      loc, rewriter.createOrFold<AddIOp>(loc, value, mask), invertedMask);
+}
+
+// Computes the allocation size of the buffer storing |transientValue|.
+static LogicalResult computeTransientBufferSize(
+    TransientValue &transientValue, Value allocator,
+    ConversionPatternRewriter &rewriter) {
+  Value streamValue = transientValue.value;
+  Location loc = streamValue.getLoc();
+  auto shapedType = streamValue.getType().cast<ShapedType>();
+  auto elementType =
+      IREE::HAL::getElementTypeValue(shapedType.getElementType());
   if (!elementType) {
-    return {};
+    return failure();
   }
   auto shape = IREE::HAL::getShapeDims(loc, streamValue, rewriter);
   if (!shape) {
-    return {};
+    return failure();
   }
-  auto allocationSize = rewriter
-                            .create<IREE::HAL::AllocatorComputeSizeOp>(
-                                loc, allocator, *shape, elementType.getValue())
-                            .getResult();
-
-  auto buffer =
+  transientValue.allocationSize =
       rewriter
-          .create<IREE::HAL::AllocatorAllocateOp>(loc, allocator, memoryTypes,
-                                                  bufferUsage, allocationSize)
+          .create<IREE::HAL::AllocatorComputeSizeOp>(loc, allocator, *shape,
+                                                     elementType.getValue())
           .getResult();
+  if (shapedType.hasStaticShape()) {
+    transientValue.staticAllocationSize =
+        shapedType.getNumElements() *
+        IREE::HAL::getRoundedElementByteWidth(shapedType.getElementType());
+  }
+  return success();
+}
 
-  return buffer;
+// Returns a cost used to pick the slot |transientValue| is packed into, where
+// lower is better: static slots that fit with the least waste, then static
+// slots that need to grow the least, and then slots that need a dynamic size.
+static std::pair<int, uint64_t> getSlotCost(
+    const TransientSlot &slot, const TransientValue &transientValue) {
+  auto required = transientValue.staticAllocationSize;
+  if (!slot.staticSize) {
+    return {required ? 2 : 0, 0};
+  } else if (!required) {
+    return {1, std::numeric_limits<uint64_t>::max() - *slot.staticSize};
+  } else if (*slot.staticSize >= *required) {
+    return {0, *slot.staticSize - *required};
+  }
+  return {1, *required - *slot.staticSize};
+}
+
+// Assigns each transient value to a slot such that values sharing a slot are
+// never live at the same time. Values are visited in the order they are
+// defined and reuse the cheapest slot that has been freed, growing it if
+// needed, before a new slot is added.
+static SmallVector<TransientSlot, 4> packTransientValues(
+    Location loc, MutableArrayRef<TransientValue> transientValues,
+    ConversionPatternRewriter &rewriter) {
+  SmallVector<TransientSlot, 4> slots;
+  for (auto &transientValue : transientValues) {
+    // Ops may read their operands while writing their results so a slot is
+    // only free once its last use has completed.
+    Optional<unsigned> bestSlot;
+    for (unsigned i = 0; i < slots.size(); ++i) {
+      if (slots[i].lastUseIndex >= transientValue.definingIndex) continue;
+      if (!bestSlot || getSlotCost(slots[i], transientValue) <
+                           getSlotCost(slots[*bestSlot], transientValue)) {
+        bestSlot = i;
+      }
+    }
+
+    if (!bestSlot) {
+      transientValue.slot = slots.size();
+      slots.push_back({transientValue.lastUseIndex,
+                       transientValue.allocationSize,
+                       transientValue.staticAllocationSize});
+      continue;
+    }
+
+    auto &slot = slots[*bestSlot];
+    transientValue.slot = *bestSlot;
+    slot.lastUseIndex = transientValue.lastUseIndex;
+    if (slot.staticSize && transientValue.staticAllocationSize) {
+      if (*transientValue.staticAllocationSize > *slot.staticSize) {
+        slot.size = transientValue.allocationSize;
+        slot.staticSize = transientValue.staticAllocationSize;
+      }
+    } else {
+      slot.size = createMaxSize(loc, slot.size, transientValue.allocationSize,
+                                rewriter);
+      slot.staticSize = llvm::None;
+    }
+  }
+  return slots;
 }
 
 // Allocates transient buffers to store the intra-stream results and populates
 // the |bufferSet| with the new mappings.
-static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
-                                     BufferSet &bufferSet,
-                                     ConversionPatternRewriter &rewriter) {
+//
+// Transient values whose live ranges within the stream do not overlap are
+// packed into the same range of a single allocation and each value is bound
+// to a subspan of it.
+static LogicalResult allocateTransientBuffers(
+    IREE::Flow::ExStreamFragmentOp streamOp, BufferSet &bufferSet,
+    ConversionPatternRewriter &rewriter) {
   LLVM_DEBUG(llvm::dbgs() << ": HAL allocateTransientBuffers: "
                           << *streamOp.getOperation() << "\n");
 
@@ -172,32 +458,28 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
     bool madeChange = false;
     // Pull outputs that terminate on identities to operands.
     for (auto &op : llvm::reverse(streamOp.body().front())) {
-      if (isIdentityOp(&op)) {
+      if (auto operand = getTiedOperand(&op)) {
         auto result = op.getResult(0);
-        auto operand = op.getOperand(0);
         if (bufferSet.rangeMap[result].buffer &&
             !bufferSet.rangeMap[operand].buffer) {
           LLVM_DEBUG(llvm::dbgs() << "  + PROPAGATE IDENTITY RESULT->OPERAND: "
                                   << op << "\n");
           madeChange = true;
-          bufferSet.rangeMap[operand].buffer =
-              bufferSet.rangeMap[result].buffer;
+          bufferSet.rangeMap[operand] = bufferSet.rangeMap[result];
         }
       }
     }
 
     // Push inputs that originate on identities to results.
     for (auto &op : streamOp.body().front()) {
-      if (isIdentityOp(&op)) {
-        auto operand = op.getOperand(0);
+      if (auto operand = getTiedOperand(&op)) {
         auto result = op.getResult(0);
         if (bufferSet.rangeMap[operand].buffer &&
             !bufferSet.rangeMap[result].buffer) {
           LLVM_DEBUG(llvm::dbgs() << "  + PROPAGATE IDENTITY OPERAND->RESULT: "
                                   << op << "\n");
           madeChange = true;
-          bufferSet.rangeMap[result].buffer =
-              bufferSet.rangeMap[operand].buffer;
+          bufferSet.rangeMap[result] = bufferSet.rangeMap[operand];
         }
       }
     }
@@ -213,11 +495,33 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
   // propagate across identity ops again (to account for identity ops on
   // the interior).
   // Because there may be runs of identity ops, propagation loops until no
-  // changes are made.
+  // changes are made. Tensor updates tied to their target are propagated the
+  // same way so that they are performed in place.
   while (propagateIdentityBuffers()) {
   }
-  for (auto &op : streamOp.body().front()) {
-    if (isNoOp(&op) || isIdentityOp(&op)) continue;
+
+  // Gather the transient values and compute their live ranges. Identity ops
+  // and tied updates extend the live range of their operand to cover the uses
+  // of their result.
+  SmallVector<TransientValue, 8> transientValues;
+  DenseMap<Value, unsigned> transientValueMap;
+  for (auto opIt : llvm::enumerate(streamOp.body().front())) {
+    auto &op = opIt.value();
+    int opIndex = static_cast<int>(opIt.index());
+    for (auto operand : op.getOperands()) {
+      auto transientIt = transientValueMap.find(operand);
+      if (transientIt == transientValueMap.end()) continue;
+      transientValues[transientIt->second].lastUseIndex = opIndex;
+    }
+    if (isNoOp(&op)) continue;
+    if (auto tiedOperand = getTiedOperand(&op)) {
+      auto transientIt = transientValueMap.find(tiedOperand);
+      if (transientIt != transientValueMap.end() &&
+          !bufferSet.rangeMap[op.getResult(0)].buffer) {
+        transientValueMap[op.getResult(0)] = transientIt->second;
+      }
+      continue;
+    }
     for (auto it : llvm::enumerate(op.getResults())) {
       auto result = it.value();
       // If the result is an output buffer we can just use that directly.
@@ -228,13 +532,76 @@ static void allocateTransientBuffers(IREE::Flow::ExStreamFragmentOp streamOp,
       }
       LLVM_DEBUG(llvm::dbgs() << "    -- ALLOCATE BUFFER FOR RESULT("
                               << it.index() << "): " << op << "\n");
-      auto buffer =
-          allocateTransientBuffer(result, bufferSet.allocator, rewriter);
-      bufferSet.rangeMap[result] = BufferRange{buffer};
+      transientValueMap[result] = transientValues.size();
+      transientValues.emplace_back(result, opIndex);
+    }
+  }
+  if (transientValues.empty()) return success();
+
+  for (auto &transientValue : transientValues) {
+    if (failed(computeTransientBufferSize(transientValue, bufferSet.allocator,
+                                          rewriter))) {
+      return streamOp.emitOpError()
+             << "unable to compute transient buffer size for "
+             << transientValue.value;
+    }
+  }
+
+  // Pack the values into slots and lay the slots out one after another.
+  Location loc = streamOp.getLoc();
+  auto slots = packTransientValues(loc, transientValues, rewriter);
+  SmallVector<Value, 4> slotOffsets;
+  Value allocationSize;
+  for (auto &slot : slots) {
+    if (!allocationSize) {
+      slotOffsets.push_back(
+          rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0));
+      allocationSize = slot.size;
+      continue;
+    }
+    auto offset = createAlignedSize(loc, allocationSize,
+                                    kTransientBufferAlignment, rewriter);
+    slotOffsets.push_back(offset);
+    allocationSize = rewriter.createOrFold<AddIOp>(loc, offset, slot.size);
+  }
+  LLVM_DEBUG(llvm::dbgs() << "  + PACKED " << transientValues.size()
+                          << " TRANSIENT VALUES INTO " << slots.size()
+                          << " SLOTS\n");
+
+  // Transient values are never visible outside of the stream and the shared
+  // allocation only needs the usage of the commands accessing them.
+  BufferRequirements requirements;
+  for (auto &transientValue : transientValues) {
+    requirements.bufferUsage = requirements.bufferUsage |
+                               computeStreamBufferUsage(transientValue.value);
+  }
+  auto transientBuffer =
+      rewriter
+          .create<IREE::HAL::AllocatorAllocateOp>(
+              loc, bufferSet.allocator, requirements.memoryTypes,
+              requirements.bufferUsage, allocationSize)
+          .getResult();
+
+  // Values in the first slot start at the beginning of the allocation and can
+  // use it directly as bindings only cover the tensor byte length.
+  for (auto &transientValue : transientValues) {
+    Value buffer = transientBuffer;
+    if (transientValue.slot != 0) {
+      buffer = rewriter
+                   .create<IREE::HAL::BufferSubspanOp>(
+                       transientValue.value.getLoc(),
+                       IREE::HAL::BufferType::get(rewriter.getContext()),
+                       transientBuffer, slotOffsets[transientValue.slot],
+                       transientValue.allocationSize)
+                   .getResult();
     }
+    bufferSet.rangeMap[transientValue.value] =
+        BufferRange{buffer, transientBuffer, transientValue.slot};
   }
+
   while (propagateIdentityBuffers()) {
   }
+  return success();
 }
 
 // Records a full execution barrier that forces visibility of all buffers.
@@ -249,9 +616,11 @@ static void recordFullExecutionBarrier(Value commandBuffer, Location loc,
   rewriter.create<IREE::HAL::CommandBufferExecutionBarrierOp>(
       loc, commandBuffer,
       IREE::HAL::ExecutionStageBitfield::CommandRetire |
-          IREE::HAL::ExecutionStageBitfield::Dispatch,
+          IREE::HAL::ExecutionStageBitfield::Dispatch |
+          IREE::HAL::ExecutionStageBitfield::Transfer,
       IREE::HAL::ExecutionStageBitfield::CommandIssue |
-          IREE::HAL::ExecutionStageBitfield::Dispatch,
+          IREE::HAL::ExecutionStageBitfield::Dispatch |
+          IREE::HAL::ExecutionStageBitfield::Transfer,
       ArrayRef<Value>{memoryBarrier}, ArrayRef<Value>{});
 }
 
@@ -442,11 +811,6 @@ static LogicalResult recordDispatch(Value device, Value commandBuffer,
     }
   }
   switchRewriter.build();
-
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, dispatchOp.getLoc(), rewriter);
   return success();
 }
 
@@ -484,50 +848,421 @@ static LogicalResult recordTensorUpdate(Value device, Value commandBuffer,
       target->computeRange(startIndices, *update->getShapeDims());
   if (!targetRange) return failure();
 
-  // TODO(benvanik): actual buffer allocation so we aren't doing this copy.
-  auto targetByteLength = target->getByteLength();
-  if (!targetByteLength) return failure();
+  // When the result is stored in the target buffer only the update range is
+  // written; otherwise the target is copied into the result first.
+  if (resultBuffer.buffer != targetBuffer.buffer) {
+    auto targetByteLength = target->getByteLength();
+    if (!targetByteLength) return failure();
 
-  rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
-      updateOp.getLoc(), commandBuffer, target->getBuffer(), zeroOffset,
-      result->getBuffer(), zeroOffset, targetByteLength);
-  // TODO(benvanik): slice left/mid/right, but really just don't do this.
-  recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
+    rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
+        updateOp.getLoc(), commandBuffer, target->getBuffer(), zeroOffset,
+        result->getBuffer(), zeroOffset, targetByteLength);
+    // TODO(benvanik): slice left/mid/right, but really just don't do this.
+    recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
+  }
   rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
       updateOp.getLoc(), commandBuffer, update->getBuffer(), zeroOffset,
       result->getBuffer(), targetRange->offset, targetRange->length);
+  return success();
+}
+
+// A command within the stream along with the buffer ranges it accesses.
+struct StreamCommand {
+  explicit StreamCommand(Operation *op) : op(op) {}
+
+  Operation *op;
+  SmallVector<BufferRange, 4> readRanges;
+  SmallVector<BufferRange, 4> writeRanges;
+
+  // Commands only depend on commands at lower levels and those at the same
+  // level can execute concurrently.
+  int level = 0;
+};
+
+// Returns true if |lhs| and |rhs| may refer to the same bytes.
+// Ranges of distinct allocations are assumed not to alias: only the stream
+// inputs are not allocated here and they are never written.
+static bool buffersOverlap(const BufferRange &lhs, const BufferRange &rhs) {
+  return lhs.allocation == rhs.allocation && lhs.slot == rhs.slot;
+}
+
+// Returns true if |after| must wait for |before| to complete as it reads a
+// range |before| writes (RAW), or writes a range |before| reads (WAR) or
+// writes (WAW).
+static bool hasHazard(const StreamCommand &before,
+                      const StreamCommand &after) {
+  auto anyOverlap = [](ArrayRef<BufferRange> lhs, ArrayRef<BufferRange> rhs) {
+    for (auto &lhsRange : lhs) {
+      for (auto &rhsRange : rhs) {
+        if (buffersOverlap(lhsRange, rhsRange)) return true;
+      }
+    }
+    return false;
+  };
+  return anyOverlap(before.writeRanges, after.readRanges) ||
+         anyOverlap(before.writeRanges, after.writeRanges) ||
+         anyOverlap(before.readRanges, after.writeRanges);
+}
+
+// Gathers the commands in |streamBlock| into |commands| in the order they
+// should be recorded.
+//
+// Each command is placed one level after the latest command it has a hazard
+// with and commands are then sorted by level. As every command at a level
+// depends on one at the previous level, a single barrier between each level is
+// the minimal set of full barriers that preserves the stream semantics.
+static LogicalResult scheduleStreamCommands(
+    Block &streamBlock, BufferSet &bufferSet,
+    SmallVectorImpl<StreamCommand> &commands) {
+  auto addTensorRanges = [&](ValueRange values,
+                             SmallVectorImpl<BufferRange> &ranges) {
+    for (auto value : values) {
+      if (!value.getType().isa<TensorType>()) continue;
+      auto &bufferRange = bufferSet.rangeMap[value];
+      assert(bufferRange.buffer && "buffer not preallocated");
+      ranges.push_back(bufferRange);
+    }
+  };
+  for (auto &op : streamBlock) {
+    if (auto dispatchOp = dyn_cast<IREE::Flow::DispatchOp>(op)) {
+      StreamCommand command(&op);
+      addTensorRanges(dispatchOp.operands(), command.readRanges);
+      addTensorRanges(dispatchOp.results(), command.writeRanges);
+      commands.push_back(std::move(command));
+    } else if (auto updateOp = dyn_cast<IREE::Flow::TensorUpdateOp>(op)) {
+      StreamCommand command(&op);
+      addTensorRanges({updateOp.target(), updateOp.update()},
+                      command.readRanges);
+      addTensorRanges(updateOp.result(), command.writeRanges);
+      commands.push_back(std::move(command));
+    } else if (auto returnOp = dyn_cast<IREE::Flow::ReturnOp>(op)) {
+      // No-op; handled by the buffer allocation.
+    } else if (isNoOp(&op) || isIdentityOp(&op)) {
+      // No work to perform. For identity ops, all buffers have been pushed
+      // to "real" ops.
+    } else {
+      return op.emitOpError() << "unexpected in stream";
+    }
+  }
 
-  // Full barriers for now as we aren't scheduling things.
-  // TODO(benvanik): don't add at the end of the command buffer (we could
-  // also do a canonicalization step that removed trailing barriers).
-  recordFullExecutionBarrier(commandBuffer, updateOp.getLoc(), rewriter);
+  for (unsigned i = 0; i < commands.size(); ++i) {
+    for (unsigned j = 0; j < i; ++j) {
+      if (commands[j].level >= commands[i].level &&
+          hasHazard(commands[j], commands[i])) {
+        commands[i].level = commands[j].level + 1;
+      }
+    }
+  }
+  std::stable_sort(commands.begin(), commands.end(),
+                   [](const StreamCommand &lhs, const StreamCommand &rhs) {
+                     return lhs.level < rhs.level;
+                   });
   return success();
 }
 
+// Records the stream commands, reordering independent commands such that
+// they can execute concurrently and only inserting barriers where required.
+// No trailing barrier is needed as the command buffer is waited on as a
+// whole.
 static LogicalResult recordStreamCommands(Value device, Value commandBuffer,
                                           Block &streamBlock,
                                           BufferSet &bufferSet,
                                           ConversionPatternRewriter &rewriter) {
-  for (auto &op : streamBlock) {
-    if (auto dispatchOp = dyn_cast<IREE::Flow::DispatchOp>(op)) {
+  SmallVector<StreamCommand, 8> commands;
+  if (failed(scheduleStreamCommands(streamBlock, bufferSet, commands))) {
+    return failure();
+  }
+  for (auto it : llvm::enumerate(commands)) {
+    auto &command = it.value();
+    if (it.index() > 0 && commands[it.index() - 1].level != command.level) {
+      // The HAL module does not support buffer barriers so levels are
+      // separated by full barriers.
+      recordFullExecutionBarrier(commandBuffer, command.op->getLoc(),
+                                 rewriter);
+    }
+    if (auto dispatchOp = dyn_cast<IREE::Flow::DispatchOp>(command.op)) {
       if (failed(recordDispatch(device, commandBuffer, dispatchOp, bufferSet,
                                 rewriter))) {
         return failure();
       }
-    } else if (auto updateOp = dyn_cast<IREE::Flow::TensorUpdateOp>(op)) {
+    } else if (auto updateOp =
+                   dyn_cast<IREE::Flow::TensorUpdateOp>(command.op)) {
       if (failed(recordTensorUpdate(device, commandBuffer, updateOp, bufferSet,
                                     rewriter))) {
         return failure();
       }
-    } else if (auto returnOp = dyn_cast<IREE::Flow::ReturnOp>(op)) {
-      // No-op; handled by the buffer allocation.
-    } else if (isNoOp(&op) || isIdentityOp(&op)) {
-      // No work to perform. For identity ops, all buffers have been pushed
-      // to "real" ops.
+    }
+  }
+  return success();
+}
+
+// Returns the name of the variable |value| is loaded from if the variable is
+// immutable such that its buffer is the same on every invocation.
+static Optional<StringRef> getImmutableVariableName(Value value) {
+  auto loadOp =
+      dyn_cast_or_null<IREE::Flow::VariableLoadOp>(value.getDefiningOp());
+  if (!loadOp) return llvm::None;
+  auto *symbolOp =
+      SymbolTable::lookupNearestSymbolFrom(loadOp, loadOp.variable());
+  if (auto variableOp = dyn_cast_or_null<IREE::Flow::VariableOp>(symbolOp)) {
+    if (variableOp.is_mutable()) return llvm::None;
+  } else if (auto variableOp =
+                 dyn_cast_or_null<IREE::HAL::VariableOp>(symbolOp)) {
+    if (variableOp.is_mutable()) return llvm::None;
+  } else {
+    return llvm::None;
+  }
+  return loadOp.variable();
+}
+
+// Returns true if the commands recorded for |streamOp| are the same on every
+// invocation and reusing them is expected to be cheaper than recording: all
+// tensors have static shapes, all other operands, such as workloads and push
+// constants, are constants, and the inputs and outputs that must be copied
+// through staging buffers on each call are small.
+static bool isStreamReusable(IREE::Flow::ExStreamFragmentOp streamOp) {
+  auto hasStaticShape = [](Type type) {
+    auto shapedType = type.dyn_cast<ShapedType>();
+    return !shapedType || shapedType.hasStaticShape();
+  };
+  auto getByteLength = [](Type type) {
+    auto shapedType = type.cast<ShapedType>();
+    return shapedType.getNumElements() *
+           static_cast<int64_t>(
+               getRoundedElementByteWidth(shapedType.getElementType()));
+  };
+  int64_t stagingBytes = 0;
+  for (auto operand : streamOp.getOperands()) {
+    if (operand.getType().isa<TensorType>()) {
+      if (!hasStaticShape(operand.getType())) return false;
+      if (!getImmutableVariableName(operand)) {
+        stagingBytes += getByteLength(operand.getType());
+      }
+    } else if (!matchPattern(operand, m_Constant())) {
+      return false;
+    }
+  }
+  bool hasDispatch = false;
+  for (auto &op : streamOp.body().front()) {
+    if (isa<IREE::Flow::DispatchOp>(op)) hasDispatch = true;
+    if (!llvm::all_of(op.getResultTypes(), hasStaticShape)) return false;
+  }
+  for (auto result : streamOp.getResults()) {
+    stagingBytes += getByteLength(result.getType());
+  }
+  return hasDispatch &&
+         stagingBytes <= clReusableCommandBuffersMaxStagingBytes;
+}
+
+// Returns a symbol name prefix for the variables caching the command buffer of
+// a stream within |funcOp| that is unique within |moduleOp|.
+static std::string getUniqueStreamSymbolPrefix(ModuleOp moduleOp,
+                                               FuncOp funcOp) {
+  for (int i = 0;; ++i) {
+    auto prefix =
+        (Twine("_") + funcOp.getName() + "_stream_" + Twine(i)).str();
+    if (!SymbolTable::lookupSymbolIn(moduleOp, prefix + "_command_buffer")) {
+      return prefix;
+    }
+  }
+}
+
+// Converts a stream whose commands are the same on every invocation (see
+// isStreamReusable) to submit a command buffer recorded once by a variable
+// initializer.
+//
+// Recorded command buffers keep referencing the buffers they were recorded
+// with so every buffer bound within the stream is owned by a variable. As the
+// bindings cannot be changed after recording the stream inputs and outputs are
+// staged: per-call command buffers submitted in the same batch copy the inputs
+// into persistent buffers before the recorded commands execute and copy the
+// outputs out of persistent buffers afterward. Inputs loaded from immutable
+// variables are bound directly.
+static LogicalResult convertReusableStream(
+    IREE::Flow::ExStreamFragmentOp streamOp, llvm::ArrayRef<Value> operands,
+    Value device, Value allocator, ConversionPatternRewriter &rewriter) {
+  Location loc = streamOp.getLoc();
+  auto moduleOp = streamOp.getParentOfType<ModuleOp>();
+  auto funcOp = streamOp.getParentOfType<FuncOp>();
+  auto symbolPrefix = getUniqueStreamSymbolPrefix(moduleOp, funcOp);
+  auto bufferType = IREE::HAL::BufferType::get(rewriter.getContext());
+  auto commandBufferType =
+      IREE::HAL::CommandBufferType::get(rewriter.getContext());
+  auto category = IREE::HAL::CommandCategoryBitfield::Dispatch |
+                  IREE::HAL::CommandCategoryBitfield::Transfer;
+  auto &entryBlock = streamOp.body().front();
+
+  // Initializers run in module order so the cache is defined at the end of the
+  // module where all of the resources it depends on have been initialized.
+  auto callInsertionPoint = rewriter.saveInsertionPoint();
+  rewriter.setInsertionPoint(moduleOp.getBody()->getTerminator());
+  auto initializerOp = rewriter.create<FuncOp>(
+      loc, symbolPrefix + "_command_buffer_initializer",
+      rewriter.getFunctionType({}, {commandBufferType}));
+  SymbolTable::setSymbolVisibility(initializerOp,
+                                   SymbolTable::Visibility::Private);
+  rewriter.setInsertionPoint(initializerOp);
+  auto commandBufferVariableOp = rewriter.create<IREE::HAL::VariableOp>(
+      loc, symbolPrefix + "_command_buffer", /*isMutable=*/false,
+      initializerOp);
+  SymbolTable::setSymbolVisibility(commandBufferVariableOp,
+                                   SymbolTable::Visibility::Private);
+
+  // Record the commands into the initializer. Constant operands are
+  // rematerialized and tensor operands are bound to their persistent buffers.
+  rewriter.setInsertionPointToEnd(initializerOp.addEntryBlock());
+  auto initDevice = rewriter.createOrFold<IREE::HAL::ExSharedDeviceOp>(loc);
+  auto initAllocator =
+      rewriter.create<IREE::HAL::DeviceAllocatorOp>(loc, initDevice)
+          .getResult();
+  BufferSet bufferSet{initAllocator};
+  SmallVector<std::pair<unsigned, Value>, 4> stagedInputs;
+  for (int i = 0; i < operands.size(); ++i) {
+    auto operand = streamOp.getOperand(i);
+    auto arg = entryBlock.getArgument(i);
+    if (!operand.getType().isa<TensorType>()) {
+      Attribute constantValue;
+      matchPattern(operand, m_Constant(&constantValue));
+      rewriter.replaceUsesOfBlockArgument(
+          arg, rewriter.create<mlir::ConstantOp>(loc, constantValue));
+    } else if (auto variableName = getImmutableVariableName(operand)) {
+      bufferSet.rangeMap[arg] =
+          BufferRange{rewriter.createOrFold<IREE::HAL::VariableLoadOp>(
+              loc, bufferType, rewriter.getSymbolRefAttr(*variableName))};
     } else {
-      return op.emitOpError() << "unexpected in stream";
+      BufferRequirements requirements;
+      requirements.bufferUsage = computeStreamBufferUsage(arg) |
+                                 IREE::HAL::BufferUsageBitfield::Transfer;
+      auto buffer = allocateOutputBuffer(operand.getLoc(), arg, requirements,
+                                         initAllocator, rewriter);
+      if (!buffer) {
+        return streamOp.emitOpError()
+               << "unable to allocate staging buffer for operand " << i;
+      }
+      bufferSet.rangeMap[arg] = BufferRange{buffer};
+      stagedInputs.emplace_back(i, buffer);
     }
   }
+  allocateOutputBuffers(streamOp, bufferSet, /*isStaging=*/true, rewriter);
+  if (failed(allocateTransientBuffers(streamOp, bufferSet, rewriter))) {
+    return failure();
+  }
+  auto commandBuffer = rewriter.createOrFold<IREE::HAL::CommandBufferCreateOp>(
+      loc, initDevice, IREE::HAL::CommandBufferModeBitfield::None, category);
+  rewriter.create<IREE::HAL::CommandBufferBeginOp>(loc, commandBuffer);
+  if (failed(recordStreamCommands(initDevice, commandBuffer, entryBlock,
+                                  bufferSet, rewriter))) {
+    return failure();
+  }
+  rewriter.create<IREE::HAL::CommandBufferEndOp>(loc, commandBuffer);
+
+  // Store every buffer created by the initializer in a variable to keep it
+  // alive for as long as the command buffer.
+  SmallVector<Value, 8> ownedBuffers;
+  for (auto &op : *rewriter.getInsertionBlock()) {
+    if (isa<IREE::HAL::VariableLoadOp>(op)) continue;
+    for (auto result : op.getResults()) {
+      if (result.getType().isa<IREE::HAL::BufferType>()) {
+        ownedBuffers.push_back(result);
+      }
+    }
+  }
+  DenseMap<Value, std::string> bufferVariableNames;
+  for (auto buffer : llvm::enumerate(ownedBuffers)) {
+    auto variableName =
+        (Twine(symbolPrefix) + "_buffer_" + Twine(buffer.index())).str();
+    {
+      OpBuilder::InsertionGuard g(rewriter);
+      rewriter.setInsertionPoint(commandBufferVariableOp);
+      auto variableOp = rewriter.create<IREE::HAL::VariableOp>(
+          loc, variableName, /*isMutable=*/true, bufferType);
+      SymbolTable::setSymbolVisibility(variableOp,
+                                       SymbolTable::Visibility::Private);
+    }
+    rewriter.create<IREE::HAL::VariableStoreOp>(loc, buffer.value(),
+                                                variableName);
+    bufferVariableNames[buffer.value()] = variableName;
+  }
+  rewriter.create<mlir::ReturnOp>(loc, commandBuffer);
+  rewriter.restoreInsertionPoint(callInsertionPoint);
+
+  auto loadBufferVariable = [&](Value initBuffer) {
+    return rewriter.createOrFold<IREE::HAL::VariableLoadOp>(
+        loc, bufferType,
+        rewriter.getSymbolRefAttr(bufferVariableNames[initBuffer]));
+  };
+  SmallVector<Value, 3> commandBuffers;
+
+  // Copy the inputs into their staging buffers.
+  if (!stagedInputs.empty()) {
+    auto inputCommandBuffer =
+        rewriter.createOrFold<IREE::HAL::CommandBufferCreateOp>(
+            loc, device, IREE::HAL::CommandBufferModeBitfield::OneShot,
+            IREE::HAL::CommandCategoryBitfield::Transfer);
+    rewriter.create<IREE::HAL::CommandBufferBeginOp>(loc, inputCommandBuffer);
+    auto zeroOffset = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0);
+    for (auto &stagedInput : stagedInputs) {
+      auto length =
+          computeBufferSize(loc, entryBlock.getArgument(stagedInput.first),
+                            allocator, rewriter);
+      if (!length) return failure();
+      auto stagingBuffer = loadBufferVariable(stagedInput.second);
+      rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
+          loc, inputCommandBuffer, operands[stagedInput.first], zeroOffset,
+          stagingBuffer, zeroOffset, length);
+    }
+    recordFullExecutionBarrier(inputCommandBuffer, loc, rewriter);
+    rewriter.create<IREE::HAL::CommandBufferEndOp>(loc, inputCommandBuffer);
+    commandBuffers.push_back(inputCommandBuffer);
+  }
+
+  commandBuffers.push_back(rewriter.createOrFold<IREE::HAL::VariableLoadOp>(
+      loc, commandBufferType,
+      rewriter.getSymbolRefAttr(commandBufferVariableOp.sym_name())));
+
+  // Copy the outputs out of their staging buffers into new buffers returned to
+  // the caller.
+  auto returnOp = cast<IREE::Flow::ReturnOp>(entryBlock.back());
+  SmallVector<Value, 4> outputBuffers;
+  for (auto result : llvm::enumerate(streamOp.getResults())) {
+    BufferRequirements requirements;
+    requirements.bufferUsage = IREE::HAL::BufferUsageBitfield::Transfer;
+    addExternalBufferRequirements(result.value(), requirements);
+    auto buffer = allocateOutputBuffer(
+        result.value().getLoc(), returnOp.getOperand(result.index()),
+        requirements, allocator, rewriter);
+    if (!buffer) return failure();
+    outputBuffers.push_back(buffer);
+  }
+  auto outputCommandBuffer =
+      rewriter.createOrFold<IREE::HAL::CommandBufferCreateOp>(
+          loc, device, IREE::HAL::CommandBufferModeBitfield::OneShot,
+          IREE::HAL::CommandCategoryBitfield::Transfer);
+  rewriter.create<IREE::HAL::CommandBufferBeginOp>(loc, outputCommandBuffer);
+  recordFullExecutionBarrier(outputCommandBuffer, loc, rewriter);
+  auto zeroOffset = rewriter.createOrFold<mlir::ConstantIndexOp>(loc, 0);
+  for (auto outputBuffer : llvm::enumerate(outputBuffers)) {
+    auto length = computeBufferSize(
+        loc, returnOp.getOperand(outputBuffer.index()), allocator, rewriter);
+    if (!length) return failure();
+    auto stagingBuffer =
+        loadBufferVariable(bufferSet.outputBuffers[outputBuffer.index()]);
+    rewriter.create<IREE::HAL::CommandBufferCopyBufferOp>(
+        loc, outputCommandBuffer, stagingBuffer, zeroOffset,
+        outputBuffer.value(), zeroOffset, length);
+  }
+  rewriter.create<IREE::HAL::CommandBufferEndOp>(loc, outputCommandBuffer);
+  commandBuffers.push_back(outputCommandBuffer);
+
+  rewriter.create<IREE::HAL::ExSubmitAndWaitOp>(loc, device, commandBuffers);
+
+  for (int i = 0; i < operands.size(); ++i) {
+    if (operands[i].getType().isa<IREE::HAL::BufferType>()) {
+      rewriter.replaceUsesOfBlockArgument(entryBlock.getArgument(i),
+                                          operands[i]);
+    }
+  }
+  rewriter.replaceOp(streamOp, outputBuffers);
   return success();
 }
 
@@ -552,6 +1287,10 @@ class ExStreamFragmentOpConversion
     auto allocator =
         rewriter.create<IREE::HAL::DeviceAllocatorOp>(streamOp.getLoc(), device)
             .getResult();
+    if (clReusableCommandBuffers && isStreamReusable(streamOp)) {
+      return convertReusableStream(streamOp, operands, device, allocator,
+                                   rewriter);
+    }
     BufferSet bufferSet{allocator};
 
     // Remap non-tensor operands (such as workloads).
@@ -567,8 +1306,10 @@ class ExStreamFragmentOpConversion
     }
 
     // Allocate buffers for outputs and transient buffers.
-    allocateOutputBuffers(streamOp, bufferSet, rewriter);
-    allocateTransientBuffers(streamOp, bufferSet, rewriter);
+    allocateOutputBuffers(streamOp, bufferSet, /*isStaging=*/false, rewriter);
+    if (failed(allocateTransientBuffers(streamOp, bufferSet, rewriter))) {
+      return failure();
+    }
 
     // Allocate and begin the command buffer.
     // In a real version we would want to pick the device based on the placement
@@ -0,0 +1,143 @@
+// RUN: iree-opt -split-input-file -iree-convert-to-hal -iree-hal-reusable-command-buffers -canonicalize %s | IreeFileCheck %s
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b2, set=0, binding=2, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>, tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+flow.variable @weights dense<1.0> : tensor<128xf32>
+
+// CHECK-LABEL: func @reusableStream
+// CHECK-SAME: (%[[ARG:.+]]: !hal.buffer)
+func @reusableStream(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  %weights = flow.variable.load @weights : tensor<128xf32>
+  // The input is copied into its staging buffer.
+  //      CHECK: %[[IN_CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer"
+  // CHECK-NEXT: hal.command_buffer.begin %[[IN_CMD]]
+  //      CHECK: %[[IN_STAGING:.+]] = hal.variable.load @_reusableStream_stream_0_buffer_0 : !hal.buffer
+  // CHECK-NEXT: hal.command_buffer.copy_buffer %[[IN_CMD]], %[[ARG]], %c0, %[[IN_STAGING]], %c0, %c512
+  // CHECK-NEXT: %[[BARRIER:.+]] = hal.make_memory_barrier
+  // CHECK-NEXT: hal.command_buffer.execution_barrier %[[IN_CMD]]
+  // CHECK-NEXT: hal.command_buffer.end %[[IN_CMD]]
+  // The recorded command buffer is reused.
+  //      CHECK: %[[CMD:.+]] = hal.variable.load @_reusableStream_stream_0_command_buffer : !hal.command_buffer
+  // The output is copied out of its staging buffer.
+  //      CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate
+  //      CHECK: %[[OUT_CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer"
+  // CHECK-NEXT: hal.command_buffer.begin %[[OUT_CMD]]
+  //      CHECK: hal.command_buffer.execution_barrier %[[OUT_CMD]]
+  // CHECK-NEXT: %[[OUT_STAGING:.+]] = hal.variable.load @_reusableStream_stream_0_buffer_1 : !hal.buffer
+  // CHECK-NEXT: hal.command_buffer.copy_buffer %[[OUT_CMD]], %[[OUT_STAGING]], %c0, %[[RET_BUF]], %c0, %c512
+  // CHECK-NEXT: hal.command_buffer.end %[[OUT_CMD]]
+  // CHECK-NEXT: hal.ex.submit_and_wait {{.+}}, %[[IN_CMD]], %[[CMD]], %[[OUT_CMD]]
+  //  CHECK-NOT: hal.command_buffer.dispatch
+  // CHECK-NEXT: return %[[RET_BUF]]
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>, %arg3 = %weights : tensor<128xf32>) -> tensor<128xf32> {
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2, %arg3) : (tensor<128xf32>, tensor<128xf32>) -> tensor<128xf32>
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1, %arg3) : (tensor<128xf32>, tensor<128xf32>) -> tensor<128xf32>
+    flow.return %2 : tensor<128xf32>
+  }
+  return %0 : tensor<128xf32>
+}
+
+// Every buffer bound by the recorded commands is owned by a variable.
+// CHECK: hal.variable @_reusableStream_stream_0_buffer_0 mutable : !hal.buffer
+// CHECK: hal.variable @_reusableStream_stream_0_buffer_1 mutable : !hal.buffer
+// CHECK: hal.variable @_reusableStream_stream_0_buffer_2 mutable : !hal.buffer
+// CHECK: hal.variable @_reusableStream_stream_0_command_buffer init(@_reusableStream_stream_0_command_buffer_initializer) : !hal.command_buffer
+
+// CHECK: func @_reusableStream_stream_0_command_buffer_initializer() -> !hal.command_buffer
+// CHECK-DAG: %[[IN_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch", %c512
+// CHECK-DAG: %[[WEIGHTS:.+]] = hal.variable.load @weights : !hal.buffer
+// CHECK: %[[OUT_BUF:.+]] = hal.allocator.allocate
+// CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Dispatch"
+// CHECK: %[[CMD:.+]] = hal.command_buffer.create {{.+}}, "None", "Transfer|Dispatch"
+// CHECK-NEXT: hal.command_buffer.begin %[[CMD]]
+// CHECK: hal.command_buffer.push_descriptor_set %[[CMD]], {{.+}}, bindings=[0 = (%[[IN_BUF]], %c0, %c512), 1 = (%[[WEIGHTS]], %c0, %c512), 2 = (%[[TMP_BUF]], %c0, %c512)]
+// CHECK: hal.command_buffer.dispatch.symbol
+// CHECK: hal.command_buffer.execution_barrier %[[CMD]]
+// CHECK: hal.command_buffer.push_descriptor_set %[[CMD]], {{.+}}, bindings=[0 = (%[[TMP_BUF]], %c0, %c512), 1 = (%[[WEIGHTS]], %c0, %c512), 2 = (%[[OUT_BUF]], %c0, %c512)]
+// CHECK: hal.command_buffer.dispatch.symbol
+// CHECK: hal.command_buffer.end %[[CMD]]
+// CHECK-NEXT: hal.variable.store %[[IN_BUF]], @_reusableStream_stream_0_buffer_0 : !hal.buffer
+// CHECK-NEXT: hal.variable.store %[[OUT_BUF]], @_reusableStream_stream_0_buffer_1 : !hal.buffer
+// CHECK-NEXT: hal.variable.store %[[TMP_BUF]], @_reusableStream_stream_0_buffer_2 : !hal.buffer
+// CHECK-NEXT: return %[[CMD]] : !hal.command_buffer
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface attributes {push_constants = 1 : i32} {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>, index) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// Streams with dynamic push constants are recorded on every invocation.
+// CHECK-LABEL: func @dynamicPushConstants
+func @dynamicPushConstants(%arg0: tensor<128xf32>, %arg1: index) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer|Dispatch"
+  // CHECK: hal.command_buffer.push_constants
+  // CHECK: hal.command_buffer.dispatch.symbol
+  // CHECK: hal.ex.submit_and_wait {{.+}}, %[[CMD]]
+  %0 = flow.ex.stream.fragment(%arg2 = %cst : index, %arg3 = %arg0 : tensor<128xf32>, %arg4 = %arg1 : index) -> tensor<128xf32> {
+    %1 = flow.dispatch @ex0::@entry0[%arg2 : index](%arg3, %arg4) : (tensor<128xf32>, index) -> tensor<128xf32>
+    flow.return %1 : tensor<128xf32>
+  }
+  return %0 : tensor<128xf32>
+}
+// CHECK-NOT: hal.variable
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Write|Discard"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<16384xf32>) -> tensor<16384xf32>
+    }
+    module {}
+  }
+}
+
+// Streams staging more than the maximum number of bytes through their inputs
+// and outputs are recorded on every invocation.
+// CHECK-LABEL: func @largeStagingBuffers
+func @largeStagingBuffers(%arg0: tensor<16384xf32>) -> tensor<16384xf32> {
+  %cst = constant 16384 : index
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer|Dispatch"
+  // CHECK: hal.command_buffer.dispatch.symbol
+  // CHECK: hal.ex.submit_and_wait {{.+}}, %[[CMD]]
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<16384xf32>) -> tensor<16384xf32> {
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<16384xf32>) -> tensor<16384xf32>
+    flow.return %1 : tensor<16384xf32>
+  }
+  return %0 : tensor<16384xf32>
+}
+// CHECK-NOT: hal.variable
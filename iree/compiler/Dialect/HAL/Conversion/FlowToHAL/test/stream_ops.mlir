@@ -21,7 +21,7 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
   // CHECK-DAG: %[[C128:.+]] = constant 128
   %cst = constant 128 : index
   // CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal", "Constant|Transfer|Mapping|Dispatch"
-  // CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Transfer|Dispatch"
+  // CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Dispatch"
   // CHECK: %[[CMD:.+]] = hal.command_buffer.create {{.+}}, "OneShot", "Transfer|Dispatch"
   // CHECK-NEXT: hal.command_buffer.begin %[[CMD]]
   %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
@@ -32,7 +32,7 @@ func @multipleDispatches(%arg0: tensor<128xf32>) -> tensor<128xf32> {
     %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
     //      CHECK: hal.command_buffer.push_descriptor_set
     //      CHECK: hal.command_buffer.dispatch.symbol {{.+}}, @ex0::@vmla::@entry0, workgroup_xyz
-    //      CHECK: hal.command_buffer.execution_barrier
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
     %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
     flow.return %2 : tensor<128xf32>
   }
@@ -58,6 +58,7 @@ func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> te
     // CHECK-NEXT: hal.command_buffer.copy_buffer %[[CMD]], %[[TBUF]], %c0, %[[RET_BUF]], %c0, %c200
     // CHECK: hal.command_buffer.execution_barrier
     // CHECK-NEXT: hal.command_buffer.copy_buffer %[[CMD]], %[[UBUF]], %c0, %[[RET_BUF]], %c204, %c40
+    // CHECK-NOT: hal.command_buffer.execution_barrier
     %1 = flow.tensor.update %arg2, %arg3[%arg4, %arg5, %arg5] : tensor<1x1x10xf32> -> tensor<5x1x10xf32>
     flow.return %1 : tensor<5x1x10xf32>
   }
@@ -68,6 +69,50 @@ func @tensorUpdate(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> te
 
 // -----
 
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<5x1x10xf32>) -> tensor<5x1x10xf32>
+    }
+    module {}
+  }
+}
+
+// CHECK-LABEL: @tensorUpdateInPlace
+// CHECK-SAME: (%[[UBUF:.+]]:{{.+}}, %[[TBUF:.+]]:{{.+}})
+func @tensorUpdateInPlace(%arg0 : tensor<1x1x10xf32>, %arg1 : tensor<5x1x10xf32>) -> tensor<5x1x10xf32> {
+  %cst = constant 50 : index
+  %c4 = constant 4 : index
+  %c1 = constant 1 : index
+  // The dispatch result is only used by the update so the update is performed
+  // in the output buffer the dispatch writes into.
+  // CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate
+  // CHECK-NOT: hal.allocator.allocate
+  // CHECK: %[[CMD:.+]] = hal.command_buffer.create
+  %0 = flow.ex.stream.fragment(%arg2 = %arg0 : tensor<1x1x10xf32>, %arg3 = %arg1 : tensor<5x1x10xf32>, %arg4 = %c4 : index, %arg5 = %c1 : index, %arg6 = %cst : index) -> tensor<5x1x10xf32> {
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[TBUF]], %c0, %c200), 1 = (%[[RET_BUF]], %c0, %c200)]
+    // CHECK: hal.command_buffer.dispatch.symbol
+    %1 = flow.dispatch @ex0::@entry0[%arg6 : index](%arg3) : (tensor<5x1x10xf32>) -> tensor<5x1x10xf32>
+    // CHECK-NOT: hal.command_buffer.copy_buffer
+    // CHECK: hal.command_buffer.execution_barrier
+    // CHECK: hal.command_buffer.copy_buffer %[[CMD]], %[[UBUF]], %c0, %[[RET_BUF]], %c204, %c40
+    // CHECK-NOT: hal.command_buffer.copy_buffer
+    %2 = flow.tensor.update %arg2, %1[%arg4, %arg5, %arg5] : tensor<1x1x10xf32> -> tensor<5x1x10xf32>
+    flow.return %2 : tensor<5x1x10xf32>
+  }
+  // CHECK: hal.command_buffer.end %[[CMD]]
+  // CHECK: return %[[RET_BUF]]
+  return %0 : tensor<5x1x10xf32>
+}
+
+// -----
+
 hal.executable @ex0 {
   hal.interface @interface attributes {push_constants = 2 : i32} {
     hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
@@ -108,3 +153,133 @@ func @dispatchWithShapeTies(%arg0: tensor<?x128xf32>, %bs : index) -> tensor<?x1
   }
   return %0 : tensor<?x128xf32>
 }
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// CHECK-LABEL: func @transientBufferPacking
+func @transientBufferPacking(%arg0: tensor<128xf32>) -> tensor<128xf32> {
+  %cst = constant 128 : index
+  // CHECK: %[[RET_BUF:.+]] = hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal"
+  // %1 and %3 are never live at the same time and share the first 512 bytes
+  // while %2 is packed after them.
+  // CHECK: %[[TMP_BUF:.+]] = hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Dispatch", %c1024
+  // CHECK-NOT: hal.allocator.allocate
+  // CHECK: hal.command_buffer.begin
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%arg0, %c0, %c512), 1 = (%[[TMP_BUF]], %c0, %c512)]
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[TMP_BUF]], %c0, %c512), 1 = (%[[TMP_BUF]], %c512, %c512)]
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[TMP_BUF]], %c512, %c512), 1 = (%[[TMP_BUF]], %c0, %c512)]
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%2) : (tensor<128xf32>) -> tensor<128xf32>
+    // CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[TMP_BUF]], %c0, %c512), 1 = (%[[RET_BUF]], %c0, %c512)]
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : index](%3) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %4 : tensor<128xf32>
+  }
+  return %0 : tensor<128xf32>
+}
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// CHECK-LABEL: func @independentDispatches
+func @independentDispatches(%arg0: tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>, tensor<128xf32>, tensor<128xf32>) {
+  %cst = constant 128 : index
+  // CHECK: %[[BUF0:.+]] = hal.allocator.allocate
+  // CHECK: %[[BUF1:.+]] = hal.allocator.allocate
+  // CHECK: %[[BUF2:.+]] = hal.allocator.allocate
+  // CHECK: %[[BUF3:.+]] = hal.allocator.allocate
+  // CHECK: hal.command_buffer.begin
+  %0:4 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> (tensor<128xf32>, tensor<128xf32>, tensor<128xf32>, tensor<128xf32>) {
+    // The two chains are independent and are interleaved so that a single
+    // barrier separates their first and second dispatches.
+    //      CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%arg0, %c0, %c512), 1 = (%[[BUF0]], %c0, %c512)]
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%arg0, %c0, %c512), 1 = (%[[BUF2]], %c0, %c512)]
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //      CHECK: hal.command_buffer.execution_barrier
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[BUF0]], %c0, %c512), 1 = (%[[BUF1]], %c0, %c512)]
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.push_descriptor_set {{.+}}, bindings=[0 = (%[[BUF2]], %c0, %c512), 1 = (%[[BUF3]], %c0, %c512)]
+    //      CHECK: hal.command_buffer.dispatch.symbol
+    //  CHECK-NOT: hal.command_buffer.execution_barrier
+    //      CHECK: hal.command_buffer.end
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %2 = flow.dispatch @ex0::@entry0[%arg1 : index](%1) : (tensor<128xf32>) -> tensor<128xf32>
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    %4 = flow.dispatch @ex0::@entry0[%arg1 : index](%3) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %1, %2, %3, %4 : tensor<128xf32>, tensor<128xf32>, tensor<128xf32>, tensor<128xf32>
+  }
+  return %0#0, %0#1, %0#2, %0#3 : tensor<128xf32>, tensor<128xf32>, tensor<128xf32>, tensor<128xf32>
+}
+
+// -----
+
+hal.executable @ex0 {
+  hal.interface @interface {
+    hal.interface.binding @s0b0, set=0, binding=0, type="StorageBuffer", access="Read"
+    hal.interface.binding @s0b1, set=0, binding=1, type="StorageBuffer", access="Read|Write"
+  }
+  hal.executable.target @vmla, filter="vmla" {
+    hal.executable.entry_point @entry0 attributes {
+      interface = @interface,
+      ordinal = 0 : i32,
+      signature = (tensor<128xf32>) -> tensor<128xf32>
+    }
+    module {}
+  }
+}
+
+// CHECK-LABEL: func @outputBufferUsage
+func @outputBufferUsage(%arg0: tensor<128xf32>) -> f32 {
+  %cst = constant 128 : index
+  // Results only consumed by other streams stay device-local.
+  // CHECK: hal.allocator.allocate {{.+}}, "DeviceVisible|DeviceLocal", "Dispatch"
+  %0 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %arg0 : tensor<128xf32>) -> tensor<128xf32> {
+    %1 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %1 : tensor<128xf32>
+  }
+  // CHECK: hal.ex.submit_and_wait
+  // Results read back on the host are mappable.
+  // CHECK: hal.allocator.allocate {{.+}}, "HostVisible|DeviceVisible|DeviceLocal", "Mapping|Dispatch"
+  %2 = flow.ex.stream.fragment(%arg1 = %cst : index, %arg2 = %0 : tensor<128xf32>) -> tensor<128xf32> {
+    %3 = flow.dispatch @ex0::@entry0[%arg1 : index](%arg2) : (tensor<128xf32>) -> tensor<128xf32>
+    flow.return %3 : tensor<128xf32>
+  }
+  %c0 = constant 0 : index
+  // CHECK: hal.buffer.load
+  %4 = flow.tensor.load %2[%c0] : tensor<128xf32>
+  return %4 : f32
+}
@@ -17,5 +17,8 @@ func @submit_and_wait() {
   %1 = "test_hal.command_buffer"() : () -> !hal.command_buffer
   // CHECK: hal.ex.submit_and_wait %0, %1
   hal.ex.submit_and_wait %0, %1
+  %2 = "test_hal.command_buffer"() : () -> !hal.command_buffer
+  // CHECK: hal.ex.submit_and_wait %0, %1, %2
+  hal.ex.submit_and_wait %0, %1, %2
   return
 }
@@ -18,6 +18,7 @@
 #include "iree/compiler/Dialect/HAL/Target/LLVM/LLVMIRPasses.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/TargetSelect.h"
@@ -86,10 +87,11 @@ class LLVMIRTargetBackend final : public LLVMBaseTargetBackend {
           "Can't build LLVMIR opt passes for ExecutableOp module");
     }
 
-    // Serialize LLVM module.
+    // Serialize LLVM module as bitcode. This is considerably smaller and
+    // faster to load than the textual form.
     std::string bufferString;
     llvm::raw_string_ostream ostream(bufferString);
-    llvmModule->print(ostream, nullptr);
+    llvm::WriteBitcodeToFile(*llvmModule, ostream);
     ostream.flush();
 
     // Creates executable bytes.
@@ -13,7 +13,7 @@ attributes {nosideeffects}
 
 vm.import @ex.submit_and_wait(
   %device : !vm.ref<!hal.device>,
-  %command_buffer : !vm.ref<!hal.command_buffer>
+  %command_buffers : !vm.ref<!hal.command_buffer> ...
 )
 
 //===----------------------------------------------------------------------===//
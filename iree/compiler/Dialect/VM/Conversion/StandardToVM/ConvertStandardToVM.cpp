@@ -174,14 +174,20 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
   LogicalResult matchAndRewrite(
       ConstantOp srcOp, ArrayRef<Value> operands,
       ConversionPatternRewriter &rewriter) const override {
-    auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
-    if (!integerAttr) {
-      return srcOp.emitRemark() << "unsupported const type for dialect";
-    }
     // TODO(#2878): use getTypeConverter() when we pass it upon creation.
     IREE::VM::TypeConverter typeConverter(
         IREE::VM::getTargetOptionsFromFlags());
     auto targetType = typeConverter.convertType(srcOp.getType());
+    if (auto floatAttr = srcOp.getValue().dyn_cast<FloatAttr>()) {
+      if (!targetType) {
+        return srcOp.emitRemark() << "unsupported const float type for target";
+      }
+      return convertFloatConstant(srcOp, floatAttr, targetType, rewriter);
+    }
+    auto integerAttr = srcOp.getValue().dyn_cast<IntegerAttr>();
+    if (!integerAttr) {
+      return srcOp.emitRemark() << "unsupported const type for dialect";
+    }
     switch (targetType.getIntOrFloatBitWidth()) {
       case 1:
       case 32:
@@ -206,6 +212,38 @@ class ConstantOpConversion : public OpConversionPattern<ConstantOp> {
     }
     return success();
   }
+
+ private:
+  LogicalResult convertFloatConstant(
+      ConstantOp srcOp, FloatAttr floatAttr, Type targetType,
+      ConversionPatternRewriter &rewriter) const {
+    // Values are converted to the target type as f64 may be truncated to f32.
+    APFloat value = floatAttr.getValue();
+    bool losesInfo = false;
+    value.convert(targetType.cast<FloatType>().getFloatSemantics(),
+                  APFloat::rmNearestTiesToEven, &losesInfo);
+    auto valueAttr = rewriter.getFloatAttr(targetType, value);
+    switch (targetType.getIntOrFloatBitWidth()) {
+      case 32:
+        if (value.isPosZero()) {
+          rewriter.replaceOpWithNewOp<IREE::VM::ConstF32ZeroOp>(srcOp);
+        } else {
+          rewriter.replaceOpWithNewOp<IREE::VM::ConstF32Op>(srcOp, valueAttr);
+        }
+        break;
+      case 64:
+        if (value.isPosZero()) {
+          rewriter.replaceOpWithNewOp<IREE::VM::ConstF64ZeroOp>(srcOp);
+        } else {
+          rewriter.replaceOpWithNewOp<IREE::VM::ConstF64Op>(srcOp, valueAttr);
+        }
+        break;
+      default:
+        return srcOp.emitRemark()
+               << "unsupported const float bit width for dialect";
+    }
+    return success();
+  }
 };
 
 class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
@@ -263,6 +301,116 @@ class CmpIOpConversion : public OpConversionPattern<CmpIOp> {
   }
 };
 
+class CmpFOpConversion : public OpConversionPattern<CmpFOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      CmpFOp srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    CmpFOp::Adaptor srcAdapter(operands);
+    auto operandType = srcAdapter.lhs().getType();
+    if (operandType.isF32()) {
+      return convertPredicate<
+          IREE::VM::CmpEQF32OOp, IREE::VM::CmpEQF32UOp, IREE::VM::CmpNEF32OOp,
+          IREE::VM::CmpNEF32UOp, IREE::VM::CmpLTF32OOp, IREE::VM::CmpLTF32UOp,
+          IREE::VM::CmpLTEF32OOp, IREE::VM::CmpLTEF32UOp,
+          IREE::VM::CmpGTF32OOp, IREE::VM::CmpGTF32UOp,
+          IREE::VM::CmpGTEF32OOp, IREE::VM::CmpGTEF32UOp,
+          IREE::VM::CmpNaNF32Op>(srcOp, srcAdapter, rewriter);
+    } else if (operandType.isF64()) {
+      return convertPredicate<
+          IREE::VM::CmpEQF64OOp, IREE::VM::CmpEQF64UOp, IREE::VM::CmpNEF64OOp,
+          IREE::VM::CmpNEF64UOp, IREE::VM::CmpLTF64OOp, IREE::VM::CmpLTF64UOp,
+          IREE::VM::CmpLTEF64OOp, IREE::VM::CmpLTEF64UOp,
+          IREE::VM::CmpGTF64OOp, IREE::VM::CmpGTF64UOp,
+          IREE::VM::CmpGTEF64OOp, IREE::VM::CmpGTEF64UOp,
+          IREE::VM::CmpNaNF64Op>(srcOp, srcAdapter, rewriter);
+    }
+    return failure();
+  }
+
+ private:
+  template <typename EQ_O, typename EQ_U, typename NE_O, typename NE_U,
+            typename LT_O, typename LT_U, typename LTE_O, typename LTE_U,
+            typename GT_O, typename GT_U, typename GTE_O, typename GTE_U,
+            typename NAN>
+  LogicalResult convertPredicate(CmpFOp srcOp, CmpFOp::Adaptor srcAdapter,
+                                 ConversionPatternRewriter &rewriter) const {
+    auto returnType = rewriter.getIntegerType(32);
+    auto lhs = srcAdapter.lhs();
+    auto rhs = srcAdapter.rhs();
+    switch (srcOp.getPredicate()) {
+      case CmpFPredicate::OEQ:
+        rewriter.replaceOpWithNewOp<EQ_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::UEQ:
+        rewriter.replaceOpWithNewOp<EQ_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::ONE:
+        rewriter.replaceOpWithNewOp<NE_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::UNE:
+        rewriter.replaceOpWithNewOp<NE_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::OLT:
+        rewriter.replaceOpWithNewOp<LT_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::ULT:
+        rewriter.replaceOpWithNewOp<LT_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::OLE:
+        rewriter.replaceOpWithNewOp<LTE_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::ULE:
+        rewriter.replaceOpWithNewOp<LTE_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::OGT:
+        rewriter.replaceOpWithNewOp<GT_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::UGT:
+        rewriter.replaceOpWithNewOp<GT_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::OGE:
+        rewriter.replaceOpWithNewOp<GTE_O>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::UGE:
+        rewriter.replaceOpWithNewOp<GTE_U>(srcOp, returnType, lhs, rhs);
+        return success();
+      case CmpFPredicate::UNO: {
+        // isnan(lhs) || isnan(rhs)
+        auto lhsNaN = rewriter.createOrFold<NAN>(srcOp.getLoc(), returnType,
+                                                 lhs);
+        auto rhsNaN = rewriter.createOrFold<NAN>(srcOp.getLoc(), returnType,
+                                                 rhs);
+        rewriter.replaceOpWithNewOp<IREE::VM::OrI32Op>(srcOp, returnType,
+                                                       lhsNaN, rhsNaN);
+        return success();
+      }
+      case CmpFPredicate::ORD: {
+        // !(isnan(lhs) || isnan(rhs))
+        auto lhsNaN = rewriter.createOrFold<NAN>(srcOp.getLoc(), returnType,
+                                                 lhs);
+        auto rhsNaN = rewriter.createOrFold<NAN>(srcOp.getLoc(), returnType,
+                                                 rhs);
+        auto anyNaN = rewriter.createOrFold<IREE::VM::OrI32Op>(
+            srcOp.getLoc(), returnType, lhsNaN, rhsNaN);
+        rewriter.replaceOpWithNewOp<IREE::VM::XorI32Op>(
+            srcOp, returnType, anyNaN,
+            rewriter.createOrFold<IREE::VM::ConstI32Op>(srcOp.getLoc(), 1));
+        return success();
+      }
+      case CmpFPredicate::AlwaysFalse:
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI32ZeroOp>(srcOp);
+        return success();
+      case CmpFPredicate::AlwaysTrue:
+        rewriter.replaceOpWithNewOp<IREE::VM::ConstI32Op>(srcOp, 1);
+        return success();
+      default:
+        return failure();
+    }
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy>
 class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -278,6 +426,26 @@ class BinaryArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   }
 };
 
+// Converts floating-point ops to the VM op matching the converted type width.
+template <typename SrcOpTy, typename DstF32OpTy, typename DstF64OpTy>
+class FloatArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto type = operands[0].getType();
+    if (type.isF32()) {
+      rewriter.replaceOpWithNewOp<DstF32OpTy>(srcOp, type, operands);
+    } else if (type.isF64()) {
+      rewriter.replaceOpWithNewOp<DstF64OpTy>(srcOp, type, operands);
+    } else {
+      return failure();
+    }
+    return success();
+  }
+};
+
 template <typename SrcOpTy, typename DstOpTy, unsigned kBits = 32>
 class ShiftArithmeticOpConversion : public OpConversionPattern<SrcOpTy> {
   using OpConversionPattern<SrcOpTy>::OpConversionPattern;
@@ -316,6 +484,58 @@ class CastingOpConversion : public OpConversionPattern<StdOp> {
   }
 };
 
+// Converts int<->float casts to the VM op for the converted float type.
+// The VM only has casts between 32-bit integers and floats so casts involving
+// any other integer width (such as i64 after conversion) are rejected.
+template <typename SrcOpTy, typename DstF32OpTy, typename DstF64OpTy>
+class FloatCastingOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto resultType =
+        this->getTypeConverter()->convertType(srcOp.getResult().getType());
+    if (!resultType) return failure();
+    // Either the source or result type is the float type being cast.
+    bool isResultFloat = resultType.isa<FloatType>();
+    auto floatType = isResultFloat ? resultType : operands[0].getType();
+    auto intType = isResultFloat ? operands[0].getType() : resultType;
+    if (!intType.isInteger(32)) {
+      return rewriter.notifyMatchFailure(
+          srcOp, "only casts to/from 32-bit integers are supported");
+    }
+    if (floatType.isF32()) {
+      rewriter.replaceOpWithNewOp<DstF32OpTy>(srcOp, resultType, operands[0]);
+    } else if (floatType.isF64()) {
+      rewriter.replaceOpWithNewOp<DstF64OpTy>(srcOp, resultType, operands[0]);
+    } else {
+      return failure();
+    }
+    return success();
+  }
+};
+
+// Converts fpext/fptrunc; these become no-ops when f64 is truncated to f32.
+template <typename SrcOpTy, typename DstOpTy>
+class FloatResizeOpConversion : public OpConversionPattern<SrcOpTy> {
+  using OpConversionPattern<SrcOpTy>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SrcOpTy srcOp, ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto resultType =
+        this->getTypeConverter()->convertType(srcOp.getResult().getType());
+    if (!resultType) return failure();
+    if (resultType == operands[0].getType()) {
+      rewriter.replaceOp(srcOp, operands);
+    } else {
+      rewriter.replaceOpWithNewOp<DstOpTy>(srcOp, resultType, operands[0]);
+    }
+    return success();
+  }
+};
+
 class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
   using OpConversionPattern::OpConversionPattern;
   LogicalResult matchAndRewrite(
@@ -332,6 +552,16 @@ class SelectI32OpConversion : public OpConversionPattern<SelectOp> {
     auto actualType = srcAdaptor.true_value().getType();
     if (actualType != requiredType && actualType.isa<IndexType>()) {
       return failure();
+    } else if (actualType.isF32()) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectF32Op>(
+          srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+      return success();
+    } else if (actualType.isF64()) {
+      rewriter.replaceOpWithNewOp<IREE::VM::SelectF64Op>(
+          srcOp, actualType, srcAdaptor.condition(), srcAdaptor.true_value(),
+          srcAdaptor.false_value());
+      return success();
     }
 
     rewriter.replaceOpWithNewOp<IREE::VM::SelectI32Op>(
@@ -398,7 +628,7 @@ void populateStandardToVMPatterns(MLIRContext *context,
                                   TypeConverter &typeConverter,
                                   OwningRewritePatternList &patterns) {
   patterns.insert<BranchOpConversion, CallOpConversion, CmpIOpConversion,
-                  CondBranchOpConversion, ModuleOpConversion,
+                  CmpFOpConversion, CondBranchOpConversion, ModuleOpConversion,
                   ModuleTerminatorOpConversion, FuncOpConversion,
                   ReturnOpConversion, CastingOpConversion<IndexCastOp>,
                   CastingOpConversion<TruncateIOp>, SelectI32OpConversion>(
@@ -420,6 +650,38 @@ void populateStandardToVMPatterns(MLIRContext *context,
               BinaryArithmeticOpConversion<XOrOp, IREE::VM::XorI32Op>>(
           typeConverter, context);
 
+  // Floating-point arithmetic ops
+  patterns.insert<
+      FloatArithmeticOpConversion<AddFOp, IREE::VM::AddF32Op,
+                                  IREE::VM::AddF64Op>,
+      FloatArithmeticOpConversion<SubFOp, IREE::VM::SubF32Op,
+                                  IREE::VM::SubF64Op>,
+      FloatArithmeticOpConversion<MulFOp, IREE::VM::MulF32Op,
+                                  IREE::VM::MulF64Op>,
+      FloatArithmeticOpConversion<DivFOp, IREE::VM::DivF32Op,
+                                  IREE::VM::DivF64Op>,
+      FloatArithmeticOpConversion<RemFOp, IREE::VM::RemF32Op,
+                                  IREE::VM::RemF64Op>,
+      FloatArithmeticOpConversion<AbsFOp, IREE::VM::AbsF32Op,
+                                  IREE::VM::AbsF64Op>,
+      FloatArithmeticOpConversion<NegFOp, IREE::VM::NegF32Op,
+                                  IREE::VM::NegF64Op>,
+      FloatArithmeticOpConversion<CeilFOp, IREE::VM::CeilF32Op,
+                                  IREE::VM::CeilF64Op>,
+      FloatArithmeticOpConversion<FloorFOp, IREE::VM::FloorF32Op,
+                                  IREE::VM::FloorF64Op>>(typeConverter,
+                                                         context);
+
+  // Floating-point conversion ops
+  patterns.insert<
+      FloatCastingOpConversion<SIToFPOp, IREE::VM::CastSI32F32Op,
+                               IREE::VM::CastSI32F64Op>,
+      FloatCastingOpConversion<FPToSIOp, IREE::VM::CastF32SI32Op,
+                               IREE::VM::CastF64SI32Op>,
+      FloatResizeOpConversion<FPExtOp, IREE::VM::ExtF32F64Op>,
+      FloatResizeOpConversion<FPTruncOp, IREE::VM::TruncF64F32Op>>(
+      typeConverter, context);
+
   // Shift ops
   // TODO(laurenzo): The standard dialect is missing shr ops. Add once in place.
   patterns.insert<ShiftArithmeticOpConversion<ShiftLeftOp, IREE::VM::ShlI32Op>>(
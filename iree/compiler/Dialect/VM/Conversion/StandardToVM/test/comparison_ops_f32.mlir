@@ -0,0 +1,122 @@
+// RUN: iree-opt -split-input-file -pass-pipeline='test-iree-convert-std-to-vm' -iree-vm-target-extensions=f32 %s | IreeFileCheck %s
+
+// -----
+// CHECK-LABEL: @t001_cmp_oeq_f32
+module @t001_cmp_oeq_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.eq.f32.o %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "oeq", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t002_cmp_une_f32
+module @t002_cmp_une_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.ne.f32.u %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "une", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t003_cmp_olt_f32
+module @t003_cmp_olt_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.lt.f32.o %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "olt", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t004_cmp_ule_f32
+module @t004_cmp_ule_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.lte.f32.u %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "ule", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t005_cmp_ogt_f32
+module @t005_cmp_ogt_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.gt.f32.o %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "ogt", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t006_cmp_uge_f32
+module @t006_cmp_uge_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK: vm.cmp.gte.f32.u %[[ARG0]], %[[ARG1]] : f32
+    %1 = cmpf "uge", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
+
+// -----
+// CHECK-LABEL: @t007_cmp_uno_f32
+module @t007_cmp_uno_f32 {
+
+module {
+  // CHECK: func @my_fn
+  // CHECK-SAME: %[[ARG0:[a-zA-Z0-9$._-]+]]
+  // CHECK-SAME: %[[ARG1:[a-zA-Z0-9$._-]+]]
+  func @my_fn(%arg0: f32, %arg1 : f32) -> (i1) {
+    // CHECK-DAG: %[[LHS_NAN:.+]] = vm.cmp.nan.f32 %[[ARG0]] : f32
+    // CHECK-DAG: %[[RHS_NAN:.+]] = vm.cmp.nan.f32 %[[ARG1]] : f32
+    // CHECK: vm.or.i32 %[[LHS_NAN]], %[[RHS_NAN]] : i32
+    %1 = cmpf "uno", %arg0, %arg1 : f32
+    return %1 : i1
+  }
+}
+
+}
@@ -57,13 +57,19 @@ class VMFuncEncoder {
   // Encodes an integer attribute as a fixed byte length based on bitwidth.
   virtual LogicalResult encodeIntAttr(IntegerAttr value) = 0;
 
+  // Encodes a floating-point attribute as its IEEE bit pattern in a fixed byte
+  // length based on bitwidth.
+  virtual LogicalResult encodeFloatAttr(FloatAttr value) = 0;
+
   // Encodes a variable-length integer array attribute.
   virtual LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) = 0;
 
   // Encodes a string attribute as a B-string.
   virtual LogicalResult encodeStrAttr(StringAttr value) = 0;
 
-  // Encodes a branch target and the operand mappings.
+  // Encodes a branch target and the operand mappings. Mappings are split into
+  // a list of primitive register pairs followed by a list of ref register
+  // pairs.
   virtual LogicalResult encodeBranch(Block *targetBlock,
                                      Operation::operand_range operands,
                                      int successorIndex) = 0;
@@ -74,11 +80,22 @@ class VMFuncEncoder {
   // Encodes a variable list of operands (by reference), including a count.
   virtual LogicalResult encodeOperands(Operation::operand_range values) = 0;
 
+  // Encodes a variable list of operands (by reference) split by register bank
+  // as a list of primitive registers followed by a list of ref registers, each
+  // including a count. The relative order of operands within each bank is
+  // preserved.
+  virtual LogicalResult encodeSplitOperands(
+      Operation::operand_range values) = 0;
+
   // Encodes a result value (by reference).
   virtual LogicalResult encodeResult(Value value) = 0;
 
   // Encodes a variable list of results (by reference), including a count.
   virtual LogicalResult encodeResults(Operation::result_range values) = 0;
+
+  // Encodes a variable list of results (by reference) split by register bank
+  // as with encodeSplitOperands.
+  virtual LogicalResult encodeSplitResults(Operation::result_range values) = 0;
 };
 
 }  // namespace iree_compiler
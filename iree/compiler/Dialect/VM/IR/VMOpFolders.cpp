@@ -16,6 +16,7 @@
 
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMOps.h"
+#include "llvm/ADT/APSInt.h"
 #include "llvm/ADT/StringExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -105,8 +106,15 @@ struct DropDefaultConstGlobalOpInitializer : public OpRewritePattern<T> {
   LogicalResult matchAndRewrite(T op,
                                 PatternRewriter &rewriter) const override {
     if (!op.initial_value().hasValue()) return failure();
-    auto value = op.initial_valueAttr().template cast<IntegerAttr>();
-    if (value.getValue() != 0) return failure();
+    auto value = op.initial_valueAttr();
+    if (auto intValue = value.template dyn_cast<IntegerAttr>()) {
+      if (intValue.getValue() != 0) return failure();
+    } else if (auto floatValue = value.template dyn_cast<FloatAttr>()) {
+      // Only +0.0 matches the zero-initialized storage; -0.0 must be kept.
+      if (!floatValue.getValue().isPosZero()) return failure();
+    } else {
+      return failure();
+    }
     rewriter.replaceOpWithNewOp<T>(op, op.sym_name(), op.is_mutable(),
                                    op.type(),
                                    llvm::to_vector<4>(op.getDialectAttrs()));
@@ -128,6 +136,18 @@ void GlobalI64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
                  DropDefaultConstGlobalOpInitializer<GlobalI64Op>>(context);
 }
 
+void GlobalF32Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF32Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF32Op>>(context);
+}
+
+void GlobalF64Op::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<InlineConstGlobalOpInitializer<GlobalF64Op>,
+                 DropDefaultConstGlobalOpInitializer<GlobalF64Op>>(context);
+}
+
 void GlobalRefOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                               MLIRContext *context) {
   results.insert<InlineConstGlobalOpInitializer<GlobalRefOp>>(context);
@@ -138,7 +158,7 @@ namespace {
 /// Inlines immutable global constants into their loads.
 template <typename LOAD_OP, typename GLOBAL_OP, typename CONST_OP,
           typename CONST_ZERO_OP>
-struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
+struct InlineConstGlobalLoadPrimitiveOp : public OpRewritePattern<LOAD_OP> {
   using OpRewritePattern<LOAD_OP>::OpRewritePattern;
   LogicalResult matchAndRewrite(LOAD_OP op,
                                 PatternRewriter &rewriter) const override {
@@ -162,15 +182,29 @@ struct InlineConstGlobalLoadIntegerOp : public OpRewritePattern<LOAD_OP> {
 
 void GlobalLoadI32Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI32Op, GlobalI32Op,
-                                                ConstI32Op, ConstI32ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI32Op, GlobalI32Op,
+                                                  ConstI32Op, ConstI32ZeroOp>>(
       context);
 }
 
 void GlobalLoadI64Op::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
-  results.insert<InlineConstGlobalLoadIntegerOp<GlobalLoadI64Op, GlobalI64Op,
-                                                ConstI64Op, ConstI64ZeroOp>>(
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadI64Op, GlobalI64Op,
+                                                  ConstI64Op, ConstI64ZeroOp>>(
+      context);
+}
+
+void GlobalLoadF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadF32Op, GlobalF32Op,
+                                                  ConstF32Op, ConstF32ZeroOp>>(
+      context);
+}
+
+void GlobalLoadF64Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<InlineConstGlobalLoadPrimitiveOp<GlobalLoadF64Op, GlobalF64Op,
+                                                  ConstF64Op, ConstF64ZeroOp>>(
       context);
 }
 
@@ -233,6 +267,20 @@ void GlobalLoadIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalLoadIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalLoadAddress<GlobalLoadIndirectF32Op, GlobalLoadF32Op>>(
+      context);
+}
+
+void GlobalLoadIndirectF64Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalLoadAddress<GlobalLoadIndirectF64Op, GlobalLoadF64Op>>(
+      context);
+}
+
 void GlobalLoadIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -273,6 +321,20 @@ void GlobalStoreIndirectI64Op::getCanonicalizationPatterns(
       context);
 }
 
+void GlobalStoreIndirectF32Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalStoreAddress<GlobalStoreIndirectF32Op, GlobalStoreF32Op>>(
+      context);
+}
+
+void GlobalStoreIndirectF64Op::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<
+      PropagateGlobalStoreAddress<GlobalStoreIndirectF64Op, GlobalStoreF64Op>>(
+      context);
+}
+
 void GlobalStoreIndirectRefOp::getCanonicalizationPatterns(
     OwningRewritePatternList &results, MLIRContext *context) {
   results.insert<
@@ -288,6 +350,10 @@ OpFoldResult ConstI32Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
 OpFoldResult ConstI64Op::fold(ArrayRef<Attribute> operands) { return value(); }
 
+OpFoldResult ConstF32Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
+OpFoldResult ConstF64Op::fold(ArrayRef<Attribute> operands) { return value(); }
+
 OpFoldResult ConstI32ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
@@ -296,6 +362,14 @@ OpFoldResult ConstI64ZeroOp::fold(ArrayRef<Attribute> operands) {
   return IntegerAttr::get(getResult().getType(), 0);
 }
 
+OpFoldResult ConstF32ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
+OpFoldResult ConstF64ZeroOp::fold(ArrayRef<Attribute> operands) {
+  return FloatAttr::get(getResult().getType(), 0.0);
+}
+
 OpFoldResult ConstRefZeroOp::fold(ArrayRef<Attribute> operands) {
   // TODO(b/144027097): relace unit attr with a proper null ref_ptr attr.
   return UnitAttr::get(getContext());
@@ -332,6 +406,14 @@ OpFoldResult SelectI64Op::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
 
+OpFoldResult SelectF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
+OpFoldResult SelectF64Op::fold(ArrayRef<Attribute> operands) {
+  return foldSelectOp(*this);
+}
+
 OpFoldResult SelectRefOp::fold(ArrayRef<Attribute> operands) {
   return foldSelectOp(*this);
 }
@@ -720,6 +802,154 @@ OpFoldResult XorI64Op::fold(ArrayRef<Attribute> operands) {
   return foldXorOp(*this, operands);
 }
 
+//===----------------------------------------------------------------------===//
+// Native floating-point arithmetic
+//===----------------------------------------------------------------------===//
+
+/// Performs const folding `calculate` on the given floating-point attribute in
+/// `operands` and returns the result if possible.
+/// Unlike constFoldUnaryOp this only handles scalars and splats as
+/// ElementsAttr::mapValues cannot produce floating-point results.
+template <class CalculationT>
+static Attribute constFoldUnaryFloatOp(ArrayRef<Attribute> operands,
+                                       const CalculationT &calculate) {
+  assert(operands.size() == 1 && "unary op takes one operand");
+  if (auto operand = operands[0].dyn_cast_or_null<FloatAttr>()) {
+    return FloatAttr::get(operand.getType(), calculate(operand.getValue()));
+  } else if (auto operand = operands[0].dyn_cast_or_null<SplatElementsAttr>()) {
+    auto elementResult =
+        constFoldUnaryFloatOp({operand.getSplatValue()}, calculate);
+    if (!elementResult) return {};
+    return DenseElementsAttr::get(operand.getType(), elementResult);
+  }
+  return {};
+}
+
+// NOTE: identities such as x + 0 = x do not hold for floating-point values
+// (-0 + 0 = +0) and are intentionally not folded; only exact rewrites and
+// constant evaluation are performed.
+
+OpFoldResult AddF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a + b; });
+}
+
+OpFoldResult AddF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a + b; });
+}
+
+OpFoldResult SubF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a - b; });
+}
+
+OpFoldResult SubF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a - b; });
+}
+
+template <typename T>
+static OpFoldResult foldMulFOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_One())) {
+    // x * 1 = x or 1 * y = y (commutative)
+    return op.lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a * b; });
+}
+
+OpFoldResult MulF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulFOp(*this, operands);
+}
+
+OpFoldResult MulF64Op::fold(ArrayRef<Attribute> operands) {
+  return foldMulFOp(*this, operands);
+}
+
+template <typename T>
+static OpFoldResult foldDivFOp(T op, ArrayRef<Attribute> operands) {
+  if (matchPattern(op.rhs(), m_One())) {
+    // x / 1 = x
+    return op.lhs();
+  }
+  return constFoldBinaryOp<FloatAttr>(
+      operands, [](const APFloat &a, const APFloat &b) { return a / b; });
+}
+
+OpFoldResult DivF32Op::fold(ArrayRef<Attribute> operands) {
+  return foldDivFOp(*this, operands);
+}
+
+OpFoldResult DivF64Op::fold(ArrayRef<Attribute> operands) {
+  return foldDivFOp(*this, operands);
+}
+
+/// Matches the C fmod semantics used by the runtime.
+static APFloat remF(const APFloat &a, const APFloat &b) {
+  APFloat result = a;
+  result.mod(b);
+  return result;
+}
+
+OpFoldResult RemF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, remF);
+}
+
+OpFoldResult RemF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldBinaryOp<FloatAttr>(operands, remF);
+}
+
+OpFoldResult AbsF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands,
+                               [](const APFloat &a) { return abs(a); });
+}
+
+OpFoldResult AbsF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands,
+                               [](const APFloat &a) { return abs(a); });
+}
+
+OpFoldResult NegF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands,
+                               [](const APFloat &a) { return neg(a); });
+}
+
+OpFoldResult NegF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands,
+                               [](const APFloat &a) { return neg(a); });
+}
+
+static APFloat roundF(const APFloat &a, APFloat::roundingMode mode) {
+  APFloat result = a;
+  result.roundToIntegral(mode);
+  return result;
+}
+
+OpFoldResult CeilF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands, [](const APFloat &a) {
+    return roundF(a, APFloat::rmTowardPositive);
+  });
+}
+
+OpFoldResult CeilF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands, [](const APFloat &a) {
+    return roundF(a, APFloat::rmTowardPositive);
+  });
+}
+
+OpFoldResult FloorF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands, [](const APFloat &a) {
+    return roundF(a, APFloat::rmTowardNegative);
+  });
+}
+
+OpFoldResult FloorF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldUnaryFloatOp(operands, [](const APFloat &a) {
+    return roundF(a, APFloat::rmTowardNegative);
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // Native bitwise shifts and rotates
 //===----------------------------------------------------------------------===//
@@ -896,6 +1126,112 @@ OpFoldResult ExtI32I64UOp::fold(ArrayRef<Attribute> operands) {
       [&](const APInt &a) { return a.zext(64); });
 }
 
+/// Performs const folding `calculate` on the given attribute in `operands` that
+/// changes the attribute kind (such as integer to floating-point).
+template <class SrcAttrElementT, class DstAttrElementT,
+          class SrcElementValueT = typename SrcAttrElementT::ValueType,
+          class DstElementValueT = typename DstAttrElementT::ValueType,
+          class CalculationT =
+              std::function<DstElementValueT(SrcElementValueT)>>
+static Attribute constFoldCastOp(Type resultType, ArrayRef<Attribute> operands,
+                                 const CalculationT &calculate) {
+  assert(operands.size() == 1 && "unary op takes one operand");
+  if (auto operand = operands[0].dyn_cast_or_null<SrcAttrElementT>()) {
+    return DstAttrElementT::get(resultType, calculate(operand.getValue()));
+  }
+  return {};
+}
+
+static APFloat castIntToFloat(const APInt &a, bool isSigned,
+                              const llvm::fltSemantics &semantics) {
+  APFloat result(semantics);
+  result.convertFromAPInt(a, isSigned, APFloat::rmNearestTiesToEven);
+  return result;
+}
+
+static APInt castFloatToInt(const APFloat &a, bool isUnsigned) {
+  llvm::APSInt result(32, isUnsigned);
+  bool isExact = false;
+  a.convertToInteger(result, APFloat::rmTowardZero, &isExact);
+  return std::move(result);
+}
+
+OpFoldResult CastSI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<IntegerAttr, FloatAttr>(
+      FloatType::getF32(getContext()), operands, [&](const APInt &a) {
+        return castIntToFloat(a, /*isSigned=*/true, APFloat::IEEEsingle());
+      });
+}
+
+OpFoldResult CastUI32F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<IntegerAttr, FloatAttr>(
+      FloatType::getF32(getContext()), operands, [&](const APInt &a) {
+        return castIntToFloat(a, /*isSigned=*/false, APFloat::IEEEsingle());
+      });
+}
+
+OpFoldResult CastF32SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      IntegerType::get(32, getContext()), operands, [&](const APFloat &a) {
+        return castFloatToInt(a, /*isUnsigned=*/false);
+      });
+}
+
+OpFoldResult CastF32UI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      IntegerType::get(32, getContext()), operands, [&](const APFloat &a) {
+        return castFloatToInt(a, /*isUnsigned=*/true);
+      });
+}
+
+OpFoldResult CastSI32F64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<IntegerAttr, FloatAttr>(
+      FloatType::getF64(getContext()), operands, [&](const APInt &a) {
+        return castIntToFloat(a, /*isSigned=*/true, APFloat::IEEEdouble());
+      });
+}
+
+OpFoldResult CastUI32F64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<IntegerAttr, FloatAttr>(
+      FloatType::getF64(getContext()), operands, [&](const APInt &a) {
+        return castIntToFloat(a, /*isSigned=*/false, APFloat::IEEEdouble());
+      });
+}
+
+OpFoldResult CastF64SI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      IntegerType::get(32, getContext()), operands, [&](const APFloat &a) {
+        return castFloatToInt(a, /*isUnsigned=*/false);
+      });
+}
+
+OpFoldResult CastF64UI32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      IntegerType::get(32, getContext()), operands, [&](const APFloat &a) {
+        return castFloatToInt(a, /*isUnsigned=*/true);
+      });
+}
+
+static APFloat convertFloat(const APFloat &a,
+                            const llvm::fltSemantics &semantics) {
+  APFloat result = a;
+  bool losesInfo = false;
+  result.convert(semantics, APFloat::rmNearestTiesToEven, &losesInfo);
+  return result;
+}
+
+OpFoldResult TruncF64F32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<FloatAttr>(
+      FloatType::getF32(getContext()), operands,
+      [&](const APFloat &a) { return convertFloat(a, APFloat::IEEEsingle()); });
+}
+
+OpFoldResult ExtF32F64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldConversionOp<FloatAttr>(
+      FloatType::getF64(getContext()), operands,
+      [&](const APFloat &a) { return convertFloat(a, APFloat::IEEEdouble()); });
+}
+
 namespace {
 
 template <typename SRC_OP, typename OP_A, int SZ_T, typename OP_B>
@@ -1360,6 +1696,381 @@ OpFoldResult CmpNZI64Op::fold(ArrayRef<Attribute> operands) {
       operands, [&](const APInt &a) { return APInt(64, a.getBoolValue()); });
 }
 
+/// Performs const folding of a floating-point comparison where `predicate`
+/// decides the result from the APFloat comparison of the two operands.
+template <class PredicateT>
+static Attribute constFoldCmpFOp(Type resultType, ArrayRef<Attribute> operands,
+                                 const PredicateT &predicate) {
+  assert(operands.size() == 2 && "binary op takes two operands");
+  auto lhs = operands[0].dyn_cast_or_null<FloatAttr>();
+  auto rhs = operands[1].dyn_cast_or_null<FloatAttr>();
+  if (!lhs || !rhs) return {};
+  return IntegerAttr::get(
+      resultType, predicate(lhs.getValue().compare(rhs.getValue())) ? 1 : 0);
+}
+
+namespace {
+
+/// Rewrites a vm.cmp.gte.f* pseudo op to a vm.cmp.lte.f* op.
+/// Unlike the integer form this cannot be expressed as !(lhs < rhs) as the
+/// result must be preserved for unordered (NaN) operands.
+template <typename T, typename U>
+struct RewritePseudoCmpGTEToLTE : public OpRewritePattern<T> {
+  using OpRewritePattern<T>::OpRewritePattern;
+  LogicalResult matchAndRewrite(T op,
+                                PatternRewriter &rewriter) const override {
+    // rhs <= lhs
+    rewriter.replaceOpWithNewOp<U>(op, op.getType(), op.rhs(), op.lhs());
+    return success();
+  }
+};
+
+}  // namespace
+
+template <typename T>
+static OpFoldResult foldCmpEQFOOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r == APFloat::cmpEqual; });
+}
+
+OpFoldResult CmpEQF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpEQFOOp(*this, operands);
+}
+
+void CmpEQF32OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpEQF32OOp, CmpNEF32UOp>>(context);
+}
+
+OpFoldResult CmpEQF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpEQFOOp(*this, operands);
+}
+
+void CmpEQF64OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpEQF64OOp, CmpNEF64UOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpEQFUOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x == x = true (even if x is NaN)
+    return oneOfType(op.getType());
+  }
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpEqual || r == APFloat::cmpUnordered;
+  });
+}
+
+OpFoldResult CmpEQF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpEQFUOp(*this, operands);
+}
+
+void CmpEQF32UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpEQF32UOp, CmpNEF32OOp>>(context);
+}
+
+OpFoldResult CmpEQF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpEQFUOp(*this, operands);
+}
+
+void CmpEQF64UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpEQF64UOp, CmpNEF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpNEFOOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x != x = false (even if x is NaN)
+    return zeroOfType(op.getType());
+  }
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpGreaterThan;
+  });
+}
+
+OpFoldResult CmpNEF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpNEFOOp(*this, operands);
+}
+
+void CmpNEF32OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpNEF32OOp, CmpEQF32UOp>>(context);
+}
+
+OpFoldResult CmpNEF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpNEFOOp(*this, operands);
+}
+
+void CmpNEF64OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpNEF64OOp, CmpEQF64UOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpNEFUOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r != APFloat::cmpEqual; });
+}
+
+OpFoldResult CmpNEF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpNEFUOp(*this, operands);
+}
+
+void CmpNEF32UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpNEF32UOp, CmpEQF32OOp>>(context);
+}
+
+OpFoldResult CmpNEF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpNEFUOp(*this, operands);
+}
+
+void CmpNEF64UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpNEF64UOp, CmpEQF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpLTFOOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x < x = false (even if x is NaN)
+    return zeroOfType(op.getType());
+  }
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r == APFloat::cmpLessThan; });
+}
+
+OpFoldResult CmpLTF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTFOOp(*this, operands);
+}
+
+void CmpLTF32OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTF32OOp, CmpGTEF32UOp>>(context);
+}
+
+OpFoldResult CmpLTF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTFOOp(*this, operands);
+}
+
+void CmpLTF64OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTF64OOp, CmpGTEF64UOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpLTFUOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpUnordered;
+  });
+}
+
+OpFoldResult CmpLTF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTFUOp(*this, operands);
+}
+
+void CmpLTF32UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTF32UOp, CmpGTEF32OOp>>(context);
+}
+
+OpFoldResult CmpLTF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTFUOp(*this, operands);
+}
+
+void CmpLTF64UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTF64UOp, CmpGTEF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpLTEFOOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpLessThan || r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpLTEF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTEFOOp(*this, operands);
+}
+
+void CmpLTEF32OOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTEF32OOp, CmpGTF32UOp>>(context);
+}
+
+OpFoldResult CmpLTEF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTEFOOp(*this, operands);
+}
+
+void CmpLTEF64OOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTEF64OOp, CmpGTF64UOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpLTEFUOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x <= x = true (even if x is NaN)
+    return oneOfType(op.getType());
+  }
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r != APFloat::cmpGreaterThan; });
+}
+
+OpFoldResult CmpLTEF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTEFUOp(*this, operands);
+}
+
+void CmpLTEF32UOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTEF32UOp, CmpGTF32OOp>>(context);
+}
+
+OpFoldResult CmpLTEF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpLTEFUOp(*this, operands);
+}
+
+void CmpLTEF64UOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpLTEF64UOp, CmpGTF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpGTFOOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x > x = false (even if x is NaN)
+    return zeroOfType(op.getType());
+  }
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r == APFloat::cmpGreaterThan; });
+}
+
+OpFoldResult CmpGTF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTFOOp(*this, operands);
+}
+
+void CmpGTF32OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTF32OOp, CmpLTEF32UOp>>(context);
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF32OOp, CmpLTF32OOp>>(context);
+}
+
+OpFoldResult CmpGTF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTFOOp(*this, operands);
+}
+
+void CmpGTF64OOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTF64OOp, CmpLTEF64UOp>>(context);
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF64OOp, CmpLTF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpGTFUOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan || r == APFloat::cmpUnordered;
+  });
+}
+
+OpFoldResult CmpGTF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTFUOp(*this, operands);
+}
+
+void CmpGTF32UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTF32UOp, CmpLTEF32OOp>>(context);
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF32UOp, CmpLTF32UOp>>(context);
+}
+
+OpFoldResult CmpGTF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTFUOp(*this, operands);
+}
+
+void CmpGTF64UOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
+                                              MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTF64UOp, CmpLTEF64OOp>>(context);
+  results.insert<RewritePseudoCmpGTToLT<CmpGTF64UOp, CmpLTF64UOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpGTEFOOp(T op, ArrayRef<Attribute> operands) {
+  return constFoldCmpFOp(op.getType(), operands, [](APFloat::cmpResult r) {
+    return r == APFloat::cmpGreaterThan || r == APFloat::cmpEqual;
+  });
+}
+
+OpFoldResult CmpGTEF32OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTEFOOp(*this, operands);
+}
+
+void CmpGTEF32OOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTEF32OOp, CmpLTF32UOp>>(context);
+  results.insert<RewritePseudoCmpGTEToLTE<CmpGTEF32OOp, CmpLTEF32OOp>>(context);
+}
+
+OpFoldResult CmpGTEF64OOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTEFOOp(*this, operands);
+}
+
+void CmpGTEF64OOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTEF64OOp, CmpLTF64UOp>>(context);
+  results.insert<RewritePseudoCmpGTEToLTE<CmpGTEF64OOp, CmpLTEF64OOp>>(context);
+}
+
+template <typename T>
+static OpFoldResult foldCmpGTEFUOp(T op, ArrayRef<Attribute> operands) {
+  if (op.lhs() == op.rhs()) {
+    // x >= x = true (even if x is NaN)
+    return oneOfType(op.getType());
+  }
+  return constFoldCmpFOp(
+      op.getType(), operands,
+      [](APFloat::cmpResult r) { return r != APFloat::cmpLessThan; });
+}
+
+OpFoldResult CmpGTEF32UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTEFUOp(*this, operands);
+}
+
+void CmpGTEF32UOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTEF32UOp, CmpLTF32OOp>>(context);
+  results.insert<RewritePseudoCmpGTEToLTE<CmpGTEF32UOp, CmpLTEF32UOp>>(context);
+}
+
+OpFoldResult CmpGTEF64UOp::fold(ArrayRef<Attribute> operands) {
+  return foldCmpGTEFUOp(*this, operands);
+}
+
+void CmpGTEF64UOp::getCanonicalizationPatterns(
+    OwningRewritePatternList &results, MLIRContext *context) {
+  results.insert<SwapInvertedCmpOps<CmpGTEF64UOp, CmpLTF64OOp>>(context);
+  results.insert<RewritePseudoCmpGTEToLTE<CmpGTEF64UOp, CmpLTEF64UOp>>(context);
+}
+
+OpFoldResult CmpNaNF32Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      getType(), operands,
+      [&](const APFloat &a) { return APInt(32, a.isNaN() ? 1 : 0); });
+}
+
+OpFoldResult CmpNaNF64Op::fold(ArrayRef<Attribute> operands) {
+  return constFoldCastOp<FloatAttr, IntegerAttr>(
+      getType(), operands,
+      [&](const APFloat &a) { return APInt(32, a.isNaN() ? 1 : 0); });
+}
+
 OpFoldResult CmpEQRefOp::fold(ArrayRef<Attribute> operands) {
   if (lhs() == rhs()) {
     // x == x = true
@@ -1738,6 +2449,20 @@ void CondFailOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
 
 namespace {
 
+/// Replaces a check op with a cond_fail on the inverse of |condValue|.
+template <typename CheckOp>
+void replaceCheckWithCondFail(CheckOp op, Value condValue,
+                              PatternRewriter &rewriter) {
+  Type condType = rewriter.getI32Type();
+  condValue = rewriter.createOrFold<XorI32Op>(
+      op.getLoc(), condType, condValue,
+      rewriter.createOrFold<IREE::VM::ConstI32Op>(op.getLoc(), 1));
+  auto statusCode = rewriter.createOrFold<ConstI32Op>(
+      op.getLoc(), /*IREE_STATUS_FAILED_PRECONDITION=*/9);
+  rewriter.replaceOpWithNewOp<IREE::VM::CondFailOp>(op, condValue, statusCode,
+                                                    op.messageAttr());
+}
+
 /// Rewrites a check op to a cmp and a cond_fail.
 template <typename CheckOp, typename CmpI32Op, typename CmpI64Op,
           typename CmpRefOp>
@@ -1763,13 +2488,34 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
     } else {
       return failure();
     }
-    condValue = rewriter.createOrFold<XorI32Op>(
-        op.getLoc(), condType, condValue,
-        rewriter.createOrFold<IREE::VM::ConstI32Op>(op.getLoc(), 1));
-    auto statusCode = rewriter.createOrFold<ConstI32Op>(
-        op.getLoc(), /*IREE_STATUS_FAILED_PRECONDITION=*/9);
-    rewriter.replaceOpWithNewOp<IREE::VM::CondFailOp>(op, condValue, statusCode,
-                                                      op.messageAttr());
+    replaceCheckWithCondFail(op, condValue, rewriter);
+    return success();
+  }
+};
+
+/// Rewrites a floating-point check op to a cmp and a cond_fail.
+/// The comparison ops chosen determine how NaNs are treated; for example
+/// vm.check.eq uses an ordered comparison such that NaN is never equal.
+template <typename CheckOp, typename CmpF32Op, typename CmpF64Op>
+struct RewriteFloatCheckToCondFail : public OpRewritePattern<CheckOp> {
+  using OpRewritePattern<CheckOp>::OpRewritePattern;
+  LogicalResult matchAndRewrite(CheckOp op,
+                                PatternRewriter &rewriter) const override {
+    Type condType = rewriter.getI32Type();
+    Value condValue;
+    Type operandType = op.getOperation()->getOperand(0).getType();
+    if (operandType.isF64()) {
+      condValue = rewriter.template createOrFold<CmpF64Op>(
+          op.getLoc(), ArrayRef<Type>{condType},
+          op.getOperation()->getOperands());
+    } else if (operandType.isF32()) {
+      condValue = rewriter.template createOrFold<CmpF32Op>(
+          op.getLoc(), ArrayRef<Type>{condType},
+          op.getOperation()->getOperands());
+    } else {
+      return failure();
+    }
+    replaceCheckWithCondFail(op, condValue, rewriter);
     return success();
   }
 };
@@ -1779,14 +2525,16 @@ struct RewriteCheckToCondFail : public OpRewritePattern<CheckOp> {
 void CheckEQOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
   results.insert<
-      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQRefOp>>(
+      RewriteCheckToCondFail<CheckEQOp, CmpEQI32Op, CmpEQI64Op, CmpEQRefOp>,
+      RewriteFloatCheckToCondFail<CheckEQOp, CmpEQF32OOp, CmpEQF64OOp>>(
       context);
 }
 
 void CheckNEOp::getCanonicalizationPatterns(OwningRewritePatternList &results,
                                             MLIRContext *context) {
   results.insert<
-      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNERefOp>>(
+      RewriteCheckToCondFail<CheckNEOp, CmpNEI32Op, CmpNEI64Op, CmpNERefOp>,
+      RewriteFloatCheckToCondFail<CheckNEOp, CmpNEF32UOp, CmpNEF64UOp>>(
       context);
 }
 
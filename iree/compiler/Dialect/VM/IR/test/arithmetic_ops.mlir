@@ -153,3 +153,69 @@ vm.module @my_module {
     vm.return %0 : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @add_f32
+vm.module @my_module {
+  vm.func @add_f32(%arg0 : f32, %arg1 : f32) -> f32 {
+    // CHECK: %0 = vm.add.f32 %arg0, %arg1 : f32
+    %0 = vm.add.f32 %arg0, %arg1 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @add_f64
+vm.module @my_module {
+  vm.func @add_f64(%arg0 : f64, %arg1 : f64) -> f64 {
+    // CHECK: %0 = vm.add.f64 %arg0, %arg1 : f64
+    %0 = vm.add.f64 %arg0, %arg1 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @neg_f32
+vm.module @my_module {
+  vm.func @neg_f32(%arg0 : f32) -> f32 {
+    // CHECK: %0 = vm.neg.f32 %arg0 : f32
+    %0 = vm.neg.f32 %arg0 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @neg_f64
+vm.module @my_module {
+  vm.func @neg_f64(%arg0 : f64) -> f64 {
+    // CHECK: %0 = vm.neg.f64 %arg0 : f64
+    %0 = vm.neg.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @floor_f32
+vm.module @my_module {
+  vm.func @floor_f32(%arg0 : f32) -> f32 {
+    // CHECK: %0 = vm.floor.f32 %arg0 : f32
+    %0 = vm.floor.f32 %arg0 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+// CHECK-LABEL: @floor_f64
+vm.module @my_module {
+  vm.func @floor_f64(%arg0 : f64) -> f64 {
+    // CHECK: %0 = vm.floor.f64 %arg0 : f64
+    %0 = vm.floor.f64 %arg0 : f64
+    vm.return %0 : f64
+  }
+}
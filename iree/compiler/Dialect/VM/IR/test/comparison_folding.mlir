@@ -450,3 +450,54 @@ vm.module @cmp_nz_ref_folds {
     vm.return %ne : i32
   }
 }
+
+// -----
+
+// CHECK-LABEL: @cmp_f32_folds
+vm.module @cmp_f32_folds {
+  // CHECK-LABEL: @const_lt
+  vm.func @const_lt() -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %c1 = vm.const.f32 1.0 : f32
+    %c2 = vm.const.f32 2.0 : f32
+    %lt = vm.cmp.lt.f32.o %c1, %c2 : f32
+    vm.return %lt : i32
+  }
+
+  // CHECK-LABEL: @const_nan_ordered
+  vm.func @const_nan_ordered() -> i32 {
+    // CHECK: %zero = vm.const.i32.zero : i32
+    // CHECK-NEXT: vm.return %zero : i32
+    %nan = vm.const.f32 0x7FC00000 : f32
+    %c1 = vm.const.f32 1.0 : f32
+    %lt = vm.cmp.lt.f32.o %nan, %c1 : f32
+    vm.return %lt : i32
+  }
+
+  // CHECK-LABEL: @const_nan_unordered
+  vm.func @const_nan_unordered() -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %nan = vm.const.f32 0x7FC00000 : f32
+    %c1 = vm.const.f32 1.0 : f32
+    %lt = vm.cmp.lt.f32.u %nan, %c1 : f32
+    vm.return %lt : i32
+  }
+
+  // CHECK-LABEL: @self_eq_unordered
+  vm.func @self_eq_unordered(%arg0 : f32) -> i32 {
+    // CHECK: %c1 = vm.const.i32 1 : i32
+    // CHECK-NEXT: vm.return %c1 : i32
+    %eq = vm.cmp.eq.f32.u %arg0, %arg0 : f32
+    vm.return %eq : i32
+  }
+
+  // CHECK-LABEL: @gt_to_lt
+  vm.func @gt_to_lt(%arg0 : f32, %arg1 : f32) -> i32 {
+    // CHECK: %[[LT:.+]] = vm.cmp.lt.f32.o %arg1, %arg0 : f32
+    // CHECK-NEXT: vm.return %[[LT]] : i32
+    %gt = vm.cmp.gt.f32.o %arg0, %arg1 : f32
+    vm.return %gt : i32
+  }
+}
@@ -24,6 +24,50 @@ vm.module @my_module {
 
 // -----
 
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32_zero
+  vm.func @const_f32_zero() -> f32 {
+    // CHECK: %zero = vm.const.f32.zero : f32
+    %zero = vm.const.f32.zero : f32
+    vm.return %zero : f32
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f32
+  vm.func @const_f32() -> f32 {
+    // CHECK: %0 = vm.const.f32 1.500000e+00 : f32
+    %0 = vm.const.f32 1.5 : f32
+    vm.return %0 : f32
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f64_zero
+  vm.func @const_f64_zero() -> f64 {
+    // CHECK: %zero = vm.const.f64.zero : f64
+    %zero = vm.const.f64.zero : f64
+    vm.return %zero : f64
+  }
+}
+
+// -----
+
+vm.module @my_module {
+  // CHECK-LABEL: @const_f64
+  vm.func @const_f64() -> f64 {
+    // CHECK: %0 = vm.const.f64 1.500000e+00 : f64
+    %0 = vm.const.f64 1.5 : f64
+    vm.return %0 : f64
+  }
+}
+
+// -----
+
 vm.module @my_module {
   // CHECK-LABEL: @const_ref_zero
   vm.func @const_ref_zero() -> !vm.ref<?> {
@@ -115,6 +115,21 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     }
   }
 
+  LogicalResult encodeFloatAttr(FloatAttr value) override {
+    auto attr = value.cast<FloatAttr>();
+    unsigned int bitWidth = attr.getType().getIntOrFloatBitWidth();
+    uint64_t bits = attr.getValue().bitcastToAPInt().getZExtValue();
+    switch (bitWidth) {
+      case 32:
+        return writeUint32(static_cast<uint32_t>(bits));
+      case 64:
+        return writeUint64(bits);
+      default:
+        return currentOp_->emitOpError()
+               << "attribute of bitwidth " << bitWidth << " not supported";
+    }
+  }
+
   LogicalResult encodeIntArrayAttr(DenseIntElementsAttr value) override {
     if (value.getNumElements() > UINT16_MAX ||
         failed(writeUint16(value.getNumElements()))) {
@@ -153,13 +168,23 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     // Compute required remappings - we only need to emit them when the source
     // and dest registers differ. Hopefully the allocator did a good job and
     // this list is small :)
+    //
+    // The remappings are split by register bank so that the runtime can
+    // process each without checking register types. Within a bank the order is
+    // preserved so that any hazard avoidance done by the allocator still holds.
     auto srcDstRegs = registerAllocation_->remapSuccessorRegisters(
         currentOp_, successorIndex);
-    writeUint16(srcDstRegs.size());
-    for (auto srcDstReg : srcDstRegs) {
-      if (failed(writeUint16(srcDstReg.first.encode())) ||
-          failed(writeUint16(srcDstReg.second.encode()))) {
-        return failure();
+    for (bool isRef : {false, true}) {
+      auto bankSrcDstRegs =
+          llvm::make_filter_range(srcDstRegs, [&](const auto &srcDstReg) {
+            return srcDstReg.first.isRef() == isRef;
+          });
+      writeUint16(std::distance(bankSrcDstRegs.begin(), bankSrcDstRegs.end()));
+      for (auto srcDstReg : bankSrcDstRegs) {
+        if (failed(writeUint16(srcDstReg.first.encode())) ||
+            failed(writeUint16(srcDstReg.second.encode()))) {
+          return failure();
+        }
       }
     }
 
@@ -186,6 +211,18 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  LogicalResult encodeSplitOperands(
+      Operation::operand_range values) override {
+    SmallVector<uint16_t, 8> refRegs;
+    SmallVector<uint16_t, 8> valueRegs;
+    for (auto it : llvm::enumerate(values)) {
+      auto reg = registerAllocation_->mapUseToRegister(it.value(), currentOp_,
+                                                       it.index());
+      (reg.isRef() ? refRegs : valueRegs).push_back(reg.encode());
+    }
+    return writeSplitRegisterLists(valueRegs, refRegs);
+  }
+
   LogicalResult encodeResult(Value value) override {
     uint16_t reg =
         registerAllocation_->mapUseToRegister(value, currentOp_, 0).encode();
@@ -203,6 +240,16 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  LogicalResult encodeSplitResults(Operation::result_range values) override {
+    SmallVector<uint16_t, 8> refRegs;
+    SmallVector<uint16_t, 8> valueRegs;
+    for (auto value : values) {
+      auto reg = registerAllocation_->mapToRegister(value);
+      (reg.isRef() ? refRegs : valueRegs).push_back(reg.encode());
+    }
+    return writeSplitRegisterLists(valueRegs, refRegs);
+  }
+
   Optional<std::vector<uint8_t>> finish() {
     if (failed(fixupOffsets())) {
       return llvm::None;
@@ -230,6 +277,18 @@ class V0BytecodeEncoder : public BytecodeEncoder {
     return success();
   }
 
+  // Writes the primitive register list followed by the ref register list.
+  LogicalResult writeSplitRegisterLists(ArrayRef<uint16_t> valueRegs,
+                                        ArrayRef<uint16_t> refRegs) {
+    for (auto regs : {valueRegs, refRegs}) {
+      if (failed(writeUint16(regs.size()))) return failure();
+      for (uint16_t reg : regs) {
+        if (failed(writeUint16(reg))) return failure();
+      }
+    }
+    return success();
+  }
+
   LogicalResult writeUint8(uint8_t value) {
     return writeBytes(&value, sizeof(value));
   }
@@ -239,6 +239,16 @@ static LogicalResult encodeCallingConventionType(Operation *op, Type type,
         s.push_back('I');
         return success();
     }
+  } else if (auto floatType = type.dyn_cast<FloatType>()) {
+    if (floatType.isF32()) {
+      s.push_back('f');
+      return success();
+    } else if (floatType.isF64()) {
+      s.push_back('F');
+      return success();
+    }
+    return op->emitError()
+           << "unsupported external calling convention float type " << type;
   } else if (auto tupleType = type.dyn_cast<TupleType>()) {
     // Flatten tuple (so tuple<i32, i64> -> `...iI...`).
     SmallVector<Type, 4> flattenedTypes;
@@ -17,8 +17,8 @@ vm.module @simple_module {
 
   // CHECK: function_descriptors:
   // CHECK-NEXT: bytecode_offset: 0
-  // CHECK-NEXT: bytecode_length: 5
+  // CHECK-NEXT: bytecode_length: 7
   // CHECK-NEXT: i32_register_count: 1
   // CHECK-NEXT: ref_register_count: 0
-  // CHECK: bytecode_data: [ 84, 1, 0, 0, 0 ]
+  // CHECK: bytecode_data: [ 84, 1, 0, 0, 0, 0, 0 ]
 }
@@ -15,6 +15,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/Format.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
 #include "llvm/TableGen/TableGenBackend.h"
 #include "mlir/TableGen/Attribute.h"
@@ -29,7 +30,153 @@ using ::llvm::format_hex;
 using ::llvm::formatv;
 using ::llvm::Record;
 
+// Returns the register bank character used in operand encoding strings for
+// values of the given type: `i` for 32-bit primitives, `I` for 64-bit
+// primitives (which span two i32 registers), `r` for refs, and `*` if the type
+// may be any of them.
+char getRegisterKind(const Record &typeDef) {
+  if (typeDef.isSubClassOf("Variadic")) {
+    return getRegisterKind(*typeDef.getValueAsDef("baseType"));
+  } else if (typeDef.getName() == "VM_AnyType") {
+    return '*';
+  } else if (typeDef.isSubClassOf("I") || typeDef.isSubClassOf("F")) {
+    return typeDef.getValueAsInt("bitwidth") == 64 ? 'I' : 'i';
+  } else if (typeDef.isSubClassOf("VM_AnyPtrOf") ||
+             typeDef.isSubClassOf("PtrOf") || typeDef.getName() == "AnyPtr") {
+    return 'i';
+  } else if (typeDef.isSubClassOf("VM_RefOf") ||
+             typeDef.isSubClassOf("VM_ListOf") ||
+             typeDef.getName() == "VM_AnyRef" ||
+             typeDef.getName() == "VM_AnyRefObject" ||
+             typeDef.getName() == "VM_AnyList") {
+    return 'r';
+  }
+  llvm::PrintFatalError(typeDef.getLoc(), llvm::Twine("type '") +
+                                              typeDef.getName() +
+                                              "' has no VM register bank");
+}
+
+// Returns the type of the operand or result named |name| on |opDef|.
+const Record &getNamedValueType(const Record &opDef, StringRef name) {
+  for (StringRef dagName : {"arguments", "results"}) {
+    auto *dag = opDef.getValueAsDag(dagName);
+    for (unsigned i = 0; i < dag->getNumArgs(); ++i) {
+      if (dag->getArgNameStr(i) != name) continue;
+      if (auto *defInit = dyn_cast<llvm::DefInit>(dag->getArg(i))) {
+        return *defInit->getDef();
+      }
+    }
+  }
+  llvm::PrintFatalError(opDef.getLoc(), llvm::Twine("encoded value '") +
+                                            name + "' not found on op");
+}
+
+// Returns the size character of an immediate value of |bitwidth| bits.
+char getImmediateSize(const Record &encodingExpr) {
+  int64_t bitwidth = encodingExpr.getValueAsInt("bitwidth");
+  if (bitwidth != 8 && bitwidth != 16 && bitwidth != 32 && bitwidth != 64) {
+    llvm::PrintFatalError(encodingExpr.getLoc(),
+                          "unsupported immediate bitwidth");
+  }
+  return '0' + bitwidth / 8;
+}
+
+// Builds the operand encoding string of an op describing the values that
+// follow the opcode in the bytecode. Used by the runtime bytecode verifier to
+// walk and validate instructions without needing per-op logic. Each value is
+// encoded as one character (some with a parameter):
+//   f:     function ordinal (int32, high bit set for imports)
+//   G/H/g: global byte offset for a 32-bit/64-bit value or ref global ordinal
+//   d:     rodata ordinal (int32)
+//   t:     type ordinal (int32)
+//   1-8:   immediate value of the given number of bytes
+//   aN:    integer array of uint16 count and N-byte elements
+//   s:     string of uint16 length and bytes
+//   b:     branch target pc (int32) and split i32/ref remap lists
+//   i/I/r: register of the i32 (or f32), i64 (or f64), or ref bank
+//   vK:    register list with registers of kind K (or `*` for any)
+//   V:     split register lists with i32 registers followed by refs
+std::string buildOperandEncoding(const Record &opDef) {
+  auto encodingExprs = opDef.getValueAsListOfDefs("encoding");
+
+  // Globals are accessed with the width of the value being loaded or stored.
+  char globalValueKind = 0;
+  for (auto *encodingExpr : encodingExprs) {
+    if (encodingExpr->isSubClassOf("VM_EncOperand") ||
+        encodingExpr->isSubClassOf("VM_EncResult")) {
+      globalValueKind = getRegisterKind(getNamedValueType(
+          opDef, encodingExpr->getValueAsString("valueName")));
+      break;
+    }
+  }
+
+  std::string encoding;
+  for (auto *encodingExpr : encodingExprs) {
+    if (encodingExpr->isSubClassOf("VM_EncOpcode")) {
+      // Opcodes (and their prefixes) are consumed by the dispatcher.
+      continue;
+    } else if (encodingExpr->isSubClassOf("VM_EncConstI8")) {
+      encoding += '1';
+    } else if (encodingExpr->isSubClassOf("VM_EncFuncAttr")) {
+      encoding += 'f';
+    } else if (encodingExpr->isSubClassOf("VM_EncGlobalAttr")) {
+      switch (globalValueKind) {
+        case 'i':
+          encoding += 'G';
+          break;
+        case 'I':
+          encoding += 'H';
+          break;
+        case 'r':
+          encoding += 'g';
+          break;
+        default:
+          llvm::PrintFatalError(opDef.getLoc(),
+                                "global access without a typed value");
+      }
+    } else if (encodingExpr->isSubClassOf("VM_EncRodataAttr")) {
+      encoding += 'd';
+    } else if (encodingExpr->isSubClassOf("VM_EncType") ||
+               encodingExpr->isSubClassOf("VM_EncTypeOf")) {
+      encoding += 't';
+    } else if (encodingExpr->isSubClassOf("VM_EncIntAttr") ||
+               encodingExpr->isSubClassOf("VM_EncFloatAttr")) {
+      encoding += getImmediateSize(*encodingExpr);
+    } else if (encodingExpr->isSubClassOf("VM_EncIntArrayAttr")) {
+      encoding += 'a';
+      encoding += getImmediateSize(*encodingExpr);
+    } else if (encodingExpr->isSubClassOf("VM_EncStrAttr")) {
+      encoding += 's';
+    } else if (encodingExpr->isSubClassOf("VM_EncBranch")) {
+      encoding += 'b';
+    } else if (encodingExpr->isSubClassOf("VM_EncOperand") ||
+               encodingExpr->isSubClassOf("VM_EncResult")) {
+      char kind = getRegisterKind(getNamedValueType(
+          opDef, encodingExpr->getValueAsString("valueName")));
+      if (kind == '*') {
+        llvm::PrintFatalError(opDef.getLoc(),
+                              "single register values must be typed");
+      }
+      encoding += kind;
+    } else if (encodingExpr->isSubClassOf("VM_EncVariadicOperands") ||
+               encodingExpr->isSubClassOf("VM_EncVariadicResults")) {
+      encoding += 'v';
+      encoding += getRegisterKind(getNamedValueType(
+          opDef, encodingExpr->getValueAsString("valueName")));
+    } else if (encodingExpr->isSubClassOf("VM_EncSplitVariadicOperands") ||
+               encodingExpr->isSubClassOf("VM_EncSplitVariadicResults")) {
+      encoding += 'V';
+    } else {
+      llvm::PrintFatalError(encodingExpr->getLoc(),
+                            "encoding expression not supported by the "
+                            "operand encoding table");
+    }
+  }
+  return encoding;
+}
+
 void emitOpTable(const llvm::RecordKeeper &recordKeeper, const Record &tableDef,
+                 const DenseMap<const Record *, std::string> &opcodeEncodings,
                  raw_ostream &os) {
   std::vector<const Record *> opEncodings(256);
   for (auto *opcodeDef : tableDef.getValueAsListOfDefs("enumerants")) {
@@ -66,16 +213,45 @@ void emitOpTable(const llvm::RecordKeeper &recordKeeper, const Record &tableDef,
     }
   }
   os << "\n\n";
+
+  os << formatv("#define IREE_VM_OP_{0}_ENCODING_TABLE(ENC)",
+                tableDef.getValueAsString("opcodeEnumTag"));
+  for (int i = 0; i < 256; ++i) {
+    auto *opcode = opEncodings[i];
+    if (!opcode) continue;
+    auto it = opcodeEncodings.find(opcode);
+    if (it == opcodeEncodings.end()) continue;
+    os << formatv(" \\\n    ENC({0}, {1}, \"{2}\")", format_hex(i, 4, true),
+                  opcode->getValueAsString("symbol"), it->second);
+  }
+  os << "\n\n";
 }
 
 // Finds all opcode tables in VMBase.td and emits a enum and template table for
-// their opcode and name.
+// their opcode and name along with a table of their operand encodings.
 bool emitOpTableDefs(const llvm::RecordKeeper &recordKeeper, raw_ostream &os) {
   llvm::emitSourceFileHeader("IREE VM Operation Tables", os);
 
+  DenseMap<const Record *, std::string> opcodeEncodings;
+  for (const auto *opDef : recordKeeper.getAllDerivedDefinitions("VM_Op")) {
+    if (opDef->isValueUnset("encoding")) continue;
+    auto encodingExprs = opDef->getValueAsListOfDefs("encoding");
+    if (encodingExprs.empty() ||
+        !encodingExprs.front()->isSubClassOf("VM_EncOpcode")) {
+      continue;
+    }
+    const Record *opcode = encodingExprs.front()->getValueAsDef("opcode");
+    std::string encoding = buildOperandEncoding(*opDef);
+    auto it = opcodeEncodings.try_emplace(opcode, encoding).first;
+    if (it->second != encoding) {
+      llvm::PrintFatalError(opDef->getLoc(),
+                            "ops sharing an opcode have different encodings");
+    }
+  }
+
   auto defs = recordKeeper.getAllDerivedDefinitions("VM_OPC_EnumAttr");
   for (const auto *def : defs) {
-    emitOpTable(recordKeeper, *def, os);
+    emitOpTable(recordKeeper, *def, opcodeEncodings, os);
   }
 
   return false;
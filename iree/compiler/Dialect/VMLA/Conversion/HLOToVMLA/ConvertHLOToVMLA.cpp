@@ -703,12 +703,40 @@ struct SortOpConversion : public OpConversionPattern<IREE::VMLA::SortPseudoOp> {
   TypeConverter &typeConverter;
 };
 
-struct FftOpConversion : public OpConversionPattern<IREE::VMLA::FftPseudoOp> {
-  FftOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+struct TopKOpConversion : public OpConversionPattern<IREE::VMLA::TopKPseudoOp> {
+  TopKOpConversion(MLIRContext *context, TypeConverter &typeConverter)
       : OpConversionPattern(context), typeConverter(typeConverter) {}
 
   LogicalResult matchAndRewrite(
-      IREE::VMLA::FftPseudoOp srcOp, ArrayRef<Value> rawOperands,
+      IREE::VMLA::TopKPseudoOp srcOp, ArrayRef<Value> rawOperands,
+      ConversionPatternRewriter &rewriter) const override {
+    auto inputType =
+        srcOp.value().getType().cast<ShapedType>().getElementType();
+    auto src = rawOperands[0];
+    auto src_shape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.value(), typeConverter, rewriter);
+    auto dst = VMLAConversionTarget::allocateOutputBuffer(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    auto dst_shape = VMLAConversionTarget::getTensorShape(
+        srcOp.getLoc(), srcOp.getResult(), typeConverter, rewriter);
+    rewriter.createOrFold<IREE::VMLA::TopKOp>(
+        srcOp.getLoc(), src, src_shape, dst, dst_shape, srcOp.orderAttr(),
+        TypeAttr::get(inputType));
+    rewriter.replaceOp(srcOp, {dst});
+    return success();
+  }
+
+  TypeConverter &typeConverter;
+};
+
+// Converts vmla.fft.pseudo/vmla.ifft.pseudo to their buffer-level op.
+template <typename SRC, typename DST>
+struct FftOpConversion : public OpConversionPattern<SRC> {
+  FftOpConversion(MLIRContext *context, TypeConverter &typeConverter)
+      : OpConversionPattern<SRC>(context), typeConverter(typeConverter) {}
+
+  LogicalResult matchAndRewrite(
+      SRC srcOp, ArrayRef<Value> rawOperands,
       ConversionPatternRewriter &rewriter) const override {
     auto input_shape = VMLAConversionTarget::getTensorShape(
         srcOp.getLoc(), srcOp.real_in(), typeConverter, rewriter);
@@ -727,7 +755,7 @@ struct FftOpConversion : public OpConversionPattern<IREE::VMLA::FftPseudoOp> {
     auto imag_out = VMLAConversionTarget::allocateOutputBuffer(
         srcOp.getLoc(), srcOp.getResult(1), typeConverter, rewriter);
 
-    rewriter.createOrFold<IREE::VMLA::FftOp>(
+    rewriter.createOrFold<DST>(
         srcOp.getLoc(), rawOperands[0], input_shape, rawOperands[1],
         input_shape, real_out, imag_out,
         TypeAttr::get(real_input_type.getElementType()),
@@ -806,8 +834,15 @@ void populateHLOToVMLAPatterns(MLIRContext *context,
   // vmla.sort.pseudo
   patterns.insert<SortOpConversion>(context, typeConverter);
 
-  // vmla.fft.pseudo
-  patterns.insert<FftOpConversion>(context, typeConverter);
+  // vmla.topk.pseudo
+  patterns.insert<TopKOpConversion>(context, typeConverter);
+
+  // vmla.fft.pseudo/vmla.ifft.pseudo
+  patterns.insert<FftOpConversion<IREE::VMLA::FftPseudoOp, IREE::VMLA::FftOp>>(
+      context, typeConverter);
+  patterns
+      .insert<FftOpConversion<IREE::VMLA::IfftPseudoOp, IREE::VMLA::IfftOp>>(
+          context, typeConverter);
 
   // Simple 1:1 conversion patterns using the automated trait-based converter.
   // Used for HLO ops that have equivalent VMLA ops such as most arithmetic ops.
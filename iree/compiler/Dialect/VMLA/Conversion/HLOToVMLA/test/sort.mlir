@@ -35,3 +35,23 @@ func @sort2D(%arg0 : tensor<4x4xf32>) -> tensor<4x4xf32> attributes { sym_visibi
   // CHECK: return [[BUF]] : !vmla.buffer
   return %sort : tensor<4x4xf32>
 }
+
+// CHECK-LABEL: func @topk2D
+func @topk2D(%arg0 : tensor<4x8xf32>) -> tensor<4x2xf32> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: [[C32:%.+]] = constant 32 : index
+  // CHECK-DAG: [[SRC_RS:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[4,8]>
+  // CHECK-DAG: [[DST_RS:%.+]] = shapex.const_ranked_shape : !shapex.ranked_shape<[4,2]>
+  // CHECK-DAG: [[BL:%.+]] = vmla.buffer.alloc byte_length = [[C32]] : !vmla.buffer
+  // CHECK-DAG: vmla.topk %arg0([[SRC_RS]] : !shapex.ranked_shape<[4,8]>), out [[BL]]([[DST_RS]] : !shapex.ranked_shape<[4,2]>), "Descending" : f32
+  // CHECK-DAG: [[BUF:%.+]] = vmla.buffer.alloc byte_length = [[C32]] : !vmla.buffer
+  // CHECK-DAG: vmla.gather %arg0([[SRC_RS]] : !shapex.ranked_shape<[4,8]>), [[BL]]([[DST_RS]] : !shapex.ranked_shape<[4,2]>), out [[BUF]]([[DST_RS]] : !shapex.ranked_shape<[4,2]>) {batch_dims = 1 : i64, dim = 1 : i64} : f32
+  %sort = "mhlo.sort"(%arg0) ( {
+  ^bb0(%arg1: tensor<f32>, %arg2: tensor<f32>):  // no predecessors
+    %compare = "mhlo.compare"(%arg1, %arg2) {comparison_direction = "GT"} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%compare) : (tensor<i1>) -> ()
+  }) {dimension = 1 : i64, is_stable = true} : (tensor<4x8xf32>) -> tensor<4x8xf32>
+  %slice = "mhlo.slice"(%sort) {limit_indices = dense<[4, 2]> : tensor<2xi64>, start_indices = dense<0> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<4x8xf32>) -> tensor<4x2xf32>
+
+  // CHECK: return [[BUF]] : !vmla.buffer
+  return %slice : tensor<4x2xf32>
+}
@@ -131,7 +131,6 @@ class VMLAImportOpConversion : public OpConversionPattern<T> {
     return typePrefix + std::to_string(bitWidth);
   }
 
- private:
   SymbolTable &importSymbols;
   TypeConverter &typeConverter;
   std::string importName;
@@ -268,13 +267,73 @@ class VMLAConvImportOpConversion
   }
 };
 
-class VMLAFftImportOpConversion
-    : public VMLAImportOpConversion<IREE::VMLA::FftOp> {
+// Converts the fused elementwise op to a call with its program encoded as an
+// inline rodata byte buffer. The generic attribute handling would expand the
+// program into one constant operand per word.
+class VMLAFusedElementwiseImportOpConversion
+    : public VMLAImportOpConversion<IREE::VMLA::FusedElementwiseOp> {
+ public:
+  using VMLAImportOpConversion<
+      IREE::VMLA::FusedElementwiseOp>::VMLAImportOpConversion;
+
+  LogicalResult matchAndRewrite(
+      IREE::VMLA::FusedElementwiseOp op, llvm::ArrayRef<Value> operands,
+      ConversionPatternRewriter &rewriter) const override {
+    std::string importFqName = importName + getImportSuffix(op);
+    auto importOp = importSymbols.lookup<IREE::VM::ImportOp>(importFqName);
+    if (!importOp) {
+      op.emitError() << "failed to resolve VM function import for "
+                     << importFqName;
+      return failure();
+    }
+
+    IREE::VMLA::FusedElementwiseOp::Adaptor adaptor(operands);
+    auto programValue = rewriter.createOrFold<IREE::VM::RodataInlineOp>(
+        op.getLoc(),
+        IREE::VM::RefType::get(IREE::ByteBufferType::get(op.getContext())),
+        op.program());
+
+    OperationState state{op.getLoc(),
+                         IREE::VM::CallVariadicOp::getOperationName()};
+    state.addAttribute("callee", rewriter.getSymbolRefAttr(importOp));
+    state.addOperands(programValue);
+    state.addOperands(adaptor.srcs());
+    state.addOperands(adaptor.dst());
+    SmallVector<int16_t, 3> segmentSizes = {
+        kFixedSingleValue,
+        static_cast<int16_t>(adaptor.srcs().size()),
+        kFixedSingleValue,
+    };
+    state.addAttribute(
+        "segment_sizes",
+        DenseIntElementsAttr::get(
+            VectorType::get({static_cast<int64_t>(segmentSizes.size())},
+                            rewriter.getIntegerType(16)),
+            llvm::makeArrayRef(segmentSizes)));
+    state.addAttribute("segment_types",
+                       rewriter.getArrayAttr(llvm::to_vector<4>(llvm::map_range(
+                           importOp.getType().getInputs(), [&](Type type) {
+                             return TypeAttr::get(type).cast<Attribute>();
+                           }))));
+    rewriter.createOperation(state);
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+ protected:
+  std::string getImportSuffix(
+      IREE::VMLA::FusedElementwiseOp op) const override {
+    return "." + getTypedTypeStr(op.element_type());
+  }
+};
+
+template <typename T>
+class VMLAFftImportOpConversion : public VMLAImportOpConversion<T> {
  public:
-  using VMLAImportOpConversion<IREE::VMLA::FftOp>::VMLAImportOpConversion;
+  using VMLAImportOpConversion<T>::VMLAImportOpConversion;
 
-  std::string getImportSuffix(IREE::VMLA::FftOp op) const override {
-    return std::string(".") + getTypedTypeStr(op.real_element_type());
+  std::string getImportSuffix(T op) const override {
+    return "." + this->getTypedTypeStr(op.real_element_type());
   }
 };
 }  // namespace
@@ -346,6 +405,7 @@ void populateVMLAToVMPatterns(MLIRContext *context,
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::CeilOp, "vmla.ceil");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::RoundOp, "vmla.round");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::SortOp, "vmla.sort");
+  VMLA_TYPED_IMPORT_OP(IREE::VMLA::TopKOp, "vmla.topk");
 
   patterns.insert<VMLAConvertImportOpConversion>(context, importSymbols,
                                                  typeConverter, "vmla.convert");
@@ -353,8 +413,12 @@ void populateVMLAToVMPatterns(MLIRContext *context,
       context, importSymbols, typeConverter, "vmla.batch.matmul");
   patterns.insert<VMLAConvImportOpConversion>(context, importSymbols,
                                               typeConverter, "vmla.conv");
-  patterns.insert<VMLAFftImportOpConversion>(context, importSymbols,
-                                             typeConverter, "vmla.fft");
+  patterns.insert<VMLAFusedElementwiseImportOpConversion>(
+      context, importSymbols, typeConverter, "vmla.fused.elementwise");
+  patterns.insert<VMLAFftImportOpConversion<IREE::VMLA::FftOp>>(
+      context, importSymbols, typeConverter, "vmla.fft");
+  patterns.insert<VMLAFftImportOpConversion<IREE::VMLA::IfftOp>>(
+      context, importSymbols, typeConverter, "vmla.ifft");
 
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceSumOp, "vmla.reduce.sum");
   VMLA_TYPED_IMPORT_OP(IREE::VMLA::ReduceMinOp, "vmla.reduce.min");
@@ -71,3 +71,29 @@ func @batch_matmul(
                     out %dst(%dst_shape : !shapex.ranked_shape<[3,4,4]>) : f32
   return
 }
+
+// -----
+
+// CHECK-LABEL: vm.func @fusedElementwise
+func @fusedElementwise(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer, %arg2 : !vmla.buffer) {
+  // CHECK-NEXT: [[PROGRAM:%.+]] = vm.rodata.inline : !vm.ref<!iree.byte_buffer> = dense<[2, 2, 3, 0, 1, 0, 13, 2, 0, 0]> : tensor<10xi32>
+  // CHECK-NEXT: vm.call.variadic @vmla.fused.elementwise.f32([[PROGRAM]], [%arg0, %arg1], %arg2) : (!vm.ref<!iree.byte_buffer>, !vm.ref<!vmla.buffer> ..., !vm.ref<!vmla.buffer>)
+  vmla.fused.elementwise(%arg0, %arg1), out %arg2 {program = dense<[2, 2, 3, 0, 1, 0, 13, 2, 0, 0]> : tensor<10xi32>} : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: vm.func @topk
+func @topk(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  %src_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[4,8]>
+  %dst_shape = shapex.const_ranked_shape : !shapex.ranked_shape<[4,2]>
+  // CHECK-DAG: %c1 = vm.const.i32 1 : i32
+  // CHECK-DAG: %c2 = vm.const.i32 2 : i32
+  // CHECK-DAG: %c4 = vm.const.i32 4 : i32
+  // CHECK-DAG: %c8 = vm.const.i32 8 : i32
+  // CHECK: vm.call.variadic @vmla.topk.f32(%arg0, [%c4, %c8], %arg1, [%c4, %c2], %c1) : (!vm.ref<!vmla.buffer>, i32 ..., !vm.ref<!vmla.buffer>, i32 ..., i32)
+  vmla.topk %arg0(%src_shape : !shapex.ranked_shape<[4,8]>),
+            out %arg1(%dst_shape : !shapex.ranked_shape<[4,2]>), "Descending" : f32
+  return
+}
@@ -0,0 +1,296 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/compiler/Dialect/VMLA/IR/VMLAOps.h"
+#include "iree/compiler/Dialect/VMLA/Transforms/Passes.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/TypeSwitch.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/StandardTypes.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir {
+namespace iree_compiler {
+namespace IREE {
+namespace VMLA {
+
+namespace {
+
+// Maximum number of instructions (including constants) in a fused program.
+// NOTE: must match FusedElementwise::kMaxInstructionCount in the runtime.
+constexpr int kMaxInstructionCount = 16;
+
+// Returns the fused opcode for |op| if it is an f32 elementwise op that can be
+// evaluated by vmla.fused.elementwise.
+Optional<FusedOpcode> getFusedOpcode(Operation *op) {
+  auto opcode = llvm::TypeSwitch<Operation *, Optional<FusedOpcode>>(op)
+                    .Case<AddOp>([](auto) { return FusedOpcode::Add; })
+                    .Case<SubOp>([](auto) { return FusedOpcode::Sub; })
+                    .Case<MulOp>([](auto) { return FusedOpcode::Mul; })
+                    .Case<DivOp>([](auto) { return FusedOpcode::Div; })
+                    .Case<MinOp>([](auto) { return FusedOpcode::Min; })
+                    .Case<MaxOp>([](auto) { return FusedOpcode::Max; })
+                    .Case<NegOp>([](auto) { return FusedOpcode::Neg; })
+                    .Case<AbsOp>([](auto) { return FusedOpcode::Abs; })
+                    .Case<ExpOp>([](auto) { return FusedOpcode::Exp; })
+                    .Case<LogOp>([](auto) { return FusedOpcode::Log; })
+                    .Case<SqrtOp>([](auto) { return FusedOpcode::Sqrt; })
+                    .Case<RsqrtOp>([](auto) { return FusedOpcode::Rsqrt; })
+                    .Case<TanhOp>([](auto) { return FusedOpcode::Tanh; })
+                    .Case<FloorOp>([](auto) { return FusedOpcode::Floor; })
+                    .Case<CeilOp>([](auto) { return FusedOpcode::Ceil; })
+                    .Case<ClampOp>([](auto) { return FusedOpcode::Clamp; })
+                    .Default([](Operation *) { return llvm::None; });
+  if (!opcode) return llvm::None;
+  auto elementType = op->getAttrOfType<TypeAttr>("element_type");
+  if (!elementType || !elementType.getValue().isF32() ||
+      op->getAttr("forceUnsigned")) {
+    return llvm::None;
+  }
+  return opcode;
+}
+
+// All elementwise ops take their inputs first and their output last.
+Value getFusedOpDst(Operation *op) {
+  return op->getOperand(op->getNumOperands() - 1);
+}
+OperandRange getFusedOpSrcs(Operation *op) {
+  return op->getOperands().drop_back();
+}
+
+// Returns the bit pattern of |value| if it is a splat f32 constant buffer.
+Optional<int32_t> getSplatConstantBits(Value value) {
+  auto constantOp = value.getDefiningOp<ConstantOp>();
+  if (!constantOp) return llvm::None;
+  auto splatAttr = constantOp.value().dyn_cast<SplatElementsAttr>();
+  if (!splatAttr || !splatAttr.getType().getElementType().isF32()) {
+    return llvm::None;
+  }
+  return static_cast<int32_t>(splatAttr.getSplatValue<FloatAttr>()
+                                  .getValue()
+                                  .bitcastToAPInt()
+                                  .getZExtValue());
+}
+
+// Returns true if |value| is a buffer allocated in the block of |producer| that
+// is only written by |producer| and only read by |consumer|.
+bool isFusibleIntermediate(Value value, Operation *producer,
+                           Operation *consumer) {
+  auto allocOp = value.getDefiningOp<BufferAllocOp>();
+  if (!allocOp || allocOp->getBlock() != producer->getBlock()) return false;
+  for (auto &use : value.getUses()) {
+    if (use.getOwner() == producer) {
+      if (use.getOperandNumber() != producer->getNumOperands() - 1) {
+        return false;
+      }
+    } else if (use.getOwner() == consumer) {
+      if (use.getOperandNumber() == consumer->getNumOperands() - 1) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// A set of elementwise ops that will be evaluated as one fused program rooted
+// at the last op. Ops are kept in block order.
+struct FusionGroup {
+  SmallVector<Operation *, 4> ops;
+  // Upper bound on the constant instructions required by |ops|.
+  int constantCount = 0;
+
+  Operation *getRoot() const { return ops.back(); }
+  int getInstructionCount() const { return ops.size() + constantCount; }
+};
+
+// Builds the fused program for |group| and replaces its ops with a single
+// vmla.fused.elementwise op.
+void emitFusedOp(FusionGroup &group) {
+  auto *rootOp = group.getRoot();
+
+  // Gather the external inputs in order of first use. Buffers written by ops
+  // within the group become registers and are never read from memory.
+  llvm::SmallPtrSet<Value, 8> intermediates;
+  for (auto *op : group.ops) {
+    if (op != rootOp) intermediates.insert(getFusedOpDst(op));
+  }
+  llvm::SetVector<Value> srcs;
+  for (auto *op : group.ops) {
+    for (auto src : getFusedOpSrcs(op)) {
+      if (!intermediates.count(src) && !getSplatConstantBits(src)) {
+        srcs.insert(src);
+      }
+    }
+  }
+
+  // Assign registers: [0, srcs) are the inputs and each instruction defines
+  // the next register in order.
+  int32_t inputCount = srcs.size();
+  SmallVector<int32_t, 64> program = {inputCount, 0};
+  llvm::DenseMap<Value, int32_t> registers;
+  for (auto src : llvm::enumerate(srcs)) {
+    registers[src.value()] = src.index();
+  }
+  int32_t nextRegister = inputCount;
+  auto appendInstruction = [&](FusedOpcode opcode, ArrayRef<int32_t> operands) {
+    program.push_back(static_cast<int32_t>(opcode));
+    for (int i = 0; i < 3; ++i) {
+      program.push_back(i < operands.size() ? operands[i] : 0);
+    }
+    return nextRegister++;
+  };
+  for (auto *op : group.ops) {
+    SmallVector<int32_t, 3> operands;
+    for (auto src : getFusedOpSrcs(op)) {
+      auto it = registers.find(src);
+      if (it == registers.end()) {
+        int32_t constantRegister = appendInstruction(
+            FusedOpcode::Constant, {getSplatConstantBits(src).getValue()});
+        it = registers.insert({src, constantRegister}).first;
+      }
+      operands.push_back(it->second);
+    }
+    registers[getFusedOpDst(op)] =
+        appendInstruction(getFusedOpcode(op).getValue(), operands);
+  }
+  program[1] = nextRegister - inputCount;
+
+  OpBuilder builder(rootOp);
+  builder.create<FusedElementwiseOp>(
+      rootOp->getLoc(), srcs.getArrayRef(), getFusedOpDst(rootOp),
+      DenseIntElementsAttr::get(
+          RankedTensorType::get({static_cast<int64_t>(program.size())},
+                                builder.getIntegerType(32)),
+          llvm::makeArrayRef(program)),
+      TypeAttr::get(builder.getF32Type()));
+
+  // Erase the original ops and any intermediates that are no longer used.
+  llvm::SetVector<Operation *> deadOps;
+  for (auto *op : llvm::reverse(group.ops)) {
+    for (auto operand : op->getOperands()) {
+      if (auto *definingOp = operand.getDefiningOp()) {
+        if (isa<BufferAllocOp, ConstantOp>(definingOp)) {
+          deadOps.insert(definingOp);
+        }
+      }
+    }
+    op->erase();
+  }
+  for (auto *op : deadOps) {
+    if (op->use_empty()) op->erase();
+  }
+}
+
+// Returns true if |op| cannot write to any buffer that existed before it.
+bool isFusionTransparent(Operation *op) {
+  return isa<BufferAllocOp>(op) || MemoryEffectOpInterface::hasNoEffect(op);
+}
+
+}  // namespace
+
+// Fuses chains of f32 elementwise ops into vmla.fused.elementwise ops.
+//
+// A producer is fused into its consumer when the buffer it writes is a
+// transient allocation used only by that consumer. Because the fused op
+// evaluates all producers at the position of the consumer no op in between may
+// write to a buffer the group reads; fusion is conservatively stopped at any op
+// that may write to an existing buffer.
+class FuseElementwiseOpsPass
+    : public PassWrapper<FuseElementwiseOpsPass, FunctionPass> {
+ public:
+  void runOnFunction() override {
+    for (auto &block : getFunction()) {
+      for (auto &group : buildFusionGroups(block)) {
+        if (group.ops.size() > 1) emitFusedOp(group);
+      }
+    }
+  }
+
+ private:
+  std::vector<FusionGroup> buildFusionGroups(Block &block) {
+    std::vector<FusionGroup> groups;
+    // Groups whose root writes a transient buffer that may still be fused into
+    // a later consumer, keyed by that buffer.
+    llvm::MapVector<Value, int> pendingGroups;
+    llvm::DenseSet<int> fusedGroups;
+
+    for (auto &op : block) {
+      if (!getFusedOpcode(&op)) {
+        if (!isFusionTransparent(&op)) pendingGroups.clear();
+        continue;
+      }
+
+      FusionGroup group;
+      for (auto src : getFusedOpSrcs(&op)) {
+        if (getSplatConstantBits(src)) ++group.constantCount;
+      }
+      for (auto src : getFusedOpSrcs(&op)) {
+        auto it = pendingGroups.find(src);
+        if (it == pendingGroups.end()) continue;
+        auto &producerGroup = groups[it->second];
+        if (!isFusibleIntermediate(src, producerGroup.getRoot(), &op) ||
+            group.getInstructionCount() +
+                    producerGroup.getInstructionCount() >
+                kMaxInstructionCount) {
+          continue;
+        }
+        group.ops.append(producerGroup.ops.begin(), producerGroup.ops.end());
+        group.constantCount += producerGroup.constantCount;
+        fusedGroups.insert(it->second);
+        pendingGroups.erase(it);
+      }
+      llvm::sort(group.ops, [](Operation *lhs, Operation *rhs) {
+        return lhs->isBeforeInBlock(rhs);
+      });
+      group.ops.push_back(&op);
+
+      // Writing to a buffer that was already read invalidates any group that
+      // may have read it.
+      Value dst = getFusedOpDst(&op);
+      bool dstIsFresh = dst.getDefiningOp<BufferAllocOp>() &&
+                        llvm::all_of(dst.getUsers(), [&](Operation *user) {
+                          return user == &op || op.isBeforeInBlock(user);
+                        });
+      if (!dstIsFresh) pendingGroups.clear();
+
+      groups.push_back(std::move(group));
+      if (dstIsFresh) pendingGroups[dst] = groups.size() - 1;
+    }
+
+    std::vector<FusionGroup> rootGroups;
+    for (int i = 0; i < groups.size(); ++i) {
+      if (!fusedGroups.count(i)) rootGroups.push_back(std::move(groups[i]));
+    }
+    return rootGroups;
+  }
+};
+
+std::unique_ptr<OperationPass<FuncOp>> createFuseElementwiseOpsPass() {
+  return std::make_unique<FuseElementwiseOpsPass>();
+}
+
+static PassRegistration<FuseElementwiseOpsPass> pass(
+    "iree-vmla-fuse-elementwise-ops",
+    "Fuses chains of elementwise VMLA ops into vmla.fused.elementwise ops.");
+
+}  // namespace VMLA
+}  // namespace IREE
+}  // namespace iree_compiler
+}  // namespace mlir
@@ -99,6 +99,11 @@ void buildVMLATransformPassPipeline(OpPassManager &passManager) {
   passManager.addNestedPass<FuncOp>(createCSEPass());
   passManager.addPass(createConversionPass());
 
+  // Fuse elementwise op chains once the buffers they communicate through are
+  // explicit.
+  passManager.addNestedPass<FuncOp>(createCSEPass());
+  passManager.addNestedPass<FuncOp>(createFuseElementwiseOpsPass());
+
   // ---------------------------------------------------------------------------
   // Cleanup identity ops that clutter up the IR and canonicalize.
   // ---------------------------------------------------------------------------
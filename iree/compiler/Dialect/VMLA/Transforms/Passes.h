@@ -64,6 +64,14 @@ std::unique_ptr<OperationPass<FuncOp>> createPreConversionLoweringPass();
 // Converts from various dialects (standard, HLO, etc) to the VMLA dialect.
 std::unique_ptr<OperationPass<mlir::ModuleOp>> createConversionPass();
 
+//===----------------------------------------------------------------------===//
+// VMLA-level optimizations
+//===----------------------------------------------------------------------===//
+
+// Fuses chains of elementwise ops into vmla.fused.elementwise ops that avoid
+// materializing intermediate buffers.
+std::unique_ptr<OperationPass<FuncOp>> createFuseElementwiseOpsPass();
+
 //===----------------------------------------------------------------------===//
 // Register all Passes
 //===----------------------------------------------------------------------===//
@@ -73,6 +81,7 @@ inline void registerVMLAPasses() {
   createUnrollReductionsPass();
   createConversionPass();
   createPreConversionLoweringPass();
+  createFuseElementwiseOpsPass();
 }
 
 }  // namespace VMLA
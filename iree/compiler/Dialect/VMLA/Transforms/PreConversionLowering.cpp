@@ -368,18 +368,155 @@ class LowerSortOp : public OpRewritePattern<mhlo::SortOp> {
   }
 };
 
+// The operand a sort orders by and the order it sorts in.
+struct SortKey {
+  int operandIndex;
+  VMLA::SortOrder order;
+};
+
+// Returns the sort key of |op| if its comparator is a single comparison of the
+// two values of one operand.
+Optional<SortKey> getSortKey(mhlo::SortOp op) {
+  auto &block = op.comparator().front();
+  if (block.getOperations().size() != 2) return llvm::None;
+  auto comparison = dyn_cast<mhlo::CompareOp>(&block.front());
+  auto returnOp = dyn_cast<mhlo::ReturnOp>(block.getTerminator());
+  if (!comparison || !returnOp || returnOp.getNumOperands() != 1 ||
+      returnOp.getOperand(0) != comparison.getResult()) {
+    return llvm::None;
+  }
+
+  auto lhs = comparison.lhs().dyn_cast<BlockArgument>();
+  auto rhs = comparison.rhs().dyn_cast<BlockArgument>();
+  if (!lhs || !rhs || lhs.getOwner() != &block || rhs.getOwner() != &block) {
+    return llvm::None;
+  }
+  // Arguments are pairs of values of each operand.
+  int lhsIndex = lhs.getArgNumber();
+  int rhsIndex = rhs.getArgNumber();
+  if (lhsIndex / 2 != rhsIndex / 2 || lhsIndex == rhsIndex) return llvm::None;
+
+  // The comparator returns true if its first value is ordered before its
+  // second, so comparing (first, second) with LT sorts ascending. GE and LE are
+  // not strict orderings and place equal elements differently than the
+  // index-ordered ties of the top-k kernel, so they are not matched.
+  auto direction = comparison.comparison_direction();
+  bool isGt = direction == "GT";
+  bool isLt = direction == "LT";
+  if (!isGt && !isLt) return llvm::None;
+  bool isSwapped = lhsIndex > rhsIndex;
+  return SortKey{lhsIndex / 2, isSwapped != isGt ? VMLA::SortOrder::Descending
+                                                 : VMLA::SortOrder::Ascending};
+}
+
+// Returns true if |sliceOp| takes the first |k| elements of the last dimension
+// of its operand and all of the other dimensions.
+bool isLeadingSliceOfLastDimension(mhlo::SliceOp sliceOp, int64_t &k) {
+  auto operandType = sliceOp.operand().getType().cast<RankedTensorType>();
+  int64_t rank = operandType.getRank();
+  auto startIndices =
+      llvm::to_vector<4>(sliceOp.start_indices().getValues<int64_t>());
+  auto limitIndices =
+      llvm::to_vector<4>(sliceOp.limit_indices().getValues<int64_t>());
+  auto strides = llvm::to_vector<4>(sliceOp.strides().getValues<int64_t>());
+  for (int64_t i = 0; i < rank; ++i) {
+    if (startIndices[i] != 0 || strides[i] != 1) return false;
+    if (i != rank - 1 && limitIndices[i] != operandType.getDimSize(i)) {
+      return false;
+    }
+  }
+  k = limitIndices[rank - 1];
+  return true;
+}
+
+// Lower an mhlo::SortOp whose results are only used to take the first k
+// elements of each row to a pseudo TopKOp in the VMLA dialect. Only the
+// selected indices are computed and sorted, which avoids sorting whole rows
+// when k is small. As with LowerSortOp the values are then gathered with a
+// torch_index_select.
+class LowerSortTopKOp : public OpRewritePattern<mhlo::SortOp> {
+ public:
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(mhlo::SortOp op,
+                                PatternRewriter &rewriter) const override {
+    auto operandTy = op.getOperand(0).getType().cast<RankedTensorType>();
+    if (!operandTy.hasStaticShape()) return failure();
+    int64_t rank = operandTy.getRank();
+    if (rank == 0 || (op.dimension() != -1 && op.dimension() != rank - 1)) {
+      return failure();
+    }
+    auto sortKey = getSortKey(op);
+    if (!sortKey) return failure();
+
+    // All results must be sliced to the same leading k elements.
+    llvm::SmallVector<mhlo::SliceOp, 4> sliceOps;
+    int64_t k = -1;
+    for (auto *user : op.getOperation()->getUsers()) {
+      auto sliceOp = dyn_cast<mhlo::SliceOp>(user);
+      int64_t sliceK = 0;
+      if (!sliceOp || !isLeadingSliceOfLastDimension(sliceOp, sliceK) ||
+          (k != -1 && sliceK != k)) {
+        return failure();
+      }
+      k = sliceK;
+      sliceOps.push_back(sliceOp);
+    }
+    if (sliceOps.empty() || k >= operandTy.getShape().back()) {
+      return failure();
+    }
+
+    auto indicesShape = llvm::to_vector<4>(operandTy.getShape());
+    indicesShape.back() = k;
+    auto topKIndices = rewriter.create<VMLA::TopKPseudoOp>(
+        op.getLoc(), RankedTensorType::get(indicesShape, rewriter.getI32Type()),
+        op.getOperand(sortKey->operandIndex),
+        rewriter.getI32IntegerAttr(static_cast<int32_t>(sortKey->order)));
+
+    for (auto sliceOp : sliceOps) {
+      auto gathered = rewriter.create<mhlo::TorchIndexSelectOp>(
+          sliceOp.getLoc(), sliceOp.getType(),
+          op.getOperand(sliceOp.operand().cast<OpResult>().getResultNumber()),
+          topKIndices,
+          /**dim=*/rank - 1,
+          /**batch_dims=*/rank - 1);
+      rewriter.replaceOp(sliceOp, {gathered});
+    }
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 class LowerFftOp : public OpRewritePattern<mhlo::FftOp> {
  public:
   using OpRewritePattern::OpRewritePattern;
   LogicalResult matchAndRewrite(mhlo::FftOp op,
                                 PatternRewriter &rewriter) const override {
+    // Only 1-D complex-to-complex transforms over the innermost dimension are
+    // supported by the runtime.
     auto tensor_type = op.operand().getType().cast<RankedTensorType>();
+    if (op.fft_length().getNumElements() != 1 || tensor_type.getRank() < 1 ||
+        (*op.fft_length().begin()).getSExtValue() !=
+            tensor_type.getShape().back()) {
+      return rewriter.notifyMatchFailure(op, "unsupported fft_length");
+    }
     auto real = rewriter.create<mhlo::RealOp>(op.getLoc(), op.getOperand());
     auto imag = rewriter.create<mhlo::ImagOp>(op.getLoc(), op.getOperand());
-    auto results = rewriter.create<VMLA::FftPseudoOp>(
-        op.getLoc(), real.getType(), imag.getType(), real, imag);
+    Value real_out, imag_out;
+    if (op.fft_type() == "FFT") {
+      auto results = rewriter.create<VMLA::FftPseudoOp>(
+          op.getLoc(), real.getType(), imag.getType(), real, imag);
+      real_out = results.real_out();
+      imag_out = results.imag_out();
+    } else if (op.fft_type() == "IFFT") {
+      auto results = rewriter.create<VMLA::IfftPseudoOp>(
+          op.getLoc(), real.getType(), imag.getType(), real, imag);
+      real_out = results.real_out();
+      imag_out = results.imag_out();
+    } else {
+      return rewriter.notifyMatchFailure(op, "unsupported fft_type");
+    }
     auto complex_result = rewriter.create<mhlo::ComplexOp>(
-        op.getLoc(), tensor_type, results.real_out(), results.imag_out());
+        op.getLoc(), tensor_type, real_out, imag_out);
     rewriter.replaceOp(op, {complex_result});
     return success();
   }
@@ -421,6 +558,7 @@ class PreConversionLoweringPass
     patterns.insert<LowerBroadcastOp>(context);
     target.addIllegalOp<mhlo::SortOp>();
     patterns.insert<LowerSortOp>(context);
+    patterns.insert<LowerSortTopKOp>(context, /*benefit=*/2);
     target.addIllegalOp<mhlo::FftOp>();
     patterns.insert<LowerFftOp>(context);
 
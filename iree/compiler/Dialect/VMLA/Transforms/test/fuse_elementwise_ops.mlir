@@ -0,0 +1,76 @@
+// RUN: iree-opt -split-input-file -iree-vmla-fuse-elementwise-ops %s | IreeFileCheck %s
+
+// CHECK-LABEL: @tanhAffine
+func @tanhAffine(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  %c16 = constant 16 : index
+  %cst0 = vmla.constant dense<2.0> : tensor<4xf32> -> !vmla.buffer
+  %cst1 = vmla.constant dense<0.5> : tensor<4xf32> -> !vmla.buffer
+  // CHECK-NOT: vmla.constant
+  // CHECK-NOT: vmla.buffer.alloc
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.mul %arg0, %cst0, out %0 : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.add %0, %cst1, out %1 : f32
+  // CHECK: vmla.fused.elementwise(%arg0), out %arg1 {program = dense<[1, 5, 0, 1073741824, 0, 0, 3, 0, 1, 0, 0, 1056964608, 0, 0, 1, 2, 3, 0, 13, 4, 0, 0]> : tensor<22xi32>} : f32
+  // CHECK-NOT: vmla.tanh
+  vmla.tanh %1, out %arg1 : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @multipleInputs
+func @multipleInputs(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer, %arg2 : !vmla.buffer, %arg3 : !vmla.buffer) {
+  %c16 = constant 16 : index
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.mul %arg0, %arg1, out %0 : f32
+  %1 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  vmla.exp %arg2, out %1 : f32
+  // CHECK: vmla.fused.elementwise(%arg0, %arg1, %arg2), out %arg3 {program = dense<[3, 3, 3, 0, 1, 0, 9, 2, 0, 0, 2, 3, 4, 0]> : tensor<14xi32>} : f32
+  vmla.sub %0, %1, out %arg3 : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @sharedIntermediate
+func @sharedIntermediate(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer, %arg2 : !vmla.buffer) {
+  %c16 = constant 16 : index
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  // CHECK: vmla.exp %arg0, out %0 : f32
+  vmla.exp %arg0, out %0 : f32
+  // CHECK-NEXT: vmla.neg %0, out %arg1 : f32
+  vmla.neg %0, out %arg1 : f32
+  // CHECK-NEXT: vmla.abs %0, out %arg2 : f32
+  vmla.abs %0, out %arg2 : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @interveningWrite
+func @interveningWrite(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer, %arg2 : !vmla.buffer) {
+  %c0 = constant 0 : index
+  %c16 = constant 16 : index
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  // CHECK: vmla.exp %arg0, out %0 : f32
+  vmla.exp %arg0, out %0 : f32
+  // CHECK-NEXT: vmla.buffer.copy
+  vmla.buffer.copy %arg2[%c0], out %arg0[%c0], byte_length = %c16
+  // CHECK-NEXT: vmla.neg %0, out %arg1 : f32
+  vmla.neg %0, out %arg1 : f32
+  return
+}
+
+// -----
+
+// CHECK-LABEL: @integerOps
+func @integerOps(%arg0 : !vmla.buffer, %arg1 : !vmla.buffer) {
+  %c16 = constant 16 : index
+  %0 = vmla.buffer.alloc byte_length = %c16 : !vmla.buffer
+  // CHECK: vmla.add %arg0, %arg0, out %0 : i32
+  vmla.add %arg0, %arg0, out %0 : i32
+  // CHECK-NEXT: vmla.mul %0, %0, out %arg1 : i32
+  vmla.mul %0, %0, out %arg1 : i32
+  return
+}
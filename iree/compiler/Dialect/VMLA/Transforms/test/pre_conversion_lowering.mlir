@@ -48,6 +48,57 @@ func @f(%arg0 : tensor<4x4xf32>) -> tensor<4x4xf32> attributes { sym_visibility
 
 // -----
 
+// CHECK-LABEL: func @f
+func @f(%arg0 : tensor<4x8xf32>, %arg1 : tensor<4x8xi32>) -> (tensor<4x2xf32>, tensor<4x2xi32>) attributes { sym_visibility = "private" } {
+  // CHECK-DAG: [[TOPK:%.+]] = vmla.topk.pseudo %arg0, "Descending" : (tensor<4x8xf32>) -> tensor<4x2xi32>
+  // CHECK-DAG: [[VALUES:%.+]] = "mhlo.torch_index_select"(%arg0, [[TOPK]]) {batch_dims = 1 : i64, dim = 1 : i64} : (tensor<4x8xf32>, tensor<4x2xi32>) -> tensor<4x2xf32>
+  // CHECK-DAG: [[INDICES:%.+]] = "mhlo.torch_index_select"(%arg1, [[TOPK]]) {batch_dims = 1 : i64, dim = 1 : i64} : (tensor<4x8xi32>, tensor<4x2xi32>) -> tensor<4x2xi32>
+  // CHECK-NOT: mhlo.sort
+  %sort:2 = "mhlo.sort"(%arg0, %arg1) ( {
+  ^bb0(%arg2: tensor<f32>, %arg3: tensor<f32>, %arg4: tensor<i32>, %arg5: tensor<i32>):  // no predecessors
+    %compare = "mhlo.compare"(%arg2, %arg3) {comparison_direction = "GT"} : (tensor<f32>, tensor<f32>) -> tensor<i1>
+    "mhlo.return"(%compare) : (tensor<i1>) -> ()
+  }) {dimension = 1 : i64, is_stable = true} : (tensor<4x8xf32>, tensor<4x8xi32>) -> (tensor<4x8xf32>, tensor<4x8xi32>)
+  %values = "mhlo.slice"(%sort#0) {limit_indices = dense<[4, 2]> : tensor<2xi64>, start_indices = dense<0> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<4x8xf32>) -> tensor<4x2xf32>
+  %indices = "mhlo.slice"(%sort#1) {limit_indices = dense<[4, 2]> : tensor<2xi64>, start_indices = dense<0> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} : (tensor<4x8xi32>) -> tensor<4x2xi32>
+  // CHECK: return [[VALUES]], [[INDICES]]
+  return %values, %indices : tensor<4x2xf32>, tensor<4x2xi32>
+}
+
+// -----
+
+// CHECK-LABEL: func @f
+func @f(%arg0 : tensor<8xi32>) -> tensor<3xi32> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: [[TOPK:%.+]] = vmla.topk.pseudo %arg0, "Ascending" : (tensor<8xi32>) -> tensor<3xi32>
+  // CHECK-DAG: [[VALUES:%.+]] = "mhlo.torch_index_select"(%arg0, [[TOPK]]) {batch_dims = 0 : i64, dim = 0 : i64}
+  %sort = "mhlo.sort"(%arg0) ( {
+  ^bb0(%arg1: tensor<i32>, %arg2: tensor<i32>):  // no predecessors
+    %compare = "mhlo.compare"(%arg1, %arg2) {comparison_direction = "LT"} : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    "mhlo.return"(%compare) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = true} : (tensor<8xi32>) -> tensor<8xi32>
+  %slice = "mhlo.slice"(%sort) {limit_indices = dense<3> : tensor<1xi64>, start_indices = dense<0> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8xi32>) -> tensor<3xi32>
+  // CHECK: return [[VALUES]]
+  return %slice : tensor<3xi32>
+}
+
+// -----
+
+// Non-strict comparators are not lowered to top-k.
+// CHECK-LABEL: func @f
+func @f(%arg0 : tensor<8xi32>) -> tensor<3xi32> attributes { sym_visibility = "private" } {
+  // CHECK-NOT: vmla.topk.pseudo
+  // CHECK: vmla.sort.pseudo %arg0
+  %sort = "mhlo.sort"(%arg0) ( {
+  ^bb0(%arg1: tensor<i32>, %arg2: tensor<i32>):  // no predecessors
+    %compare = "mhlo.compare"(%arg1, %arg2) {comparison_direction = "LE"} : (tensor<i32>, tensor<i32>) -> tensor<i1>
+    "mhlo.return"(%compare) : (tensor<i1>) -> ()
+  }) {dimension = 0 : i64, is_stable = true} : (tensor<8xi32>) -> tensor<8xi32>
+  %slice = "mhlo.slice"(%sort) {limit_indices = dense<3> : tensor<1xi64>, start_indices = dense<0> : tensor<1xi64>, strides = dense<1> : tensor<1xi64>} : (tensor<8xi32>) -> tensor<3xi32>
+  return %slice : tensor<3xi32>
+}
+
+// -----
+
 // CHECK-LABEL: func @f
 func @f(%arg0: tensor<3xf32>) -> tensor<4x3xf32> {
   // CHECK: "shapex.ranked_broadcast_in_dim"(%arg0, %rs4_3)
@@ -78,6 +129,18 @@ func @f(%arg0: tensor<8xcomplex<f32>>) -> tensor<8xcomplex<f32>> attributes { sy
 
 // -----
 
+// CHECK-LABEL: func @f
+func @f(%arg0: tensor<2x8xcomplex<f32>>) -> tensor<2x8xcomplex<f32>> attributes { sym_visibility = "private" } {
+  // CHECK-DAG: [[REAL:%.+]] = "mhlo.real"(%arg0)
+  // CHECK-DAG: [[IMAG:%.+]] = "mhlo.imag"(%arg0)
+  // CHECK-DAG: [[REAL_OUT:%.+]], [[IMAG_OUT:%.+]] = vmla.ifft.pseudo [[REAL]], [[IMAG]]
+  // CHECK: "mhlo.complex"([[REAL_OUT]], [[IMAG_OUT]])
+  %0 = "mhlo.fft"(%arg0) {fft_length = dense<8> : tensor<1xi64>, fft_type = "IFFT"} : (tensor<2x8xcomplex<f32>>) -> tensor<2x8xcomplex<f32>>
+  return %0 : tensor<2x8xcomplex<f32>>
+}
+
+// -----
+
 // CHECK-LABEL: func @f
 func @f(%arg0: tensor<3xf32>, %arg1: tensor<3xf32>) -> tensor<3xf32> {
   // CHECK-NOT: "mhlo.complex"
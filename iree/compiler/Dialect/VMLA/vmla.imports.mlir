@@ -347,12 +347,35 @@ vm.import @sort.f32(
   %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
   %dst : !vm.ref<!vmla.buffer>)
 
+vm.import @topk.i8(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %order : i32)
+vm.import @topk.i16(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %order : i32)
+vm.import @topk.i32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %order : i32)
+vm.import @topk.f32(
+  %src : !vm.ref<!vmla.buffer>, %src_shape : i32 ...,
+  %dst : !vm.ref<!vmla.buffer>, %dst_shape : i32 ...,
+  %order : i32)
+
 vm.import @fft.f32(
   %real_src : !vm.ref<!vmla.buffer>, %real_src_shape : i32 ...,
   %imag_src : !vm.ref<!vmla.buffer>, %imag_src_shape : i32 ...,
   %real_dst : !vm.ref<!vmla.buffer>,
   %imag_dst : !vm.ref<!vmla.buffer>)
 
+vm.import @ifft.f32(
+  %real_src : !vm.ref<!vmla.buffer>, %real_src_shape : i32 ...,
+  %imag_src : !vm.ref<!vmla.buffer>, %imag_src_shape : i32 ...,
+  %real_dst : !vm.ref<!vmla.buffer>,
+  %imag_dst : !vm.ref<!vmla.buffer>)
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: conversion
 //===----------------------------------------------------------------------===//
@@ -370,6 +393,16 @@ vm.import @convert.f32.i8(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buf
 vm.import @convert.f32.i16(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 vm.import @convert.f32.i32(%src : !vm.ref<!vmla.buffer>, %dst : !vm.ref<!vmla.buffer>)
 
+//===----------------------------------------------------------------------===//
+// VMLA Ops: fused elementwise
+//===----------------------------------------------------------------------===//
+
+vm.import @fused.elementwise.f32(
+  %program : !vm.ref<!iree.byte_buffer>,
+  %srcs : !vm.ref<!vmla.buffer> ...,
+  %dst : !vm.ref<!vmla.buffer>
+)
+
 //===----------------------------------------------------------------------===//
 // VMLA Ops: Convolution
 //===----------------------------------------------------------------------===//
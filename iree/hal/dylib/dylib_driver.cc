@@ -19,6 +19,7 @@
 #include "iree/hal/device_info.h"
 #include "iree/hal/dylib/dylib_device.h"
 #include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/task/task_scheduling_model.h"
 
 namespace iree {
 namespace hal {
@@ -39,7 +40,10 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-DyLibDriver::DyLibDriver() : Driver("dylib") {}
+DyLibDriver::DyLibDriver() : DyLibDriver(Options{}) {}
+
+DyLibDriver::DyLibDriver(Options options)
+    : Driver("dylib"), options_(std::move(options)) {}
 
 DyLibDriver::~DyLibDriver() = default;
 
@@ -56,7 +60,14 @@ StatusOr<ref_ptr<Device>> DyLibDriver::CreateDefaultDevice() {
 
 StatusOr<ref_ptr<Device>> DyLibDriver::CreateDevice(DriverDeviceID device_id) {
   // Only one device, ignore device_id.
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  std::unique_ptr<host::SchedulingModel> scheduling_model;
+  if (options_.submission_worker_count > 0) {
+    scheduling_model = std::make_unique<host::TaskSchedulingModel>(
+        options_.submission_worker_count, options_.dispatch_worker_count);
+  } else {
+    scheduling_model = std::make_unique<host::SerialSchedulingModel>(
+        options_.dispatch_worker_count);
+  }
   return make_ref<DyLibDevice>(GetDefaultDeviceInfo(),
                                std::move(scheduling_model));
 }
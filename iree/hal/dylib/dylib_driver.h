@@ -23,7 +23,19 @@ namespace dylib {
 
 class DyLibDriver final : public Driver {
  public:
+  struct Options {
+    // Number of threads used to process the tiles of each dispatch in addition
+    // to the thread executing the command buffer. 0 processes tiles serially.
+    int dispatch_worker_count = 0;
+
+    // Number of threads used to execute independent submissions concurrently
+    // with the out-of-order task scheduler. 0 executes submissions in order on
+    // a single queue thread.
+    int submission_worker_count = 0;
+  };
+
   DyLibDriver();
+  explicit DyLibDriver(Options options);
   ~DyLibDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +43,9 @@ class DyLibDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  Options options_;
 };
 
 }  // namespace dylib
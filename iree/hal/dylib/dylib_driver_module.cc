@@ -14,17 +14,35 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
+#include "iree/hal/host/grid_executor.h"
 #include "iree/hal/dylib/dylib_driver.h"
 
+ABSL_FLAG(int, dylib_worker_count, -1,
+          "Number of worker threads used to process dispatch tiles. "
+          "-1 uses one worker per additional hardware thread and 0 processes "
+          "all tiles on the queue thread.");
+ABSL_FLAG(int, dylib_submission_worker_count, 0,
+          "Number of worker threads used to execute independent submissions "
+          "out of order. 0 executes submissions in order on a single queue "
+          "thread.");
+
 namespace iree {
 namespace hal {
 namespace dylib {
 
 static StatusOr<ref_ptr<Driver>> CreateDyLibDriver() {
-  return make_ref<DyLibDriver>();
+  DyLibDriver::Options options;
+  options.dispatch_worker_count = absl::GetFlag(FLAGS_dylib_worker_count);
+  if (options.dispatch_worker_count < 0) {
+    options.dispatch_worker_count = host::GridExecutor::GetDefaultWorkerCount();
+  }
+  options.submission_worker_count =
+      absl::GetFlag(FLAGS_dylib_submission_worker_count);
+  return make_ref<DyLibDriver>(options);
 }
 
 }  // namespace dylib
@@ -57,13 +57,54 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
     return InvalidArgumentErrorBuilder(IREE_LOC) << "No embedded library";
   }
 
+  // Load the library directly from the flatbuffer when the platform allows
+  // so that we don't pay for writing (and later deleting) a temp file per
+  // executable. Otherwise fall back to going through the filesystem. Debug
+  // databases are only attached on the fallback path as the platforms
+  // supporting in-memory loading read debug info from the library itself.
+  auto library_or = DynamicLibrary::LoadFromMemory(
+      "dylib_executable",
+      absl::MakeConstSpan(dylib_executable_def->library_embedded()->data(),
+                          dylib_executable_def->library_embedded()->size()));
+  if (library_or.ok()) {
+    executable_library_ = std::move(library_or).value();
+  } else if (IsUnimplemented(library_or.status()) ||
+             IsUnavailable(library_or.status())) {
+    IREE_RETURN_IF_ERROR(LoadLibraryFromTempFile(*dylib_executable_def));
+  } else {
+    return std::move(library_or).status();
+  }
+
+  const auto& entry_points = *dylib_executable_def->entry_points();
+  entry_functions_.resize(entry_points.size());
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+  entry_names_.resize(entry_points.size());
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+  for (int i = 0; i < entry_functions_.size(); ++i) {
+    void* symbol = executable_library_->GetSymbol(entry_points[i]->c_str());
+    if (!symbol) {
+      return NotFoundErrorBuilder(IREE_LOC)
+             << "Could not find symbol: " << entry_points[i];
+    }
+    entry_functions_[i] = symbol;
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+    entry_names_[i] = entry_points[i]->c_str();
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+  }
+
+  return OkStatus();
+}
+
+Status DyLibExecutable::LoadLibraryFromTempFile(
+    const DyLibExecutableDef& dylib_executable_def) {
+  IREE_TRACE_SCOPE0("DyLibExecutable::LoadLibraryFromTempFile");
+
   // Write the embedded library out to a temp file, since all of the dynamic
-  // library APIs work with files. We could instead use in-memory files on
-  // platforms where that is convenient.
+  // library APIs work with files.
   std::string base_name = "dylib_executable";
   IREE_ASSIGN_OR_RETURN(auto library_temp_path,
                         file_io::GetTempFile(base_name));
-  temp_file_paths_.push_back(library_temp_path);
 
 // Add platform-specific file extensions so opinionated dynamic library
 // loaders are more likely to find the file:
@@ -72,27 +113,28 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
 #else
   library_temp_path += ".so";
 #endif
+  temp_file_paths_.push_back(library_temp_path);
 
   absl::string_view embedded_library_data(
       reinterpret_cast<const char*>(
-          dylib_executable_def->library_embedded()->data()),
-      dylib_executable_def->library_embedded()->size());
+          dylib_executable_def.library_embedded()->data()),
+      dylib_executable_def.library_embedded()->size());
   IREE_RETURN_IF_ERROR(
       file_io::SetFileContents(library_temp_path, embedded_library_data));
 
   IREE_ASSIGN_OR_RETURN(executable_library_,
                         DynamicLibrary::Load(library_temp_path.c_str()));
 
-  if (dylib_executable_def->debug_database_filename() &&
-      dylib_executable_def->debug_database_embedded()) {
+  if (dylib_executable_def.debug_database_filename() &&
+      dylib_executable_def.debug_database_embedded()) {
     IREE_TRACE_SCOPE0("DyLibExecutable::AttachDebugDatabase");
     absl::string_view debug_database_filename(
-        dylib_executable_def->debug_database_filename()->data(),
-        dylib_executable_def->debug_database_filename()->size());
+        dylib_executable_def.debug_database_filename()->data(),
+        dylib_executable_def.debug_database_filename()->size());
     absl::string_view debug_database_data(
         reinterpret_cast<const char*>(
-            dylib_executable_def->debug_database_embedded()->data()),
-        dylib_executable_def->debug_database_embedded()->size());
+            dylib_executable_def.debug_database_embedded()->data()),
+        dylib_executable_def.debug_database_embedded()->size());
     auto debug_database_path = file_path::JoinPaths(
         file_path::DirectoryName(library_temp_path), debug_database_filename);
     temp_file_paths_.push_back(debug_database_path);
@@ -101,24 +143,6 @@ Status DyLibExecutable::Initialize(ExecutableSpec spec) {
     executable_library_->AttachDebugDatabase(debug_database_path.c_str());
   }
 
-  const auto& entry_points = *dylib_executable_def->entry_points();
-  entry_functions_.resize(entry_points.size());
-#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
-  entry_names_.resize(entry_points.size());
-#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
-  for (int i = 0; i < entry_functions_.size(); ++i) {
-    void* symbol = executable_library_->GetSymbol(entry_points[i]->c_str());
-    if (!symbol) {
-      return NotFoundErrorBuilder(IREE_LOC)
-             << "Could not find symbol: " << entry_points[i];
-    }
-    entry_functions_[i] = symbol;
-
-#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
-    entry_names_[i] = entry_points[i]->c_str();
-#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
-  }
-
   return OkStatus();
 }
 
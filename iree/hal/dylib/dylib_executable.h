@@ -26,6 +26,7 @@
 #include "iree/hal/host/host_executable.h"
 
 namespace iree {
+struct DyLibExecutableDef;
 namespace hal {
 namespace dylib {
 
@@ -48,6 +49,12 @@ class DyLibExecutable final : public HostExecutable {
  private:
   Status Initialize(ExecutableSpec spec);
 
+  // Writes the embedded library (and debug database, if present) to temp files
+  // and loads the library from there. Used when in-memory loading is not
+  // available on the platform.
+  Status LoadLibraryFromTempFile(
+      const DyLibExecutableDef& dylib_executable_def);
+
   absl::InlinedVector<std::string, 4> temp_file_paths_;
   std::unique_ptr<DynamicLibrary> executable_library_;
   std::vector<void*> entry_functions_;
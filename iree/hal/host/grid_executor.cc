@@ -0,0 +1,243 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/grid_executor.h"
+
+#include <algorithm>
+#include <new>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+namespace {
+
+// Target number of chunks per lane. More chunks improve balancing when tiles
+// have uneven cost at the expense of more contention on the lane cursors.
+constexpr uint64_t kChunksPerLane = 4;
+
+// Size of a cache line on the targets we run on.
+constexpr uintptr_t kCacheLineSize = 64;
+
+// A contiguous range of flattened tile indices owned by a single lane.
+// Both the owner and thieves claim chunks by bumping |next| so ownership only
+// decides which range a lane starts on. Each lane occupies its own cache line
+// so that cursors of adjacent lanes never share one.
+struct alignas(kCacheLineSize) Lane {
+  std::atomic<uint64_t> next{0};
+  uint64_t end = 0;
+};
+static_assert(sizeof(Lane) == kCacheLineSize, "lanes must fill a cache line");
+
+}  // namespace
+
+struct GridExecutor::Grid {
+  HostExecutable* executable = nullptr;
+  HostExecutable::DispatchState* dispatch_state = nullptr;
+  std::array<uint32_t, 3> workgroup_count;
+  uint64_t chunk_size = 1;
+
+  // |lanes| points into |lane_storage| at the first cache line boundary as
+  // operator new does not honor the alignment of over-aligned types in C++14.
+  int lane_count = 0;
+  std::unique_ptr<uint8_t[]> lane_storage;
+  Lane* lanes = nullptr;
+
+  // Set when any tile fails so that other lanes stop claiming chunks.
+  std::atomic<bool> failed{false};
+  absl::Mutex status_mutex;
+  Status status ABSL_GUARDED_BY(status_mutex);
+};
+
+// static
+int GridExecutor::GetDefaultWorkerCount() {
+  int hardware_thread_count =
+      static_cast<int>(std::thread::hardware_concurrency());
+  return std::max(0, hardware_thread_count - 1);
+}
+
+GridExecutor::GridExecutor(int worker_count) {
+  IREE_TRACE_SCOPE0("GridExecutor::ctor");
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    // Lane 0 is reserved for the thread calling Execute.
+    workers_.emplace_back([this, i]() { ThreadMain(i + 1); });
+  }
+}
+
+GridExecutor::~GridExecutor() {
+  IREE_TRACE_SCOPE0("GridExecutor::dtor");
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void GridExecutor::ThreadMain(int lane_index) {
+  IREE_TRACE_SET_THREAD_NAME("grid-worker");
+
+  uint64_t seen_epoch = 0;
+  while (true) {
+    Grid* grid = nullptr;
+    {
+      absl::MutexLock lock(&mutex_);
+      struct WakeState {
+        GridExecutor* executor;
+        uint64_t seen_epoch;
+      } wake_state = {this, seen_epoch};
+      mutex_.Await(absl::Condition(
+          +[](WakeState* state) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+            return state->executor->shutdown_ ||
+                   state->executor->grid_epoch_ != state->seen_epoch;
+          },
+          &wake_state));
+      if (shutdown_) return;
+      seen_epoch = grid_epoch_;
+      grid = grid_;
+    }
+
+    ProcessLane(grid, lane_index);
+
+    absl::MutexLock lock(&mutex_);
+    --active_worker_count_;
+  }
+}
+
+// static
+void GridExecutor::ProcessLane(Grid* grid, int lane_index) {
+  const uint32_t count_x = grid->workgroup_count[0];
+  const uint32_t count_y = grid->workgroup_count[1];
+  for (int i = 0; i < grid->lane_count; ++i) {
+    // Start with our own lane and then walk the others to steal their work.
+    auto& lane = grid->lanes[(lane_index + i) % grid->lane_count];
+    while (!grid->failed.load(std::memory_order_relaxed)) {
+      uint64_t begin =
+          lane.next.fetch_add(grid->chunk_size, std::memory_order_relaxed);
+      if (begin >= lane.end) break;
+      uint64_t end = std::min(begin + grid->chunk_size, lane.end);
+
+      // Only the first tile of the chunk needs the full index decomposition.
+      uint32_t x = static_cast<uint32_t>(begin % count_x);
+      uint32_t y = static_cast<uint32_t>((begin / count_x) % count_y);
+      uint32_t z = static_cast<uint32_t>(begin / count_x / count_y);
+      for (uint64_t tile = begin; tile < end; ++tile) {
+        auto status =
+            grid->executable->DispatchTile(grid->dispatch_state, {x, y, z});
+        if (!status.ok()) {
+          absl::MutexLock lock(&grid->status_mutex);
+          if (grid->status.ok()) grid->status = std::move(status);
+          grid->failed.store(true, std::memory_order_relaxed);
+          return;
+        }
+        if (++x == count_x) {
+          x = 0;
+          if (++y == count_y) {
+            y = 0;
+            ++z;
+          }
+        }
+      }
+    }
+  }
+}
+
+// static
+Status GridExecutor::ExecuteInline(
+    HostExecutable* executable, HostExecutable::DispatchState* dispatch_state,
+    std::array<uint32_t, 3> workgroup_count) {
+  for (uint32_t z = 0; z < workgroup_count[2]; ++z) {
+    for (uint32_t y = 0; y < workgroup_count[1]; ++y) {
+      for (uint32_t x = 0; x < workgroup_count[0]; ++x) {
+        IREE_RETURN_IF_ERROR(
+            executable->DispatchTile(dispatch_state, {x, y, z}));
+      }
+    }
+  }
+  return OkStatus();
+}
+
+Status GridExecutor::Execute(HostExecutable* executable,
+                             HostExecutable::DispatchState* dispatch_state,
+                             std::array<uint32_t, 3> workgroup_count) {
+  IREE_TRACE_SCOPE0("GridExecutor::Execute");
+
+  uint64_t tile_count = static_cast<uint64_t>(workgroup_count[0]) *
+                        workgroup_count[1] * workgroup_count[2];
+  if (workers_.empty() || tile_count < 2 ||
+      !executable->supports_concurrent_dispatch()) {
+    return ExecuteInline(executable, dispatch_state, workgroup_count);
+  }
+
+  // If another thread is already distributing a grid we run ours inline
+  // instead of waiting for the workers to become available.
+  if (!execute_mutex_.TryLock()) {
+    return ExecuteInline(executable, dispatch_state, workgroup_count);
+  }
+
+  Grid grid;
+  grid.executable = executable;
+  grid.dispatch_state = dispatch_state;
+  grid.workgroup_count = workgroup_count;
+  grid.lane_count = static_cast<int>(
+      std::min<uint64_t>(workers_.size() + 1, tile_count));
+  grid.chunk_size = std::max<uint64_t>(
+      1, tile_count / (grid.lane_count * kChunksPerLane));
+  grid.lane_storage.reset(
+      new uint8_t[grid.lane_count * sizeof(Lane) + kCacheLineSize - 1]);
+  uintptr_t lane_address =
+      reinterpret_cast<uintptr_t>(grid.lane_storage.get());
+  lane_address = (lane_address + kCacheLineSize - 1) & ~(kCacheLineSize - 1);
+  grid.lanes = reinterpret_cast<Lane*>(lane_address);
+  uint64_t lane_begin = 0;
+  for (int i = 0; i < grid.lane_count; ++i) {
+    uint64_t lane_end = tile_count * (i + 1) / grid.lane_count;
+    new (&grid.lanes[i]) Lane();
+    grid.lanes[i].next.store(lane_begin, std::memory_order_relaxed);
+    grid.lanes[i].end = lane_end;
+    lane_begin = lane_end;
+  }
+
+  {
+    absl::MutexLock lock(&mutex_);
+    grid_ = &grid;
+    ++grid_epoch_;
+    active_worker_count_ = static_cast<int>(workers_.size());
+  }
+
+  // The calling thread participates as lane 0.
+  ProcessLane(&grid, 0);
+
+  // Join with all workers. Workers with no lane of their own (small grids)
+  // will immediately find everything claimed and return.
+  {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        +[](int* active_worker_count) { return *active_worker_count == 0; },
+        &active_worker_count_));
+    grid_ = nullptr;
+  }
+  execute_mutex_.Unlock();
+
+  absl::MutexLock lock(&grid.status_mutex);
+  return std::move(grid.status);
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,105 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_GRID_EXECUTOR_H_
+#define IREE_HAL_HOST_GRID_EXECUTOR_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+#include "iree/hal/host/host_executable.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Executes HostExecutable tile grids across a pool of worker threads.
+//
+// The XYZ grid is flattened and split into one contiguous range per lane (one
+// lane per worker plus one for the calling thread). Lanes claim fixed-size
+// chunks of tiles from the front of their own range and when exhausted steal
+// chunks from the ranges of other lanes. Execute returns only after all tiles
+// have completed (or the first failure has been observed), so the grid acts as
+// a join point for the dispatch just as with serial execution.
+//
+// Executables that report !supports_concurrent_dispatch() and grids too small
+// to benefit are processed inline on the calling thread.
+//
+// Thread-safe. Only one grid is distributed across the workers at a time; if
+// the workers are busy with another grid the caller processes its grid inline.
+class GridExecutor final {
+ public:
+  // Returns a worker count suitable for the current machine: one worker per
+  // hardware thread other than the calling thread.
+  static int GetDefaultWorkerCount();
+
+  // Creates an executor with |worker_count| threads. A |worker_count| of 0
+  // will process all tiles on the calling thread.
+  explicit GridExecutor(int worker_count);
+  ~GridExecutor();
+
+  GridExecutor(const GridExecutor&) = delete;
+  GridExecutor& operator=(const GridExecutor&) = delete;
+
+  // Total number of worker threads (excluding any calling thread).
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Processes all tiles of |workgroup_count| with |executable| and blocks
+  // until they have completed. Returns the first error reported by any tile.
+  Status Execute(HostExecutable* executable,
+                 HostExecutable::DispatchState* dispatch_state,
+                 std::array<uint32_t, 3> workgroup_count);
+
+ private:
+  struct Grid;
+
+  // Processes all tiles on the calling thread in XYZ order.
+  static Status ExecuteInline(HostExecutable* executable,
+                              HostExecutable::DispatchState* dispatch_state,
+                              std::array<uint32_t, 3> workgroup_count);
+
+  // Processes chunks from |lane_index| and then steals from the other lanes
+  // until the grid has been fully claimed.
+  static void ProcessLane(Grid* grid, int lane_index);
+
+  // Thread entry point for the worker with the given |lane_index|.
+  void ThreadMain(int lane_index);
+
+  std::vector<std::thread> workers_;
+
+  // Held by the thread distributing a grid across the workers.
+  absl::Mutex execute_mutex_;
+
+  absl::Mutex mutex_;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  // Incremented each time a new grid is published to the workers.
+  uint64_t grid_epoch_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Grid currently being processed, if any.
+  Grid* grid_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  // Number of workers that have not yet finished with |grid_|.
+  int active_worker_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_GRID_EXECUTOR_H_
@@ -0,0 +1,157 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/grid_executor.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "iree/base/status.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Executable that counts the number of times each tile has been dispatched.
+class CountingExecutable final : public HostExecutable {
+ public:
+  struct CountingState : public DispatchState {
+    explicit CountingState(std::array<uint32_t, 3> workgroup_count)
+        : workgroup_count(workgroup_count),
+          tile_counts(workgroup_count[0] * workgroup_count[1] *
+                      workgroup_count[2]) {}
+    std::array<uint32_t, 3> workgroup_count;
+    std::vector<std::atomic<int>> tile_counts;
+  };
+
+  explicit CountingExecutable(bool supports_concurrent_dispatch = true)
+      : supports_concurrent_dispatch_(supports_concurrent_dispatch) {}
+
+  bool supports_debugging() const override { return false; }
+  bool supports_concurrent_dispatch() const override {
+    return supports_concurrent_dispatch_;
+  }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    return ref_ptr<DispatchState>(new CountingState(params.workgroup_count));
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    auto* counting_state = static_cast<CountingState*>(state);
+    const auto& count = counting_state->workgroup_count;
+    if (workgroup_xyz[0] >= count[0] || workgroup_xyz[1] >= count[1] ||
+        workgroup_xyz[2] >= count[2]) {
+      return OutOfRangeErrorBuilder(IREE_LOC) << "Tile out of range";
+    }
+    if (workgroup_xyz == fail_xyz_) {
+      return InternalErrorBuilder(IREE_LOC) << "Requested failure";
+    }
+    int index = workgroup_xyz[0] + workgroup_xyz[1] * count[0] +
+                workgroup_xyz[2] * count[0] * count[1];
+    ++counting_state->tile_counts[index];
+    return OkStatus();
+  }
+
+  void FailTile(std::array<uint32_t, 3> workgroup_xyz) {
+    fail_xyz_ = workgroup_xyz;
+  }
+
+ private:
+  bool supports_concurrent_dispatch_;
+  std::array<uint32_t, 3> fail_xyz_ = {UINT32_MAX, UINT32_MAX, UINT32_MAX};
+};
+
+// Executes a grid and verifies that every tile was dispatched exactly once.
+void ExecuteAndVerify(GridExecutor* grid_executor,
+                      CountingExecutable* executable,
+                      std::array<uint32_t, 3> workgroup_count) {
+  HostExecutable::DispatchParams params;
+  params.workgroup_count = workgroup_count;
+  IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                            executable->PrepareDispatch(params));
+  IREE_ASSERT_OK(grid_executor->Execute(executable, dispatch_state.get(),
+                                        workgroup_count));
+  auto* counting_state =
+      static_cast<CountingExecutable::CountingState*>(dispatch_state.get());
+  for (size_t i = 0; i < counting_state->tile_counts.size(); ++i) {
+    EXPECT_EQ(1, counting_state->tile_counts[i].load()) << "tile " << i;
+  }
+}
+
+TEST(GridExecutorTest, NoWorkers) {
+  GridExecutor grid_executor(0);
+  EXPECT_EQ(0, grid_executor.worker_count());
+  CountingExecutable executable;
+  ExecuteAndVerify(&grid_executor, &executable, {7, 5, 3});
+}
+
+TEST(GridExecutorTest, EmptyGrid) {
+  GridExecutor grid_executor(4);
+  CountingExecutable executable;
+  ExecuteAndVerify(&grid_executor, &executable, {0, 5, 3});
+  ExecuteAndVerify(&grid_executor, &executable, {1, 1, 1});
+}
+
+// Tests grids with fewer tiles than there are lanes.
+TEST(GridExecutorTest, SmallGrid) {
+  GridExecutor grid_executor(8);
+  CountingExecutable executable;
+  ExecuteAndVerify(&grid_executor, &executable, {3, 1, 1});
+}
+
+TEST(GridExecutorTest, LargeGrid) {
+  GridExecutor grid_executor(4);
+  CountingExecutable executable;
+  ExecuteAndVerify(&grid_executor, &executable, {33, 17, 9});
+}
+
+// Tests that the executor can be reused across many dispatches.
+TEST(GridExecutorTest, RepeatedGrids) {
+  GridExecutor grid_executor(3);
+  CountingExecutable executable;
+  for (uint32_t i = 1; i < 64; ++i) {
+    ExecuteAndVerify(&grid_executor, &executable, {i, 2, 1});
+  }
+}
+
+TEST(GridExecutorTest, SerialExecutable) {
+  GridExecutor grid_executor(4);
+  CountingExecutable executable(/*supports_concurrent_dispatch=*/false);
+  ExecuteAndVerify(&grid_executor, &executable, {16, 16, 1});
+}
+
+// Tests that the first tile failure is returned to the caller.
+TEST(GridExecutorTest, TileFailure) {
+  GridExecutor grid_executor(4);
+  CountingExecutable executable;
+  executable.FailTile({5, 3, 0});
+  HostExecutable::DispatchParams params;
+  params.workgroup_count = {16, 16, 1};
+  IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                            executable.PrepareDispatch(params));
+  EXPECT_TRUE(IsInternal(grid_executor.Execute(
+      &executable, dispatch_state.get(), params.workgroup_count)));
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -63,6 +63,11 @@ class HostExecutable : public Executable {
   virtual StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
       const DispatchParams& params) = 0;
 
+  // Returns true if DispatchTile may be called concurrently from multiple
+  // threads for the same dispatch state. Executables that share mutable state
+  // across tiles can return false to have their grids processed serially.
+  virtual bool supports_concurrent_dispatch() const { return true; }
+
   // Processes a single tile within the grid.
   // |workgroup_xyz| is the tile coordinates in the grid as defined during
   // preparation. May be called from any thread.
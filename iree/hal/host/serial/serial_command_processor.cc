@@ -24,8 +24,9 @@ namespace hal {
 namespace host {
 
 SerialCommandProcessor::SerialCommandProcessor(
-    CommandCategoryBitfield command_categories)
-    : CommandBuffer(CommandBufferMode::kOneShot, command_categories) {}
+    CommandCategoryBitfield command_categories, GridExecutor* grid_executor)
+    : CommandBuffer(CommandBufferMode::kOneShot, command_categories),
+      grid_executor_(grid_executor) {}
 
 SerialCommandProcessor::~SerialCommandProcessor() = default;
 
@@ -229,6 +230,10 @@ Status SerialCommandProcessor::DispatchGrid(
   auto* host_executable = reinterpret_cast<HostExecutable*>(executable);
   IREE_ASSIGN_OR_RETURN(auto dispatch_state,
                         host_executable->PrepareDispatch(params));
+  if (grid_executor_) {
+    return grid_executor_->Execute(host_executable, dispatch_state.get(),
+                                   params.workgroup_count);
+  }
   for (uint32_t z = 0; z < params.workgroup_count[2]; ++z) {
     for (uint32_t y = 0; y < params.workgroup_count[1]; ++y) {
       for (uint32_t x = 0; x < params.workgroup_count[0]; ++x) {
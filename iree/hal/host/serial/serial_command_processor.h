@@ -17,6 +17,7 @@
 
 #include "absl/container/inlined_vector.h"
 #include "iree/hal/command_buffer.h"
+#include "iree/hal/host/grid_executor.h"
 #include "iree/hal/host/host_executable.h"
 
 namespace iree {
@@ -28,12 +29,15 @@ namespace host {
 // This assumes that all buffers are host-visible (if not local) and that all
 // buffers can be mapped for access.
 //
-// Uses HostExecutable to perform tiled dispatch processing.
+// Uses HostExecutable to perform tiled dispatch processing. When provided a
+// GridExecutor the tiles of each dispatch are distributed across its workers;
+// otherwise they are processed in order on the calling thread.
 //
 // Thread-compatible (as with CommandBuffer itself).
 class SerialCommandProcessor final : public CommandBuffer {
  public:
-  explicit SerialCommandProcessor(CommandCategoryBitfield command_categories);
+  SerialCommandProcessor(CommandCategoryBitfield command_categories,
+                         GridExecutor* grid_executor = nullptr);
   ~SerialCommandProcessor() override;
 
   bool is_recording() const override { return is_recording_; }
@@ -98,6 +102,9 @@ class SerialCommandProcessor final : public CommandBuffer {
 
   bool is_recording_ = false;
 
+  // Optional executor used to process dispatch grids. Unowned.
+  GridExecutor* grid_executor_ = nullptr;
+
   PushConstantBlock push_constants_;
   absl::InlinedVector<absl::InlinedVector<DescriptorSet::Binding, 8>, 2>
       descriptor_sets_;
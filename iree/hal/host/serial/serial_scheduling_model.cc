@@ -39,8 +39,10 @@ namespace {
 class UnsynchronizedCommandQueue final : public CommandQueue {
  public:
   UnsynchronizedCommandQueue(std::string name,
-                             CommandCategoryBitfield supported_categories)
-      : CommandQueue(std::move(name), supported_categories) {}
+                             CommandCategoryBitfield supported_categories,
+                             GridExecutor* grid_executor)
+      : CommandQueue(std::move(name), supported_categories),
+        grid_executor_(grid_executor) {}
   ~UnsynchronizedCommandQueue() override = default;
 
   Status Submit(absl::Span<const SubmissionBatch> batches) override {
@@ -73,19 +75,24 @@ class UnsynchronizedCommandQueue final : public CommandQueue {
     for (auto* command_buffer : command_buffers) {
       auto* inproc_command_buffer =
           static_cast<InProcCommandBuffer*>(command_buffer->impl());
-      SerialCommandProcessor command_processor(supported_categories());
+      SerialCommandProcessor command_processor(supported_categories(),
+                                               grid_executor_);
       IREE_RETURN_IF_ERROR(inproc_command_buffer->Process(&command_processor));
     }
     return OkStatus();
   }
+
+  GridExecutor* grid_executor_;
 };
 
 }  // namespace
 
-SerialSchedulingModel::SerialSchedulingModel() {
+SerialSchedulingModel::SerialSchedulingModel(int dispatch_worker_count)
+    : grid_executor_(absl::make_unique<GridExecutor>(dispatch_worker_count)) {
   // We currently only expose a single command queue.
   auto command_queue = absl::make_unique<UnsynchronizedCommandQueue>(
-      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch);
+      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+      grid_executor_.get());
 
   // Wrap in the simple async command queue.
   auto async_command_queue =
@@ -17,6 +17,7 @@
 
 #include "absl/container/inlined_vector.h"
 #include "iree/base/memory.h"
+#include "iree/hal/host/grid_executor.h"
 #include "iree/hal/host/scheduling_model.h"
 
 namespace iree {
@@ -28,9 +29,13 @@ namespace host {
 // core. This is a reference implementation that has no dependencies beyond
 // std::thread and allows us to quickly bring up new platforms and more easily
 // debug/profile as we won't have OS fibers/other weird constructs involved.
+//
+// Tiles within a single dispatch may optionally be distributed across
+// |dispatch_worker_count| worker threads; the dispatch still completes before
+// the next command in the buffer is processed.
 class SerialSchedulingModel final : public SchedulingModel {
  public:
-  SerialSchedulingModel();
+  explicit SerialSchedulingModel(int dispatch_worker_count = 0);
   ~SerialSchedulingModel() override;
 
   absl::Span<CommandQueue*> dispatch_queues() const override {
@@ -56,6 +61,7 @@ class SerialSchedulingModel final : public SchedulingModel {
   Status WaitIdle(Time deadline_ns) override;
 
  private:
+  std::unique_ptr<GridExecutor> grid_executor_;
   mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
 };
 
@@ -0,0 +1,277 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_command_queue.h"
+
+#include <atomic>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/serial/serial_command_processor.h"
+#include "iree/hal/host/task/task_semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// A submitted batch and its scheduling state.
+// Shared between the semaphore timepoints and the tasks executing the batch.
+struct TaskCommandQueue::BatchNode {
+  absl::InlinedVector<SemaphoreValue, 4> wait_semaphores;
+  absl::InlinedVector<CommandBuffer*, 4> command_buffers;
+  absl::InlinedVector<SemaphoreValue, 4> signal_semaphores;
+
+  // A timepoint registered on one of the wait semaphores.
+  struct WaitTimepoint {
+    TaskSemaphore* semaphore = nullptr;
+    // Token returned from EnqueueTimepoint; 0 until registered.
+    uint64_t token = 0;
+    // Set once the timepoint callback has been made.
+    bool resolved = false;
+  };
+
+  // Wait semaphores not yet resolved plus one held during submission so that
+  // timepoints resolving inline don't schedule the batch early.
+  std::atomic<int> pending_wait_count{0};
+
+  absl::Mutex status_mutex;
+  // The first failure from a wait semaphore.
+  Status status ABSL_GUARDED_BY(status_mutex);
+  // One timepoint per wait semaphore. Unresolved timepoints are cancelled if
+  // the queue is destroyed before they are reached.
+  absl::InlinedVector<WaitTimepoint, 4> wait_timepoints
+      ABSL_GUARDED_BY(status_mutex);
+};
+
+TaskCommandQueue::TaskCommandQueue(std::string name,
+                                   CommandCategoryBitfield supported_categories,
+                                   TaskPool* task_pool,
+                                   GridExecutor* grid_executor)
+    : CommandQueue(std::move(name), supported_categories),
+      task_pool_(task_pool),
+      grid_executor_(grid_executor) {}
+
+TaskCommandQueue::~TaskCommandQueue() {
+  IREE_TRACE_SCOPE0("TaskCommandQueue::dtor");
+  // Batches waiting on semaphores that may never be signaled would keep us
+  // waiting forever so we fail them instead.
+  CancelWaitingBatches();
+  // Pending batches reference the queue from their timepoints and tasks so we
+  // must let them all retire before going away.
+  WaitIdle(InfiniteFuture()).IgnoreError();
+}
+
+void TaskCommandQueue::CancelWaitingBatches() {
+  absl::InlinedVector<std::shared_ptr<BatchNode>, 4> waiting_batches;
+  {
+    absl::MutexLock lock(&mutex_);
+    for (auto& it : waiting_batches_) {
+      waiting_batches.push_back(it.second);
+    }
+  }
+  for (auto& batch : waiting_batches) {
+    absl::InlinedVector<std::pair<TaskSemaphore*, uint64_t>, 4> timepoints;
+    {
+      absl::MutexLock lock(&batch->status_mutex);
+      for (const auto& timepoint : batch->wait_timepoints) {
+        if (!timepoint.resolved && timepoint.token) {
+          timepoints.push_back({timepoint.semaphore, timepoint.token});
+        }
+      }
+    }
+    // Timepoints that could not be cancelled are having their callbacks made
+    // and resolve the wait themselves.
+    for (auto& timepoint : timepoints) {
+      if (timepoint.first->CancelTimepoint(timepoint.second)) {
+        OnWaitResolved(batch,
+                       CancelledErrorBuilder(IREE_LOC)
+                           << "Command queue destroyed with pending batches");
+      }
+    }
+  }
+}
+
+Status TaskCommandQueue::Submit(absl::Span<const SubmissionBatch> batches) {
+  IREE_TRACE_SCOPE0("TaskCommandQueue::Submit");
+
+  // Validate all batches up front so that we never submit a partial set.
+  for (const auto& batch : batches) {
+    for (const auto& wait_point : batch.wait_semaphores) {
+      if (!TaskSemaphore::Cast(wait_point.semaphore)) {
+        return InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Wait semaphores must be TaskSemaphores";
+      }
+    }
+  }
+
+  {
+    absl::MutexLock lock(&mutex_);
+    pending_batch_count_ += static_cast<int>(batches.size());
+  }
+
+  for (const auto& batch : batches) {
+    auto batch_node = std::make_shared<BatchNode>();
+    batch_node->wait_semaphores = {batch.wait_semaphores.begin(),
+                                   batch.wait_semaphores.end()};
+    batch_node->command_buffers = {batch.command_buffers.begin(),
+                                   batch.command_buffers.end()};
+    batch_node->signal_semaphores = {batch.signal_semaphores.begin(),
+                                     batch.signal_semaphores.end()};
+    batch_node->pending_wait_count =
+        static_cast<int>(batch_node->wait_semaphores.size()) + 1;
+    absl::InlinedVector<TaskSemaphore*, 4> semaphores;
+    for (const auto& wait_point : batch_node->wait_semaphores) {
+      semaphores.push_back(static_cast<TaskSemaphore*>(wait_point.semaphore));
+    }
+    {
+      absl::MutexLock lock(&batch_node->status_mutex);
+      batch_node->wait_timepoints.resize(semaphores.size());
+      for (int i = 0; i < semaphores.size(); ++i) {
+        batch_node->wait_timepoints[i].semaphore = semaphores[i];
+      }
+    }
+    {
+      absl::MutexLock lock(&mutex_);
+      waiting_batches_[batch_node.get()] = batch_node;
+    }
+
+    // Each timepoint resolves one wait; they may resolve inline if the
+    // semaphore has already been signaled.
+    for (int i = 0; i < semaphores.size(); ++i) {
+      uint64_t token = semaphores[i]->EnqueueTimepoint(
+          batch_node->wait_semaphores[i].value,
+          [this, batch_node, i](Status status) {
+            {
+              absl::MutexLock lock(&batch_node->status_mutex);
+              batch_node->wait_timepoints[i].resolved = true;
+            }
+            OnWaitResolved(batch_node, std::move(status));
+          });
+      absl::MutexLock lock(&batch_node->status_mutex);
+      batch_node->wait_timepoints[i].token = token;
+    }
+
+    // Drop the submission reference; this schedules the batch if all waits
+    // have already been resolved.
+    OnWaitResolved(batch_node, OkStatus());
+  }
+
+  return OkStatus();
+}
+
+void TaskCommandQueue::OnWaitResolved(const std::shared_ptr<BatchNode>& batch,
+                                      Status status) {
+  if (!status.ok()) {
+    absl::MutexLock lock(&batch->status_mutex);
+    if (batch->status.ok()) batch->status = std::move(status);
+  }
+  if (batch->pending_wait_count.fetch_sub(1) != 1) {
+    // Still waiting on other semaphores.
+    return;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    waiting_batches_.erase(batch.get());
+  }
+
+  Status wait_status;
+  {
+    absl::MutexLock lock(&batch->status_mutex);
+    wait_status = batch->status;
+  }
+  if (!wait_status.ok()) {
+    // Batch dependencies failed; propagate to anything waiting on us.
+    CompleteBatch(batch, std::move(wait_status));
+    return;
+  }
+
+  if (batch->command_buffers.empty()) {
+    CompleteBatch(batch, OkStatus());
+    return;
+  }
+
+  task_pool_->Enqueue([this, batch]() { ExecuteBatch(batch); });
+}
+
+void TaskCommandQueue::ExecuteBatch(const std::shared_ptr<BatchNode>& batch) {
+  IREE_TRACE_SCOPE0("TaskCommandQueue::ExecuteBatch");
+
+  // Command buffers in a batch are ordered with respect to each other (just as
+  // commands within a command buffer are) so they run one after the other.
+  Status status;
+  for (auto* command_buffer : batch->command_buffers) {
+    // Process with a fresh processor so that no state carries across buffers.
+    auto* inproc_command_buffer =
+        static_cast<InProcCommandBuffer*>(command_buffer->impl());
+    SerialCommandProcessor command_processor(supported_categories(),
+                                             grid_executor_);
+    status = inproc_command_buffer->Process(&command_processor);
+    if (!status.ok()) break;
+  }
+  CompleteBatch(batch, std::move(status));
+}
+
+void TaskCommandQueue::CompleteBatch(const std::shared_ptr<BatchNode>& batch,
+                                     Status status) {
+  IREE_TRACE_SCOPE0("TaskCommandQueue::CompleteBatch");
+
+  if (status.ok()) {
+    // Signal all semaphores to allow them to unblock waiters. This may
+    // schedule other batches that were waiting on us.
+    for (const auto& signal_point : batch->signal_semaphores) {
+      auto signal_status = signal_point.semaphore->Signal(signal_point.value);
+      if (!signal_status.ok() && status.ok()) {
+        status = std::move(signal_status);
+      }
+    }
+  }
+  if (!status.ok()) {
+    // Fail all semaphores that we would have signaled.
+    for (const auto& signal_point : batch->signal_semaphores) {
+      signal_point.semaphore->Fail(status);
+    }
+  }
+
+  absl::MutexLock lock(&mutex_);
+  if (!status.ok() && error_.ok()) {
+    error_ = std::move(status);
+  }
+  --pending_batch_count_;
+}
+
+Status TaskCommandQueue::WaitIdle(Time deadline_ns) {
+  IREE_TRACE_SCOPE0("TaskCommandQueue::WaitIdle");
+
+  absl::MutexLock lock(&mutex_);
+  if (!mutex_.AwaitWithDeadline(
+          absl::Condition(
+              +[](int* pending_batch_count) {
+                return *pending_batch_count == 0;
+              },
+              &pending_batch_count_),
+          absl::FromUnixNanos(static_cast<int64_t>(deadline_ns)))) {
+    return DeadlineExceededErrorBuilder(IREE_LOC)
+           << "Deadline exceeded waiting for submissions to complete";
+  }
+  // Report the error once; the failed batches have already failed their
+  // semaphores and new submissions are unaffected.
+  Status status = std::move(error_);
+  error_ = OkStatus();
+  return status;
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,102 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_COMMAND_QUEUE_H_
+#define IREE_HAL_HOST_TASK_TASK_COMMAND_QUEUE_H_
+
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/status.h"
+#include "iree/hal/command_queue.h"
+#include "iree/hal/host/grid_executor.h"
+#include "iree/hal/host/task/task_pool.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Command queue that schedules each submitted batch as a node in a dependency
+// graph. A batch becomes ready once all of its wait semaphores have reached
+// their payload values, at which point its command buffers are executed in
+// order by a single task on the |task_pool|. When all command buffers in the
+// batch have completed the signal semaphores are signaled, which in turn may
+// make other batches ready.
+//
+// Command buffers within a batch execute as if they were a single command
+// buffer so that work recorded into one (such as staging copies) is complete
+// before the next begins. Batches without dependencies between them run
+// concurrently and complete in any order; only the semaphores define the
+// execution order across batches. All semaphores must be TaskSemaphores.
+//
+// When a batch fails (either because a wait semaphore failed or a command
+// buffer returned an error) the remaining command buffers of the batch are
+// skipped and the signal semaphores of the batch are failed with the error.
+// The first such error is also returned from the next WaitIdle, after which
+// the queue is usable again.
+//
+// Destroying the queue fails any batches still waiting on semaphores with
+// CANCELLED and waits for those already executing to complete.
+//
+// Thread-safe.
+class TaskCommandQueue final : public CommandQueue {
+ public:
+  // |task_pool| and |grid_executor| (optional) must remain valid for the
+  // lifetime of the queue.
+  TaskCommandQueue(std::string name,
+                   CommandCategoryBitfield supported_categories,
+                   TaskPool* task_pool, GridExecutor* grid_executor);
+  ~TaskCommandQueue() override;
+
+  Status Submit(absl::Span<const SubmissionBatch> batches) override;
+
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  struct BatchNode;
+
+  // Called as each wait semaphore of |batch| is resolved.
+  void OnWaitResolved(const std::shared_ptr<BatchNode>& batch, Status status);
+
+  // Executes the command buffers of |batch| in order on the calling thread and
+  // completes the batch.
+  void ExecuteBatch(const std::shared_ptr<BatchNode>& batch);
+
+  // Signals (or fails) the semaphores of |batch| and retires it.
+  void CompleteBatch(const std::shared_ptr<BatchNode>& batch, Status status);
+
+  // Cancels the unresolved waits of all batches still waiting on semaphores,
+  // failing the batches.
+  void CancelWaitingBatches();
+
+  TaskPool* task_pool_;
+  GridExecutor* grid_executor_;
+
+  absl::Mutex mutex_;
+  // Total number of batches that have been submitted but not completed.
+  int pending_batch_count_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Batches that have not yet had all of their wait semaphores resolved.
+  absl::flat_hash_map<BatchNode*, std::shared_ptr<BatchNode>> waiting_batches_
+      ABSL_GUARDED_BY(mutex_);
+  // The first error from a failed batch since the last WaitIdle.
+  Status error_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_COMMAND_QUEUE_H_
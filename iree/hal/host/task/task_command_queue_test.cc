@@ -0,0 +1,340 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_command_queue.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "iree/base/status.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/hal/host/host_executable.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/task/task_pool.h"
+#include "iree/hal/host/task/task_semaphore.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Executable whose tiles block until |expected_count| tiles (across all
+// dispatches) have started. Fails if that does not happen within a timeout.
+class RendezvousExecutable final : public HostExecutable {
+ public:
+  explicit RendezvousExecutable(int expected_count)
+      : expected_count_(expected_count) {}
+
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    return make_ref<DispatchState>();
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    absl::MutexLock lock(&mutex_);
+    ++arrived_count_;
+    auto condition = [this]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+      return arrived_count_ >= expected_count_;
+    };
+    if (!mutex_.AwaitWithTimeout(absl::Condition(&condition),
+                                 absl::Seconds(10))) {
+      return DeadlineExceededErrorBuilder(IREE_LOC)
+             << "Only " << arrived_count_ << " of " << expected_count_
+             << " tiles started";
+    }
+    return OkStatus();
+  }
+
+ private:
+  int expected_count_;
+  absl::Mutex mutex_;
+  int arrived_count_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Executable whose tiles sleep for |delay| and then append |id| to |log|.
+class LoggingExecutable final : public HostExecutable {
+ public:
+  LoggingExecutable(int id, absl::Duration delay, absl::Mutex* mutex,
+                    std::vector<int>* log)
+      : id_(id), delay_(delay), mutex_(mutex), log_(log) {}
+
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    return make_ref<DispatchState>();
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    absl::SleepFor(delay_);
+    absl::MutexLock lock(mutex_);
+    log_->push_back(id_);
+    return OkStatus();
+  }
+
+ private:
+  int id_;
+  absl::Duration delay_;
+  absl::Mutex* mutex_;
+  std::vector<int>* log_;
+};
+
+// Executable whose tiles always fail.
+class FailingExecutable final : public HostExecutable {
+ public:
+  bool supports_debugging() const override { return false; }
+
+  StatusOr<ref_ptr<DispatchState>> PrepareDispatch(
+      const DispatchParams& params) override {
+    return make_ref<DispatchState>();
+  }
+
+  Status DispatchTile(DispatchState* state,
+                      std::array<uint32_t, 3> workgroup_xyz) override {
+    return UnknownErrorBuilder(IREE_LOC) << "Tile failed";
+  }
+};
+
+// Semaphore not created by the task scheduling model.
+class ForeignSemaphore final : public Semaphore {
+ public:
+  StatusOr<uint64_t> Query() override { return 0u; }
+  Status Signal(uint64_t value) override { return OkStatus(); }
+  void Fail(Status status) override {}
+  Status Wait(uint64_t value, Time deadline_ns) override { return OkStatus(); }
+};
+
+struct TaskCommandQueueTest : public ::testing::Test {
+  std::unique_ptr<TaskPool> task_pool;
+  std::unique_ptr<CommandQueue> command_queue;
+
+  void SetUp() override {
+    task_pool = absl::make_unique<TaskPool>(4);
+    command_queue = absl::make_unique<TaskCommandQueue>(
+        "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+        task_pool.get(), /*grid_executor=*/nullptr);
+  }
+
+  void TearDown() override {
+    command_queue.reset();
+    task_pool.reset();
+  }
+
+  // Records a command buffer that writes |value| to the first word of
+  // |buffer|.
+  ref_ptr<CommandBuffer> RecordWrite(Buffer* buffer, uint32_t value) {
+    auto command_buffer = make_ref<InProcCommandBuffer>(
+        CommandBufferMode::kOneShot, CommandCategory::kTransfer);
+    IREE_CHECK_OK(command_buffer->Begin());
+    IREE_CHECK_OK(
+        command_buffer->UpdateBuffer(&value, 0, buffer, 0, sizeof(value)));
+    IREE_CHECK_OK(command_buffer->End());
+    return command_buffer;
+  }
+
+  // Records a command buffer that dispatches a single tile of |executable|.
+  ref_ptr<CommandBuffer> RecordDispatch(Executable* executable) {
+    auto command_buffer = make_ref<InProcCommandBuffer>(
+        CommandBufferMode::kOneShot, CommandCategory::kDispatch);
+    IREE_CHECK_OK(command_buffer->Begin());
+    IREE_CHECK_OK(command_buffer->Dispatch(executable, 0, {1, 1, 1}));
+    IREE_CHECK_OK(command_buffer->End());
+    return command_buffer;
+  }
+};
+
+// Tests that an empty batch signals its semaphores.
+TEST_F(TaskCommandQueueTest, EmptyBatch) {
+  TaskSemaphore semaphore(0u);
+  SemaphoreValue signal_point = {&semaphore, 1u};
+  IREE_ASSERT_OK(command_queue->Submit({{}, {}, {&signal_point, 1}}));
+  IREE_ASSERT_OK(semaphore.Wait(1u, InfiniteFuture()));
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+}
+
+// Tests that a batch does not run until its wait semaphores are signaled, even
+// when submitted ahead of the batch that signals them.
+TEST_F(TaskCommandQueueTest, WaitBeforeSignal) {
+  auto buffer = HeapBuffer::Allocate(BufferUsage::kAll, sizeof(uint32_t));
+  TaskSemaphore semaphore_a(0u);
+  TaskSemaphore semaphore_b(0u);
+  TaskSemaphore semaphore_c(0u);
+
+  // b: waits on a, writes 2, signals c.
+  auto command_buffer_b = RecordWrite(buffer.get(), 2u);
+  CommandBuffer* command_buffers_b[] = {command_buffer_b.get()};
+  SemaphoreValue wait_b = {&semaphore_a, 1u};
+  SemaphoreValue signal_b = {&semaphore_c, 1u};
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{&wait_b, 1}, command_buffers_b, {&signal_b, 1}}));
+
+  // a: writes 1, signals b's wait semaphore only after the host does.
+  auto command_buffer_a = RecordWrite(buffer.get(), 1u);
+  CommandBuffer* command_buffers_a[] = {command_buffer_a.get()};
+  SemaphoreValue wait_a = {&semaphore_b, 1u};
+  SemaphoreValue signal_a = {&semaphore_a, 1u};
+  IREE_ASSERT_OK(command_queue->Submit(
+      {{&wait_a, 1}, command_buffers_a, {&signal_a, 1}}));
+
+  EXPECT_EQ(0u, semaphore_c.Query().value());
+  IREE_ASSERT_OK(semaphore_b.Signal(1u));
+  IREE_ASSERT_OK(semaphore_c.Wait(1u, InfiniteFuture()));
+
+  uint32_t value = 0;
+  IREE_ASSERT_OK(buffer->ReadData(0, &value, sizeof(value)));
+  EXPECT_EQ(2u, value);
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+}
+
+// Tests that failed wait semaphores propagate to the signal semaphores.
+TEST_F(TaskCommandQueueTest, FailedWait) {
+  TaskSemaphore wait_semaphore(0u);
+  TaskSemaphore signal_semaphore(0u);
+  SemaphoreValue wait_point = {&wait_semaphore, 1u};
+  SemaphoreValue signal_point = {&signal_semaphore, 1u};
+  IREE_ASSERT_OK(
+      command_queue->Submit({{&wait_point, 1}, {}, {&signal_point, 1}}));
+  wait_semaphore.Fail(UnknownErrorBuilder(IREE_LOC));
+  EXPECT_TRUE(IsUnknown(signal_semaphore.Wait(1u, InfiniteFuture())));
+  EXPECT_TRUE(IsUnknown(command_queue->WaitIdle()));
+
+  // The error is only reported once and the queue accepts new work.
+  IREE_EXPECT_OK(command_queue->WaitIdle());
+  TaskSemaphore semaphore(0u);
+  SemaphoreValue next_signal_point = {&semaphore, 1u};
+  IREE_ASSERT_OK(command_queue->Submit({{}, {}, {&next_signal_point, 1}}));
+  IREE_ASSERT_OK(semaphore.Wait(1u, InfiniteFuture()));
+  IREE_EXPECT_OK(command_queue->WaitIdle());
+}
+
+// Tests that batches without dependencies between them execute concurrently.
+// Each batch dispatches a tile that only completes once the tile of the other
+// batch has started, so running them one after the other fails.
+TEST_F(TaskCommandQueueTest, IndependentBatchesRunConcurrently) {
+  auto executable = make_ref<RendezvousExecutable>(2);
+  auto command_buffer_a = RecordDispatch(executable.get());
+  auto command_buffer_b = RecordDispatch(executable.get());
+  CommandBuffer* command_buffers_a[] = {command_buffer_a.get()};
+  CommandBuffer* command_buffers_b[] = {command_buffer_b.get()};
+  TaskSemaphore semaphore_a(0u);
+  TaskSemaphore semaphore_b(0u);
+  SemaphoreValue signal_a = {&semaphore_a, 1u};
+  SemaphoreValue signal_b = {&semaphore_b, 1u};
+  SubmissionBatch batches[] = {
+      {{}, command_buffers_a, {&signal_a, 1}},
+      {{}, command_buffers_b, {&signal_b, 1}},
+  };
+  IREE_ASSERT_OK(command_queue->Submit(batches));
+  IREE_ASSERT_OK(semaphore_a.Wait(1u, InfiniteFuture()));
+  IREE_ASSERT_OK(semaphore_b.Wait(1u, InfiniteFuture()));
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+}
+
+// Tests that the command buffers within a batch execute in order. This is
+// relied on by submissions that stage inputs in one command buffer, dispatch
+// in a second, and copy out results in a third. Earlier command buffers take
+// longer so that running them concurrently would complete them out of order.
+TEST_F(TaskCommandQueueTest, BatchCommandBuffersRunInOrder) {
+  absl::Mutex mutex;
+  std::vector<int> log;
+  auto executable_0 = make_ref<LoggingExecutable>(0, absl::Milliseconds(100),
+                                                  &mutex, &log);
+  auto executable_1 = make_ref<LoggingExecutable>(1, absl::Milliseconds(50),
+                                                  &mutex, &log);
+  auto executable_2 =
+      make_ref<LoggingExecutable>(2, absl::ZeroDuration(), &mutex, &log);
+  auto command_buffer_0 = RecordDispatch(executable_0.get());
+  auto command_buffer_1 = RecordDispatch(executable_1.get());
+  auto command_buffer_2 = RecordDispatch(executable_2.get());
+  CommandBuffer* command_buffers[] = {
+      command_buffer_0.get(),
+      command_buffer_1.get(),
+      command_buffer_2.get(),
+  };
+  TaskSemaphore semaphore(0u);
+  SemaphoreValue signal_point = {&semaphore, 1u};
+  IREE_ASSERT_OK(
+      command_queue->Submit({{}, command_buffers, {&signal_point, 1}}));
+  IREE_ASSERT_OK(semaphore.Wait(1u, InfiniteFuture()));
+  IREE_ASSERT_OK(command_queue->WaitIdle());
+
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ((std::vector<int>{0, 1, 2}), log);
+}
+
+// Tests that a failed command buffer skips the rest of its batch and fails the
+// signal semaphores.
+TEST_F(TaskCommandQueueTest, FailedCommandBufferSkipsBatch) {
+  absl::Mutex mutex;
+  std::vector<int> log;
+  auto failing_executable = make_ref<FailingExecutable>();
+  auto executable =
+      make_ref<LoggingExecutable>(1, absl::ZeroDuration(), &mutex, &log);
+  auto command_buffer_0 = RecordDispatch(failing_executable.get());
+  auto command_buffer_1 = RecordDispatch(executable.get());
+  CommandBuffer* command_buffers[] = {
+      command_buffer_0.get(),
+      command_buffer_1.get(),
+  };
+  TaskSemaphore semaphore(0u);
+  SemaphoreValue signal_point = {&semaphore, 1u};
+  IREE_ASSERT_OK(
+      command_queue->Submit({{}, command_buffers, {&signal_point, 1}}));
+  EXPECT_TRUE(IsUnknown(semaphore.Wait(1u, InfiniteFuture())));
+  EXPECT_TRUE(IsUnknown(command_queue->WaitIdle()));
+
+  absl::MutexLock lock(&mutex);
+  EXPECT_TRUE(log.empty());
+}
+
+// Tests that destroying the queue fails batches whose wait semaphores are
+// never signaled instead of waiting for them forever.
+TEST_F(TaskCommandQueueTest, DestroyWithWaitingBatch) {
+  TaskSemaphore wait_semaphore(0u);
+  TaskSemaphore signal_semaphore(0u);
+  SemaphoreValue wait_point = {&wait_semaphore, 1u};
+  SemaphoreValue signal_point = {&signal_semaphore, 1u};
+  IREE_ASSERT_OK(
+      command_queue->Submit({{&wait_point, 1}, {}, {&signal_point, 1}}));
+  command_queue.reset();
+  EXPECT_TRUE(IsCancelled(signal_semaphore.Query().status()));
+
+  // The cancelled timepoint must not fire once the semaphore is signaled.
+  IREE_EXPECT_OK(wait_semaphore.Signal(1u));
+}
+
+// Tests that semaphores from other drivers are rejected.
+TEST_F(TaskCommandQueueTest, ForeignWaitSemaphore) {
+  ForeignSemaphore semaphore;
+  SemaphoreValue wait_point = {&semaphore, 1u};
+  EXPECT_TRUE(
+      IsInvalidArgument(command_queue->Submit({{&wait_point, 1}, {}, {}})));
+  IREE_EXPECT_OK(command_queue->WaitIdle());
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
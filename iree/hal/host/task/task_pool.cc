@@ -0,0 +1,75 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_pool.h"
+
+#include <algorithm>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+TaskPool::TaskPool(int worker_count) {
+  IREE_TRACE_SCOPE0("TaskPool::ctor");
+  worker_count = std::max(1, worker_count);
+  workers_.reserve(worker_count);
+  for (int i = 0; i < worker_count; ++i) {
+    workers_.emplace_back([this]() { ThreadMain(); });
+  }
+}
+
+TaskPool::~TaskPool() {
+  IREE_TRACE_SCOPE0("TaskPool::dtor");
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void TaskPool::Enqueue(Task task) {
+  absl::MutexLock lock(&mutex_);
+  tasks_.push_back(std::move(task));
+}
+
+void TaskPool::ThreadMain() {
+  IREE_TRACE_SET_THREAD_NAME("task-worker");
+
+  while (true) {
+    Task task;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](TaskPool* pool) ABSL_NO_THREAD_SAFETY_ANALYSIS {
+            return pool->shutdown_ || !pool->tasks_.empty();
+          },
+          this));
+      if (tasks_.empty()) {
+        // Only reached on shutdown once all tasks have been drained.
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
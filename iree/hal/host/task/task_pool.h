@@ -0,0 +1,68 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_POOL_H_
+#define IREE_HAL_HOST_TASK_TASK_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// A pool of worker threads that executes tasks in FIFO order.
+// Tasks are expected to be ready to run when enqueued; dependency tracking is
+// left to the producer (such as the TaskCommandQueue).
+//
+// Thread-safe. Tasks may be enqueued from any thread, including from within
+// other tasks.
+class TaskPool final {
+ public:
+  using Task = std::function<void()>;
+
+  // Creates a pool with |worker_count| threads (at least one).
+  explicit TaskPool(int worker_count);
+  // Runs all tasks that have been enqueued and joins the workers.
+  ~TaskPool();
+
+  TaskPool(const TaskPool&) = delete;
+  TaskPool& operator=(const TaskPool&) = delete;
+
+  int worker_count() const { return static_cast<int>(workers_.size()); }
+
+  // Enqueues |task| to be run on one of the worker threads.
+  void Enqueue(Task task);
+
+ private:
+  // Thread entry point for each worker.
+  void ThreadMain();
+
+  std::vector<std::thread> workers_;
+
+  absl::Mutex mutex_;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::deque<Task> tasks_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_POOL_H_
@@ -0,0 +1,81 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_scheduling_model.h"
+
+#include "absl/memory/memory.h"
+#include "iree/base/tracing.h"
+#include "iree/hal/host/inproc_command_buffer.h"
+#include "iree/hal/host/nop_event.h"
+#include "iree/hal/host/task/task_command_queue.h"
+#include "iree/hal/host/task/task_semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+TaskSchedulingModel::TaskSchedulingModel(int submission_worker_count,
+                                         int dispatch_worker_count)
+    : grid_executor_(absl::make_unique<GridExecutor>(dispatch_worker_count)),
+      task_pool_(absl::make_unique<TaskPool>(submission_worker_count)) {
+  // All work is scheduled onto the same pool so a single queue is enough;
+  // ordering comes from the semaphores and not the queue.
+  command_queues_.push_back(absl::make_unique<TaskCommandQueue>(
+      "cpu0", CommandCategory::kTransfer | CommandCategory::kDispatch,
+      task_pool_.get(), grid_executor_.get()));
+}
+
+TaskSchedulingModel::~TaskSchedulingModel() {
+  // Retire all queued work before the pool and executor are torn down.
+  command_queues_.clear();
+}
+
+StatusOr<ref_ptr<CommandBuffer>> TaskSchedulingModel::CreateCommandBuffer(
+    CommandBufferModeBitfield mode,
+    CommandCategoryBitfield command_categories) {
+  return make_ref<InProcCommandBuffer>(mode, command_categories);
+}
+
+StatusOr<ref_ptr<Event>> TaskSchedulingModel::CreateEvent() {
+  return make_ref<NopEvent>();
+}
+
+StatusOr<ref_ptr<Semaphore>> TaskSchedulingModel::CreateSemaphore(
+    uint64_t initial_value) {
+  return make_ref<TaskSemaphore>(initial_value);
+}
+
+Status TaskSchedulingModel::WaitAllSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return TaskSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/true,
+                                          deadline_ns)
+      .status();
+}
+
+StatusOr<int> TaskSchedulingModel::WaitAnySemaphore(
+    absl::Span<const SemaphoreValue> semaphores, Time deadline_ns) {
+  return TaskSemaphore::WaitForSemaphores(semaphores, /*wait_all=*/false,
+                                          deadline_ns);
+}
+
+Status TaskSchedulingModel::WaitIdle(Time deadline_ns) {
+  for (auto& command_queue : command_queues_) {
+    IREE_RETURN_IF_ERROR(command_queue->WaitIdle(deadline_ns));
+  }
+  return OkStatus();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,76 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
+#define IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
+
+#include <memory>
+
+#include "absl/container/inlined_vector.h"
+#include "iree/base/memory.h"
+#include "iree/hal/host/grid_executor.h"
+#include "iree/hal/host/scheduling_model.h"
+#include "iree/hal/host/task/task_pool.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Performs host-local scheduling with an out-of-order task graph.
+// Each submission batch becomes a task whose dependencies are the semaphore
+// values it waits on. Batches that do not depend on each other are executed
+// concurrently across a pool of |submission_worker_count| threads while the
+// command buffers within a batch execute in order. Semaphore waits wake as
+// soon as the awaited values are reached instead of polling.
+//
+// Tiles within each dispatch may additionally be distributed across
+// |dispatch_worker_count| threads as with the SerialSchedulingModel.
+class TaskSchedulingModel final : public SchedulingModel {
+ public:
+  TaskSchedulingModel(int submission_worker_count, int dispatch_worker_count);
+  ~TaskSchedulingModel() override;
+
+  absl::Span<CommandQueue*> dispatch_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  absl::Span<CommandQueue*> transfer_queues() const override {
+    return RawPtrSpan(absl::MakeSpan(command_queues_));
+  }
+
+  StatusOr<ref_ptr<CommandBuffer>> CreateCommandBuffer(
+      CommandBufferModeBitfield mode,
+      CommandCategoryBitfield command_categories) override;
+
+  StatusOr<ref_ptr<Event>> CreateEvent() override;
+
+  StatusOr<ref_ptr<Semaphore>> CreateSemaphore(uint64_t initial_value) override;
+
+  Status WaitAllSemaphores(absl::Span<const SemaphoreValue> semaphores,
+                           Time deadline_ns) override;
+  StatusOr<int> WaitAnySemaphore(absl::Span<const SemaphoreValue> semaphores,
+                                 Time deadline_ns) override;
+  Status WaitIdle(Time deadline_ns) override;
+
+ private:
+  std::unique_ptr<GridExecutor> grid_executor_;
+  std::unique_ptr<TaskPool> task_pool_;
+  mutable absl::InlinedVector<std::unique_ptr<CommandQueue>, 4> command_queues_;
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_SCHEDULING_MODEL_H_
@@ -0,0 +1,259 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_semaphore.h"
+
+#include <algorithm>
+#include <memory>
+
+#include "absl/container/flat_hash_set.h"
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+namespace {
+
+// All live TaskSemaphores. Lets us validate the semaphores passed in by callers
+// without RTTI.
+struct SemaphoreRegistry {
+  absl::Mutex mutex;
+  absl::flat_hash_set<const Semaphore*> semaphores ABSL_GUARDED_BY(mutex);
+};
+
+SemaphoreRegistry* GetSemaphoreRegistry() {
+  static auto* registry = new SemaphoreRegistry();
+  return registry;
+}
+
+}  // namespace
+
+// static
+TaskSemaphore* TaskSemaphore::Cast(Semaphore* semaphore) {
+  auto* registry = GetSemaphoreRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  if (!registry->semaphores.contains(semaphore)) return nullptr;
+  return static_cast<TaskSemaphore*>(semaphore);
+}
+
+TaskSemaphore::TaskSemaphore(uint64_t initial_value) : value_(initial_value) {
+  auto* registry = GetSemaphoreRegistry();
+  absl::MutexLock lock(&registry->mutex);
+  registry->semaphores.insert(this);
+}
+
+TaskSemaphore::~TaskSemaphore() {
+  {
+    auto* registry = GetSemaphoreRegistry();
+    absl::MutexLock lock(&registry->mutex);
+    registry->semaphores.erase(this);
+  }
+
+  // Any remaining timepoints will never be reached; let their owners know so
+  // that they don't wait forever.
+  absl::InlinedVector<Timepoint, 4> timepoints;
+  {
+    absl::MutexLock lock(&mutex_);
+    timepoints.swap(timepoints_);
+  }
+  for (auto& timepoint : timepoints) {
+    timepoint.callback(CancelledErrorBuilder(IREE_LOC)
+                       << "Semaphore destroyed with pending timepoints");
+  }
+}
+
+StatusOr<uint64_t> TaskSemaphore::Query() {
+  absl::MutexLock lock(&mutex_);
+  if (!status_.ok()) {
+    return status_;
+  }
+  return value_.load(std::memory_order_acquire);
+}
+
+absl::InlinedVector<TaskSemaphore::Timepoint, 4>
+TaskSemaphore::TakeReadyTimepoints() {
+  absl::InlinedVector<Timepoint, 4> ready_timepoints;
+  uint64_t current_value = value_.load(std::memory_order_acquire);
+  for (auto it = timepoints_.begin(); it != timepoints_.end();) {
+    if (!status_.ok() || it->value <= current_value) {
+      ready_timepoints.push_back(std::move(*it));
+      it = timepoints_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  return ready_timepoints;
+}
+
+Status TaskSemaphore::Signal(uint64_t value) {
+  absl::InlinedVector<Timepoint, 4> ready_timepoints;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!status_.ok()) {
+      return status_;
+    }
+    // Submissions may complete out of order and signal the same semaphore; as
+    // with SubmissionBatch the payload only ever moves forward.
+    if (value_.load(std::memory_order_acquire) >= value) {
+      return OkStatus();
+    }
+    value_.store(value, std::memory_order_release);
+    ready_timepoints = TakeReadyTimepoints();
+  }
+
+  // Callbacks are made outside of the lock so that they may signal other
+  // semaphores or schedule work without risking lock inversion.
+  for (auto& timepoint : ready_timepoints) {
+    timepoint.callback(OkStatus());
+  }
+  return OkStatus();
+}
+
+void TaskSemaphore::Fail(Status status) {
+  absl::InlinedVector<Timepoint, 4> ready_timepoints;
+  {
+    absl::MutexLock lock(&mutex_);
+    status_ = status;
+    value_.store(UINT64_MAX, std::memory_order_release);
+    ready_timepoints = TakeReadyTimepoints();
+  }
+  for (auto& timepoint : ready_timepoints) {
+    timepoint.callback(status);
+  }
+}
+
+uint64_t TaskSemaphore::EnqueueTimepoint(uint64_t value,
+                                         TimepointCallback callback) {
+  Status status;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (status_.ok() && value_.load(std::memory_order_acquire) < value) {
+      uint64_t token = next_token_++;
+      timepoints_.push_back({token, value, std::move(callback)});
+      return token;
+    }
+    status = status_;
+  }
+  callback(std::move(status));
+  return 0;
+}
+
+bool TaskSemaphore::CancelTimepoint(uint64_t token) {
+  absl::MutexLock lock(&mutex_);
+  for (auto it = timepoints_.begin(); it != timepoints_.end(); ++it) {
+    if (it->token == token) {
+      timepoints_.erase(it);
+      return true;
+    }
+  }
+  return false;
+}
+
+// static
+StatusOr<int> TaskSemaphore::WaitForSemaphores(
+    absl::Span<const SemaphoreValue> semaphores, bool wait_all,
+    Time deadline_ns) {
+  IREE_TRACE_SCOPE0("TaskSemaphore::WaitForSemaphores");
+
+  // Shared with the timepoint callbacks as they may be made after we have
+  // returned (such as on timeout).
+  struct WaitState {
+    absl::Mutex mutex;
+    int pending_count ABSL_GUARDED_BY(mutex) = 0;
+    int signaled_index ABSL_GUARDED_BY(mutex) = -1;
+    Status status ABSL_GUARDED_BY(mutex);
+  };
+  auto wait_state = std::make_shared<WaitState>();
+
+  // Some of the semaphores may already be signaled; we only need to register
+  // timepoints on those that are not yet at the expected value.
+  absl::InlinedVector<std::pair<TaskSemaphore*, uint64_t>, 4> timepoints;
+  StatusOr<int> result = 0;
+  bool is_ready = false;
+  for (int i = 0; i < semaphores.size(); ++i) {
+    auto* semaphore = TaskSemaphore::Cast(semaphores[i].semaphore);
+    if (!semaphore) {
+      result = Status(InvalidArgumentErrorBuilder(IREE_LOC)
+                      << "Semaphore " << i << " is not a TaskSemaphore");
+      is_ready = true;
+      break;
+    }
+    auto current_value = semaphore->Query();
+    if (!current_value.ok()) {
+      result = std::move(current_value).status();
+      is_ready = true;
+      break;
+    } else if (current_value.value() >= semaphores[i].value) {
+      if (wait_all) continue;
+      result = i;
+      is_ready = true;
+      break;
+    }
+    {
+      absl::MutexLock lock(&wait_state->mutex);
+      ++wait_state->pending_count;
+    }
+    uint64_t token = semaphore->EnqueueTimepoint(
+        semaphores[i].value, [wait_state, i](Status status) {
+          absl::MutexLock lock(&wait_state->mutex);
+          --wait_state->pending_count;
+          if (!status.ok()) {
+            if (wait_state->status.ok()) {
+              wait_state->status = std::move(status);
+            }
+          } else if (wait_state->signaled_index == -1) {
+            wait_state->signaled_index = i;
+          }
+        });
+    if (token) timepoints.push_back({semaphore, token});
+  }
+
+  if (!is_ready) {
+    absl::MutexLock lock(&wait_state->mutex);
+    auto condition = [&]() ABSL_NO_THREAD_SAFETY_ANALYSIS {
+      if (!wait_state->status.ok()) return true;
+      return wait_all ? wait_state->pending_count == 0
+                      : wait_state->signaled_index != -1 ||
+                            wait_state->pending_count == 0;
+    };
+    if (!wait_state->mutex.AwaitWithDeadline(
+            absl::Condition(&condition),
+            absl::FromUnixNanos(static_cast<int64_t>(deadline_ns)))) {
+      result = Status(DeadlineExceededErrorBuilder(IREE_LOC)
+                      << "Deadline exceeded waiting for semaphores");
+    } else if (!wait_state->status.ok()) {
+      result = wait_state->status;
+    } else if (!wait_all) {
+      result = std::max(0, wait_state->signaled_index);
+    }
+  }
+
+  // Drop any timepoints that were not reached so that they don't accumulate on
+  // semaphores we may never see signaled.
+  for (auto& timepoint : timepoints) {
+    timepoint.first->CancelTimepoint(timepoint.second);
+  }
+
+  return result;
+}
+
+Status TaskSemaphore::Wait(uint64_t value, Time deadline_ns) {
+  return WaitForSemaphores({{this, value}}, /*wait_all=*/true, deadline_ns)
+      .status();
+}
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
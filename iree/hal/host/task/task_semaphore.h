@@ -0,0 +1,108 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_HOST_TASK_TASK_SEMAPHORE_H_
+#define IREE_HAL_HOST_TASK_TASK_SEMAPHORE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/hal/semaphore.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+
+// Host-only semaphore that notifies registered timepoints when signaled.
+// Signaling with a value less than or equal to the current payload is ignored
+// as independent submissions may complete (and signal) in any order.
+//
+// Timepoints allow the task scheduler to chain work off of semaphore values
+// without a thread blocking (or polling) on each of them and let waits on
+// multiple semaphores (including wait-any) sleep until one of the relevant
+// semaphores changes.
+//
+// Thread-safe (as instances may be imported and used by others).
+class TaskSemaphore final : public Semaphore {
+ public:
+  // Called once the semaphore reaches the timepoint value or fails.
+  // |status| is OK if the value was reached and otherwise the failure status.
+  // Callbacks may be made from any thread (including the one registering the
+  // timepoint) and must not call back into the semaphore.
+  using TimepointCallback = std::function<void(Status status)>;
+
+  // Waits for one or more (or all) semaphores to reach or exceed the given
+  // values. Returns the index of a semaphore that was signaled; for wait-all
+  // this is always 0.
+  static StatusOr<int> WaitForSemaphores(
+      absl::Span<const SemaphoreValue> semaphores, bool wait_all,
+      Time deadline_ns);
+
+  // Returns |semaphore| as a TaskSemaphore or nullptr if it is some other
+  // type of semaphore (such as one created by another driver).
+  static TaskSemaphore* Cast(Semaphore* semaphore);
+
+  explicit TaskSemaphore(uint64_t initial_value);
+  ~TaskSemaphore() override;
+
+  StatusOr<uint64_t> Query() override;
+
+  Status Signal(uint64_t value) override;
+  void Fail(Status status) override;
+  Status Wait(uint64_t value, Time deadline_ns) override;
+
+  // Registers |callback| to be called when the semaphore reaches |value|.
+  // If the value has already been reached (or the semaphore has failed) the
+  // callback is made immediately on the calling thread.
+  //
+  // Returns a token that can be passed to CancelTimepoint, or 0 if the callback
+  // was made inline.
+  uint64_t EnqueueTimepoint(uint64_t value, TimepointCallback callback);
+
+  // Cancels a pending timepoint. Returns true if the timepoint was removed
+  // before its callback was made.
+  bool CancelTimepoint(uint64_t token);
+
+ private:
+  struct Timepoint {
+    uint64_t token;
+    uint64_t value;
+    TimepointCallback callback;
+  };
+
+  // Removes and returns all timepoints satisfied by the current state.
+  absl::InlinedVector<Timepoint, 4> TakeReadyTimepoints()
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // The mutex is not required to query the value; this lets us quickly check if
+  // a required value has been exceeded.
+  std::atomic<uint64_t> value_{0};
+
+  mutable absl::Mutex mutex_;
+  Status status_ ABSL_GUARDED_BY(mutex_);
+  uint64_t next_token_ ABSL_GUARDED_BY(mutex_) = 1;
+  absl::InlinedVector<Timepoint, 4> timepoints_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_HOST_TASK_TASK_SEMAPHORE_H_
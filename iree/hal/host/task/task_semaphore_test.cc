@@ -0,0 +1,134 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/host/task/task_semaphore.h"
+
+#include <cstdint>
+#include <thread>  // NOLINT
+
+#include "iree/base/status.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace host {
+namespace {
+
+// Tests that a semaphore will accept new values as it is signaled.
+TEST(TaskSemaphoreTest, NormalSignaling) {
+  TaskSemaphore semaphore(2u);
+  EXPECT_EQ(2u, semaphore.Query().value());
+  IREE_EXPECT_OK(semaphore.Signal(3u));
+  EXPECT_EQ(3u, semaphore.Query().value());
+  IREE_EXPECT_OK(semaphore.Signal(40u));
+  EXPECT_EQ(40u, semaphore.Query().value());
+}
+
+// Tests that signaling older values (out-of-order completion) is ignored.
+TEST(TaskSemaphoreTest, IgnoresDecreasingValues) {
+  TaskSemaphore semaphore(5u);
+  IREE_EXPECT_OK(semaphore.Signal(3u));
+  EXPECT_EQ(5u, semaphore.Query().value());
+}
+
+// Tests that a semaphore that has failed will remain in a failed state.
+TEST(TaskSemaphoreTest, StickyFailure) {
+  TaskSemaphore semaphore(2u);
+  semaphore.Fail(UnknownErrorBuilder(IREE_LOC));
+  EXPECT_TRUE(IsUnknown(semaphore.Query().status()));
+  EXPECT_TRUE(IsUnknown(semaphore.Signal(4u)));
+}
+
+// Tests that timepoints are notified as their values are reached.
+TEST(TaskSemaphoreTest, Timepoints) {
+  TaskSemaphore semaphore(1u);
+  int reached_mask = 0;
+  semaphore.EnqueueTimepoint(1u, [&](Status status) {
+    IREE_EXPECT_OK(status);
+    reached_mask |= 1;
+  });
+  EXPECT_EQ(1, reached_mask);  // already reached; made inline
+  semaphore.EnqueueTimepoint(3u, [&](Status status) {
+    IREE_EXPECT_OK(status);
+    reached_mask |= 2;
+  });
+  uint64_t token = semaphore.EnqueueTimepoint(
+      4u, [&](Status status) { reached_mask |= 4; });
+  IREE_EXPECT_OK(semaphore.Signal(2u));
+  EXPECT_EQ(1, reached_mask);
+  EXPECT_TRUE(semaphore.CancelTimepoint(token));
+  IREE_EXPECT_OK(semaphore.Signal(10u));
+  EXPECT_EQ(1 | 2, reached_mask);
+}
+
+// Tests that failures are propagated to pending timepoints.
+TEST(TaskSemaphoreTest, TimepointFailure) {
+  TaskSemaphore semaphore(1u);
+  bool failed = false;
+  semaphore.EnqueueTimepoint(
+      2u, [&](Status status) { failed = IsUnknown(status); });
+  semaphore.Fail(UnknownErrorBuilder(IREE_LOC));
+  EXPECT_TRUE(failed);
+}
+
+// Tests waiting on a semaphore that has not been signaled.
+TEST(TaskSemaphoreTest, WaitUnsignaled) {
+  TaskSemaphore semaphore(2u);
+  EXPECT_TRUE(IsDeadlineExceeded(semaphore.Wait(3u, InfinitePast())));
+}
+
+// Tests waiting on any of a set of semaphores where one is already signaled.
+TEST(TaskSemaphoreTest, WaitAnyAlreadySignaled) {
+  TaskSemaphore a(0u);
+  TaskSemaphore b(1u);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int index, TaskSemaphore::WaitForSemaphores(
+                     {{&a, 1u}, {&b, 1u}}, /*wait_all=*/false, InfinitePast()));
+  EXPECT_EQ(1, index);
+}
+
+// Tests that a wait-any wakes when a semaphore is signaled from another thread.
+TEST(TaskSemaphoreTest, WaitAnyThreaded) {
+  TaskSemaphore a(0u);
+  TaskSemaphore b(0u);
+  std::thread thread([&]() { IREE_ASSERT_OK(b.Signal(1u)); });
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int index,
+      TaskSemaphore::WaitForSemaphores({{&a, 1u}, {&b, 1u}},
+                                       /*wait_all=*/false, InfiniteFuture()));
+  EXPECT_EQ(1, index);
+  thread.join();
+}
+
+// Tests that a wait-all blocks until all semaphores have been signaled.
+TEST(TaskSemaphoreTest, WaitAllThreaded) {
+  TaskSemaphore a(0u);
+  TaskSemaphore b(0u);
+  std::thread thread([&]() {
+    IREE_ASSERT_OK(a.Signal(1u));
+    IREE_ASSERT_OK(b.Signal(1u));
+  });
+  IREE_ASSERT_OK(TaskSemaphore::WaitForSemaphores(
+                     {{&a, 1u}, {&b, 1u}}, /*wait_all=*/true, InfiniteFuture())
+                     .status());
+  EXPECT_EQ(1u, a.Query().value());
+  EXPECT_EQ(1u, b.Query().value());
+  thread.join();
+}
+
+}  // namespace
+}  // namespace host
+}  // namespace hal
+}  // namespace iree
@@ -25,14 +25,16 @@ namespace llvmjit {
 
 LLVMJITDevice::LLVMJITDevice(
     DeviceInfo device_info,
-    std::unique_ptr<host::SchedulingModel> scheduling_model)
-    : HostLocalDevice(std::move(device_info), std::move(scheduling_model)) {}
+    std::unique_ptr<host::SchedulingModel> scheduling_model,
+    std::shared_ptr<LLVMJITSession> session)
+    : HostLocalDevice(std::move(device_info), std::move(scheduling_model)),
+      session_(std::move(session)) {}
 
 LLVMJITDevice::~LLVMJITDevice() = default;
 
 ref_ptr<ExecutableCache> LLVMJITDevice::CreateExecutableCache() {
   IREE_TRACE_SCOPE0("LLVMJITDevice::CreateExecutableCache");
-  return make_ref<LLVMJITExecutableCache>();
+  return make_ref<LLVMJITExecutableCache>(session_);
 }
 
 }  // namespace llvmjit
@@ -18,6 +18,7 @@
 
 #include "iree/hal/device_info.h"
 #include "iree/hal/host/serial/serial_scheduling_model.h"
+#include "iree/hal/host/task/task_scheduling_model.h"
 #include "iree/hal/llvmjit/llvmjit_device.h"
 
 namespace iree {
@@ -38,7 +39,10 @@ DeviceInfo GetDefaultDeviceInfo() {
 
 }  // namespace
 
-LLVMJITDriver::LLVMJITDriver() : Driver("llvmjit") {}
+LLVMJITDriver::LLVMJITDriver() : LLVMJITDriver(Options{}) {}
+
+LLVMJITDriver::LLVMJITDriver(Options options)
+    : Driver("llvmjit"), options_(std::move(options)) {}
 
 LLVMJITDriver::~LLVMJITDriver() = default;
 
@@ -52,11 +56,32 @@ StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDefaultDevice() {
   return CreateDevice(0);
 }
 
+StatusOr<std::shared_ptr<LLVMJITSession>>
+LLVMJITDriver::GetOrCreateSession() {
+  absl::MutexLock lock(&session_mutex_);
+  if (!session_) {
+    LLVMJITSession::Options session_options;
+    session_options.cache_dir = options_.cache_dir;
+    session_options.compile_thread_count = options_.compile_thread_count;
+    IREE_ASSIGN_OR_RETURN(session_, LLVMJITSession::Create(session_options));
+  }
+  return session_;
+}
+
 StatusOr<ref_ptr<Device>> LLVMJITDriver::CreateDevice(
     DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  IREE_ASSIGN_OR_RETURN(auto session, GetOrCreateSession());
+  std::unique_ptr<host::SchedulingModel> scheduling_model;
+  if (options_.submission_worker_count > 0) {
+    scheduling_model = std::make_unique<host::TaskSchedulingModel>(
+        options_.submission_worker_count, options_.dispatch_worker_count);
+  } else {
+    scheduling_model = std::make_unique<host::SerialSchedulingModel>(
+        options_.dispatch_worker_count);
+  }
   return make_ref<LLVMJITDevice>(GetDefaultDeviceInfo(),
-                                 std::move(scheduling_model));
+                                 std::move(scheduling_model),
+                                 std::move(session));
 }
 
 }  // namespace llvmjit
@@ -15,7 +15,12 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_DRIVER_H_
 
+#include <memory>
+#include <string>
+
+#include "absl/synchronization/mutex.h"
 #include "iree/hal/driver.h"
+#include "iree/hal/llvmjit/llvmjit_session.h"
 
 namespace iree {
 namespace hal {
@@ -23,7 +28,29 @@ namespace llvmjit {
 
 class LLVMJITDriver final : public Driver {
  public:
+  struct Options {
+    // Number of threads used to process the tiles of each dispatch in addition
+    // to the thread executing the command buffer. 0 processes tiles serially.
+    int dispatch_worker_count = 0;
+
+    // Number of threads used to execute independent submissions concurrently
+    // with the out-of-order task scheduler. 0 executes submissions in order on
+    // a single queue thread.
+    int submission_worker_count = 0;
+
+    // Number of threads used to JIT compile executables concurrently.
+    // 0 compiles each executable on the thread preparing it.
+    int compile_thread_count = 0;
+
+    // Directory used to persist JIT-compiled executables across processes.
+    // Only executables prepared with
+    // ExecutableCachingMode::kAllowPersistentCaching are persisted. Empty
+    // disables persistent caching.
+    std::string cache_dir;
+  };
+
   LLVMJITDriver();
+  explicit LLVMJITDriver(Options options);
   ~LLVMJITDriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -31,6 +58,15 @@ class LLVMJITDriver final : public Driver {
   StatusOr<ref_ptr<Device>> CreateDefaultDevice() override;
 
   StatusOr<ref_ptr<Device>> CreateDevice(DriverDeviceID device_id) override;
+
+ private:
+  // Returns the JIT session shared by all devices, creating it if needed.
+  StatusOr<std::shared_ptr<LLVMJITSession>> GetOrCreateSession();
+
+  Options options_;
+
+  absl::Mutex session_mutex_;
+  std::shared_ptr<LLVMJITSession> session_ ABSL_GUARDED_BY(session_mutex_);
 };
 
 }  // namespace llvmjit
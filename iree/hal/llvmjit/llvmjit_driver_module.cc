@@ -13,13 +13,33 @@
 // limitations under the License.
 
 #include <memory>
+#include <string>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
+#include "iree/hal/host/grid_executor.h"
 #include "iree/hal/llvmjit/llvmjit_driver.h"
 #include "llvm/Support/TargetSelect.h"
 
+ABSL_FLAG(int, llvmjit_worker_count, -1,
+          "Number of worker threads used to process dispatch tiles. "
+          "-1 uses one worker per additional hardware thread and 0 processes "
+          "all tiles on the queue thread.");
+ABSL_FLAG(int, llvmjit_submission_worker_count, 0,
+          "Number of worker threads used to execute independent submissions "
+          "out of order. 0 executes submissions in order on a single queue "
+          "thread.");
+ABSL_FLAG(int, llvmjit_compile_thread_count, -1,
+          "Number of threads used to JIT compile the entry points of "
+          "executables concurrently. -1 uses one thread per additional "
+          "hardware thread and 0 compiles on the thread loading the "
+          "executable.");
+ABSL_FLAG(std::string, llvmjit_cache_dir, "",
+          "Directory used to persist JIT-compiled executables across "
+          "processes. Empty disables the persistent cache.");
+
 namespace iree {
 namespace hal {
 namespace llvmjit {
@@ -27,7 +47,20 @@ namespace llvmjit {
 static StatusOr<ref_ptr<Driver>> CreateLLVMJITDriver() {
   llvm::InitializeNativeTarget();
   llvm::InitializeNativeTargetAsmPrinter();
-  return make_ref<LLVMJITDriver>();
+  LLVMJITDriver::Options options;
+  options.dispatch_worker_count = absl::GetFlag(FLAGS_llvmjit_worker_count);
+  if (options.dispatch_worker_count < 0) {
+    options.dispatch_worker_count = host::GridExecutor::GetDefaultWorkerCount();
+  }
+  options.submission_worker_count =
+      absl::GetFlag(FLAGS_llvmjit_submission_worker_count);
+  options.compile_thread_count =
+      absl::GetFlag(FLAGS_llvmjit_compile_thread_count);
+  if (options.compile_thread_count < 0) {
+    options.compile_thread_count = host::GridExecutor::GetDefaultWorkerCount();
+  }
+  options.cache_dir = absl::GetFlag(FLAGS_llvmjit_cache_dir);
+  return make_ref<LLVMJITDriver>(options);
 }
 
 }  // namespace llvmjit
@@ -14,22 +14,15 @@
 
 #include "iree/hal/llvmjit/llvmjit_executable.h"
 
-#include <iostream>
 #include <memory>
+#include <string>
+#include <utility>
 
 #include "flatbuffers/flatbuffers.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/executable.h"
 #include "iree/schemas/llvmir_executable_def_generated.h"
-#include "llvm/ADT/ArrayRef.h"
-#include "llvm/ADT/StringRef.h"
-#include "llvm/AsmParser/Parser.h"
-#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
-#include "llvm/IR/LLVMContext.h"
-#include "llvm/Support/Error.h"
-#include "llvm/Support/MemoryBuffer.h"
-#include "llvm/Support/SourceMgr.h"
 
 namespace iree {
 namespace hal {
@@ -37,68 +30,35 @@ namespace llvmjit {
 
 // static
 StatusOr<ref_ptr<LLVMJITExecutable>> LLVMJITExecutable::Load(
-    ExecutableSpec spec, bool allow_aliasing_data) {
+    std::shared_ptr<LLVMJITSession> session, ExecutableSpec spec,
+    bool allow_aliasing_data, bool allow_persistent_caching) {
   IREE_TRACE_SCOPE0("LLVMJITExecutable::Load");
 
   auto module_def =
       ::flatbuffers::GetRoot<LLVMIRExecutableDef>(spec.executable_data.data());
-  auto data =
-      reinterpret_cast<const char*>(module_def->llvmir_module()->data());
-  const int size = module_def->llvmir_module()->size();
-  auto mem_buffer = llvm::MemoryBuffer::getMemBufferCopy(
-      llvm::StringRef(data, size), "llvm-ir");
-  auto llvm_context = std::make_unique<llvm::LLVMContext>();
-  llvm::SMDiagnostic sm_diagnostic;
-  auto module = llvm::parseAssembly(*mem_buffer, sm_diagnostic, *llvm_context);
-  if (!module) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Can't parse LLVMIR Module: " << sm_diagnostic.getMessage().str();
-  }
-  auto dataLayout = module->getDataLayout();
-  const auto entry_points = module_def->entry_points();
-  llvm::orc::ThreadSafeModule thread_safe_module(std::move(module),
-                                                 std::move(llvm_context));
-  auto ll_jit = llvm::cantFail(llvm::orc::LLJITBuilder().create());
-
-  llvm::Error err = ll_jit->addIRModule(std::move(thread_safe_module));
-  if (err) {
-    return InvalidArgumentErrorBuilder(IREE_LOC)
-           << "Can't add executable module to executable LLJIT"
-           << llvm::toString(std::move(err));
-  }
-
-  auto dylib_serarch_generator =
-      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
-          dataLayout.getGlobalPrefix());
-  if (!dylib_serarch_generator) {
-    return UnavailableErrorBuilder(IREE_LOC)
-           << "Can't resolve symbols in current process: "
-           << llvm::toString(dylib_serarch_generator.takeError());
+  const auto* llvmir_module = module_def->llvmir_module();
+  std::vector<std::string> entry_point_names;
+  entry_point_names.reserve(module_def->entry_points()->size());
+  for (const auto func_name : *module_def->entry_points()) {
+    entry_point_names.push_back(func_name->str());
   }
 
-  auto& main_jitdylib = ll_jit->getMainJITDylib();
-  main_jitdylib.addGenerator(std::move(dylib_serarch_generator.get()));
-
-  auto executable =
-      make_ref<LLVMJITExecutable>(spec, std::move(ll_jit), allow_aliasing_data);
-
-  for (const auto func_name : *entry_points) {
-    auto func_symbol = executable->ll_jit_->lookup(func_name->str());
-    if (!func_symbol) {
-      return NotFoundErrorBuilder(IREE_LOC)
-             << "Can't JIT compile function '" << func_name
-             << "': " << llvm::toString(func_symbol.takeError());
-    }
-    executable->symbols_.push_back(func_symbol.get());
-  }
+  IREE_ASSIGN_OR_RETURN(
+      auto symbols,
+      session->LoadModule(
+          absl::MakeConstSpan(llvmir_module->data(), llvmir_module->size()),
+          entry_point_names, allow_persistent_caching));
 
+  auto executable = make_ref<LLVMJITExecutable>(spec, std::move(session),
+                                                allow_aliasing_data);
+  executable->symbols_ = std::move(symbols);
   return executable;
 }
 
 LLVMJITExecutable::LLVMJITExecutable(ExecutableSpec spec,
-                                     std::unique_ptr<llvm::orc::LLJIT> ll_jit,
+                                     std::shared_ptr<LLVMJITSession> session,
                                      bool allow_aliasing_data)
-    : spec_(spec), ll_jit_(std::move(ll_jit)) {
+    : spec_(spec), session_(std::move(session)) {
   if (!allow_aliasing_data) {
     // Clone data.
     cloned_executable_data_ = {spec.executable_data.begin(),
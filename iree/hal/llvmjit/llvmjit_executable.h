@@ -15,14 +15,15 @@
 #ifndef IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 #define IREE_HAL_LLVMJIT_LLVMJIT_EXECUTABLE_H_
 
+#include <memory>
 #include <vector>
 
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
 #include "iree/hal/host/host_executable.h"
-#include "iree/schemas/llvmir_executable_def_generated.h"
-#include "llvm/ADT/ArrayRef.h"
-#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "iree/hal/llvmjit/llvmjit_session.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
 
 namespace iree {
 namespace hal {
@@ -32,11 +33,12 @@ struct MemrefType;
 
 class LLVMJITExecutable final : public HostExecutable {
  public:
-  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(ExecutableSpec spec,
-                                                   bool allow_aliasing_data);
+  static StatusOr<ref_ptr<LLVMJITExecutable>> Load(
+      std::shared_ptr<LLVMJITSession> session, ExecutableSpec spec,
+      bool allow_aliasing_data, bool allow_persistent_caching);
 
   LLVMJITExecutable(ExecutableSpec spec,
-                    std::unique_ptr<llvm::orc::LLJIT> ll_jit,
+                    std::shared_ptr<LLVMJITSession> session,
                     bool allow_aliasing_data);
   ~LLVMJITExecutable() override;
 
@@ -50,7 +52,8 @@ class LLVMJITExecutable final : public HostExecutable {
  private:
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
-  std::unique_ptr<llvm::orc::LLJIT> ll_jit_;
+  // Keeps the JIT-compiled code referenced by |symbols_| alive.
+  std::shared_ptr<LLVMJITSession> session_;
   llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols_;
 };
 
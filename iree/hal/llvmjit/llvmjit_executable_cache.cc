@@ -14,6 +14,8 @@
 
 #include "iree/hal/llvmjit/llvmjit_executable_cache.h"
 
+#include <utility>
+
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/executable_format.h"
@@ -23,7 +25,9 @@ namespace iree {
 namespace hal {
 namespace llvmjit {
 
-LLVMJITExecutableCache::LLVMJITExecutableCache() = default;
+LLVMJITExecutableCache::LLVMJITExecutableCache(
+    std::shared_ptr<LLVMJITSession> session)
+    : session_(std::move(session)) {}
 
 LLVMJITExecutableCache::~LLVMJITExecutableCache() = default;
 
@@ -39,8 +43,12 @@ StatusOr<ref_ptr<Executable>> LLVMJITExecutableCache::PrepareExecutable(
   // Wrap the data (or copy it).
   bool allow_aliasing_data =
       AllBitsSet(mode, ExecutableCachingMode::kAliasProvidedData);
-  IREE_ASSIGN_OR_RETURN(auto executable,
-                        LLVMJITExecutable::Load(spec, !allow_aliasing_data));
+  bool allow_persistent_caching =
+      AllBitsSet(mode, ExecutableCachingMode::kAllowPersistentCaching);
+  IREE_ASSIGN_OR_RETURN(
+      auto executable,
+      LLVMJITExecutable::Load(session_, spec, allow_aliasing_data,
+                              allow_persistent_caching));
 
   return executable;
 }
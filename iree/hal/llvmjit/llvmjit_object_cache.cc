@@ -0,0 +1,149 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "iree/base/file_path.h"
+#include "iree/base/logging.h"
+#include "iree/base/tracing.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// static
+std::string LLVMJITObjectCache::ComputeKey(
+    absl::Span<const uint8_t> llvmir_module) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::ComputeKey");
+  std::string host_description =
+      absl::StrCat(LLVM_VERSION_STRING, ";", llvm::sys::getProcessTriple(), ";",
+                   llvm::sys::getHostCPUName().str(), ";");
+  auto target_machine_builder =
+      llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (target_machine_builder) {
+    absl::StrAppend(&host_description,
+                    target_machine_builder->getFeatures().getString());
+  } else {
+    llvm::consumeError(target_machine_builder.takeError());
+  }
+
+  llvm::SHA1 hasher;
+  hasher.update(host_description);
+  hasher.update(llvm::ArrayRef<uint8_t>(llvmir_module.data(),
+                                        llvmir_module.size()));
+  return llvm::toHex(hasher.result(), /*LowerCase=*/true);
+}
+
+LLVMJITObjectCache::LLVMJITObjectCache(std::string cache_dir)
+    : cache_dir_(std::move(cache_dir)) {}
+
+LLVMJITObjectCache::~LLVMJITObjectCache() = default;
+
+// static
+std::string LLVMJITObjectCache::GetObjectName(
+    absl::string_view module_identifier) {
+  return absl::StrCat(module_identifier, ".o");
+}
+
+std::string LLVMJITObjectCache::GetEntryPath(absl::string_view name) const {
+  return file_path::JoinPaths(cache_dir_, name);
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::Lookup(
+    absl::string_view name) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Lookup");
+  auto buffer_or =
+      llvm::MemoryBuffer::getFile(GetEntryPath(name), /*FileSize=*/-1,
+                                  /*RequiresNullTerminator=*/false);
+  if (!buffer_or) return nullptr;
+  return std::move(buffer_or.get());
+}
+
+bool LLVMJITObjectCache::Contains(absl::string_view name) {
+  return llvm::sys::fs::exists(GetEntryPath(name));
+}
+
+void LLVMJITObjectCache::Store(absl::string_view name, llvm::StringRef data) {
+  IREE_TRACE_SCOPE0("LLVMJITObjectCache::Store");
+  std::error_code error_code =
+      llvm::sys::fs::create_directories(cache_dir_, /*IgnoreExisting=*/true);
+  if (error_code) {
+    LOG(WARNING) << "Unable to create LLVM JIT cache directory '" << cache_dir_
+                 << "': " << error_code.message();
+    return;
+  }
+
+  // Write to a unique temporary file and rename it into place so that readers
+  // in other processes never observe a partially written entry.
+  std::string entry_path = GetEntryPath(name);
+  int temp_fd = -1;
+  llvm::SmallString<128> temp_path;
+  error_code = llvm::sys::fs::createUniqueFile(entry_path + ".%%%%%%.tmp",
+                                               temp_fd, temp_path);
+  if (error_code) {
+    LOG(WARNING) << "Unable to create LLVM JIT cache file for '" << entry_path
+                 << "': " << error_code.message();
+    return;
+  }
+  {
+    llvm::raw_fd_ostream stream(temp_fd, /*shouldClose=*/true);
+    stream << data;
+    stream.close();
+    if (stream.has_error()) {
+      LOG(WARNING) << "Unable to write LLVM JIT cache file '"
+                   << temp_path.str().str()
+                   << "': " << stream.error().message();
+      stream.clear_error();
+      llvm::sys::fs::remove(temp_path);
+      return;
+    }
+  }
+  error_code = llvm::sys::fs::rename(temp_path, entry_path);
+  if (error_code) {
+    LOG(WARNING) << "Unable to move LLVM JIT cache file into place at '"
+                 << entry_path << "': " << error_code.message();
+    llvm::sys::fs::remove(temp_path);
+  }
+}
+
+void LLVMJITObjectCache::notifyObjectCompiled(const llvm::Module* module,
+                                              llvm::MemoryBufferRef object) {
+  const std::string& module_identifier = module->getModuleIdentifier();
+  if (module_identifier.empty()) return;
+  Store(GetObjectName(module_identifier), object.getBuffer());
+}
+
+std::unique_ptr<llvm::MemoryBuffer> LLVMJITObjectCache::getObject(
+    const llvm::Module* module) {
+  const std::string& module_identifier = module->getModuleIdentifier();
+  if (module_identifier.empty()) return nullptr;
+  return Lookup(GetObjectName(module_identifier));
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,81 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// An ORC object cache that persists compiled objects to a directory on disk.
+//
+// Objects are keyed by the identifier of the module they were compiled from,
+// which is expected to be derived from a key produced by ComputeKey. Modules
+// with an empty identifier are never cached; this allows callers to opt
+// individual modules out of persistence while sharing the same compile layer.
+//
+// Besides objects the cache can hold arbitrary named entries such as manifests
+// describing how a module was partitioned. Entries are written to a temporary
+// file and renamed into place so that multiple processes may share the same
+// cache directory.
+class LLVMJITObjectCache final : public llvm::ObjectCache {
+ public:
+  // Returns a key identifying the object produced by compiling |llvmir_module|
+  // for the host. The key includes the host target triple, CPU, and features
+  // as well as the LLVM version so that stale or foreign objects are ignored.
+  static std::string ComputeKey(absl::Span<const uint8_t> llvmir_module);
+
+  // Returns the name of the entry holding the object compiled from the module
+  // with the given identifier.
+  static std::string GetObjectName(absl::string_view module_identifier);
+
+  explicit LLVMJITObjectCache(std::string cache_dir);
+  ~LLVMJITObjectCache() override;
+
+  // Returns the contents of the entry |name| or nullptr if it is not present.
+  std::unique_ptr<llvm::MemoryBuffer> Lookup(absl::string_view name);
+
+  // Returns true if the entry |name| is present.
+  bool Contains(absl::string_view name);
+
+  // Writes |data| to the entry |name|, replacing any existing contents.
+  // The cache is best-effort and failures are logged and otherwise ignored.
+  void Store(absl::string_view name, llvm::StringRef data);
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+  std::unique_ptr<llvm::MemoryBuffer> getObject(
+      const llvm::Module* module) override;
+
+ private:
+  std::string GetEntryPath(absl::string_view name) const;
+
+  std::string cache_dir_;
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_OBJECT_CACHE_H_
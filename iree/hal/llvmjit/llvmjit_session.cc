@@ -0,0 +1,351 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/llvmjit/llvmjit_session.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "iree/base/tracing.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ExecutionEngine/Orc/CompileUtils.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Transforms/Utils/SplitModule.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+namespace {
+
+// Modules are split into more partitions than there are compile threads so
+// that a few expensive functions do not leave the remaining threads idle.
+constexpr int kPartitionsPerCompileThread = 4;
+
+// Name of the cache entry listing the partitions compiled for a module.
+std::string GetManifestName(const std::string& key) {
+  return absl::StrCat(key, ".manifest");
+}
+
+bool HasDefinitions(const llvm::Module& module) {
+  for (const auto& global_value : module.global_values()) {
+    if (!global_value.isDeclaration()) return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+// static
+StatusOr<std::shared_ptr<LLVMJITSession>> LLVMJITSession::Create(
+    Options options) {
+  IREE_TRACE_SCOPE0("LLVMJITSession::Create");
+
+  std::unique_ptr<LLVMJITObjectCache> object_cache;
+  if (!options.cache_dir.empty()) {
+    object_cache =
+        std::make_unique<LLVMJITObjectCache>(std::move(options.cache_dir));
+  }
+
+  auto target_machine_builder =
+      llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!target_machine_builder) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't detect the host target: "
+           << llvm::toString(target_machine_builder.takeError());
+  }
+
+  // The concurrent compiler creates a target machine per compile and routes
+  // all objects through the (optional) object cache. With compile threads
+  // LLJIT dispatches each materialization to its thread pool.
+  auto* object_cache_ptr = object_cache.get();
+  auto ll_jit_or =
+      llvm::orc::LLJITBuilder()
+          .setJITTargetMachineBuilder(std::move(*target_machine_builder))
+          .setNumCompileThreads(
+              static_cast<unsigned>(std::max(0, options.compile_thread_count)))
+          .setCompileFunctionCreator(
+              [object_cache_ptr](llvm::orc::JITTargetMachineBuilder
+                                     target_machine_builder)
+                  -> llvm::Expected<std::unique_ptr<
+                      llvm::orc::IRCompileLayer::IRCompiler>> {
+                return std::make_unique<llvm::orc::ConcurrentIRCompiler>(
+                    std::move(target_machine_builder), object_cache_ptr);
+              })
+          .create();
+  if (!ll_jit_or) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't create LLJIT session: "
+           << llvm::toString(ll_jit_or.takeError());
+  }
+
+  return std::shared_ptr<LLVMJITSession>(
+      new LLVMJITSession(std::move(object_cache), std::move(ll_jit_or.get()),
+                         options.compile_thread_count));
+}
+
+LLVMJITSession::LLVMJITSession(std::unique_ptr<LLVMJITObjectCache> object_cache,
+                               std::unique_ptr<llvm::orc::LLJIT> ll_jit,
+                               int compile_thread_count)
+    : object_cache_(std::move(object_cache)),
+      ll_jit_(std::move(ll_jit)),
+      compile_thread_count_(compile_thread_count) {}
+
+LLVMJITSession::~LLVMJITSession() = default;
+
+std::vector<std::unique_ptr<llvm::MemoryBuffer>>
+LLVMJITSession::LookupCachedObjects(const std::string& key) {
+  IREE_TRACE_SCOPE0("LLVMJITSession::LookupCachedObjects");
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> objects;
+  auto manifest = object_cache_->Lookup(GetManifestName(key));
+  if (!manifest) return objects;
+
+  // Ensure all objects are present before adding any as they cannot be
+  // removed from the JITDylib once added.
+  llvm::SmallVector<llvm::StringRef, 8> partition_ids;
+  manifest->getBuffer().split(partition_ids, '\n', /*MaxSplit=*/-1,
+                              /*KeepEmpty=*/false);
+  objects.reserve(partition_ids.size());
+  for (auto partition_id : partition_ids) {
+    auto object = object_cache_->Lookup(LLVMJITObjectCache::GetObjectName(
+        absl::string_view(partition_id.data(), partition_id.size())));
+    if (!object) {
+      objects.clear();
+      return objects;
+    }
+    objects.push_back(std::move(object));
+  }
+  return objects;
+}
+
+void LLVMJITSession::WriteManifest(
+    const std::string& key, absl::Span<const std::string> partition_ids) {
+  // Partitions that were never needed by an entry point are never compiled and
+  // are omitted; they are not needed by later loads either.
+  std::string manifest;
+  for (const auto& partition_id : partition_ids) {
+    if (!object_cache_->Contains(
+            LLVMJITObjectCache::GetObjectName(partition_id))) {
+      continue;
+    }
+    absl::StrAppend(&manifest, partition_id, "\n");
+  }
+  if (manifest.empty()) return;
+  object_cache_->Store(GetManifestName(key), manifest);
+}
+
+Status LLVMJITSession::PrepareModule(const std::string& key,
+                                     absl::Span<const uint8_t> llvmir_module,
+                                     int partition_count,
+                                     bool use_object_cache,
+                                     ModuleContents* out_contents) {
+  IREE_TRACE_SCOPE0("LLVMJITSession::PrepareModule");
+
+  if (use_object_cache) {
+    // Warm start: link the previously compiled objects directly.
+    out_contents->cached_objects = LookupCachedObjects(key);
+    if (!out_contents->cached_objects.empty()) return OkStatus();
+  }
+
+  // parseIR detects whether the module is bitcode or text.
+  llvm::MemoryBufferRef mem_buffer(
+      llvm::StringRef(reinterpret_cast<const char*>(llvmir_module.data()),
+                      llvmir_module.size()),
+      "llvm-ir");
+  llvm::orc::ThreadSafeContext thread_safe_context(
+      std::make_unique<llvm::LLVMContext>());
+  llvm::SMDiagnostic sm_diagnostic;
+  auto module = llvm::parseIR(mem_buffer, sm_diagnostic,
+                              *thread_safe_context.getContext());
+  if (!module) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Can't parse LLVMIR Module: " << sm_diagnostic.getMessage().str();
+  }
+
+  // Split the module so that partitions can be compiled concurrently. Each
+  // partition is moved into its own context as ORC serializes compilation of
+  // modules sharing a context. Local symbols are promoted so that they can be
+  // referenced across partitions.
+  auto& partitions = out_contents->partitions;
+  if (partition_count > 1) {
+    IREE_TRACE_SCOPE0("LLVMJITSession::PrepareModule#split");
+    llvm::SplitModule(
+        std::move(module), static_cast<unsigned>(partition_count),
+        [&](std::unique_ptr<llvm::Module> partition_module) {
+          if (!HasDefinitions(*partition_module)) return;
+          llvm::orc::ThreadSafeModule partition(std::move(partition_module),
+                                                thread_safe_context);
+          partitions.push_back(llvm::orc::cloneToNewContext(partition));
+        },
+        /*PreserveLocals=*/false);
+  } else {
+    partitions.emplace_back(std::move(module), thread_safe_context);
+  }
+
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    // The object cache uses the module identifier as its key and ignores
+    // modules with an empty identifier.
+    std::string partition_id;
+    if (use_object_cache) {
+      partition_id = absl::StrCat(key, "-", partition_count, "-", i);
+      out_contents->partition_ids.push_back(partition_id);
+    }
+    partitions[i].withModuleDo([&](llvm::Module& partition_module) {
+      partition_module.setModuleIdentifier(partition_id);
+    });
+  }
+  return OkStatus();
+}
+
+StatusOr<llvm::orc::JITDylib*> LLVMJITSession::CreateJITDylib(
+    const std::string& key, ModuleContents* contents) {
+  IREE_TRACE_SCOPE0("LLVMJITSession::CreateJITDylib");
+
+  auto jit_dylib_or = ll_jit_->createJITDylib(
+      absl::StrCat("iree_", key, "_", next_jit_dylib_id_++));
+  if (!jit_dylib_or) {
+    return InternalErrorBuilder(IREE_LOC)
+           << "Can't create JITDylib: "
+           << llvm::toString(jit_dylib_or.takeError());
+  }
+  auto& jit_dylib = jit_dylib_or.get();
+
+  auto dylib_search_generator =
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          ll_jit_->getDataLayout().getGlobalPrefix());
+  if (!dylib_search_generator) {
+    return UnavailableErrorBuilder(IREE_LOC)
+           << "Can't resolve symbols in current process: "
+           << llvm::toString(dylib_search_generator.takeError());
+  }
+  jit_dylib.addGenerator(std::move(dylib_search_generator.get()));
+
+  for (auto& object : contents->cached_objects) {
+    llvm::Error err = ll_jit_->addObjectFile(jit_dylib, std::move(object));
+    if (err) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't add cached object to LLJIT: "
+             << llvm::toString(std::move(err));
+    }
+  }
+  for (auto& partition : contents->partitions) {
+    llvm::Error err = ll_jit_->addIRModule(jit_dylib, std::move(partition));
+    if (err) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Can't add executable module to LLJIT: "
+             << llvm::toString(std::move(err));
+    }
+  }
+  return &jit_dylib;
+}
+
+llvm::orc::JITDylib* LLVMJITSession::FindJITDylib(const std::string& key,
+                                                  bool use_object_cache) {
+  auto it = jit_dylibs_.find(key);
+  if (it == jit_dylibs_.end()) return nullptr;
+  if (use_object_cache && !it->second.persistent) return nullptr;
+  return it->second.jit_dylib;
+}
+
+StatusOr<llvm::SmallVector<llvm::JITEvaluatedSymbol, 4>>
+LLVMJITSession::LoadModule(absl::Span<const uint8_t> llvmir_module,
+                           absl::Span<const std::string> entry_point_names,
+                           bool allow_persistent_caching) {
+  IREE_TRACE_SCOPE0("LLVMJITSession::LoadModule");
+
+  std::string key = LLVMJITObjectCache::ComputeKey(llvmir_module);
+  int partition_count = 1;
+  if (compile_thread_count_ > 0) {
+    partition_count =
+        std::min(static_cast<int>(entry_point_names.size()),
+                 compile_thread_count_ * kPartitionsPerCompileThread);
+    partition_count = std::max(1, partition_count);
+  }
+
+  bool use_object_cache = object_cache_ && allow_persistent_caching;
+  llvm::orc::JITDylib* jit_dylib = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    jit_dylib = FindJITDylib(key, use_object_cache);
+  }
+
+  std::vector<std::string> partition_ids;
+  if (!jit_dylib) {
+    // Parse and split the module without holding the lock so that loads of
+    // other modules are not serialized behind it. Concurrent first loads of the
+    // same module may each prepare it but only the first to finish adds it to
+    // the session; the others drop their copy and reuse that JITDylib.
+    ModuleContents contents;
+    IREE_RETURN_IF_ERROR(PrepareModule(key, llvmir_module, partition_count,
+                                       use_object_cache, &contents));
+    absl::MutexLock lock(&mutex_);
+    jit_dylib = FindJITDylib(key, use_object_cache);
+    if (!jit_dylib) {
+      // Code already resolved from a replaced JITDylib remains valid as
+      // JITDylibs are never removed from the session.
+      IREE_ASSIGN_OR_RETURN(jit_dylib, CreateJITDylib(key, &contents));
+      jit_dylibs_[key] = {jit_dylib, use_object_cache};
+      partition_ids = std::move(contents.partition_ids);
+    }
+  }
+
+  // Look up all entry points at once so that the partitions defining them are
+  // materialized concurrently. Concurrent loads of the same module wait here
+  // for the in-flight compilation to complete.
+  llvm::orc::SymbolLookupSet lookup_set;
+  std::vector<llvm::orc::SymbolStringPtr> mangled_names;
+  mangled_names.reserve(entry_point_names.size());
+  for (const auto& func_name : entry_point_names) {
+    mangled_names.push_back(ll_jit_->mangleAndIntern(func_name));
+    lookup_set.add(mangled_names.back());
+  }
+  auto symbol_map_or = ll_jit_->getExecutionSession().lookup(
+      llvm::orc::makeJITDylibSearchOrder(jit_dylib), lookup_set);
+  if (!symbol_map_or) {
+    // Forget the JITDylib so that the next load of the module starts over
+    // instead of failing against the same definitions.
+    absl::MutexLock lock(&mutex_);
+    auto it = jit_dylibs_.find(key);
+    if (it != jit_dylibs_.end() && it->second.jit_dylib == jit_dylib) {
+      jit_dylibs_.erase(it);
+    }
+    return NotFoundErrorBuilder(IREE_LOC)
+           << "Can't JIT compile entry points: "
+           << llvm::toString(symbol_map_or.takeError());
+  }
+
+  llvm::SmallVector<llvm::JITEvaluatedSymbol, 4> symbols;
+  symbols.reserve(mangled_names.size());
+  for (const auto& mangled_name : mangled_names) {
+    symbols.push_back((*symbol_map_or)[mangled_name]);
+  }
+
+  if (!partition_ids.empty()) {
+    WriteManifest(key, partition_ids);
+  }
+  return symbols;
+}
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,151 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_LLVMJIT_LLVMJIT_SESSION_H_
+#define IREE_HAL_LLVMJIT_LLVMJIT_SESSION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/hal/llvmjit/llvmjit_object_cache.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ExecutionEngine/JITSymbol.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+namespace iree {
+namespace hal {
+namespace llvmjit {
+
+// A JIT session shared by all executables loaded by a driver.
+//
+// Each unique LLVM IR module is compiled once into its own JITDylib and
+// subsequent loads of the same module within the process reuse the existing
+// code. When a cache directory is provided compiled objects are also persisted
+// to disk so that later processes can skip parsing and codegen entirely.
+//
+// When compile threads are available modules are split into partitions that
+// are compiled concurrently on a bounded thread pool.
+//
+// JITDylibs cannot be removed from a session and the code for a module remains
+// resident until the session is destroyed. Executables retain a reference to
+// the session to keep their code alive.
+//
+// Thread-safe.
+class LLVMJITSession final {
+ public:
+  struct Options {
+    // Directory used to persist compiled objects across processes.
+    // Persistent caching is disabled when empty.
+    std::string cache_dir;
+
+    // Number of threads used to compile module partitions concurrently.
+    // 0 compiles each module as a whole on the thread loading it.
+    int compile_thread_count = 0;
+  };
+
+  static StatusOr<std::shared_ptr<LLVMJITSession>> Create(Options options);
+
+  ~LLVMJITSession();
+
+  // Loads the LLVM IR |llvmir_module| (bitcode or text) and resolves the given
+  // entry point functions, returning their symbols in order.
+  //
+  // Only loads with |allow_persistent_caching| may read from or populate the
+  // on-disk object cache.
+  StatusOr<llvm::SmallVector<llvm::JITEvaluatedSymbol, 4>> LoadModule(
+      absl::Span<const uint8_t> llvmir_module,
+      absl::Span<const std::string> entry_point_names,
+      bool allow_persistent_caching);
+
+ private:
+  LLVMJITSession(std::unique_ptr<LLVMJITObjectCache> object_cache,
+                 std::unique_ptr<llvm::orc::LLJIT> ll_jit,
+                 int compile_thread_count);
+
+  // The contents of a module ready to be added to a JITDylib: either the
+  // objects previously compiled for it or its IR split into partitions.
+  struct ModuleContents {
+    std::vector<std::unique_ptr<llvm::MemoryBuffer>> cached_objects;
+    std::vector<llvm::orc::ThreadSafeModule> partitions;
+    // Identifiers of |partitions| if they are compiled with persistent caching
+    // so that a manifest can be written once they have been compiled.
+    std::vector<std::string> partition_ids;
+  };
+
+  // Prepares |llvmir_module| for loading by reading its cached objects or, if
+  // not cached, by parsing it and splitting it into |partition_count|
+  // partitions. Only reads the object cache and does not require |mutex_|.
+  Status PrepareModule(const std::string& key,
+                       absl::Span<const uint8_t> llvmir_module,
+                       int partition_count, bool use_object_cache,
+                       ModuleContents* out_contents);
+
+  // Returns the cached objects listed in the manifest for |key| or an empty
+  // list if the manifest or any of its objects are not present.
+  std::vector<std::unique_ptr<llvm::MemoryBuffer>> LookupCachedObjects(
+      const std::string& key);
+
+  // Creates a new JITDylib named for |key| and moves |contents| into it.
+  // Each JITDylib gets a unique name so that a module can be added again after
+  // a failed attempt left a partially populated JITDylib in the session.
+  StatusOr<llvm::orc::JITDylib*> CreateJITDylib(const std::string& key,
+                                                ModuleContents* contents)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the JITDylib for |key| or nullptr if there is none that can be
+  // used by a load with the given caching mode.
+  llvm::orc::JITDylib* FindJITDylib(const std::string& key,
+                                    bool use_object_cache)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Writes the manifest for |key| listing the partitions that were compiled.
+  void WriteManifest(const std::string& key,
+                     absl::Span<const std::string> partition_ids);
+
+  // May be nullptr if persistent caching is disabled.
+  // Must outlive |ll_jit_| as it is referenced by the compile layer.
+  std::unique_ptr<LLVMJITObjectCache> object_cache_;
+  std::unique_ptr<llvm::orc::LLJIT> ll_jit_;
+  int compile_thread_count_;
+
+  struct JITDylibEntry {
+    llvm::orc::JITDylib* jit_dylib = nullptr;
+    // True if the JITDylib was loaded from or will populate the object cache.
+    // Loads that allow persistent caching replace entries without it so that
+    // the cache is populated even if the module was first loaded without.
+    bool persistent = false;
+  };
+
+  absl::Mutex mutex_;
+  // JITDylibs keyed by LLVMJITObjectCache::ComputeKey of their source module.
+  // Entries are removed if resolving their entry points fails so that later
+  // loads start over with a new JITDylib.
+  absl::flat_hash_map<std::string, JITDylibEntry> jit_dylibs_
+      ABSL_GUARDED_BY(mutex_);
+  int next_jit_dylib_id_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace llvmjit
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_LLVMJIT_LLVMJIT_SESSION_H_
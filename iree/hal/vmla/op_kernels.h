@@ -35,6 +35,7 @@
 #define IREE_HAL_VMLA_OP_KERNELS_H_
 
 #include <cstdint>
+#include <memory>
 
 #include "absl/types/span.h"
 #include "iree/base/status.h"
@@ -92,16 +93,6 @@ struct CompareGE {
                         absl::Span<uint8_t> dst_buffer);
 };
 
-struct Conv2D {
-  template <typename T>
-  static Status Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
-                        absl::Span<const T> filter_buffer,
-                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
-                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
-                        ShapeSpan pad_w, ShapeSpan lhs_dilation,
-                        ShapeSpan rhs_dilation, const int32_t groups);
-};
-
 struct Copy {
   template <int element_size>
   static Status Execute(absl::Span<const uint8_t> src_buffer,
@@ -127,10 +118,18 @@ struct Finite {
 };
 
 struct Transpose {
+  // Merges dimensions that stay adjacent and then copies whole rows or
+  // transposes cache-sized 2D blocks using the SIMD micro-kernels.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         absl::Span<const int32_t> perm);
+  // Computes the source of each destination element. Used as the reference
+  // for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                                 absl::Span<const int32_t> perm);
 };
 
 struct Pad {
@@ -168,15 +167,64 @@ struct Reverse {
                         absl::Span<const int32_t> dimensions);
 };
 
+// Sorts each row of the innermost dimension in ascending order and writes the
+// indices of the sorted elements. Equal elements keep their original order.
+// Floating-point NaNs are ordered by sign bit: negative NaNs before -inf and
+// positive NaNs after +inf.
 struct Sort {
+  // Radix sorts long rows of integer and float elements. Rows are sorted on
+  // the calling thread as dispatches already run concurrently on the workers
+  // of the host scheduling model.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<int32_t> dst_buffer, ShapeSpan src_shape);
+
+  // std::stable_sort of each row. Used as the reference for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<int32_t> dst_buffer,
+                                 ShapeSpan src_shape);
 };
 
+// Writes the indices of the first k elements of each row of the innermost
+// dimension as ordered by a stable sort, where k is the innermost dimension of
+// |dst_shape|. A descending order selects the k largest elements.
+struct TopK {
+  // NOTE: must match VMLA_SortOrderAttr in VMLABase.td.
+  enum class Order : uint32_t {
+    kAscending = 0,
+    kDescending = 1,
+  };
+
+  template <typename T>
+  static Status Execute(absl::Span<const T> src_buffer,
+                        absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                        ShapeSpan dst_shape, Order order);
+};
+
+// Complex-to-complex FFT over the innermost dimension of split real/imaginary
+// buffers. All leading dimensions are treated as batch dimensions.
 struct Fft {
+  // Caches transform plans (factorizations and twiddle tables) by length so
+  // that they can be reused across batch rows and invocations.
+  struct RuntimeState;
+
+  static std::unique_ptr<RuntimeState> CreateRuntimeState();
+
   template <typename T>
-  static Status Execute(absl::Span<const T> real_src_buffer,
+  static Status Execute(RuntimeState* runtime_state,
+                        absl::Span<const T> real_src_buffer,
+                        absl::Span<const T> imag_src_buffer,
+                        absl::Span<T> real_dst_buffer,
+                        absl::Span<T> imag_dst_buffer, ShapeSpan real_src_shape,
+                        ShapeSpan imag_src_shape);
+};
+
+// Inverse of Fft, including the 1/N normalization.
+struct Ifft {
+  template <typename T>
+  static Status Execute(Fft::RuntimeState* runtime_state,
+                        absl::Span<const T> real_src_buffer,
                         absl::Span<const T> imag_src_buffer,
                         absl::Span<T> real_dst_buffer,
                         absl::Span<T> imag_dst_buffer, ShapeSpan real_src_shape,
@@ -195,10 +243,18 @@ struct Iota {
 };
 
 struct Tile {
+  // Copies each source row into place and then replicates completed tiles
+  // from the innermost dimension outwards.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         ShapeSpan dst_shape);
+  // Computes the source of each destination element. Used as the reference
+  // for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                                 ShapeSpan dst_shape);
 };
 
 struct Not {
@@ -303,21 +359,39 @@ struct Pow {
 };
 
 struct Exp {
+  // Uses the vectorized kernel when one is available for T and the CPU.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer);
+
+  // Scalar C++ implementation. Used as the reference for the vectorized kernel.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer);
 };
 
 struct Log {
+  // Uses the vectorized kernel when one is available for T and the CPU.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer);
+
+  // Scalar C++ implementation. Used as the reference for the vectorized kernel.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer);
 };
 
 struct Rsqrt {
+  // Uses the vectorized kernel when one is available for T and the CPU.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer);
+
+  // Scalar C++ implementation. Used as the reference for the vectorized kernel.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer);
 };
 
 struct Sqrt {
@@ -339,9 +413,15 @@ struct Sin {
 };
 
 struct Tanh {
+  // Uses the vectorized kernel when one is available for T and the CPU.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<T> dst_buffer);
+
+  // Scalar C++ implementation. Used as the reference for the vectorized kernel.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<T> dst_buffer);
 };
 
 struct Atan2 {
@@ -397,6 +477,52 @@ struct Convert {
                         absl::Span<DST> dst_buffer);
 };
 
+// Evaluates a fused chain of elementwise ops with a small register program.
+//
+// Elements are processed in blocks of kBlockSize so that intermediate values
+// stay in cache instead of being materialized to full buffers between ops.
+//
+// Program layout (int32 words):
+//   [0] input count (N)
+//   [1] instruction count (M)
+//   then M instructions of kInstructionWordCount words each:
+//     opcode, operand0, operand1, operand2
+// Registers [0, N) are the source buffers and register N + i holds the result
+// of instruction i. Operands reference prior registers, except for kConstant
+// whose operand0 is the bit pattern of the element value. The result of the
+// last instruction is written to the destination buffer.
+struct FusedElementwise {
+  // NOTE: must match VMLA_FusedOpcodeAttr in VMLABase.td.
+  enum class Opcode : int32_t {
+    kConstant = 0,
+    kAdd = 1,
+    kSub = 2,
+    kMul = 3,
+    kDiv = 4,
+    kMin = 5,
+    kMax = 6,
+    kNeg = 7,
+    kAbs = 8,
+    kExp = 9,
+    kLog = 10,
+    kSqrt = 11,
+    kRsqrt = 12,
+    kTanh = 13,
+    kFloor = 14,
+    kCeil = 15,
+    kClamp = 16,
+  };
+
+  static constexpr int kInstructionWordCount = 4;
+  static constexpr int kMaxInstructionCount = 16;
+  static constexpr int kBlockSize = 256;
+
+  template <typename T>
+  static Status Execute(absl::Span<const int32_t> program,
+                        absl::Span<const absl::Span<const T>> src_buffers,
+                        absl::Span<T> dst_buffer);
+};
+
 struct MatMul {
   struct RuntimeState;
 
@@ -426,60 +552,169 @@ struct MatMul {
                         const Buffers<T, ACC>& buffers);
 };
 
+// 2D (grouped) convolution of a single HWC input example with an HWIO filter
+// producing an HWC output. The filter input dimension spans all input channels
+// and the output dimension is per-group (so depthwise convolutions use a
+// [kh, kw, channels, channel_multiplier] filter). The destination is
+// overwritten.
+struct Conv2D {
+  // Selects the fastest implementation supporting the given attributes.
+  template <typename T>
+  static Status Execute(MatMul::RuntimeState* runtime_state,
+                        absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                        absl::Span<const T> filter_buffer,
+                        ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                        ShapeSpan dst_shape, ShapeSpan strides, ShapeSpan pad_h,
+                        ShapeSpan pad_w, ShapeSpan lhs_dilation,
+                        ShapeSpan rhs_dilation, const int32_t groups);
+
+  // Direct loop nest supporting all attributes. Used as the reference for the
+  // other implementations.
+  template <typename T>
+  static Status ExecuteReference(
+      absl::Span<const T> input_buffer, ShapeSpan input_shape,
+      absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+      absl::Span<T> dst_buffer, ShapeSpan dst_shape, ShapeSpan strides,
+      ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
+      ShapeSpan rhs_dilation, const int32_t groups);
+
+  // Packs input patches into an im2col matrix and performs one GEMM per group.
+  // 1x1 convolutions without striding or padding use the input directly.
+  // Requires a floating-point T and no lhs (input) dilation.
+  template <typename T>
+  static Status ExecuteIm2Col(
+      MatMul::RuntimeState* runtime_state, absl::Span<const T> input_buffer,
+      ShapeSpan input_shape, absl::Span<const T> filter_buffer,
+      ShapeSpan filter_shape, absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+      ShapeSpan strides, ShapeSpan pad_h, ShapeSpan pad_w,
+      ShapeSpan lhs_dilation, ShapeSpan rhs_dilation, const int32_t groups);
+
+  // Direct depthwise convolution vectorized over the channel dimension.
+  // Requires one input channel per group (groups == input channels).
+  template <typename T>
+  static Status ExecuteDepthwise(
+      absl::Span<const T> input_buffer, ShapeSpan input_shape,
+      absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+      absl::Span<T> dst_buffer, ShapeSpan dst_shape, ShapeSpan strides,
+      ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
+      ShapeSpan rhs_dilation, const int32_t groups);
+};
+
 struct RuntimeState {
   std::unique_ptr<MatMul::RuntimeState> mat_mul_state =
       MatMul::CreateRuntimeState();
+  std::unique_ptr<Fft::RuntimeState> fft_state = Fft::CreateRuntimeState();
 };
 
 struct ReduceSum {
+  // Reduces contiguous rows, vectorized along the innermost dimension.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
                         ShapeSpan src_shape, ShapeSpan dst_shape);
+
+  // Visits each element by index. Used as the reference for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, int32_t dimension,
+                                 ShapeSpan src_shape, ShapeSpan dst_shape);
 };
 
 struct ReduceMin {
+  // Reduces contiguous rows, vectorized along the innermost dimension.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
                         ShapeSpan src_shape, ShapeSpan dst_shape);
+
+  // Visits each element by index. Used as the reference for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, int32_t dimension,
+                                 ShapeSpan src_shape, ShapeSpan dst_shape);
 };
 
 struct ReduceMax {
+  // Reduces contiguous rows, vectorized along the innermost dimension.
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, int32_t dimension,
                         ShapeSpan src_shape, ShapeSpan dst_shape);
+
+  // Visits each element by index. Used as the reference for Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, int32_t dimension,
+                                 ShapeSpan src_shape, ShapeSpan dst_shape);
 };
 
 struct PoolingSum {
+  // Pools whole rows of the innermost dimension at a time when it is not
+  // windowed (such as the channels of NHWC pooling).
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         ShapeSpan dst_shape, ShapeSpan window_dimensions,
                         ShapeSpan strides, ShapeSpan pad_low);
+
+  // Computes each output element independently. Used as the reference for
+  // Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                                 ShapeSpan dst_shape,
+                                 ShapeSpan window_dimensions, ShapeSpan strides,
+                                 ShapeSpan pad_low);
 };
 
 struct PoolingMin {
+  // Pools whole rows of the innermost dimension at a time when it is not
+  // windowed (such as the channels of NHWC pooling).
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         ShapeSpan dst_shape, ShapeSpan window_dimensions,
                         ShapeSpan strides, ShapeSpan pad_low);
+
+  // Computes each output element independently. Used as the reference for
+  // Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                                 ShapeSpan dst_shape,
+                                 ShapeSpan window_dimensions, ShapeSpan strides,
+                                 ShapeSpan pad_low);
 };
 
 struct PoolingMax {
+  // Pools whole rows of the innermost dimension at a time when it is not
+  // windowed (such as the channels of NHWC pooling).
   template <typename T>
   static Status Execute(absl::Span<const T> src_buffer,
                         absl::Span<const T> init_buffer,
                         absl::Span<T> dst_buffer, ShapeSpan src_shape,
                         ShapeSpan dst_shape, ShapeSpan window_dimensions,
                         ShapeSpan strides, ShapeSpan pad_low);
+
+  // Computes each output element independently. Used as the reference for
+  // Execute.
+  template <typename T>
+  static Status ExecuteReference(absl::Span<const T> src_buffer,
+                                 absl::Span<const T> init_buffer,
+                                 absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                                 ShapeSpan dst_shape,
+                                 ShapeSpan window_dimensions, ShapeSpan strides,
+                                 ShapeSpan pad_low);
 };
 
 }  // namespace kernels
@@ -0,0 +1,433 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <numeric>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "benchmark/benchmark.h"
+#include "iree/base/status.h"
+#include "iree/hal/vmla/op_kernels.h"
+#include "iree/hal/vmla/op_kernels_simd.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace {
+
+using Shape = absl::InlinedVector<int32_t, 4>;
+
+enum class Conv2DImpl {
+  kReference,
+  kIm2Col,
+  kDepthwise,
+};
+
+// Benchmarks a stride 1 'same' padded convolution of a square |size| x |size|
+// image. |groups| of 0 selects a depthwise convolution.
+void RunConv2D(benchmark::State& state, Conv2DImpl impl, int32_t kernel_size,
+               int32_t input_channels, int32_t output_channels,
+               int32_t groups) {
+  const int32_t size = static_cast<int32_t>(state.range(0));
+  if (groups == 0) groups = input_channels;
+  const int32_t pad = kernel_size / 2;
+  Shape input_shape = {size, size, input_channels};
+  Shape filter_shape = {kernel_size, kernel_size, input_channels,
+                        output_channels / groups};
+  Shape dst_shape = {size, size, output_channels};
+  Shape strides = {1, 1};
+  Shape pad_h = {pad, kernel_size - 1 - pad};
+  Shape pad_w = {pad, kernel_size - 1 - pad};
+  Shape dilation = {1, 1};
+
+  std::vector<float> input_buffer(GetElementCount(input_shape));
+  for (size_t i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = static_cast<float>(i % 13) * 0.25f;
+  }
+  std::vector<float> filter_buffer(GetElementCount(filter_shape));
+  for (size_t i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = static_cast<float>(i % 7) * 0.5f - 1.5f;
+  }
+  std::vector<float> dst_buffer(GetElementCount(dst_shape));
+
+  RuntimeState runtime_state;
+  for (auto _ : state) {
+    Status status;
+    switch (impl) {
+      case Conv2DImpl::kReference:
+        status = Conv2D::ExecuteReference<float>(
+            input_buffer, input_shape, filter_buffer, filter_shape,
+            absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h, pad_w,
+            dilation, dilation, groups);
+        break;
+      case Conv2DImpl::kIm2Col:
+        status = Conv2D::ExecuteIm2Col<float>(
+            runtime_state.mat_mul_state.get(), input_buffer, input_shape,
+            filter_buffer, filter_shape, absl::MakeSpan(dst_buffer), dst_shape,
+            strides, pad_h, pad_w, dilation, dilation, groups);
+        break;
+      case Conv2DImpl::kDepthwise:
+        status = Conv2D::ExecuteDepthwise<float>(
+            input_buffer, input_shape, filter_buffer, filter_shape,
+            absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h, pad_w,
+            dilation, dilation, groups);
+        break;
+    }
+    IREE_CHECK_OK(status);
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+
+  const int64_t macs_per_iteration =
+      static_cast<int64_t>(size) * size * output_channels * kernel_size *
+      kernel_size * (input_channels / groups);
+  state.counters["FLOPS"] =
+      benchmark::Counter(2 * macs_per_iteration * state.iterations(),
+                         benchmark::Counter::kIsRate);
+}
+
+// 3x3 convolution typical of the body of a ResNet-style model.
+static void BM_Conv2D3x3Reference(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kReference, 3, 32, 32, 1);
+}
+BENCHMARK(BM_Conv2D3x3Reference)->Arg(16)->Arg(56);
+
+static void BM_Conv2D3x3Im2Col(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kIm2Col, 3, 32, 32, 1);
+}
+BENCHMARK(BM_Conv2D3x3Im2Col)->Arg(16)->Arg(56);
+
+// 1x1 pointwise convolution; the im2col path multiplies the input directly.
+static void BM_Conv2D1x1Reference(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kReference, 1, 64, 128, 1);
+}
+BENCHMARK(BM_Conv2D1x1Reference)->Arg(16)->Arg(56);
+
+static void BM_Conv2D1x1Im2Col(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kIm2Col, 1, 64, 128, 1);
+}
+BENCHMARK(BM_Conv2D1x1Im2Col)->Arg(16)->Arg(56);
+
+// 3x3 depthwise convolution as used by MobileNet-style models.
+static void BM_DepthwiseConv2D3x3Reference(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kReference, 3, 64, 64, 0);
+}
+BENCHMARK(BM_DepthwiseConv2D3x3Reference)->Arg(16)->Arg(56);
+
+static void BM_DepthwiseConv2D3x3Direct(benchmark::State& state) {
+  RunConv2D(state, Conv2DImpl::kDepthwise, 3, 64, 64, 0);
+}
+BENCHMARK(BM_DepthwiseConv2D3x3Direct)->Arg(16)->Arg(56);
+
+// Batch of 16 forward transforms of the given length.
+static void BM_Fft(benchmark::State& state) {
+  const int32_t length = static_cast<int32_t>(state.range(0));
+  Shape shape = {16, length};
+  std::vector<float> real_src(GetElementCount(shape));
+  std::vector<float> imag_src(real_src.size());
+  for (size_t i = 0; i < real_src.size(); ++i) {
+    real_src[i] = static_cast<float>(i % 17) * 0.125f;
+    imag_src[i] = static_cast<float>(i % 5) * -0.25f;
+  }
+  std::vector<float> real_dst(real_src.size());
+  std::vector<float> imag_dst(real_src.size());
+
+  RuntimeState runtime_state;
+  for (auto _ : state) {
+    IREE_CHECK_OK(Fft::Execute<float>(
+        runtime_state.fft_state.get(), real_src, imag_src,
+        absl::MakeSpan(real_dst), absl::MakeSpan(imag_dst), shape, shape));
+    benchmark::DoNotOptimize(real_dst.data());
+    benchmark::DoNotOptimize(imag_dst.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * real_src.size());
+}
+// Powers of two use only radix-4/2 stages; 400 and 960 also exercise the
+// radix-3 and generic (radix-5) stages.
+BENCHMARK(BM_Fft)->Arg(256)->Arg(400)->Arg(960)->Arg(1024);
+
+// Elementwise transcendental of |state.range(0)| elements. |kReference| selects
+// the scalar C++ loop and otherwise the SIMD kernel for the CPU (if any).
+template <typename KernelType, bool kReference>
+void RunUnary(benchmark::State& state, float scale) {
+  std::vector<float> src_buffer(state.range(0));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = static_cast<float>(i % 101 + 1) * scale;
+  }
+  std::vector<float> dst_buffer(src_buffer.size());
+  if (!kReference) {
+    const simd::Kernels* kernels = simd::GetBestKernels();
+    state.SetLabel(kernels ? kernels->name : "generic");
+  }
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference ? KernelType::template ExecuteReference<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer))
+                             : KernelType::template Execute<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer)));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+
+static void BM_ExpReference(benchmark::State& state) {
+  RunUnary<Exp, true>(state, 0.05f);
+}
+BENCHMARK(BM_ExpReference)->Arg(4096);
+
+static void BM_ExpSimd(benchmark::State& state) {
+  RunUnary<Exp, false>(state, 0.05f);
+}
+BENCHMARK(BM_ExpSimd)->Arg(4096);
+
+static void BM_LogReference(benchmark::State& state) {
+  RunUnary<Log, true>(state, 0.25f);
+}
+BENCHMARK(BM_LogReference)->Arg(4096);
+
+static void BM_LogSimd(benchmark::State& state) {
+  RunUnary<Log, false>(state, 0.25f);
+}
+BENCHMARK(BM_LogSimd)->Arg(4096);
+
+static void BM_TanhReference(benchmark::State& state) {
+  RunUnary<Tanh, true>(state, 0.02f);
+}
+BENCHMARK(BM_TanhReference)->Arg(4096);
+
+static void BM_TanhSimd(benchmark::State& state) {
+  RunUnary<Tanh, false>(state, 0.02f);
+}
+BENCHMARK(BM_TanhSimd)->Arg(4096);
+
+static void BM_RsqrtReference(benchmark::State& state) {
+  RunUnary<Rsqrt, true>(state, 0.25f);
+}
+BENCHMARK(BM_RsqrtReference)->Arg(4096);
+
+static void BM_RsqrtSimd(benchmark::State& state) {
+  RunUnary<Rsqrt, false>(state, 0.25f);
+}
+BENCHMARK(BM_RsqrtSimd)->Arg(4096);
+
+// Sums a [64, 1024] buffer along |dimension|: 1 reduces contiguous rows and 0
+// accumulates rows into the output.
+template <bool kReference>
+void RunReduceSum(benchmark::State& state) {
+  const int32_t dimension = static_cast<int32_t>(state.range(0));
+  Shape src_shape = {64, 1024};
+  Shape dst_shape = {src_shape[1 - dimension]};
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = static_cast<float>(i % 31) * 0.5f;
+  }
+  std::vector<float> init_buffer = {0.0f};
+  std::vector<float> dst_buffer(GetElementCount(dst_shape));
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference ? ReduceSum::ExecuteReference<float>(
+                                   src_buffer, init_buffer,
+                                   absl::MakeSpan(dst_buffer), dimension,
+                                   src_shape, dst_shape)
+                             : ReduceSum::Execute<float>(
+                                   src_buffer, init_buffer,
+                                   absl::MakeSpan(dst_buffer), dimension,
+                                   src_shape, dst_shape));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+
+static void BM_ReduceSumReference(benchmark::State& state) {
+  RunReduceSum<true>(state);
+}
+BENCHMARK(BM_ReduceSumReference)->Arg(0)->Arg(1);
+
+static void BM_ReduceSumStrided(benchmark::State& state) {
+  RunReduceSum<false>(state);
+}
+BENCHMARK(BM_ReduceSumStrided)->Arg(0)->Arg(1);
+
+// 3x3 stride 2 max pooling of a |size| x |size| x 64 NHWC image.
+template <bool kReference>
+void RunPoolingMax(benchmark::State& state) {
+  const int32_t size = static_cast<int32_t>(state.range(0));
+  Shape src_shape = {1, size, size, 64};
+  Shape dst_shape = {1, (size + 1) / 2, (size + 1) / 2, 64};
+  Shape window_dimensions = {1, 3, 3, 1};
+  Shape strides = {1, 2, 2, 1};
+  Shape pad_low = {0, 1, 1, 0};
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = static_cast<float>(i % 23) * 0.25f;
+  }
+  std::vector<float> init_buffer = {-1e30f};
+  std::vector<float> dst_buffer(GetElementCount(dst_shape));
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference ? PoolingMax::ExecuteReference<float>(
+                                   src_buffer, init_buffer,
+                                   absl::MakeSpan(dst_buffer), src_shape,
+                                   dst_shape, window_dimensions, strides,
+                                   pad_low)
+                             : PoolingMax::Execute<float>(
+                                   src_buffer, init_buffer,
+                                   absl::MakeSpan(dst_buffer), src_shape,
+                                   dst_shape, window_dimensions, strides,
+                                   pad_low));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * dst_buffer.size());
+}
+
+static void BM_PoolingMaxReference(benchmark::State& state) {
+  RunPoolingMax<true>(state);
+}
+BENCHMARK(BM_PoolingMaxReference)->Arg(56);
+
+static void BM_PoolingMaxRows(benchmark::State& state) {
+  RunPoolingMax<false>(state);
+}
+BENCHMARK(BM_PoolingMaxRows)->Arg(56);
+
+// Transposes a [state.range(0), state.range(0)] matrix, or with
+// state.range(1) set the [8, 128, 12, 64] -> [8, 12, 128, 64] head split of a
+// transformer. |kReference| selects the per-element implementation.
+template <bool kReference>
+void RunTranspose(benchmark::State& state) {
+  Shape src_shape = {static_cast<int32_t>(state.range(0)),
+                     static_cast<int32_t>(state.range(0))};
+  Shape perm = {1, 0};
+  if (state.range(1)) {
+    src_shape = {8, 128, 12, 64};
+    perm = {0, 2, 1, 3};
+  }
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  std::iota(src_buffer.begin(), src_buffer.end(), 0.0f);
+  std::vector<float> dst_buffer(src_buffer.size());
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference ? Transpose::ExecuteReference<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer),
+                                   src_shape, perm)
+                             : Transpose::Execute<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer),
+                                   src_shape, perm));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * dst_buffer.size() *
+                          sizeof(float));
+}
+
+static void BM_TransposeReference(benchmark::State& state) {
+  RunTranspose<true>(state);
+}
+BENCHMARK(BM_TransposeReference)->Args({1024, 0})->Args({0, 1});
+
+static void BM_TransposeBlocked(benchmark::State& state) {
+  RunTranspose<false>(state);
+}
+BENCHMARK(BM_TransposeBlocked)->Args({1024, 0})->Args({0, 1});
+
+// Tiles a [64, 64] matrix into [256, 256].
+template <bool kReference>
+void RunTile(benchmark::State& state) {
+  Shape src_shape = {64, 64};
+  Shape dst_shape = {256, 256};
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  std::iota(src_buffer.begin(), src_buffer.end(), 0.0f);
+  std::vector<float> dst_buffer(GetElementCount(dst_shape));
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference ? Tile::ExecuteReference<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer),
+                                   src_shape, dst_shape)
+                             : Tile::Execute<float>(
+                                   src_buffer, absl::MakeSpan(dst_buffer),
+                                   src_shape, dst_shape));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * dst_buffer.size() *
+                          sizeof(float));
+}
+
+static void BM_TileReference(benchmark::State& state) { RunTile<true>(state); }
+BENCHMARK(BM_TileReference);
+
+static void BM_Tile(benchmark::State& state) { RunTile<false>(state); }
+BENCHMARK(BM_Tile);
+
+// Sorts |state.range(0)| rows of 4096 values. |kReference| selects the
+// std::stable_sort implementation.
+template <bool kReference>
+void RunSort(benchmark::State& state) {
+  const int32_t row_count = static_cast<int32_t>(state.range(0));
+  Shape src_shape = {row_count, 4096};
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  uint32_t seed = 1;
+  for (auto& value : src_buffer) {
+    seed = seed * 1103515245u + 12345u;
+    value = static_cast<float>(seed >> 8) - 8388608.0f;
+  }
+  std::vector<int32_t> dst_buffer(src_buffer.size());
+  for (auto _ : state) {
+    IREE_CHECK_OK(kReference
+                      ? Sort::ExecuteReference<float>(
+                            src_buffer, absl::MakeSpan(dst_buffer), src_shape)
+                      : Sort::Execute<float>(
+                            src_buffer, absl::MakeSpan(dst_buffer), src_shape));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+
+static void BM_SortReference(benchmark::State& state) {
+  RunSort<true>(state);
+}
+BENCHMARK(BM_SortReference)->Arg(1)->Arg(64);
+
+static void BM_Sort(benchmark::State& state) { RunSort<false>(state); }
+BENCHMARK(BM_Sort)->Arg(1)->Arg(64);
+
+// Selects the largest |state.range(0)| of 100000 values.
+static void BM_TopK(benchmark::State& state) {
+  const int32_t k = static_cast<int32_t>(state.range(0));
+  Shape src_shape = {100000};
+  Shape dst_shape = {k};
+  std::vector<float> src_buffer(GetElementCount(src_shape));
+  uint32_t seed = 1;
+  for (auto& value : src_buffer) {
+    seed = seed * 1103515245u + 12345u;
+    value = static_cast<float>(seed >> 8) - 8388608.0f;
+  }
+  std::vector<int32_t> dst_buffer(k);
+  for (auto _ : state) {
+    IREE_CHECK_OK(TopK::Execute<float>(src_buffer, absl::MakeSpan(dst_buffer),
+                                       src_shape, dst_shape,
+                                       TopK::Order::kDescending));
+    benchmark::DoNotOptimize(dst_buffer.data());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * src_buffer.size());
+}
+BENCHMARK(BM_TopK)->Arg(10)->Arg(100)->Arg(10000);
+
+}  // namespace
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -17,14 +17,24 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
+#include "iree/hal/vmla/op_kernels_simd.h"
 
 namespace iree {
 namespace hal {
@@ -162,12 +172,12 @@ Status Copy::Execute(absl::Span<const uint8_t> src_buffer, ShapeSpan src_shape,
 }
 
 template <typename T>
-Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
-                       absl::Span<const T> filter_buffer,
-                       ShapeSpan filter_shape, absl::Span<T> dst_buffer,
-                       ShapeSpan dst_shape, ShapeSpan window_strides,
-                       ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
-                       ShapeSpan rhs_dilation, const int32_t groups) {
+Status Conv2D::ExecuteReference(
+    absl::Span<const T> input_buffer, ShapeSpan input_shape,
+    absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+    absl::Span<T> dst_buffer, ShapeSpan dst_shape, ShapeSpan window_strides,
+    ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
+    ShapeSpan rhs_dilation, const int32_t groups) {
   const std::array<int32_t, 3> input_strides = {input_shape[1] * input_shape[2],
                                                 input_shape[2], 1};
   const std::array<int32_t, 4> filter_strides = {
@@ -177,7 +187,7 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
                                               dst_shape[2], 1};
   // Direct 2d (grouped) convolution slow implementation. ref:
   // https://www.tensorflow.org/versions/r2.0/api_docs/python/tf/nn/convolution)
-  // TODO(ataei): Implement tiled GEMM based implementation.
+  std::fill(dst_buffer.begin(), dst_buffer.end(), T(0));
   const int output_group_size = dst_shape[2] / groups;
   const int input_group_size = input_shape[2] / groups;
   for (int ho = 0; ho < dst_shape[0]; ho++) {
@@ -218,6 +228,62 @@ Status Conv2D::Execute(absl::Span<const T> input_buffer, ShapeSpan input_shape,
   return OkStatus();
 }
 
+template <typename T>
+Status Conv2D::ExecuteDepthwise(
+    absl::Span<const T> input_buffer, ShapeSpan input_shape,
+    absl::Span<const T> filter_buffer, ShapeSpan filter_shape,
+    absl::Span<T> dst_buffer, ShapeSpan dst_shape, ShapeSpan window_strides,
+    ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
+    ShapeSpan rhs_dilation, const int32_t groups) {
+  if (input_shape[2] != groups) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Depthwise Conv2D requires one input channel per group; have "
+           << input_shape[2] << " channels in " << groups << " groups";
+  }
+  // With a single input channel per group the filter row for each (kh, kw) has
+  // the same [channel, multiplier] layout as the destination channels, so each
+  // window position is one multiply-accumulate over a contiguous vector.
+  const int channels = input_shape[2];
+  const int multiplier = dst_shape[2] / groups;
+  const int dst_channels = dst_shape[2];
+  std::fill(dst_buffer.begin(), dst_buffer.end(), T(0));
+  for (int ho = 0; ho < dst_shape[0]; ho++) {
+    for (int wo = 0; wo < dst_shape[1]; wo++) {
+      T* dst_row =
+          dst_buffer.data() + (ho * dst_shape[1] + wo) * dst_channels;
+      for (int kh = 0; kh < filter_shape[0]; kh++) {
+        int ih = ho * window_strides[0] + kh * rhs_dilation[0] - pad_h[0];
+        if (ih < 0 || ih % lhs_dilation[0]) continue;
+        ih = ih / lhs_dilation[0];
+        if (ih >= input_shape[0]) continue;
+        for (int kw = 0; kw < filter_shape[1]; kw++) {
+          int iw = wo * window_strides[1] + kw * rhs_dilation[1] - pad_w[0];
+          if (iw < 0 || iw % lhs_dilation[1]) continue;
+          iw = iw / lhs_dilation[1];
+          if (iw >= input_shape[1]) continue;
+          const T* input_row =
+              input_buffer.data() + (ih * input_shape[1] + iw) * channels;
+          const T* filter_row =
+              filter_buffer.data() + (kh * filter_shape[1] + kw) * dst_channels;
+          if (multiplier == 1) {
+            for (int c = 0; c < channels; ++c) {
+              dst_row[c] += input_row[c] * filter_row[c];
+            }
+          } else {
+            for (int c = 0; c < channels; ++c) {
+              for (int m = 0; m < multiplier; ++m) {
+                dst_row[c * multiplier + m] +=
+                    input_row[c] * filter_row[c * multiplier + m];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  return OkStatus();
+}
+
 template <typename T>
 Status Select::Execute(absl::Span<const uint8_t> cond_buffer,
                        absl::Span<const T> lhs_buffer,
@@ -238,11 +304,197 @@ Status Finite::Execute(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+// Row-major strides of |shape| in elements.
+inline absl::InlinedVector<size_t, 6> ComputeStrides(ShapeSpan shape) {
+  absl::InlinedVector<size_t, 6> strides(shape.size());
+  size_t stride = 1;
+  for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+// Calls |fn(src_offset, dst_offset)| for every index of the dimensions of
+// |shape| that are not in |skip_dims| (a bitmask), with the offsets of that
+// index under |src_strides| and |dst_strides|. Indices are visited in
+// row-major order.
+template <typename Fn>
+void ForEachOuterOffset(ShapeSpan shape, uint32_t skip_dims,
+                        absl::Span<const size_t> src_strides,
+                        absl::Span<const size_t> dst_strides, const Fn& fn) {
+  absl::InlinedVector<int, 6> dims;
+  for (int i = 0; i < shape.size(); ++i) {
+    if (!(skip_dims & (1u << i))) dims.push_back(i);
+  }
+  absl::InlinedVector<int32_t, 6> indices(dims.size(), 0);
+  size_t src_offset = 0;
+  size_t dst_offset = 0;
+  while (true) {
+    fn(src_offset, dst_offset);
+    int i = static_cast<int>(dims.size()) - 1;
+    for (; i >= 0; --i) {
+      int dim = dims[i];
+      src_offset += src_strides[dim];
+      dst_offset += dst_strides[dim];
+      if (++indices[i] < shape[dim]) break;
+      src_offset -= src_strides[dim] * shape[dim];
+      dst_offset -= dst_strides[dim] * shape[dim];
+      indices[i] = 0;
+    }
+    if (i < 0) return;
+  }
+}
+
+// Drops unit dimensions from a transpose and merges dimensions that stay
+// adjacent, such that no two consecutive |perm| entries are consecutive.
+inline void CanonicalizeTranspose(ShapeSpan src_shape,
+                                  absl::Span<const int32_t> perm,
+                                  absl::InlinedVector<int32_t, 6>* shape,
+                                  absl::InlinedVector<int32_t, 6>* new_perm) {
+  // Maps each kept source dimension to its position among the kept ones.
+  absl::InlinedVector<int32_t, 6> kept_index(src_shape.size(), -1);
+  int kept_count = 0;
+  for (int i = 0; i < src_shape.size(); ++i) {
+    if (src_shape[i] != 1) kept_index[i] = kept_count++;
+  }
+  // Groups of consecutive source dimensions in destination order, as
+  // [first, last] kept source dimension indices.
+  absl::InlinedVector<std::pair<int32_t, int32_t>, 6> groups;
+  absl::InlinedVector<int32_t, 6> kept_sizes(kept_count);
+  for (int i = 0; i < src_shape.size(); ++i) {
+    if (kept_index[i] >= 0) kept_sizes[kept_index[i]] = src_shape[i];
+  }
+  for (int i = 0; i < perm.size(); ++i) {
+    int32_t dim = kept_index[perm[i]];
+    if (dim < 0) continue;
+    if (!groups.empty() && groups.back().second + 1 == dim) {
+      groups.back().second = dim;
+    } else {
+      groups.push_back({dim, dim});
+    }
+  }
+  // Source order of the groups is the order of their first dimension.
+  absl::InlinedVector<int32_t, 6> src_order(groups.size());
+  std::iota(src_order.begin(), src_order.end(), 0);
+  std::sort(src_order.begin(), src_order.end(), [&](int32_t lhs, int32_t rhs) {
+    return groups[lhs].first < groups[rhs].first;
+  });
+  shape->resize(groups.size());
+  new_perm->resize(groups.size());
+  for (int i = 0; i < src_order.size(); ++i) {
+    const auto& group = groups[src_order[i]];
+    int32_t size = 1;
+    for (int dim = group.first; dim <= group.second; ++dim) {
+      size *= kept_sizes[dim];
+    }
+    (*shape)[i] = size;
+    (*new_perm)[src_order[i]] = i;
+  }
+}
+
+// Destination blocks are kept small enough that both the source and
+// destination blocks stay in L1.
+constexpr size_t kTransposeBlockSize = 64;
+
+// dst[col * dst_stride + row] = src[row * src_stride + col] for a |rows| x
+// |cols| matrix, processed in cache-sized blocks.
+template <typename T>
+void TransposeMatrix(const T* src, size_t src_stride, T* dst,
+                     size_t dst_stride, size_t rows, size_t cols) {
+  const simd::Kernels* kernels =
+      sizeof(T) == sizeof(uint32_t) ? simd::GetBestKernels() : nullptr;
+  for (size_t row = 0; row < rows; row += kTransposeBlockSize) {
+    size_t block_rows = std::min(kTransposeBlockSize, rows - row);
+    for (size_t col = 0; col < cols; col += kTransposeBlockSize) {
+      size_t block_cols = std::min(kTransposeBlockSize, cols - col);
+      const T* block_src = src + row * src_stride + col;
+      T* block_dst = dst + col * dst_stride + row;
+      if (kernels) {
+        kernels->transpose_x32(reinterpret_cast<const uint32_t*>(block_src),
+                               src_stride,
+                               reinterpret_cast<uint32_t*>(block_dst),
+                               dst_stride, block_rows, block_cols);
+        continue;
+      }
+      for (size_t i = 0; i < block_rows; ++i) {
+        for (size_t j = 0; j < block_cols; ++j) {
+          block_dst[j * dst_stride + i] = block_src[i * src_stride + j];
+        }
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Transpose::Execute(absl::Span<const T> src_buffer,
                           absl::Span<T> dst_buffer, ShapeSpan src_shape,
                           absl::Span<const int32_t> perm) {
-  // This implementation is .... not fast.
+  absl::InlinedVector<int32_t, 6> shape;
+  absl::InlinedVector<int32_t, 6> canonical_perm;
+  impl::CanonicalizeTranspose(src_shape, perm, &shape, &canonical_perm);
+  const int rank = shape.size();
+  if (dst_buffer.empty()) return OkStatus();
+  if (rank <= 1) {
+    std::memcpy(dst_buffer.data(), src_buffer.data(),
+                dst_buffer.size() * sizeof(T));
+    return OkStatus();
+  }
+
+  auto src_strides = impl::ComputeStrides(shape);
+  // Source strides in destination dimension order.
+  absl::InlinedVector<int32_t, 6> dst_shape(rank);
+  absl::InlinedVector<size_t, 6> permuted_src_strides(rank);
+  for (int i = 0; i < rank; ++i) {
+    dst_shape[i] = shape[canonical_perm[i]];
+    permuted_src_strides[i] = src_strides[canonical_perm[i]];
+  }
+  auto dst_strides = impl::ComputeStrides(dst_shape);
+  const T* src = src_buffer.data();
+  T* dst = dst_buffer.data();
+
+  // Rows that stay innermost are copied whole.
+  if (canonical_perm.back() == rank - 1) {
+    const size_t row_size = shape[rank - 1] * sizeof(T);
+    impl::ForEachOuterOffset(dst_shape, 1u << (rank - 1), permuted_src_strides,
+                             dst_strides,
+                             [&](size_t src_offset, size_t dst_offset) {
+                               std::memcpy(dst + dst_offset, src + src_offset,
+                                           row_size);
+                             });
+    return OkStatus();
+  }
+
+  // Otherwise each destination element maps to the source through a 2D
+  // transpose of the source dimension that becomes innermost in the
+  // destination and the destination dimension that was innermost in the
+  // source.
+  const int src_inner_dim = static_cast<int>(
+      std::find(canonical_perm.begin(), canonical_perm.end(), rank - 1) -
+      canonical_perm.begin());
+  const size_t rows = dst_shape[rank - 1];
+  const size_t cols = dst_shape[src_inner_dim];
+  const size_t src_row_stride = permuted_src_strides[rank - 1];
+  const size_t dst_row_stride = dst_strides[src_inner_dim];
+  impl::ForEachOuterOffset(
+      dst_shape, (1u << (rank - 1)) | (1u << src_inner_dim),
+      permuted_src_strides, dst_strides,
+      [&](size_t src_offset, size_t dst_offset) {
+        impl::TransposeMatrix(src + src_offset, src_row_stride,
+                              dst + dst_offset, dst_row_stride, rows, cols);
+      });
+  return OkStatus();
+}
+
+template <typename T>
+Status Transpose::ExecuteReference(absl::Span<const T> src_buffer,
+                                   absl::Span<T> dst_buffer,
+                                   ShapeSpan src_shape,
+                                   absl::Span<const int32_t> perm) {
   int rank = src_shape.size();
   absl::InlinedVector<int, 8> src_strides(rank);
   absl::InlinedVector<int, 8> dst_strides(rank);
@@ -378,20 +630,31 @@ Status Gather::Execute(absl::Span<const T> src_buffer,
   // src[d_0,...,d_{dim-1},indices[d_0,...,d_1, i_B,...,i_{M-1}, d_{dim+1},...,d_{N-1}]
   // clang-format on
   // see:https://www.tensorflow.org/api_docs/python/tf/gather
-  // TODO(ataei): Shrink inner loop by scanning indices_buffer for
-  // contiguous indices and collide the copy of these slices.
+  // Runs of consecutive indices select adjacent slices in both the source and
+  // destination, so each run is copied at once.
+  const int indices_batching_stride =
+      batch_dims > 0 ? indices_strides[batch_dims - 1] : 1;
   for (size_t b = 0; b < batching_size; ++b) {
+    const int32_t* indices =
+        indices_buffer.data() + b * indices_batching_stride;
     for (size_t i = 0; i < outer_size; ++i) {
       const int index = b * outer_size + i;
-      for (size_t j = 0; j < indices_size; ++j) {
-        const int indices_batching_stride =
-            batch_dims > 0 ? indices_strides[batch_dims - 1] : 1;
-        const int indices_index = b * indices_batching_stride + j;
-        const size_t dst_offset = index * output_stride + j * slize_size;
-        const size_t src_offset =
-            index * input_stride + indices_buffer[indices_index] * slize_size;
-        std::memcpy(dst_buffer.data() + dst_offset,
-                    src_buffer.data() + src_offset, sizeof(T) * slize_size);
+      const T* src = src_buffer.data() + index * input_stride;
+      T* dst = dst_buffer.data() + index * output_stride;
+      for (size_t j = 0; j < indices_size;) {
+        size_t run_length = 1;
+        while (j + run_length < indices_size &&
+               indices[j + run_length] ==
+                   indices[j] + static_cast<int32_t>(run_length)) {
+          ++run_length;
+        }
+        if (slize_size == 1 && run_length == 1) {
+          dst[j] = src[indices[j]];
+        } else {
+          std::memcpy(dst + j * slize_size, src + indices[j] * slize_size,
+                      sizeof(T) * slize_size * run_length);
+        }
+        j += run_length;
       }
     }
   }
@@ -526,9 +789,205 @@ Status Reverse::Execute(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+// Rows at least this long are radix sorted. Shorter rows use std::stable_sort,
+// which has less fixed overhead.
+constexpr size_t kRadixSortMinLength = 256;
+
+// Maps |value| to an unsigned key with the same ordering.
+template <typename T>
+typename std::make_unsigned<T>::type ToRadixKey(T value) {
+  using Key = typename std::make_unsigned<T>::type;
+  Key key = static_cast<Key>(value);
+  if (std::is_signed<T>::value) {
+    key = static_cast<Key>(key ^ (Key{1} << (sizeof(Key) * 8 - 1)));
+  }
+  return key;
+}
+// Floating-point keys order values as
+//   -NaN < -inf < ... < -0 == +0 < ... < +inf < +NaN
+// which is a total order over all values, including NaNs.
+inline uint32_t ToRadixKey(float value) {
+  // -0 and +0 compare equal and must map to the same key.
+  if (value == 0.0f) value = 0.0f;
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x80000000u) ? ~bits : bits | 0x80000000u;
+}
+inline uint64_t ToRadixKey(double value) {
+  if (value == 0.0) value = 0.0;
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return (bits & 0x8000000000000000ull) ? ~bits
+                                        : bits | 0x8000000000000000ull;
+}
+
+// Returns true if |lhs| sorts before |rhs|. Floating-point values are compared
+// by their radix keys so that rows containing NaNs are ordered the same way by
+// every sorting path; operator< is not a strict weak ordering with NaNs.
+template <typename T>
+bool SortLess(T lhs, T rhs) {
+  return lhs < rhs;
+}
+inline bool SortLess(float lhs, float rhs) {
+  return ToRadixKey(lhs) < ToRadixKey(rhs);
+}
+inline bool SortLess(double lhs, double rhs) {
+  return ToRadixKey(lhs) < ToRadixKey(rhs);
+}
+
+template <typename T>
+using IsRadixSortable =
+    std::integral_constant<bool, (std::is_integral<T>::value &&
+                                  !std::is_same<T, bool>::value &&
+                                  sizeof(T) <= sizeof(uint32_t)) ||
+                                     std::is_same<T, float>::value>;
+
+// Sorts the indices [0, length) in |dst| by the values in |src| using
+// std::stable_sort.
+template <typename T>
+void StableSortRow(const T* src, size_t length, bool descending,
+                   int32_t* dst) {
+  std::iota(dst, dst + length, 0);
+  if (descending) {
+    std::stable_sort(dst, dst + length, [src](int32_t lhs, int32_t rhs) {
+      return SortLess(src[rhs], src[lhs]);
+    });
+  } else {
+    std::stable_sort(dst, dst + length, [src](int32_t lhs, int32_t rhs) {
+      return SortLess(src[lhs], src[rhs]);
+    });
+  }
+}
+
+// Stable sort of the element indices of a row. Sorters keep their scratch
+// memory so that they can be reused across rows.
+template <typename T, typename Enable = void>
+class RowSorter {
+ public:
+  void Sort(const T* src, size_t length, bool descending, int32_t* dst) {
+    StableSortRow(src, length, descending, dst);
+  }
+};
+
+// Least-significant-digit radix sort over 8-bit digits. Digits that are the
+// same for every key in the row are skipped.
+template <typename T>
+class RowSorter<T, typename std::enable_if<IsRadixSortable<T>::value>::type> {
+ public:
+  void Sort(const T* src, size_t length, bool descending, int32_t* dst) {
+    if (length < kRadixSortMinLength) {
+      StableSortRow(src, length, descending, dst);
+      return;
+    }
+    keys_.resize(length);
+    keys_scratch_.resize(length);
+    indices_scratch_.resize(length);
+
+    // Build the histograms of all digits in a single pass. Descending order
+    // sorts the inverted keys, which keeps equal elements in index order.
+    size_t counts[kDigitCount][kBucketCount] = {};
+    const Key key_mask = descending ? static_cast<Key>(~Key{0}) : Key{0};
+    for (size_t i = 0; i < length; ++i) {
+      Key key = static_cast<Key>(ToRadixKey(src[i]) ^ key_mask);
+      keys_[i] = key;
+      dst[i] = static_cast<int32_t>(i);
+      for (int digit = 0; digit < kDigitCount; ++digit) {
+        ++counts[digit][(key >> (digit * 8)) & 0xFF];
+      }
+    }
+
+    Key* keys = keys_.data();
+    Key* keys_out = keys_scratch_.data();
+    int32_t* indices = dst;
+    int32_t* indices_out = indices_scratch_.data();
+    for (int digit = 0; digit < kDigitCount; ++digit) {
+      const int shift = digit * 8;
+      size_t* digit_counts = counts[digit];
+      if (digit_counts[(keys[0] >> shift) & 0xFF] == length) continue;
+      size_t offset = 0;
+      for (int bucket = 0; bucket < kBucketCount; ++bucket) {
+        size_t count = digit_counts[bucket];
+        digit_counts[bucket] = offset;
+        offset += count;
+      }
+      for (size_t i = 0; i < length; ++i) {
+        size_t position = digit_counts[(keys[i] >> shift) & 0xFF]++;
+        keys_out[position] = keys[i];
+        indices_out[position] = indices[i];
+      }
+      std::swap(keys, keys_out);
+      std::swap(indices, indices_out);
+    }
+    if (indices != dst) std::copy_n(indices, length, dst);
+  }
+
+ private:
+  using Key = decltype(ToRadixKey(T()));
+  static constexpr int kDigitCount = sizeof(Key);
+  static constexpr int kBucketCount = 256;
+
+  std::vector<Key> keys_;
+  std::vector<Key> keys_scratch_;
+  std::vector<int32_t> indices_scratch_;
+};
+
+// Rows are fully sorted when at least this fraction of the elements is
+// selected; otherwise a bounded heap selects the elements in a single pass.
+constexpr size_t kTopKSortRatio = 16;
+
+// Writes the indices of the first |k| elements of the row in stable sorted
+// order to |dst|.
+template <typename T>
+void SelectTopK(const T* src, size_t length, size_t k, bool descending,
+                std::vector<int32_t>* heap, int32_t* dst) {
+  // Returns true if element |lhs| is ordered before element |rhs|.
+  auto precedes = [src, descending](int32_t lhs, int32_t rhs) {
+    T lhs_value = descending ? src[rhs] : src[lhs];
+    T rhs_value = descending ? src[lhs] : src[rhs];
+    if (SortLess(lhs_value, rhs_value)) return true;
+    if (SortLess(rhs_value, lhs_value)) return false;
+    return lhs < rhs;
+  };
+  // A max-heap under |precedes| keeps the last selected element at the front
+  // so that each new element needs a single comparison to be rejected.
+  heap->clear();
+  for (size_t i = 0; i < length; ++i) {
+    int32_t index = static_cast<int32_t>(i);
+    if (heap->size() < k) {
+      heap->push_back(index);
+      std::push_heap(heap->begin(), heap->end(), precedes);
+    } else if (precedes(index, heap->front())) {
+      std::pop_heap(heap->begin(), heap->end(), precedes);
+      heap->back() = index;
+      std::push_heap(heap->begin(), heap->end(), precedes);
+    }
+  }
+  std::sort_heap(heap->begin(), heap->end(), precedes);
+  std::copy(heap->begin(), heap->end(), dst);
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Sort::Execute(absl::Span<const T> src_buffer,
                      absl::Span<int32_t> dst_buffer, ShapeSpan src_shape) {
+  const size_t row_length = src_shape.empty() ? 1 : src_shape.back();
+  if (row_length == 0) return OkStatus();
+  const size_t row_count = GetElementCount(src_shape) / row_length;
+  impl::RowSorter<T> sorter;
+  for (size_t row = 0; row < row_count; ++row) {
+    sorter.Sort(src_buffer.data() + row * row_length, row_length,
+                /*descending=*/false, dst_buffer.data() + row * row_length);
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status Sort::ExecuteReference(absl::Span<const T> src_buffer,
+                              absl::Span<int32_t> dst_buffer,
+                              ShapeSpan src_shape) {
   int elements = src_buffer.size();
   const int sort_size = src_shape.back();
 
@@ -538,7 +997,7 @@ Status Sort::Execute(absl::Span<const T> src_buffer,
     std::iota(dst_subspan.begin(), dst_subspan.end(), 0);
     std::stable_sort(dst_subspan.begin(), dst_subspan.end(),
                      [&src_subspan](int32_t i1, int32_t i2) {
-                       return src_subspan[i1] < src_subspan[i2];
+                       return impl::SortLess(src_subspan[i1], src_subspan[i2]);
                      });
   }
 
@@ -546,23 +1005,459 @@ Status Sort::Execute(absl::Span<const T> src_buffer,
 }
 
 template <typename T>
-Status Fft::Execute(absl::Span<const T> real_src_buffer,
+Status TopK::Execute(absl::Span<const T> src_buffer,
+                     absl::Span<int32_t> dst_buffer, ShapeSpan src_shape,
+                     ShapeSpan dst_shape, Order order) {
+  if (src_shape.empty() || src_shape.size() != dst_shape.size() ||
+      dst_shape.back() > src_shape.back()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "TopK requires rows of at least k elements";
+  }
+  const size_t row_length = src_shape.back();
+  const size_t k = dst_shape.back();
+  if (k == 0) return OkStatus();
+  const size_t row_count = GetElementCount(src_shape) / row_length;
+  const bool descending = order == Order::kDescending;
+  impl::RowSorter<T> sorter;
+  std::vector<int32_t> indices;
+  for (size_t row = 0; row < row_count; ++row) {
+    const T* src = src_buffer.data() + row * row_length;
+    int32_t* dst = dst_buffer.data() + row * k;
+    if (k * impl::kTopKSortRatio >= row_length) {
+      indices.resize(row_length);
+      sorter.Sort(src, row_length, descending, indices.data());
+      std::copy_n(indices.data(), k, dst);
+    } else {
+      impl::SelectTopK(src, row_length, k, descending, &indices, dst);
+    }
+  }
+  return OkStatus();
+}
+
+namespace impl {
+
+// Mixed-radix Stockham FFT precomputed for a fixed transform length.
+//
+// The length is factored into radix-4, radix-2 and radix-3 stages with any
+// remaining prime factors handled by generic DFT stages. Each stage reads one
+// buffer and writes the other so that no bit-reversal permutation is required.
+// Real and imaginary components are kept in separate arrays and each stage
+// stores its twiddles contiguously so that the butterfly loops are unit-stride
+// and can be auto-vectorized.
+//
+// Plans are immutable after construction and may be shared across threads.
+template <typename T>
+class FftPlan {
+ public:
+  explicit FftPlan(int32_t length);
+
+  int32_t length() const { return length_; }
+
+  // Performs a forward transform of |real| and |imag| in-place.
+  // |scratch_real| and |scratch_imag| must each have room for length()
+  // elements.
+  void Forward(T* real, T* imag, T* scratch_real, T* scratch_imag) const;
+
+ private:
+  struct Stage {
+    int32_t radix = 0;
+    // Length of the sub-transforms remaining after this stage.
+    int32_t m = 0;
+    // Number of interleaved sequences transformed by this stage.
+    int32_t stride = 0;
+    // Twiddle factors w^(p*k) for k in [1, radix) and p in [0, m) stored as
+    // [k - 1][p].
+    std::vector<T> twiddle_real;
+    std::vector<T> twiddle_imag;
+    // Roots of unity for the radix. Only used by generic stages.
+    std::vector<T> root_real;
+    std::vector<T> root_imag;
+  };
+
+  static void Radix2(const Stage& stage, const T* x_re, const T* x_im, T* y_re,
+                     T* y_im);
+  static void Radix3(const Stage& stage, const T* x_re, const T* x_im, T* y_re,
+                     T* y_im);
+  static void Radix4(const Stage& stage, const T* x_re, const T* x_im, T* y_re,
+                     T* y_im);
+  static void RadixGeneric(const Stage& stage, const T* x_re, const T* x_im,
+                           T* y_re, T* y_im);
+
+  int32_t length_;
+  std::vector<Stage> stages_;
+};
+
+template <typename T>
+FftPlan<T>::FftPlan(int32_t length) : length_(length) {
+  static_assert(std::is_floating_point<T>::value,
+                "FFT only supports floating-point types");
+  if (length <= 1) return;
+
+  // Prefer radix-4 stages as they need the fewest passes over the data.
+  std::vector<int32_t> radices;
+  int32_t n = length;
+  while (n % 4 == 0) {
+    radices.push_back(4);
+    n /= 4;
+  }
+  while (n % 2 == 0) {
+    radices.push_back(2);
+    n /= 2;
+  }
+  for (int32_t factor = 3; factor * factor <= n; factor += 2) {
+    while (n % factor == 0) {
+      radices.push_back(factor);
+      n /= factor;
+    }
+  }
+  if (n > 1) radices.push_back(n);
+
+  constexpr double kPi = 3.14159265358979323846;
+  int32_t sub_length = length;
+  int32_t stride = 1;
+  for (int32_t radix : radices) {
+    Stage stage;
+    stage.radix = radix;
+    stage.m = sub_length / radix;
+    stage.stride = stride;
+    stage.twiddle_real.resize((radix - 1) * stage.m);
+    stage.twiddle_imag.resize((radix - 1) * stage.m);
+    for (int32_t k = 1; k < radix; ++k) {
+      for (int32_t p = 0; p < stage.m; ++p) {
+        // Reduce the exponent first to keep the angle accurate for long
+        // transforms.
+        int64_t exponent = (static_cast<int64_t>(p) * k) % sub_length;
+        double angle = -2.0 * kPi * exponent / sub_length;
+        stage.twiddle_real[(k - 1) * stage.m + p] =
+            static_cast<T>(std::cos(angle));
+        stage.twiddle_imag[(k - 1) * stage.m + p] =
+            static_cast<T>(std::sin(angle));
+      }
+    }
+    if (radix > 4) {
+      stage.root_real.resize(radix);
+      stage.root_imag.resize(radix);
+      for (int32_t j = 0; j < radix; ++j) {
+        double angle = -2.0 * kPi * j / radix;
+        stage.root_real[j] = static_cast<T>(std::cos(angle));
+        stage.root_imag[j] = static_cast<T>(std::sin(angle));
+      }
+    }
+    stages_.push_back(std::move(stage));
+    stride *= radix;
+    sub_length /= radix;
+  }
+}
+
+template <typename T>
+void FftPlan<T>::Forward(T* real, T* imag, T* scratch_real,
+                         T* scratch_imag) const {
+  T* x_re = real;
+  T* x_im = imag;
+  T* y_re = scratch_real;
+  T* y_im = scratch_imag;
+  for (const auto& stage : stages_) {
+    switch (stage.radix) {
+      case 2:
+        Radix2(stage, x_re, x_im, y_re, y_im);
+        break;
+      case 3:
+        Radix3(stage, x_re, x_im, y_re, y_im);
+        break;
+      case 4:
+        Radix4(stage, x_re, x_im, y_re, y_im);
+        break;
+      default:
+        RadixGeneric(stage, x_re, x_im, y_re, y_im);
+        break;
+    }
+    std::swap(x_re, y_re);
+    std::swap(x_im, y_im);
+  }
+  if (x_re != real) {
+    std::copy_n(x_re, length_, real);
+    std::copy_n(x_im, length_, imag);
+  }
+}
+
+// Stage p reads element j of each butterfly from x[q + s * (p + j * m)] and
+// writes output k to y[q + s * (radix * p + k)] for q in [0, s).
+
+template <typename T>
+void FftPlan<T>::Radix2(const Stage& stage, const T* x_re, const T* x_im,
+                        T* y_re, T* y_im) {
+  const int32_t m = stage.m;
+  const int32_t s = stage.stride;
+  for (int32_t p = 0; p < m; ++p) {
+    const T w_re = stage.twiddle_real[p];
+    const T w_im = stage.twiddle_imag[p];
+    const T* a0_re = x_re + s * p;
+    const T* a0_im = x_im + s * p;
+    const T* a1_re = x_re + s * (p + m);
+    const T* a1_im = x_im + s * (p + m);
+    T* y0_re = y_re + s * (2 * p);
+    T* y0_im = y_im + s * (2 * p);
+    T* y1_re = y_re + s * (2 * p + 1);
+    T* y1_im = y_im + s * (2 * p + 1);
+    for (int32_t q = 0; q < s; ++q) {
+      const T d_re = a0_re[q] - a1_re[q];
+      const T d_im = a0_im[q] - a1_im[q];
+      y0_re[q] = a0_re[q] + a1_re[q];
+      y0_im[q] = a0_im[q] + a1_im[q];
+      y1_re[q] = d_re * w_re - d_im * w_im;
+      y1_im[q] = d_re * w_im + d_im * w_re;
+    }
+  }
+}
+
+template <typename T>
+void FftPlan<T>::Radix3(const Stage& stage, const T* x_re, const T* x_im,
+                        T* y_re, T* y_im) {
+  // sin(2 * pi / 3)
+  const T c = static_cast<T>(0.86602540378443864676);
+  const int32_t m = stage.m;
+  const int32_t s = stage.stride;
+  for (int32_t p = 0; p < m; ++p) {
+    const T w1_re = stage.twiddle_real[p];
+    const T w1_im = stage.twiddle_imag[p];
+    const T w2_re = stage.twiddle_real[m + p];
+    const T w2_im = stage.twiddle_imag[m + p];
+    const T* a0_re = x_re + s * p;
+    const T* a0_im = x_im + s * p;
+    const T* a1_re = x_re + s * (p + m);
+    const T* a1_im = x_im + s * (p + m);
+    const T* a2_re = x_re + s * (p + 2 * m);
+    const T* a2_im = x_im + s * (p + 2 * m);
+    T* y0_re = y_re + s * (3 * p);
+    T* y0_im = y_im + s * (3 * p);
+    T* y1_re = y_re + s * (3 * p + 1);
+    T* y1_im = y_im + s * (3 * p + 1);
+    T* y2_re = y_re + s * (3 * p + 2);
+    T* y2_im = y_im + s * (3 * p + 2);
+    for (int32_t q = 0; q < s; ++q) {
+      const T sum_re = a1_re[q] + a2_re[q];
+      const T sum_im = a1_im[q] + a2_im[q];
+      const T diff_re = a1_re[q] - a2_re[q];
+      const T diff_im = a1_im[q] - a2_im[q];
+      const T h_re = a0_re[q] - T(0.5) * sum_re;
+      const T h_im = a0_im[q] - T(0.5) * sum_im;
+      const T b1_re = h_re + c * diff_im;
+      const T b1_im = h_im - c * diff_re;
+      const T b2_re = h_re - c * diff_im;
+      const T b2_im = h_im + c * diff_re;
+      y0_re[q] = a0_re[q] + sum_re;
+      y0_im[q] = a0_im[q] + sum_im;
+      y1_re[q] = b1_re * w1_re - b1_im * w1_im;
+      y1_im[q] = b1_re * w1_im + b1_im * w1_re;
+      y2_re[q] = b2_re * w2_re - b2_im * w2_im;
+      y2_im[q] = b2_re * w2_im + b2_im * w2_re;
+    }
+  }
+}
+
+template <typename T>
+void FftPlan<T>::Radix4(const Stage& stage, const T* x_re, const T* x_im,
+                        T* y_re, T* y_im) {
+  const int32_t m = stage.m;
+  const int32_t s = stage.stride;
+  for (int32_t p = 0; p < m; ++p) {
+    const T w1_re = stage.twiddle_real[p];
+    const T w1_im = stage.twiddle_imag[p];
+    const T w2_re = stage.twiddle_real[m + p];
+    const T w2_im = stage.twiddle_imag[m + p];
+    const T w3_re = stage.twiddle_real[2 * m + p];
+    const T w3_im = stage.twiddle_imag[2 * m + p];
+    const T* a0_re = x_re + s * p;
+    const T* a0_im = x_im + s * p;
+    const T* a1_re = x_re + s * (p + m);
+    const T* a1_im = x_im + s * (p + m);
+    const T* a2_re = x_re + s * (p + 2 * m);
+    const T* a2_im = x_im + s * (p + 2 * m);
+    const T* a3_re = x_re + s * (p + 3 * m);
+    const T* a3_im = x_im + s * (p + 3 * m);
+    T* y0_re = y_re + s * (4 * p);
+    T* y0_im = y_im + s * (4 * p);
+    T* y1_re = y_re + s * (4 * p + 1);
+    T* y1_im = y_im + s * (4 * p + 1);
+    T* y2_re = y_re + s * (4 * p + 2);
+    T* y2_im = y_im + s * (4 * p + 2);
+    T* y3_re = y_re + s * (4 * p + 3);
+    T* y3_im = y_im + s * (4 * p + 3);
+    for (int32_t q = 0; q < s; ++q) {
+      const T t0_re = a0_re[q] + a2_re[q];
+      const T t0_im = a0_im[q] + a2_im[q];
+      const T t1_re = a0_re[q] - a2_re[q];
+      const T t1_im = a0_im[q] - a2_im[q];
+      const T t2_re = a1_re[q] + a3_re[q];
+      const T t2_im = a1_im[q] + a3_im[q];
+      const T t3_re = a1_re[q] - a3_re[q];
+      const T t3_im = a1_im[q] - a3_im[q];
+      // Multiplications by -i are folded into the additions.
+      const T b1_re = t1_re + t3_im;
+      const T b1_im = t1_im - t3_re;
+      const T b2_re = t0_re - t2_re;
+      const T b2_im = t0_im - t2_im;
+      const T b3_re = t1_re - t3_im;
+      const T b3_im = t1_im + t3_re;
+      y0_re[q] = t0_re + t2_re;
+      y0_im[q] = t0_im + t2_im;
+      y1_re[q] = b1_re * w1_re - b1_im * w1_im;
+      y1_im[q] = b1_re * w1_im + b1_im * w1_re;
+      y2_re[q] = b2_re * w2_re - b2_im * w2_im;
+      y2_im[q] = b2_re * w2_im + b2_im * w2_re;
+      y3_re[q] = b3_re * w3_re - b3_im * w3_im;
+      y3_im[q] = b3_re * w3_im + b3_im * w3_re;
+    }
+  }
+}
+
+template <typename T>
+void FftPlan<T>::RadixGeneric(const Stage& stage, const T* x_re,
+                              const T* x_im, T* y_re, T* y_im) {
+  // O(radix^2) DFT for prime factors without a specialized butterfly.
+  const int32_t radix = stage.radix;
+  const int32_t m = stage.m;
+  const int32_t s = stage.stride;
+  std::vector<T> a_re(radix);
+  std::vector<T> a_im(radix);
+  for (int32_t p = 0; p < m; ++p) {
+    for (int32_t q = 0; q < s; ++q) {
+      for (int32_t j = 0; j < radix; ++j) {
+        a_re[j] = x_re[q + s * (p + j * m)];
+        a_im[j] = x_im[q + s * (p + j * m)];
+      }
+      for (int32_t k = 0; k < radix; ++k) {
+        T sum_re = 0;
+        T sum_im = 0;
+        int32_t root_index = 0;
+        for (int32_t j = 0; j < radix; ++j) {
+          const T r_re = stage.root_real[root_index];
+          const T r_im = stage.root_imag[root_index];
+          sum_re += a_re[j] * r_re - a_im[j] * r_im;
+          sum_im += a_re[j] * r_im + a_im[j] * r_re;
+          root_index += k;
+          if (root_index >= radix) root_index -= radix;
+        }
+        if (k > 0) {
+          const T w_re = stage.twiddle_real[(k - 1) * m + p];
+          const T w_im = stage.twiddle_imag[(k - 1) * m + p];
+          const T t_re = sum_re * w_re - sum_im * w_im;
+          sum_im = sum_re * w_im + sum_im * w_re;
+          sum_re = t_re;
+        }
+        y_re[q + s * (radix * p + k)] = sum_re;
+        y_im[q + s * (radix * p + k)] = sum_im;
+      }
+    }
+  }
+}
+
+}  // namespace impl
+
+struct Fft::RuntimeState {
+  // Returns the plan for transforms of |length| elements, creating it if
+  // needed.
+  template <typename T>
+  std::shared_ptr<const impl::FftPlan<T>> GetPlan(int32_t length) {
+    absl::MutexLock lock(&mutex);
+    auto& plan = plans[std::make_pair(length, sizeof(T))];
+    if (!plan) plan = std::make_shared<const impl::FftPlan<T>>(length);
+    return std::static_pointer_cast<const impl::FftPlan<T>>(plan);
+  }
+
+  absl::Mutex mutex;
+  // Plans keyed by length and element size.
+  absl::flat_hash_map<std::pair<int32_t, size_t>, std::shared_ptr<const void>>
+      plans ABSL_GUARDED_BY(mutex);
+};
+
+inline std::unique_ptr<Fft::RuntimeState> Fft::CreateRuntimeState() {
+  return absl::make_unique<RuntimeState>();
+}
+
+namespace impl {
+
+// Transforms each row of the innermost dimension. The inverse transform is
+// computed as conj(FFT(conj(x))) / N so that a single plan serves both.
+template <typename T>
+Status ExecuteFft(Fft::RuntimeState* runtime_state, bool inverse,
+                  absl::Span<const T> real_src_buffer,
+                  absl::Span<const T> imag_src_buffer,
+                  absl::Span<T> real_dst_buffer, absl::Span<T> imag_dst_buffer,
+                  ShapeSpan real_src_shape, ShapeSpan imag_src_shape) {
+  if (real_src_shape != imag_src_shape) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "FFT real and imaginary shapes must match";
+  } else if (real_src_shape.empty()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "FFT requires at least one dimension";
+  }
+  const int32_t length = real_src_shape.back();
+  const size_t element_count = GetElementCount(real_src_shape);
+  if (element_count == 0) return OkStatus();
+  const size_t batch_count = element_count / length;
+
+  auto plan = runtime_state->GetPlan<T>(length);
+  std::vector<T> scratch(2 * length);
+  T* scratch_real = scratch.data();
+  T* scratch_imag = scratch.data() + length;
+  const T scale = T(1) / static_cast<T>(length);
+  for (size_t batch = 0; batch < batch_count; ++batch) {
+    // Rows are transformed in-place in the destination.
+    const size_t offset = batch * length;
+    T* real = real_dst_buffer.data() + offset;
+    T* imag = imag_dst_buffer.data() + offset;
+    std::copy_n(real_src_buffer.data() + offset, length, real);
+    if (inverse) {
+      for (int32_t i = 0; i < length; ++i) {
+        imag[i] = -imag_src_buffer[offset + i];
+      }
+    } else {
+      std::copy_n(imag_src_buffer.data() + offset, length, imag);
+    }
+
+    plan->Forward(real, imag, scratch_real, scratch_imag);
+
+    if (inverse) {
+      for (int32_t i = 0; i < length; ++i) {
+        real[i] *= scale;
+        imag[i] *= -scale;
+      }
+    }
+  }
+  return OkStatus();
+}
+
+}  // namespace impl
+
+template <typename T>
+Status Fft::Execute(RuntimeState* runtime_state,
+                    absl::Span<const T> real_src_buffer,
                     absl::Span<const T> imag_src_buffer,
                     absl::Span<T> real_dst_buffer,
                     absl::Span<T> imag_dst_buffer, ShapeSpan real_src_shape,
                     ShapeSpan imag_src_shape) {
-  // TODO (natashaknk): implement
-  std::fill(real_dst_buffer.begin(), real_dst_buffer.end(), 1);
-  std::fill(imag_dst_buffer.begin(), imag_dst_buffer.end(), 2);
-  return OkStatus();
+  return impl::ExecuteFft(runtime_state, /*inverse=*/false, real_src_buffer,
+                          imag_src_buffer, real_dst_buffer, imag_dst_buffer,
+                          real_src_shape, imag_src_shape);
+}
+
+template <typename T>
+Status Ifft::Execute(Fft::RuntimeState* runtime_state,
+                     absl::Span<const T> real_src_buffer,
+                     absl::Span<const T> imag_src_buffer,
+                     absl::Span<T> real_dst_buffer,
+                     absl::Span<T> imag_dst_buffer, ShapeSpan real_src_shape,
+                     ShapeSpan imag_src_shape) {
+  return impl::ExecuteFft(runtime_state, /*inverse=*/true, real_src_buffer,
+                          imag_src_buffer, real_dst_buffer, imag_dst_buffer,
+                          real_src_shape, imag_src_shape);
 }
 
 template <typename T>
 Status Broadcast::Execute(absl::Span<const T> src_buffer,
                           absl::Span<T> dst_buffer) {
-  for (size_t i = 0; i < dst_buffer.size(); ++i) {
-    dst_buffer[i] = src_buffer[0];
-  }
+  std::fill(dst_buffer.begin(), dst_buffer.end(), src_buffer[0]);
   return OkStatus();
 }
 
@@ -579,7 +1474,51 @@ Status Iota::Execute(absl::Span<T> dst_buffer) {
 template <typename T>
 Status Tile::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer,
                      ShapeSpan src_shape, ShapeSpan dst_shape) {
-  // This implementation is .... not fast.
+  const int rank = dst_shape.size();
+  if (rank == 0 || dst_buffer.empty()) {
+    std::copy(src_buffer.begin(), src_buffer.end(), dst_buffer.begin());
+    return OkStatus();
+  }
+  auto src_strides = impl::ComputeStrides(src_shape);
+  auto dst_strides = impl::ComputeStrides(dst_shape);
+  const T* src = src_buffer.data();
+  T* dst = dst_buffer.data();
+
+  // Write every source row at the start of its first tile and repeat it along
+  // the innermost dimension.
+  const size_t row_length = src_shape[rank - 1];
+  const size_t row_repeats = dst_shape[rank - 1] / row_length;
+  impl::ForEachOuterOffset(
+      src_shape.subspan(0, rank - 1), 0, src_strides, dst_strides,
+      [&](size_t src_offset, size_t dst_offset) {
+        for (size_t i = 0; i < row_repeats; ++i) {
+          std::memcpy(dst + dst_offset + i * row_length, src + src_offset,
+                      row_length * sizeof(T));
+        }
+      });
+
+  // Going outwards, each dimension's first tile is now complete and
+  // contiguous, so the remaining tiles are copies of it.
+  for (int dim = rank - 2; dim >= 0; --dim) {
+    const size_t tile_size = src_shape[dim] * dst_strides[dim];
+    const size_t tile_repeats = dst_shape[dim] / src_shape[dim];
+    if (tile_repeats == 1) continue;
+    impl::ForEachOuterOffset(
+        src_shape.subspan(0, dim), 0, src_strides, dst_strides,
+        [&](size_t src_offset, size_t dst_offset) {
+          for (size_t i = 1; i < tile_repeats; ++i) {
+            std::memcpy(dst + dst_offset + i * tile_size, dst + dst_offset,
+                        tile_size * sizeof(T));
+          }
+        });
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status Tile::ExecuteReference(absl::Span<const T> src_buffer,
+                              absl::Span<T> dst_buffer, ShapeSpan src_shape,
+                              ShapeSpan dst_shape) {
   int rank = dst_shape.size();
   absl::InlinedVector<int, 8> src_strides(rank);
   absl::InlinedVector<int, 8> dst_strides(rank);
@@ -746,8 +1685,41 @@ Status Pow::Execute(absl::Span<const T> lhs_buffer,
   return OkStatus();
 }
 
+namespace impl {
+
+using SimdUnaryKernel = void (*)(const float* src, float* dst, size_t count);
+
+// Runs |kernel| from the best SIMD kernel table for the CPU, if any. Returns
+// false if there is no vectorized kernel for T.
+template <typename T>
+bool TryExecuteSimdUnary(SimdUnaryKernel simd::Kernels::*kernel,
+                         absl::Span<const T> src_buffer,
+                         absl::Span<T> dst_buffer) {
+  return false;
+}
+inline bool TryExecuteSimdUnary(SimdUnaryKernel simd::Kernels::*kernel,
+                                absl::Span<const float> src_buffer,
+                                absl::Span<float> dst_buffer) {
+  const simd::Kernels* kernels = simd::GetBestKernels();
+  if (!kernels || !(kernels->*kernel)) return false;
+  (kernels->*kernel)(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+  return true;
+}
+
+}  // namespace impl
+
 template <typename T>
 Status Exp::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
+  if (impl::TryExecuteSimdUnary(&simd::Kernels::exp_f32, src_buffer,
+                                dst_buffer)) {
+    return OkStatus();
+  }
+  return ExecuteReference(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status Exp::ExecuteReference(absl::Span<const T> src_buffer,
+                             absl::Span<T> dst_buffer) {
   for (size_t i = 0; i < dst_buffer.size(); ++i) {
     dst_buffer[i] = std::exp(src_buffer[i]);
   }
@@ -757,6 +1729,16 @@ Status Exp::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
 template <typename T>
 Status Rsqrt::Execute(absl::Span<const T> src_buffer,
                       absl::Span<T> dst_buffer) {
+  if (impl::TryExecuteSimdUnary(&simd::Kernels::rsqrt_f32, src_buffer,
+                                dst_buffer)) {
+    return OkStatus();
+  }
+  return ExecuteReference(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status Rsqrt::ExecuteReference(absl::Span<const T> src_buffer,
+                               absl::Span<T> dst_buffer) {
   for (size_t i = 0; i < dst_buffer.size(); ++i) {
     dst_buffer[i] = 1.0 / std::sqrt(src_buffer[i]);
   }
@@ -773,6 +1755,16 @@ Status Sqrt::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
 
 template <typename T>
 Status Log::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
+  if (impl::TryExecuteSimdUnary(&simd::Kernels::log_f32, src_buffer,
+                                dst_buffer)) {
+    return OkStatus();
+  }
+  return ExecuteReference(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status Log::ExecuteReference(absl::Span<const T> src_buffer,
+                             absl::Span<T> dst_buffer) {
   for (size_t i = 0; i < dst_buffer.size(); ++i) {
     dst_buffer[i] = std::log(src_buffer[i]);
   }
@@ -797,6 +1789,16 @@ Status Sin::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
 
 template <typename T>
 Status Tanh::Execute(absl::Span<const T> src_buffer, absl::Span<T> dst_buffer) {
+  if (impl::TryExecuteSimdUnary(&simd::Kernels::tanh_f32, src_buffer,
+                                dst_buffer)) {
+    return OkStatus();
+  }
+  return ExecuteReference(src_buffer, dst_buffer);
+}
+
+template <typename T>
+Status Tanh::ExecuteReference(absl::Span<const T> src_buffer,
+                              absl::Span<T> dst_buffer) {
   for (size_t i = 0; i < dst_buffer.size(); ++i) {
     dst_buffer[i] = std::tanh(src_buffer[i]);
   }
@@ -883,6 +1885,222 @@ Status Convert::Execute(absl::Span<const SRC> src_buffer,
 
 namespace impl {
 
+// Returns the number of register operands used by |opcode| or -1 if invalid.
+inline int GetFusedOperandCount(FusedElementwise::Opcode opcode) {
+  using Opcode = FusedElementwise::Opcode;
+  switch (opcode) {
+    case Opcode::kConstant:
+      return 0;
+    case Opcode::kNeg:
+    case Opcode::kAbs:
+    case Opcode::kExp:
+    case Opcode::kLog:
+    case Opcode::kSqrt:
+    case Opcode::kRsqrt:
+    case Opcode::kTanh:
+    case Opcode::kFloor:
+    case Opcode::kCeil:
+      return 1;
+    case Opcode::kAdd:
+    case Opcode::kSub:
+    case Opcode::kMul:
+    case Opcode::kDiv:
+    case Opcode::kMin:
+    case Opcode::kMax:
+      return 2;
+    case Opcode::kClamp:
+      return 3;
+  }
+  return -1;
+}
+
+// Evaluates one instruction over |length| elements. Each case is a simple loop
+// over contiguous memory so that the compiler can vectorize it; transcendental
+// functions use the SIMD kernels when available.
+template <typename T>
+void EvaluateFusedInstruction(FusedElementwise::Opcode opcode, const T* a,
+                              const T* b, const T* c, T* dst, size_t length) {
+  using Opcode = FusedElementwise::Opcode;
+  switch (opcode) {
+    case Opcode::kConstant:
+      // Constants are materialized into their registers ahead of time.
+      break;
+    case Opcode::kAdd:
+      for (size_t i = 0; i < length; ++i) dst[i] = a[i] + b[i];
+      break;
+    case Opcode::kSub:
+      for (size_t i = 0; i < length; ++i) dst[i] = a[i] - b[i];
+      break;
+    case Opcode::kMul:
+      for (size_t i = 0; i < length; ++i) dst[i] = a[i] * b[i];
+      break;
+    case Opcode::kDiv:
+      for (size_t i = 0; i < length; ++i) dst[i] = a[i] / b[i];
+      break;
+    case Opcode::kMin:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::min(a[i], b[i]);
+      break;
+    case Opcode::kMax:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::max(a[i], b[i]);
+      break;
+    case Opcode::kNeg:
+      for (size_t i = 0; i < length; ++i) dst[i] = -a[i];
+      break;
+    case Opcode::kAbs:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::abs(a[i]);
+      break;
+    case Opcode::kExp:
+      if (TryExecuteSimdUnary(&simd::Kernels::exp_f32,
+                              absl::MakeConstSpan(a, length),
+                              absl::MakeSpan(dst, length))) {
+        break;
+      }
+      for (size_t i = 0; i < length; ++i) dst[i] = std::exp(a[i]);
+      break;
+    case Opcode::kLog:
+      if (TryExecuteSimdUnary(&simd::Kernels::log_f32,
+                              absl::MakeConstSpan(a, length),
+                              absl::MakeSpan(dst, length))) {
+        break;
+      }
+      for (size_t i = 0; i < length; ++i) dst[i] = std::log(a[i]);
+      break;
+    case Opcode::kSqrt:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::sqrt(a[i]);
+      break;
+    case Opcode::kRsqrt:
+      if (TryExecuteSimdUnary(&simd::Kernels::rsqrt_f32,
+                              absl::MakeConstSpan(a, length),
+                              absl::MakeSpan(dst, length))) {
+        break;
+      }
+      for (size_t i = 0; i < length; ++i) dst[i] = 1.0 / std::sqrt(a[i]);
+      break;
+    case Opcode::kTanh:
+      if (TryExecuteSimdUnary(&simd::Kernels::tanh_f32,
+                              absl::MakeConstSpan(a, length),
+                              absl::MakeSpan(dst, length))) {
+        break;
+      }
+      for (size_t i = 0; i < length; ++i) dst[i] = std::tanh(a[i]);
+      break;
+    case Opcode::kFloor:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::floor(a[i]);
+      break;
+    case Opcode::kCeil:
+      for (size_t i = 0; i < length; ++i) dst[i] = std::ceil(a[i]);
+      break;
+    case Opcode::kClamp:
+      // Operands are (min, value, max) as with Clamp.
+      for (size_t i = 0; i < length; ++i) {
+        T src = b[i];
+        dst[i] = src <= a[i] ? a[i] : src >= c[i] ? c[i] : src;
+      }
+      break;
+  }
+}
+
+}  // namespace impl
+
+template <typename T>
+Status FusedElementwise::Execute(
+    absl::Span<const int32_t> program,
+    absl::Span<const absl::Span<const T>> src_buffers,
+    absl::Span<T> dst_buffer) {
+  static_assert(sizeof(T) == sizeof(int32_t),
+                "constants are encoded as a single program word");
+  if (program.size() < 2) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Fused program is missing its header";
+  }
+  const int32_t input_count = program[0];
+  const int32_t instruction_count = program[1];
+  if (input_count != src_buffers.size()) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Fused program expects " << input_count << " inputs but "
+           << src_buffers.size() << " were provided";
+  } else if (instruction_count < 1 ||
+             instruction_count > kMaxInstructionCount ||
+             program.size() !=
+                 2 + instruction_count * kInstructionWordCount) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Fused program has an invalid instruction count "
+           << instruction_count;
+  }
+  for (const auto& src_buffer : src_buffers) {
+    if (src_buffer.size() < dst_buffer.size()) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Fused input has " << src_buffer.size()
+             << " elements but the output has " << dst_buffer.size();
+    }
+  }
+
+  // Verify the program up front so that the block loop can trust it.
+  auto instructions = program.subspan(2);
+  for (int32_t i = 0; i < instruction_count; ++i) {
+    const int32_t* instruction = &instructions[i * kInstructionWordCount];
+    int operand_count =
+        impl::GetFusedOperandCount(static_cast<Opcode>(instruction[0]));
+    if (operand_count < 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Fused instruction " << i << " has invalid opcode "
+             << instruction[0];
+    }
+    for (int j = 0; j < operand_count; ++j) {
+      int32_t operand = instruction[1 + j];
+      if (operand < 0 || operand >= input_count + i) {
+        return InvalidArgumentErrorBuilder(IREE_LOC)
+               << "Fused instruction " << i << " references invalid register "
+               << operand;
+      }
+    }
+  }
+
+  // Scratch registers holding one block of each instruction result.
+  alignas(64) T scratch[kMaxInstructionCount][kBlockSize];
+  absl::InlinedVector<const T*, 32> registers(input_count + instruction_count);
+
+  // Constants are invariant across blocks and only need to be filled once.
+  for (int32_t i = 0; i < instruction_count; ++i) {
+    const int32_t* instruction = &instructions[i * kInstructionWordCount];
+    if (static_cast<Opcode>(instruction[0]) == Opcode::kConstant) {
+      T value;
+      std::memcpy(&value, &instruction[1], sizeof(value));
+      std::fill_n(scratch[i], kBlockSize, value);
+    }
+  }
+
+  const size_t element_count = dst_buffer.size();
+  for (size_t offset = 0; offset < element_count; offset += kBlockSize) {
+    const size_t length =
+        std::min(element_count - offset, static_cast<size_t>(kBlockSize));
+    for (int32_t i = 0; i < input_count; ++i) {
+      registers[i] = src_buffers[i].data() + offset;
+    }
+    for (int32_t i = 0; i < instruction_count; ++i) {
+      const int32_t* instruction = &instructions[i * kInstructionWordCount];
+      auto opcode = static_cast<Opcode>(instruction[0]);
+      // The final result is written directly to the destination.
+      bool is_last = i == instruction_count - 1;
+      T* dst = is_last ? dst_buffer.data() + offset : scratch[i];
+      if (opcode == Opcode::kConstant) {
+        if (is_last) std::copy_n(scratch[i], length, dst);
+      } else {
+        int operand_count = impl::GetFusedOperandCount(opcode);
+        impl::EvaluateFusedInstruction<T>(
+            opcode, registers[instruction[1]],
+            operand_count > 1 ? registers[instruction[2]] : nullptr,
+            operand_count > 2 ? registers[instruction[3]] : nullptr, dst,
+            length);
+      }
+      registers[input_count + i] = dst;
+    }
+  }
+  return OkStatus();
+}
+
+namespace impl {
+
 struct SumKernel {
   template <typename T>
   inline void operator()(T* value0, const T value1) {
@@ -999,6 +2217,107 @@ Status GenericReduce(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+// Vectorized row kernels matching KernelImpl, or nullptr if unavailable.
+template <typename T, typename KernelImpl>
+struct SimdReduceKernels {
+  using ReduceFn = T (*)(const T* src, size_t count, T init);
+  using AccumulateFn = void (*)(const T* src, T* dst, size_t count);
+  static ReduceFn GetReduce() { return nullptr; }
+  static AccumulateFn GetAccumulate() { return nullptr; }
+};
+
+template <typename T, T (*simd::Kernels::*kReduce)(const T*, size_t, T),
+          void (*simd::Kernels::*kAccumulate)(const T*, T*, size_t)>
+struct SimdReduceKernelsImpl {
+  using ReduceFn = T (*)(const T* src, size_t count, T init);
+  using AccumulateFn = void (*)(const T* src, T* dst, size_t count);
+  static ReduceFn GetReduce() {
+    const simd::Kernels* kernels = simd::GetBestKernels();
+    return kernels ? kernels->*kReduce : nullptr;
+  }
+  static AccumulateFn GetAccumulate() {
+    const simd::Kernels* kernels = simd::GetBestKernels();
+    return kernels ? kernels->*kAccumulate : nullptr;
+  }
+};
+
+template <>
+struct SimdReduceKernels<float, SumKernel>
+    : SimdReduceKernelsImpl<float, &simd::Kernels::reduce_sum_f32,
+                            &simd::Kernels::accumulate_sum_f32> {};
+template <>
+struct SimdReduceKernels<float, MinKernel>
+    : SimdReduceKernelsImpl<float, &simd::Kernels::reduce_min_f32,
+                            &simd::Kernels::accumulate_min_f32> {};
+template <>
+struct SimdReduceKernels<float, MaxKernel>
+    : SimdReduceKernelsImpl<float, &simd::Kernels::reduce_max_f32,
+                            &simd::Kernels::accumulate_max_f32> {};
+template <>
+struct SimdReduceKernels<int32_t, SumKernel>
+    : SimdReduceKernelsImpl<int32_t, &simd::Kernels::reduce_sum_i32,
+                            &simd::Kernels::accumulate_sum_i32> {};
+template <>
+struct SimdReduceKernels<int32_t, MinKernel>
+    : SimdReduceKernelsImpl<int32_t, &simd::Kernels::reduce_min_i32,
+                            &simd::Kernels::accumulate_min_i32> {};
+template <>
+struct SimdReduceKernels<int32_t, MaxKernel>
+    : SimdReduceKernelsImpl<int32_t, &simd::Kernels::reduce_max_i32,
+                            &simd::Kernels::accumulate_max_i32> {};
+
+// Applies KernelImpl elementwise as dst[i] = op(dst[i], src[i]).
+template <typename T, typename KernelImpl>
+inline void AccumulateRow(
+    typename SimdReduceKernels<T, KernelImpl>::AccumulateFn accumulate_fn,
+    const T* src, T* dst, size_t count) {
+  if (accumulate_fn) {
+    accumulate_fn(src, dst, count);
+    return;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    KernelImpl()(&dst[i], src[i]);
+  }
+}
+
+// Treats the source as [outer, reduce, inner] and reduces the middle
+// dimension. Each reduced row is contiguous when inner is 1 and is otherwise
+// accumulated into the destination one inner row at a time, so all memory is
+// accessed sequentially.
+template <typename T, typename KernelImpl>
+Status StridedReduce(absl::Span<const T> src_buffer,
+                     absl::Span<const T> init_buffer, absl::Span<T> dst_buffer,
+                     int32_t dimension, ShapeSpan src_shape) {
+  size_t outer_size = GetElementCount(src_shape.subspan(0, dimension));
+  size_t reduce_size = src_shape[dimension];
+  size_t inner_size = GetElementCount(src_shape.subspan(dimension + 1));
+  const T init_value = init_buffer[0];
+  auto reduce_fn = SimdReduceKernels<T, KernelImpl>::GetReduce();
+  auto accumulate_fn = SimdReduceKernels<T, KernelImpl>::GetAccumulate();
+  for (size_t i = 0; i < outer_size; ++i) {
+    const T* src = src_buffer.data() + i * reduce_size * inner_size;
+    T* dst = dst_buffer.data() + i * inner_size;
+    if (inner_size == 1) {
+      if (reduce_fn) {
+        *dst = reduce_fn(src, reduce_size, init_value);
+      } else {
+        T value = init_value;
+        for (size_t j = 0; j < reduce_size; ++j) {
+          KernelImpl()(&value, src[j]);
+        }
+        *dst = value;
+      }
+      continue;
+    }
+    std::fill_n(dst, inner_size, init_value);
+    for (size_t j = 0; j < reduce_size; ++j) {
+      AccumulateRow<T, KernelImpl>(accumulate_fn, src + j * inner_size, dst,
+                                   inner_size);
+    }
+  }
+  return OkStatus();
+}
+
 }  // namespace impl
 
 template <typename T>
@@ -1006,6 +2325,15 @@ Status ReduceSum::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
                           ShapeSpan src_shape, ShapeSpan dst_shape) {
+  return impl::StridedReduce<T, impl::SumKernel>(
+      src_buffer, init_buffer, dst_buffer, dimension, src_shape);
+}
+
+template <typename T>
+Status ReduceSum::ExecuteReference(absl::Span<const T> src_buffer,
+                                   absl::Span<const T> init_buffer,
+                                   absl::Span<T> dst_buffer, int32_t dimension,
+                                   ShapeSpan src_shape, ShapeSpan dst_shape) {
   return impl::GenericReduce<T, impl::SumKernel>(
       src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
 }
@@ -1015,6 +2343,15 @@ Status ReduceMin::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
                           ShapeSpan src_shape, ShapeSpan dst_shape) {
+  return impl::StridedReduce<T, impl::MinKernel>(
+      src_buffer, init_buffer, dst_buffer, dimension, src_shape);
+}
+
+template <typename T>
+Status ReduceMin::ExecuteReference(absl::Span<const T> src_buffer,
+                                   absl::Span<const T> init_buffer,
+                                   absl::Span<T> dst_buffer, int32_t dimension,
+                                   ShapeSpan src_shape, ShapeSpan dst_shape) {
   return impl::GenericReduce<T, impl::MinKernel>(
       src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
 }
@@ -1024,6 +2361,15 @@ Status ReduceMax::Execute(absl::Span<const T> src_buffer,
                           absl::Span<const T> init_buffer,
                           absl::Span<T> dst_buffer, int32_t dimension,
                           ShapeSpan src_shape, ShapeSpan dst_shape) {
+  return impl::StridedReduce<T, impl::MaxKernel>(
+      src_buffer, init_buffer, dst_buffer, dimension, src_shape);
+}
+
+template <typename T>
+Status ReduceMax::ExecuteReference(absl::Span<const T> src_buffer,
+                                   absl::Span<const T> init_buffer,
+                                   absl::Span<T> dst_buffer, int32_t dimension,
+                                   ShapeSpan src_shape, ShapeSpan dst_shape) {
   return impl::GenericReduce<T, impl::MaxKernel>(
       src_buffer, init_buffer, dst_buffer, dimension, src_shape, dst_shape);
 }
@@ -1075,6 +2421,71 @@ Status GenericPooling(absl::Span<const T> src_buffer,
   return OkStatus();
 }
 
+// Pools rows of the innermost dimension when it has a window of 1 and a
+// stride of 1. Each window position then maps to a contiguous row of the
+// source that is accumulated into the destination row.
+template <typename T, typename KernelImpl>
+Status RowPooling(absl::Span<const T> src_buffer,
+                  absl::Span<const T> init_buffer, absl::Span<T> dst_buffer,
+                  ShapeSpan src_shape, ShapeSpan dst_shape,
+                  ShapeSpan window_dimensions, ShapeSpan strides,
+                  ShapeSpan pad_low) {
+  int outer_rank = src_shape.size() - 1;
+  size_t row_size = src_shape[outer_rank];
+  ShapeSpan outer_dst_shape = dst_shape.subspan(0, outer_rank);
+  ShapeSpan outer_window_dimensions = window_dimensions.subspan(0, outer_rank);
+  size_t window_size = GetElementCount(outer_window_dimensions);
+  const T init_value = init_buffer[0];
+  auto accumulate_fn = SimdReduceKernels<T, KernelImpl>::GetAccumulate();
+
+  // Windows extending past the source accumulate the init value as with
+  // GenericPooling.
+  std::vector<T> init_row(row_size, init_value);
+
+  absl::InlinedVector<int, 8> dst_indices(outer_rank, 0);
+  absl::InlinedVector<int, 8> window_indices(outer_rank, 0);
+  for (size_t i = 0, e = GetElementCount(outer_dst_shape); i < e; ++i) {
+    T* dst = dst_buffer.data() + i * row_size;
+    std::fill_n(dst, row_size, init_value);
+    std::fill(window_indices.begin(), window_indices.end(), 0);
+    for (size_t w = 0; w < window_size; ++w) {
+      const T* src = init_row.data();
+      size_t flat_index = 0;
+      bool in_bounds = true;
+      for (int j = 0; j < outer_rank && in_bounds; ++j) {
+        int index =
+            dst_indices[j] * strides[j] - pad_low[j] + window_indices[j];
+        in_bounds = index >= 0 && index < src_shape[j];
+        flat_index = flat_index * src_shape[j] + index;
+      }
+      if (in_bounds) src = src_buffer.data() + flat_index * row_size;
+      AccumulateRow<T, KernelImpl>(accumulate_fn, src, dst, row_size);
+      IncrementShapeIndex(absl::MakeSpan(window_indices),
+                          outer_window_dimensions);
+    }
+    IncrementShapeIndex(absl::MakeSpan(dst_indices), outer_dst_shape);
+  }
+  return OkStatus();
+}
+
+template <typename T, typename KernelImpl>
+Status Pooling(absl::Span<const T> src_buffer, absl::Span<const T> init_buffer,
+               absl::Span<T> dst_buffer, ShapeSpan src_shape,
+               ShapeSpan dst_shape, ShapeSpan window_dimensions,
+               ShapeSpan strides, ShapeSpan pad_low) {
+  int inner_dim = static_cast<int>(src_shape.size()) - 1;
+  if (inner_dim >= 0 && window_dimensions[inner_dim] == 1 &&
+      strides[inner_dim] == 1 && pad_low[inner_dim] == 0 &&
+      src_shape[inner_dim] == dst_shape[inner_dim]) {
+    return RowPooling<T, KernelImpl>(src_buffer, init_buffer, dst_buffer,
+                                     src_shape, dst_shape, window_dimensions,
+                                     strides, pad_low);
+  }
+  return GenericPooling<T, KernelImpl>(src_buffer, init_buffer, dst_buffer,
+                                       src_shape, dst_shape, window_dimensions,
+                                       strides, pad_low);
+}
+
 }  // namespace impl
 
 template <typename T>
@@ -1083,6 +2494,16 @@ Status PoolingSum::Execute(absl::Span<const T> src_buffer,
                            absl::Span<T> dst_buffer, ShapeSpan src_shape,
                            ShapeSpan dst_shape, ShapeSpan window_dimensions,
                            ShapeSpan strides, ShapeSpan pad_low) {
+  return impl::Pooling<T, impl::SumKernel>(src_buffer, init_buffer, dst_buffer,
+                                           src_shape, dst_shape,
+                                           window_dimensions, strides, pad_low);
+}
+
+template <typename T>
+Status PoolingSum::ExecuteReference(
+    absl::Span<const T> src_buffer, absl::Span<const T> init_buffer,
+    absl::Span<T> dst_buffer, ShapeSpan src_shape, ShapeSpan dst_shape,
+    ShapeSpan window_dimensions, ShapeSpan strides, ShapeSpan pad_low) {
   return impl::GenericPooling<T, impl::SumKernel>(
       src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
       window_dimensions, strides, pad_low);
@@ -1094,6 +2515,16 @@ Status PoolingMin::Execute(absl::Span<const T> src_buffer,
                            absl::Span<T> dst_buffer, ShapeSpan src_shape,
                            ShapeSpan dst_shape, ShapeSpan window_dimensions,
                            ShapeSpan strides, ShapeSpan pad_low) {
+  return impl::Pooling<T, impl::MinKernel>(src_buffer, init_buffer, dst_buffer,
+                                           src_shape, dst_shape,
+                                           window_dimensions, strides, pad_low);
+}
+
+template <typename T>
+Status PoolingMin::ExecuteReference(
+    absl::Span<const T> src_buffer, absl::Span<const T> init_buffer,
+    absl::Span<T> dst_buffer, ShapeSpan src_shape, ShapeSpan dst_shape,
+    ShapeSpan window_dimensions, ShapeSpan strides, ShapeSpan pad_low) {
   return impl::GenericPooling<T, impl::MinKernel>(
       src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
       window_dimensions, strides, pad_low);
@@ -1105,6 +2536,16 @@ Status PoolingMax::Execute(absl::Span<const T> src_buffer,
                            absl::Span<T> dst_buffer, ShapeSpan src_shape,
                            ShapeSpan dst_shape, ShapeSpan window_dimensions,
                            ShapeSpan strides, ShapeSpan pad_low) {
+  return impl::Pooling<T, impl::MaxKernel>(src_buffer, init_buffer, dst_buffer,
+                                           src_shape, dst_shape,
+                                           window_dimensions, strides, pad_low);
+}
+
+template <typename T>
+Status PoolingMax::ExecuteReference(
+    absl::Span<const T> src_buffer, absl::Span<const T> init_buffer,
+    absl::Span<T> dst_buffer, ShapeSpan src_shape, ShapeSpan dst_shape,
+    ShapeSpan window_dimensions, ShapeSpan strides, ShapeSpan pad_low) {
   return impl::GenericPooling<T, impl::MaxKernel>(
       src_buffer, init_buffer, dst_buffer, src_shape, dst_shape,
       window_dimensions, strides, pad_low);
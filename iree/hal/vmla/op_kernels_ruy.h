@@ -15,10 +15,13 @@
 #ifndef IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 #define IREE_HAL_VMLA_OP_KERNELS_RUY_H_
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "iree/base/status.h"
 #include "ruy/context.h"
 #include "ruy/mul_params.h"
@@ -29,11 +32,38 @@ namespace hal {
 namespace vmla {
 namespace kernels {
 
-// TODO(benvanik): something more clever for making this shareable.
-// Maybe a factory fn based on the impl selected?
+// Shared across all contexts using the VMLA module and used concurrently by
+// tiles running on different threads. ruy::Context is not thread-safe so each
+// Mul leases a context from a pool for its duration. The pool grows to the
+// peak number of concurrent callers and contexts are reused afterward so their
+// packing buffers and tuning state stay warm.
+//
+// Contexts are kept single-threaded: parallelism comes from dispatching tiles
+// across the host workers and a ruy thread pool per context would
+// oversubscribe the machine.
 struct MatMul::RuntimeState {
-  // TODO(benvanik): share the thread pool but keep context per-fiber?
-  ruy::Context context;
+  // Acquires a context for exclusive use by the caller until it is returned
+  // with ReleaseContext.
+  std::unique_ptr<ruy::Context> AcquireContext() {
+    absl::MutexLock lock(&mutex);
+    if (idle_contexts.empty()) {
+      auto context = absl::make_unique<ruy::Context>();
+      context->set_max_num_threads(1);
+      return context;
+    }
+    auto context = std::move(idle_contexts.back());
+    idle_contexts.pop_back();
+    return context;
+  }
+
+  void ReleaseContext(std::unique_ptr<ruy::Context> context) {
+    absl::MutexLock lock(&mutex);
+    idle_contexts.push_back(std::move(context));
+  }
+
+  absl::Mutex mutex;
+  std::vector<std::unique_ptr<ruy::Context>> idle_contexts
+      ABSL_GUARDED_BY(mutex);
 };
 
 inline std::unique_ptr<MatMul::RuntimeState> MatMul::CreateRuntimeState() {
@@ -111,11 +141,149 @@ Status MatMul::Execute(RuntimeState* runtime_state,
   ruy::MulParams<ACC, T> mul_params;
   MakeRuyMulParams(buffers, &mul_params);
 
-  ruy::Mul(lhs, rhs, mul_params, &runtime_state->context, &dst);
+  auto context = runtime_state->AcquireContext();
+  ruy::Mul(lhs, rhs, mul_params, context.get(), &dst);
+  runtime_state->ReleaseContext(std::move(context));
 
   return OkStatus();
 }
 
+template <typename T>
+Status Conv2D::ExecuteIm2Col(
+    MatMul::RuntimeState* runtime_state, absl::Span<const T> input_buffer,
+    ShapeSpan input_shape, absl::Span<const T> filter_buffer,
+    ShapeSpan filter_shape, absl::Span<T> dst_buffer, ShapeSpan dst_shape,
+    ShapeSpan window_strides, ShapeSpan pad_h, ShapeSpan pad_w,
+    ShapeSpan lhs_dilation, ShapeSpan rhs_dilation, const int32_t groups) {
+  static_assert(std::is_floating_point<T>::value,
+                "im2col Conv2D only supports floating-point types");
+  if (lhs_dilation[0] != 1 || lhs_dilation[1] != 1) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "im2col Conv2D does not support lhs dilation";
+  }
+  const int input_h = input_shape[0];
+  const int input_w = input_shape[1];
+  const int input_channels = input_shape[2];
+  const int kernel_h = filter_shape[0];
+  const int kernel_w = filter_shape[1];
+  const int dst_h = dst_shape[0];
+  const int dst_w = dst_shape[1];
+  const int dst_channels = dst_shape[2];
+  const int input_group_size = input_channels / groups;
+  const int output_group_size = dst_channels / groups;
+
+  // Each output pixel is one row of the [patch_count, patch_size] im2col
+  // matrix; multiplying it by the [patch_size, output_group_size] filter
+  // produces the output channels of the group for every pixel at once.
+  const int patch_count = dst_h * dst_w;
+  const int patch_size = kernel_h * kernel_w * input_group_size;
+
+  // Pointwise convolutions already have their patches laid out as rows.
+  const bool is_pointwise =
+      groups == 1 && kernel_h == 1 && kernel_w == 1 && window_strides[0] == 1 &&
+      window_strides[1] == 1 && pad_h[0] == 0 && pad_w[0] == 0 &&
+      dst_h == input_h && dst_w == input_w;
+
+  std::vector<T> patches;
+  if (!is_pointwise) patches.resize(patch_count * patch_size);
+  std::vector<T> group_filter;
+  if (groups > 1) group_filter.resize(patch_size * output_group_size);
+
+  for (int g = 0; g < groups; ++g) {
+    const T* lhs_data = input_buffer.data();
+    if (!is_pointwise) {
+      for (int ho = 0; ho < dst_h; ++ho) {
+        for (int wo = 0; wo < dst_w; ++wo) {
+          T* patch = patches.data() + (ho * dst_w + wo) * patch_size;
+          for (int kh = 0; kh < kernel_h; ++kh) {
+            const int ih =
+                ho * window_strides[0] + kh * rhs_dilation[0] - pad_h[0];
+            for (int kw = 0; kw < kernel_w; ++kw) {
+              const int iw =
+                  wo * window_strides[1] + kw * rhs_dilation[1] - pad_w[0];
+              T* patch_row = patch + (kh * kernel_w + kw) * input_group_size;
+              if (ih < 0 || ih >= input_h || iw < 0 || iw >= input_w) {
+                std::fill_n(patch_row, input_group_size, T(0));
+              } else {
+                std::copy_n(input_buffer.data() +
+                                (ih * input_w + iw) * input_channels +
+                                g * input_group_size,
+                            input_group_size, patch_row);
+              }
+            }
+          }
+        }
+      }
+      lhs_data = patches.data();
+    }
+
+    // With a single group the HWIO filter is already a row-major
+    // [patch_size, output_channels] matrix; otherwise gather the rows of the
+    // input channels belonging to the group.
+    const T* rhs_data = filter_buffer.data();
+    if (groups > 1) {
+      for (int k = 0; k < kernel_h * kernel_w; ++k) {
+        for (int ci = 0; ci < input_group_size; ++ci) {
+          std::copy_n(filter_buffer.data() +
+                          (k * input_channels + g * input_group_size + ci) *
+                              output_group_size,
+                      output_group_size,
+                      group_filter.data() +
+                          (k * input_group_size + ci) * output_group_size);
+        }
+      }
+      rhs_data = group_filter.data();
+    }
+
+    ruy::Matrix<T> lhs;
+    lhs.set_data(lhs_data);
+    ruy::MakeSimpleLayout(patch_count, patch_size, ruy::Order::kRowMajor,
+                          lhs.mutable_layout());
+
+    ruy::Matrix<T> rhs;
+    rhs.set_data(rhs_data);
+    ruy::MakeSimpleLayout(patch_size, output_group_size, ruy::Order::kRowMajor,
+                          rhs.mutable_layout());
+
+    // Groups write a column slice of the HWC destination.
+    ruy::Matrix<T> dst;
+    dst.set_data(dst_buffer.data() + g * output_group_size);
+    dst.mutable_layout()->set_rows(patch_count);
+    dst.mutable_layout()->set_cols(output_group_size);
+    dst.mutable_layout()->set_order(ruy::Order::kRowMajor);
+    dst.mutable_layout()->set_stride(dst_channels);
+
+    ruy::MulParams<T, T> mul_params;
+    auto context = runtime_state->AcquireContext();
+    ruy::Mul(lhs, rhs, mul_params, context.get(), &dst);
+    runtime_state->ReleaseContext(std::move(context));
+  }
+  return OkStatus();
+}
+
+template <typename T>
+Status Conv2D::Execute(MatMul::RuntimeState* runtime_state,
+                       absl::Span<const T> input_buffer, ShapeSpan input_shape,
+                       absl::Span<const T> filter_buffer,
+                       ShapeSpan filter_shape, absl::Span<T> dst_buffer,
+                       ShapeSpan dst_shape, ShapeSpan window_strides,
+                       ShapeSpan pad_h, ShapeSpan pad_w, ShapeSpan lhs_dilation,
+                       ShapeSpan rhs_dilation, const int32_t groups) {
+  if (groups > 1 && input_shape[2] == groups) {
+    return ExecuteDepthwise(input_buffer, input_shape, filter_buffer,
+                            filter_shape, dst_buffer, dst_shape, window_strides,
+                            pad_h, pad_w, lhs_dilation, rhs_dilation, groups);
+  } else if (lhs_dilation[0] == 1 && lhs_dilation[1] == 1) {
+    return ExecuteIm2Col(runtime_state, input_buffer, input_shape,
+                         filter_buffer, filter_shape, dst_buffer, dst_shape,
+                         window_strides, pad_h, pad_w, lhs_dilation,
+                         rhs_dilation, groups);
+  }
+  return ExecuteReference(input_buffer, input_shape, filter_buffer,
+                          filter_shape, dst_buffer, dst_shape, window_strides,
+                          pad_h, pad_w, lhs_dilation, rhs_dilation, groups);
+}
+
 }  // namespace kernels
 }  // namespace vmla
 }  // namespace hal
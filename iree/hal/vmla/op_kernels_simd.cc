@@ -0,0 +1,442 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/op_kernels_simd.h"
+
+#include <cmath>
+#include <cstring>
+
+// x86 kernels are compiled for each instruction set with function-level target
+// attributes so that the binary runs on any x86-64 CPU and selects the
+// kernels at runtime. This requires GCC or clang.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+#define IREE_VMLA_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+// NEON is part of the base aarch64 instruction set.
+#define IREE_VMLA_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+// Each Vec struct provides the vector operations used by
+// op_kernels_simd_impl.h:
+//   F/I: float and int32 vector types.
+//   kWidth: the number of lanes in each vector.
+//   kRsqrtRefinementSteps: Newton-Raphson steps needed for a full precision
+//     reciprocal square root from RsqrtEstimate.
+// Comparisons return a mask usable with Select(mask, if_true, if_false).
+// Comparisons against NaN are false.
+// TransposeTile transposes a kTransposeTile x kTransposeTile block of 32-bit
+// elements in registers.
+
+#if defined(IREE_VMLA_SIMD_X86)
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+namespace sse41 {
+constexpr const char* kIsaName = "sse4.1";
+struct Vec {
+  using F = __m128;
+  using I = __m128i;
+  static constexpr int kWidth = 4;
+  static constexpr int kRsqrtRefinementSteps = 1;
+
+  static F LoadF(const float* p) { return _mm_loadu_ps(p); }
+  static void StoreF(float* p, F v) { _mm_storeu_ps(p, v); }
+  static F SplatF(float v) { return _mm_set1_ps(v); }
+  static F Add(F a, F b) { return _mm_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm_div_ps(a, b); }
+  static F Min(F a, F b) { return _mm_min_ps(a, b); }
+  static F Max(F a, F b) { return _mm_max_ps(a, b); }
+  static F MulAdd(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+  static F Floor(F a) { return _mm_floor_ps(a); }
+  static F RsqrtEstimate(F a) { return _mm_rsqrt_ps(a); }
+  static F Lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+  static F Eq(F a, F b) { return _mm_cmpeq_ps(a, b); }
+  static F IsNan(F a) { return _mm_cmpunord_ps(a, a); }
+  static F Select(F mask, F a, F b) { return _mm_blendv_ps(b, a, mask); }
+
+  static I LoadI(const int32_t* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+  }
+  static void StoreI(int32_t* p, I v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+  }
+  static I SplatI(int32_t v) { return _mm_set1_epi32(v); }
+  static I AddI(I a, I b) { return _mm_add_epi32(a, b); }
+  static I SubI(I a, I b) { return _mm_sub_epi32(a, b); }
+  static I MinI(I a, I b) { return _mm_min_epi32(a, b); }
+  static I MaxI(I a, I b) { return _mm_max_epi32(a, b); }
+  static I AndI(I a, I b) { return _mm_and_si128(a, b); }
+  static I OrI(I a, I b) { return _mm_or_si128(a, b); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return _mm_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return _mm_srli_epi32(a, N);
+  }
+  static I FloatToInt(F a) { return _mm_cvttps_epi32(a); }
+  static F IntToFloat(I a) { return _mm_cvtepi32_ps(a); }
+  static I BitcastToInt(F a) { return _mm_castps_si128(a); }
+  static F BitcastToFloat(I a) { return _mm_castsi128_ps(a); }
+
+  static constexpr int kTransposeTile = 4;
+  static void TransposeTile(const uint32_t* src, size_t src_stride,
+                            uint32_t* dst, size_t dst_stride) {
+    F r0 = BitcastToFloat(LoadI(reinterpret_cast<const int32_t*>(src)));
+    F r1 = BitcastToFloat(
+        LoadI(reinterpret_cast<const int32_t*>(src + src_stride)));
+    F r2 = BitcastToFloat(
+        LoadI(reinterpret_cast<const int32_t*>(src + 2 * src_stride)));
+    F r3 = BitcastToFloat(
+        LoadI(reinterpret_cast<const int32_t*>(src + 3 * src_stride)));
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    StoreI(reinterpret_cast<int32_t*>(dst), BitcastToInt(r0));
+    StoreI(reinterpret_cast<int32_t*>(dst + dst_stride), BitcastToInt(r1));
+    StoreI(reinterpret_cast<int32_t*>(dst + 2 * dst_stride), BitcastToInt(r2));
+    StoreI(reinterpret_cast<int32_t*>(dst + 3 * dst_stride), BitcastToInt(r3));
+  }
+};
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // NOLINT
+}  // namespace sse41
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+namespace avx2 {
+constexpr const char* kIsaName = "avx2";
+struct Vec {
+  using F = __m256;
+  using I = __m256i;
+  static constexpr int kWidth = 8;
+  static constexpr int kRsqrtRefinementSteps = 1;
+
+  static F LoadF(const float* p) { return _mm256_loadu_ps(p); }
+  static void StoreF(float* p, F v) { _mm256_storeu_ps(p, v); }
+  static F SplatF(float v) { return _mm256_set1_ps(v); }
+  static F Add(F a, F b) { return _mm256_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm256_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm256_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm256_div_ps(a, b); }
+  static F Min(F a, F b) { return _mm256_min_ps(a, b); }
+  static F Max(F a, F b) { return _mm256_max_ps(a, b); }
+  static F MulAdd(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+  static F Floor(F a) { return _mm256_floor_ps(a); }
+  static F RsqrtEstimate(F a) { return _mm256_rsqrt_ps(a); }
+  static F Lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static F Eq(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static F IsNan(F a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+  static F Select(F mask, F a, F b) { return _mm256_blendv_ps(b, a, mask); }
+
+  static I LoadI(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  }
+  static void StoreI(int32_t* p, I v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+  }
+  static I SplatI(int32_t v) { return _mm256_set1_epi32(v); }
+  static I AddI(I a, I b) { return _mm256_add_epi32(a, b); }
+  static I SubI(I a, I b) { return _mm256_sub_epi32(a, b); }
+  static I MinI(I a, I b) { return _mm256_min_epi32(a, b); }
+  static I MaxI(I a, I b) { return _mm256_max_epi32(a, b); }
+  static I AndI(I a, I b) { return _mm256_and_si256(a, b); }
+  static I OrI(I a, I b) { return _mm256_or_si256(a, b); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return _mm256_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return _mm256_srli_epi32(a, N);
+  }
+  static I FloatToInt(F a) { return _mm256_cvttps_epi32(a); }
+  static F IntToFloat(I a) { return _mm256_cvtepi32_ps(a); }
+  static I BitcastToInt(F a) { return _mm256_castps_si256(a); }
+  static F BitcastToFloat(I a) { return _mm256_castsi256_ps(a); }
+
+  static constexpr int kTransposeTile = 8;
+  static void TransposeTile(const uint32_t* src, size_t src_stride,
+                            uint32_t* dst, size_t dst_stride) {
+    F r[8];
+    for (int i = 0; i < 8; ++i) {
+      r[i] = BitcastToFloat(
+          LoadI(reinterpret_cast<const int32_t*>(src + i * src_stride)));
+    }
+    // Interleave pairs of rows, then pairs of pairs, then swap the 128-bit
+    // halves.
+    F t[8];
+    for (int i = 0; i < 8; i += 2) {
+      t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+      t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+    }
+    for (int i = 0; i < 8; i += 4) {
+      r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+      r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+      r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+    for (int i = 0; i < 4; ++i) {
+      t[i] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x20);
+      t[i + 4] = _mm256_permute2f128_ps(r[i], r[i + 4], 0x31);
+    }
+    for (int i = 0; i < 8; ++i) {
+      StoreI(reinterpret_cast<int32_t*>(dst + i * dst_stride),
+             BitcastToInt(t[i]));
+    }
+  }
+};
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // NOLINT
+}  // namespace avx2
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), \
+                             apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC's AVX-512 intrinsics pass _mm512_undefined_* values as the masked-off
+// sources, which trips -Wmaybe-uninitialized once inlined into the kernels.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+namespace avx512 {
+constexpr const char* kIsaName = "avx512f";
+struct Vec {
+  using F = __m512;
+  using I = __m512i;
+  using M = __mmask16;
+  static constexpr int kWidth = 16;
+  static constexpr int kRsqrtRefinementSteps = 1;
+
+  static F LoadF(const float* p) { return _mm512_loadu_ps(p); }
+  static void StoreF(float* p, F v) { _mm512_storeu_ps(p, v); }
+  static F SplatF(float v) { return _mm512_set1_ps(v); }
+  static F Add(F a, F b) { return _mm512_add_ps(a, b); }
+  static F Sub(F a, F b) { return _mm512_sub_ps(a, b); }
+  static F Mul(F a, F b) { return _mm512_mul_ps(a, b); }
+  static F Div(F a, F b) { return _mm512_div_ps(a, b); }
+  static F Min(F a, F b) { return _mm512_min_ps(a, b); }
+  static F Max(F a, F b) { return _mm512_max_ps(a, b); }
+  static F MulAdd(F a, F b, F c) { return _mm512_fmadd_ps(a, b, c); }
+  static F Floor(F a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+  }
+  static F RsqrtEstimate(F a) { return _mm512_rsqrt14_ps(a); }
+  static M Lt(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static M Eq(F a, F b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static M IsNan(F a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+  static F Select(M mask, F a, F b) { return _mm512_mask_blend_ps(mask, b, a); }
+
+  static I LoadI(const int32_t* p) { return _mm512_loadu_si512(p); }
+  static void StoreI(int32_t* p, I v) { _mm512_storeu_si512(p, v); }
+  static I SplatI(int32_t v) { return _mm512_set1_epi32(v); }
+  static I AddI(I a, I b) { return _mm512_add_epi32(a, b); }
+  static I SubI(I a, I b) { return _mm512_sub_epi32(a, b); }
+  static I MinI(I a, I b) { return _mm512_min_epi32(a, b); }
+  static I MaxI(I a, I b) { return _mm512_max_epi32(a, b); }
+  static I AndI(I a, I b) { return _mm512_and_si512(a, b); }
+  static I OrI(I a, I b) { return _mm512_or_si512(a, b); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return _mm512_slli_epi32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return _mm512_srli_epi32(a, N);
+  }
+  static I FloatToInt(F a) { return _mm512_cvttps_epi32(a); }
+  static F IntToFloat(I a) { return _mm512_cvtepi32_ps(a); }
+  static I BitcastToInt(F a) { return _mm512_castps_si512(a); }
+  static F BitcastToFloat(I a) { return _mm512_castsi512_ps(a); }
+
+  // 256-bit tiles avoid the long shuffle chains of 16x16 tiles.
+  static constexpr int kTransposeTile = avx2::Vec::kTransposeTile;
+  static void TransposeTile(const uint32_t* src, size_t src_stride,
+                            uint32_t* dst, size_t dst_stride) {
+    avx2::Vec::TransposeTile(src, src_stride, dst, dst_stride);
+  }
+};
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // NOLINT
+}  // namespace avx512
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+bool IsIsaSupported(Isa isa) {
+  __builtin_cpu_init();
+  switch (isa) {
+    case Isa::kSse41:
+      return __builtin_cpu_supports("sse4.1");
+    case Isa::kAvx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case Isa::kAvx512:
+      return __builtin_cpu_supports("avx512f");
+    default:
+      return false;
+  }
+}
+
+const Kernels* GetKernels(Isa isa) {
+  if (!IsIsaSupported(isa)) return nullptr;
+  switch (isa) {
+    case Isa::kSse41:
+      return &sse41::kKernels;
+    case Isa::kAvx2:
+      return &avx2::kKernels;
+    case Isa::kAvx512:
+      return &avx512::kKernels;
+    default:
+      return nullptr;
+  }
+}
+
+#elif defined(IREE_VMLA_SIMD_NEON)
+
+namespace neon {
+constexpr const char* kIsaName = "neon";
+struct Vec {
+  using F = float32x4_t;
+  using I = int32x4_t;
+  using M = uint32x4_t;
+  static constexpr int kWidth = 4;
+  // The NEON estimate is only accurate to ~8 bits.
+  static constexpr int kRsqrtRefinementSteps = 2;
+
+  static F LoadF(const float* p) { return vld1q_f32(p); }
+  static void StoreF(float* p, F v) { vst1q_f32(p, v); }
+  static F SplatF(float v) { return vdupq_n_f32(v); }
+  static F Add(F a, F b) { return vaddq_f32(a, b); }
+  static F Sub(F a, F b) { return vsubq_f32(a, b); }
+  static F Mul(F a, F b) { return vmulq_f32(a, b); }
+  static F Div(F a, F b) { return vdivq_f32(a, b); }
+  static F Min(F a, F b) { return vminq_f32(a, b); }
+  static F Max(F a, F b) { return vmaxq_f32(a, b); }
+  static F MulAdd(F a, F b, F c) { return vfmaq_f32(c, a, b); }
+  static F Floor(F a) { return vrndmq_f32(a); }
+  static F RsqrtEstimate(F a) { return vrsqrteq_f32(a); }
+  static M Lt(F a, F b) { return vcltq_f32(a, b); }
+  static M Eq(F a, F b) { return vceqq_f32(a, b); }
+  static M IsNan(F a) { return vmvnq_u32(vceqq_f32(a, a)); }
+  static F Select(M mask, F a, F b) { return vbslq_f32(mask, a, b); }
+
+  static I LoadI(const int32_t* p) { return vld1q_s32(p); }
+  static void StoreI(int32_t* p, I v) { vst1q_s32(p, v); }
+  static I SplatI(int32_t v) { return vdupq_n_s32(v); }
+  static I AddI(I a, I b) { return vaddq_s32(a, b); }
+  static I SubI(I a, I b) { return vsubq_s32(a, b); }
+  static I MinI(I a, I b) { return vminq_s32(a, b); }
+  static I MaxI(I a, I b) { return vmaxq_s32(a, b); }
+  static I AndI(I a, I b) { return vandq_s32(a, b); }
+  static I OrI(I a, I b) { return vorrq_s32(a, b); }
+  template <int N>
+  static I ShiftLeft(I a) {
+    return vshlq_n_s32(a, N);
+  }
+  template <int N>
+  static I ShiftRightLogical(I a) {
+    return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), N));
+  }
+  static I FloatToInt(F a) { return vcvtq_s32_f32(a); }
+  static F IntToFloat(I a) { return vcvtq_f32_s32(a); }
+  static I BitcastToInt(F a) { return vreinterpretq_s32_f32(a); }
+  static F BitcastToFloat(I a) { return vreinterpretq_f32_s32(a); }
+
+  static constexpr int kTransposeTile = 4;
+  static void TransposeTile(const uint32_t* src, size_t src_stride,
+                            uint32_t* dst, size_t dst_stride) {
+    uint32x4x2_t r01 =
+        vtrnq_u32(vld1q_u32(src), vld1q_u32(src + src_stride));
+    uint32x4x2_t r23 = vtrnq_u32(vld1q_u32(src + 2 * src_stride),
+                                 vld1q_u32(src + 3 * src_stride));
+    vst1q_u32(dst, vcombine_u32(vget_low_u32(r01.val[0]),
+                                vget_low_u32(r23.val[0])));
+    vst1q_u32(dst + dst_stride, vcombine_u32(vget_low_u32(r01.val[1]),
+                                             vget_low_u32(r23.val[1])));
+    vst1q_u32(dst + 2 * dst_stride, vcombine_u32(vget_high_u32(r01.val[0]),
+                                                 vget_high_u32(r23.val[0])));
+    vst1q_u32(dst + 3 * dst_stride, vcombine_u32(vget_high_u32(r01.val[1]),
+                                                 vget_high_u32(r23.val[1])));
+  }
+};
+#include "iree/hal/vmla/op_kernels_simd_impl.h"  // NOLINT
+}  // namespace neon
+
+bool IsIsaSupported(Isa isa) { return isa == Isa::kNeon; }
+
+const Kernels* GetKernels(Isa isa) {
+  return isa == Isa::kNeon ? &neon::kKernels : nullptr;
+}
+
+#else
+
+bool IsIsaSupported(Isa isa) { return false; }
+
+const Kernels* GetKernels(Isa isa) { return nullptr; }
+
+#endif  // IREE_VMLA_SIMD_*
+
+const Kernels* GetBestKernels() {
+  static const Kernels* best_kernels = []() -> const Kernels* {
+    const Isa kPreferredIsas[] = {Isa::kAvx512, Isa::kAvx2, Isa::kSse41,
+                                  Isa::kNeon};
+    for (Isa isa : kPreferredIsas) {
+      if (const Kernels* kernels = GetKernels(isa)) return kernels;
+    }
+    return nullptr;
+  }();
+  return best_kernels;
+}
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,96 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Vectorized inner loops used by the VMLA kernels.
+//
+// Each supported instruction set provides a table of kernels operating on
+// contiguous memory. The kernels in op_kernels_generic.h select the best table
+// for the running CPU and fall back to their scalar implementations when no
+// table (or table entry) is available.
+
+#ifndef IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+#define IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace kernels {
+namespace simd {
+
+// Instruction sets that may have vectorized kernels.
+enum class Isa {
+  kSse41,
+  kAvx2,
+  kAvx512,
+  kNeon,
+};
+
+// A table of vectorized kernels for a single instruction set.
+//
+// Transcendental kernels use polynomial approximations accurate to a few ulp
+// and follow the IEEE results for special values (0, inf, NaN). Denormal
+// results may be flushed to zero.
+struct Kernels {
+  // Name of the instruction set (such as "avx2").
+  const char* name;
+
+  // dst[i] = f(src[i]) for |count| elements.
+  void (*exp_f32)(const float* src, float* dst, size_t count);
+  void (*log_f32)(const float* src, float* dst, size_t count);
+  void (*tanh_f32)(const float* src, float* dst, size_t count);
+  void (*rsqrt_f32)(const float* src, float* dst, size_t count);
+
+  // Returns op(init, src[0], ..., src[count - 1]). Elements may be combined in
+  // any order.
+  float (*reduce_sum_f32)(const float* src, size_t count, float init);
+  float (*reduce_min_f32)(const float* src, size_t count, float init);
+  float (*reduce_max_f32)(const float* src, size_t count, float init);
+  int32_t (*reduce_sum_i32)(const int32_t* src, size_t count, int32_t init);
+  int32_t (*reduce_min_i32)(const int32_t* src, size_t count, int32_t init);
+  int32_t (*reduce_max_i32)(const int32_t* src, size_t count, int32_t init);
+
+  // dst[i] = op(dst[i], src[i]) for |count| elements.
+  void (*accumulate_sum_f32)(const float* src, float* dst, size_t count);
+  void (*accumulate_min_f32)(const float* src, float* dst, size_t count);
+  void (*accumulate_max_f32)(const float* src, float* dst, size_t count);
+  void (*accumulate_sum_i32)(const int32_t* src, int32_t* dst, size_t count);
+  void (*accumulate_min_i32)(const int32_t* src, int32_t* dst, size_t count);
+  void (*accumulate_max_i32)(const int32_t* src, int32_t* dst, size_t count);
+
+  // Transposes a |rows| x |cols| matrix of 32-bit elements:
+  // dst[col * dst_stride + row] = src[row * src_stride + col].
+  void (*transpose_x32)(const uint32_t* src, size_t src_stride, uint32_t* dst,
+                        size_t dst_stride, size_t rows, size_t cols);
+};
+
+// Returns true if |isa| is compiled into this binary and supported by the CPU.
+bool IsIsaSupported(Isa isa);
+
+// Returns the kernels for |isa| or nullptr if it is not supported.
+const Kernels* GetKernels(Isa isa);
+
+// Returns the kernels for the widest instruction set supported by the CPU or
+// nullptr if none are available. The result is computed once per process.
+const Kernels* GetBestKernels();
+
+}  // namespace simd
+}  // namespace kernels
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_OP_KERNELS_SIMD_H_
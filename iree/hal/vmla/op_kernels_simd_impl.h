@@ -0,0 +1,326 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Instruction set independent implementations of the kernels in
+// op_kernels_simd.h.
+//
+// NOTE: this file has no include guard. It is included by op_kernels_simd.cc
+// once per instruction set, inside a namespace that defines:
+//   kIsaName: the name of the instruction set.
+//   Vec: a struct of static vector operations (see op_kernels_simd.cc).
+// so that every function here is compiled with that instruction set enabled.
+
+using F = Vec::F;
+using I = Vec::I;
+
+inline F Abs(F x) {
+  return Vec::BitcastToFloat(
+      Vec::AndI(Vec::BitcastToInt(x), Vec::SplatI(0x7FFFFFFF)));
+}
+
+// Returns |magnitude| with the sign of |sign|.
+inline F CopySign(F magnitude, F sign) {
+  I sign_bit =
+      Vec::AndI(Vec::BitcastToInt(sign), Vec::SplatI(INT32_C(-2147483647) - 1));
+  return Vec::BitcastToFloat(
+      Vec::OrI(Vec::BitcastToInt(Abs(magnitude)), sign_bit));
+}
+
+// Returns 2^e for integers e in [-126, 127].
+inline F Pow2(I e) {
+  return Vec::BitcastToFloat(
+      Vec::ShiftLeft<23>(Vec::AddI(e, Vec::SplatI(127))));
+}
+
+// Cephes-style expf: range reduction by ln(2) and a degree 5 polynomial.
+inline F Exp(F x) {
+  const F kMin = Vec::SplatF(-87.3365478515625f);  // ln(FLT_MIN)
+  const F kMax = Vec::SplatF(88.72283935546875f);  // ln(FLT_MAX)
+  F clamped = Vec::Min(Vec::Max(x, kMin), kMax);
+
+  // n = round(x / ln(2)), r = x - n * ln(2) in two parts for precision.
+  F n = Vec::Floor(Vec::MulAdd(clamped, Vec::SplatF(1.44269504088896341f),
+                               Vec::SplatF(0.5f)));
+  F r = Vec::MulAdd(n, Vec::SplatF(-0.693359375f), clamped);
+  r = Vec::MulAdd(n, Vec::SplatF(2.12194440e-4f), r);
+
+  F y = Vec::SplatF(1.9875691500e-4f);
+  y = Vec::MulAdd(y, r, Vec::SplatF(1.3981999507e-3f));
+  y = Vec::MulAdd(y, r, Vec::SplatF(8.3334519073e-3f));
+  y = Vec::MulAdd(y, r, Vec::SplatF(4.1665795894e-2f));
+  y = Vec::MulAdd(y, r, Vec::SplatF(1.6666665459e-1f));
+  y = Vec::MulAdd(y, r, Vec::SplatF(5.0000001201e-1f));
+  y = Vec::MulAdd(y, Vec::Mul(r, r), r);
+  y = Vec::Add(y, Vec::SplatF(1.0f));
+
+  // Scale by 2^n in two steps as n may be up to 128, which does not fit in the
+  // exponent field.
+  I n_int = Vec::FloatToInt(n);
+  I n_low = Vec::MinI(n_int, Vec::SplatI(64));
+  I n_high = Vec::SubI(n_int, n_low);
+  y = Vec::Mul(Vec::Mul(y, Pow2(n_low)), Pow2(n_high));
+
+  y = Vec::Select(Vec::Lt(x, kMin), Vec::SplatF(0.0f), y);
+  y = Vec::Select(Vec::Lt(kMax, x), Vec::SplatF(INFINITY), y);
+  return Vec::Select(Vec::IsNan(x), x, y);
+}
+
+// Cephes-style logf: splits x into 2^e * m with m in [sqrt(0.5), sqrt(2)) and
+// evaluates a degree 9 polynomial in m - 1.
+inline F Log(F x) {
+  const F kOne = Vec::SplatF(1.0f);
+  // Scale denormals into the normal range.
+  auto denormal = Vec::Lt(x, Vec::SplatF(1.17549435e-38f));
+  F normal = Vec::Select(denormal, Vec::Mul(x, Vec::SplatF(8388608.0f)), x);
+
+  I bits = Vec::BitcastToInt(normal);
+  F e = Vec::IntToFloat(
+      Vec::SubI(Vec::ShiftRightLogical<23>(bits), Vec::SplatI(126)));
+  e = Vec::Select(denormal, Vec::Sub(e, Vec::SplatF(23.0f)), e);
+  F m = Vec::BitcastToFloat(Vec::OrI(Vec::AndI(bits, Vec::SplatI(0x007FFFFF)),
+                                     Vec::SplatI(0x3F000000)));
+
+  auto below_sqrt_half = Vec::Lt(m, Vec::SplatF(0.707106781186547524f));
+  e = Vec::Select(below_sqrt_half, Vec::Sub(e, kOne), e);
+  m = Vec::Sub(Vec::Select(below_sqrt_half, Vec::Add(m, m), m), kOne);
+
+  F z = Vec::Mul(m, m);
+  F y = Vec::SplatF(7.0376836292e-2f);
+  y = Vec::MulAdd(y, m, Vec::SplatF(-1.1514610310e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(1.1676998740e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(-1.2420140846e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(1.4249322787e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(-1.6668057665e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(2.0000714765e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(-2.4999993993e-1f));
+  y = Vec::MulAdd(y, m, Vec::SplatF(3.3333331174e-1f));
+  y = Vec::Mul(Vec::Mul(y, m), z);
+  y = Vec::MulAdd(e, Vec::SplatF(-2.12194440e-4f), y);
+  y = Vec::MulAdd(z, Vec::SplatF(-0.5f), y);
+  F result = Vec::MulAdd(e, Vec::SplatF(0.693359375f), Vec::Add(m, y));
+
+  result = Vec::Select(Vec::Eq(x, Vec::SplatF(0.0f)), Vec::SplatF(-INFINITY),
+                       result);
+  result = Vec::Select(Vec::Lt(x, Vec::SplatF(0.0f)), Vec::SplatF(NAN), result);
+  result =
+      Vec::Select(Vec::Eq(x, Vec::SplatF(INFINITY)), Vec::SplatF(INFINITY),
+                  result);
+  return Vec::Select(Vec::IsNan(x), x, result);
+}
+
+// Cephes-style tanhf: an odd polynomial for |x| < 0.625 and
+// 1 - 2 / (exp(2|x|) + 1) otherwise.
+inline F Tanh(F x) {
+  const F kOne = Vec::SplatF(1.0f);
+  F abs_x = Abs(x);
+
+  F z = Vec::Mul(x, x);
+  F p = Vec::SplatF(-5.70498872745e-3f);
+  p = Vec::MulAdd(p, z, Vec::SplatF(2.06390887954e-2f));
+  p = Vec::MulAdd(p, z, Vec::SplatF(-5.37397155531e-2f));
+  p = Vec::MulAdd(p, z, Vec::SplatF(1.33314422036e-1f));
+  p = Vec::MulAdd(p, z, Vec::SplatF(-3.33332819422e-1f));
+  F small = Vec::MulAdd(Vec::Mul(p, z), x, x);
+
+  F exp_2x = Exp(Vec::Add(abs_x, abs_x));
+  F large = Vec::Sub(kOne, Vec::Div(Vec::SplatF(2.0f), Vec::Add(exp_2x, kOne)));
+  large = CopySign(large, x);
+
+  return Vec::Select(Vec::Lt(abs_x, Vec::SplatF(0.625f)), small, large);
+}
+
+// Hardware estimate refined with Newton-Raphson steps.
+inline F Rsqrt(F x) {
+  // Estimates treat denormals as 0 so scale them into the normal range first.
+  auto denormal = Vec::Lt(x, Vec::SplatF(1.17549435e-38f));
+  x = Vec::Select(denormal, Vec::Mul(x, Vec::SplatF(16777216.0f)), x);
+  F r = Vec::RsqrtEstimate(x);
+  for (int i = 0; i < Vec::kRsqrtRefinementSteps; ++i) {
+    // r = r * (1.5 - 0.5 * x * r * r)
+    F half_x_r = Vec::Mul(Vec::Mul(x, Vec::SplatF(0.5f)), r);
+    r = Vec::Mul(r, Vec::MulAdd(Vec::Mul(half_x_r, Vec::SplatF(-1.0f)), r,
+                                Vec::SplatF(1.5f)));
+  }
+  // The refinement produces NaN for 0 and inf.
+  r = Vec::Select(denormal, Vec::Mul(r, Vec::SplatF(4096.0f)), r);
+  r = Vec::Select(Vec::Eq(x, Vec::SplatF(0.0f)),
+                  CopySign(Vec::SplatF(INFINITY), x), r);
+  return Vec::Select(Vec::Eq(x, Vec::SplatF(INFINITY)), Vec::SplatF(0.0f), r);
+}
+
+template <F (*Fn)(F)>
+void UnaryF32(const float* src, float* dst, size_t count) {
+  size_t i = 0;
+  for (; i + Vec::kWidth <= count; i += Vec::kWidth) {
+    Vec::StoreF(dst + i, Fn(Vec::LoadF(src + i)));
+  }
+  if (i < count) {
+    // Pad the tail to a full vector so that it gets the same results.
+    float tail[Vec::kWidth] = {0.0f};
+    std::memcpy(tail, src + i, (count - i) * sizeof(float));
+    Vec::StoreF(tail, Fn(Vec::LoadF(tail)));
+    std::memcpy(dst + i, tail, (count - i) * sizeof(float));
+  }
+}
+
+// Reduction operators over element type T and vector type V.
+struct SumF32 {
+  using T = float;
+  using V = F;
+  static V Load(const T* p) { return Vec::LoadF(p); }
+  static void Store(T* p, V v) { Vec::StoreF(p, v); }
+  static V Apply(V a, V b) { return Vec::Add(a, b); }
+  static T Apply(T a, T b) { return a + b; }
+};
+struct MinF32 {
+  using T = float;
+  using V = F;
+  static V Load(const T* p) { return Vec::LoadF(p); }
+  static void Store(T* p, V v) { Vec::StoreF(p, v); }
+  static V Apply(V a, V b) { return Vec::Min(a, b); }
+  static T Apply(T a, T b) { return b < a ? b : a; }
+};
+struct MaxF32 {
+  using T = float;
+  using V = F;
+  static V Load(const T* p) { return Vec::LoadF(p); }
+  static void Store(T* p, V v) { Vec::StoreF(p, v); }
+  static V Apply(V a, V b) { return Vec::Max(a, b); }
+  static T Apply(T a, T b) { return a < b ? b : a; }
+};
+struct SumI32 {
+  using T = int32_t;
+  using V = I;
+  static V Load(const T* p) { return Vec::LoadI(p); }
+  static void Store(T* p, V v) { Vec::StoreI(p, v); }
+  static V Apply(V a, V b) { return Vec::AddI(a, b); }
+  static T Apply(T a, T b) {
+    // Wrap on overflow as the vector instructions do.
+    return static_cast<T>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+  }
+};
+struct MinI32 {
+  using T = int32_t;
+  using V = I;
+  static V Load(const T* p) { return Vec::LoadI(p); }
+  static void Store(T* p, V v) { Vec::StoreI(p, v); }
+  static V Apply(V a, V b) { return Vec::MinI(a, b); }
+  static T Apply(T a, T b) { return b < a ? b : a; }
+};
+struct MaxI32 {
+  using T = int32_t;
+  using V = I;
+  static V Load(const T* p) { return Vec::LoadI(p); }
+  static void Store(T* p, V v) { Vec::StoreI(p, v); }
+  static V Apply(V a, V b) { return Vec::MaxI(a, b); }
+  static T Apply(T a, T b) { return a < b ? b : a; }
+};
+
+template <typename Op>
+typename Op::T ReduceRow(const typename Op::T* src, size_t count,
+                         typename Op::T init) {
+  using T = typename Op::T;
+  using V = typename Op::V;
+  constexpr size_t kWidth = Vec::kWidth;
+  typename Op::T result = init;
+  size_t i = 0;
+  if (count >= kWidth) {
+    // Independent accumulators hide the latency of the combining op.
+    V acc0 = Op::Load(src);
+    V acc1 = acc0, acc2 = acc0, acc3 = acc0;
+    i = kWidth;
+    if (count >= 4 * kWidth) {
+      acc1 = Op::Load(src + kWidth);
+      acc2 = Op::Load(src + 2 * kWidth);
+      acc3 = Op::Load(src + 3 * kWidth);
+      i = 4 * kWidth;
+      for (; i + 4 * kWidth <= count; i += 4 * kWidth) {
+        acc0 = Op::Apply(acc0, Op::Load(src + i));
+        acc1 = Op::Apply(acc1, Op::Load(src + i + kWidth));
+        acc2 = Op::Apply(acc2, Op::Load(src + i + 2 * kWidth));
+        acc3 = Op::Apply(acc3, Op::Load(src + i + 3 * kWidth));
+      }
+      acc0 = Op::Apply(Op::Apply(acc0, acc1), Op::Apply(acc2, acc3));
+    }
+    for (; i + kWidth <= count; i += kWidth) {
+      acc0 = Op::Apply(acc0, Op::Load(src + i));
+    }
+    T lanes[kWidth];
+    Op::Store(lanes, acc0);
+    for (size_t lane = 0; lane < kWidth; ++lane) {
+      result = Op::Apply(result, lanes[lane]);
+    }
+  }
+  for (; i < count; ++i) {
+    result = Op::Apply(result, src[i]);
+  }
+  return result;
+}
+
+template <typename Op>
+void AccumulateRow(const typename Op::T* src, typename Op::T* dst,
+                   size_t count) {
+  constexpr size_t kWidth = Vec::kWidth;
+  size_t i = 0;
+  for (; i + kWidth <= count; i += kWidth) {
+    Op::Store(dst + i, Op::Apply(Op::Load(dst + i), Op::Load(src + i)));
+  }
+  for (; i < count; ++i) {
+    dst[i] = Op::Apply(dst[i], src[i]);
+  }
+}
+
+void TransposeX32(const uint32_t* src, size_t src_stride, uint32_t* dst,
+                  size_t dst_stride, size_t rows, size_t cols) {
+  constexpr size_t kTile = Vec::kTransposeTile;
+  size_t row = 0;
+  for (; row + kTile <= rows; row += kTile) {
+    size_t col = 0;
+    for (; col + kTile <= cols; col += kTile) {
+      Vec::TransposeTile(src + row * src_stride + col, src_stride,
+                         dst + col * dst_stride + row, dst_stride);
+    }
+    for (; col < cols; ++col) {
+      for (size_t i = row; i < row + kTile; ++i) {
+        dst[col * dst_stride + i] = src[i * src_stride + col];
+      }
+    }
+  }
+  for (; row < rows; ++row) {
+    for (size_t col = 0; col < cols; ++col) {
+      dst[col * dst_stride + row] = src[row * src_stride + col];
+    }
+  }
+}
+
+const Kernels kKernels = {
+    kIsaName,
+    UnaryF32<Exp>,
+    UnaryF32<Log>,
+    UnaryF32<Tanh>,
+    UnaryF32<Rsqrt>,
+    ReduceRow<SumF32>,
+    ReduceRow<MinF32>,
+    ReduceRow<MaxF32>,
+    ReduceRow<SumI32>,
+    ReduceRow<MinI32>,
+    ReduceRow<MaxI32>,
+    AccumulateRow<SumF32>,
+    AccumulateRow<MinF32>,
+    AccumulateRow<MaxF32>,
+    AccumulateRow<SumI32>,
+    AccumulateRow<MinI32>,
+    AccumulateRow<MaxI32>,
+    TransposeX32,
+};
@@ -14,8 +14,15 @@
 
 #include "iree/hal/vmla/op_kernels.h"
 
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 #include "absl/container/inlined_vector.h"
 #include "iree/base/memory.h"
+#include "iree/hal/vmla/op_kernels_simd.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -377,6 +384,84 @@ TEST(Pad, HighRank) {
   EXPECT_EQ(dst_buffer, expected_dst);
 }
 
+template <typename T>
+void ExpectTransposeMatchesReference(Shape src_shape, Shape perm) {
+  std::vector<T> src(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<T>(i * 7 + 3);
+  std::vector<T> expected(src.size());
+  std::vector<T> actual(src.size());
+  IREE_ASSERT_OK(Transpose::ExecuteReference<T>(
+      src, absl::MakeSpan(expected), src_shape, perm));
+  IREE_ASSERT_OK(
+      Transpose::Execute<T>(src, absl::MakeSpan(actual), src_shape, perm));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(Transpose, MatchesReference) {
+  // Blocked 2D transposes with partial blocks and tiles.
+  ExpectTransposeMatchesReference<uint32_t>({67, 131}, {1, 0});
+  ExpectTransposeMatchesReference<uint16_t>({67, 131}, {1, 0});
+  ExpectTransposeMatchesReference<uint8_t>({5, 3}, {1, 0});
+  ExpectTransposeMatchesReference<float>({3, 17, 9}, {0, 2, 1});
+  ExpectTransposeMatchesReference<uint32_t>({4, 5, 6, 7}, {3, 1, 0, 2});
+  // Innermost dimension preserved.
+  ExpectTransposeMatchesReference<uint32_t>({4, 5, 6}, {1, 0, 2});
+  ExpectTransposeMatchesReference<uint8_t>({4, 5, 6, 3}, {2, 0, 1, 3});
+  // Adjacent and unit dimensions are merged.
+  ExpectTransposeMatchesReference<uint16_t>({2, 3, 4, 5}, {2, 3, 0, 1});
+  ExpectTransposeMatchesReference<uint32_t>({1, 8, 1, 9}, {3, 2, 0, 1});
+  ExpectTransposeMatchesReference<uint32_t>({2, 3, 4}, {0, 1, 2});
+}
+
+template <typename T>
+void ExpectTileMatchesReference(Shape src_shape, Shape dst_shape) {
+  std::vector<T> src(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<T>(i + 1);
+  std::vector<T> expected(GetShapeElementCount(dst_shape));
+  std::vector<T> actual(expected.size());
+  IREE_ASSERT_OK(Tile::ExecuteReference<T>(src, absl::MakeSpan(expected),
+                                           src_shape, dst_shape));
+  IREE_ASSERT_OK(
+      Tile::Execute<T>(src, absl::MakeSpan(actual), src_shape, dst_shape));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(Tile, MatchesReference) {
+  ExpectTileMatchesReference<uint32_t>({3}, {12});
+  ExpectTileMatchesReference<uint8_t>({2, 3}, {4, 9});
+  ExpectTileMatchesReference<uint16_t>({2, 3, 4}, {2, 6, 8});
+  ExpectTileMatchesReference<float>({1, 5}, {3, 5});
+  ExpectTileMatchesReference<uint32_t>({2, 1, 3}, {6, 4, 3});
+}
+
+TEST(Gather, ContiguousAndScatteredIndices) {
+  Shape src_shape = {6, 2};
+  Shape indices_shape = {5};
+  Shape dst_shape = {5, 2};
+  std::vector<float> src = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<int32_t> indices = {1, 2, 3, 0, 5};
+  std::vector<float> expected = {2, 3, 4, 5, 6, 7, 0, 1, 10, 11};
+  std::vector<float> dst(dst_shape[0] * dst_shape[1]);
+  IREE_EXPECT_OK(Gather::Execute<float>(src, indices, absl::MakeSpan(dst),
+                                        src_shape, indices_shape, dst_shape,
+                                        /*dim=*/0, /*batch_dims=*/0));
+  EXPECT_EQ(expected, dst);
+}
+
+TEST(Gather, BatchedElements) {
+  Shape src_shape = {2, 4};
+  Shape indices_shape = {2, 3};
+  Shape dst_shape = {2, 3};
+  std::vector<int32_t> src = {10, 11, 12, 13, 20, 21, 22, 23};
+  std::vector<int32_t> indices = {3, 0, 1, 1, 2, 3};
+  std::vector<int32_t> expected = {13, 10, 11, 21, 22, 23};
+  std::vector<int32_t> dst(6);
+  IREE_EXPECT_OK(Gather::Execute<int32_t>(src, indices, absl::MakeSpan(dst),
+                                          src_shape, indices_shape, dst_shape,
+                                          /*dim=*/1, /*batch_dims=*/1));
+  EXPECT_EQ(expected, dst);
+}
+
 TEST(ReduceSum, Scalar) {
   Shape src_shape = {5};
   int32_t dimension = 0;
@@ -472,6 +557,243 @@ TEST(PoolingSum, Overlapping) {
   }
 }
 
+TEST(ReduceSum, MatchesReference) {
+  // Reduces each dimension so that both the contiguous (innermost) and the
+  // strided (outer) paths are checked.
+  Shape src_shape = {3, 5, 37};
+  std::vector<int32_t> src_buffer(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = static_cast<int32_t>(i * 7919 % 211) - 100;
+  }
+  std::vector<int32_t> init_buffer = {3};
+  for (int32_t dimension = 0; dimension < src_shape.size(); ++dimension) {
+    Shape dst_shape = src_shape;
+    dst_shape.erase(dst_shape.begin() + dimension);
+    std::vector<int32_t> dst_buffer(GetShapeElementCount(dst_shape));
+    std::vector<int32_t> expected_dst(dst_buffer.size());
+    IREE_EXPECT_OK(ReduceSum::ExecuteReference<int32_t>(
+        src_buffer, init_buffer, absl::MakeSpan(expected_dst), dimension,
+        src_shape, dst_shape));
+    IREE_EXPECT_OK(ReduceSum::Execute<int32_t>(
+        src_buffer, init_buffer, absl::MakeSpan(dst_buffer), dimension,
+        src_shape, dst_shape));
+    EXPECT_EQ(expected_dst, dst_buffer) << "dimension " << dimension;
+  }
+}
+
+TEST(ReduceMax, MatchesReference) {
+  Shape src_shape = {4, 3, 101};
+  std::vector<float> src_buffer(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = std::sin(static_cast<float>(i)) * 100.0f;
+  }
+  std::vector<float> init_buffer = {std::numeric_limits<float>::lowest()};
+  for (int32_t dimension = 0; dimension < src_shape.size(); ++dimension) {
+    Shape dst_shape = src_shape;
+    dst_shape.erase(dst_shape.begin() + dimension);
+    std::vector<float> dst_buffer(GetShapeElementCount(dst_shape));
+    std::vector<float> expected_dst(dst_buffer.size());
+    IREE_EXPECT_OK(ReduceMax::ExecuteReference<float>(
+        src_buffer, init_buffer, absl::MakeSpan(expected_dst), dimension,
+        src_shape, dst_shape));
+    IREE_EXPECT_OK(ReduceMax::Execute<float>(src_buffer, init_buffer,
+                                             absl::MakeSpan(dst_buffer),
+                                             dimension, src_shape, dst_shape));
+    EXPECT_EQ(expected_dst, dst_buffer) << "dimension " << dimension;
+  }
+}
+
+TEST(PoolingMax, ChannelsMatchReference) {
+  // NHWC pooling with a padded and strided window; the channel rows are pooled
+  // together.
+  Shape src_shape = {2, 7, 6, 19};
+  Shape dst_shape = {2, 4, 3, 19};
+  Shape window_sizes = {1, 3, 3, 1};
+  Shape strides = {1, 2, 2, 1};
+  Shape pad_low = {0, 1, 1, 0};
+  std::vector<float> src_buffer(GetShapeElementCount(src_shape));
+  for (size_t i = 0; i < src_buffer.size(); ++i) {
+    src_buffer[i] = std::cos(static_cast<float>(i)) * 10.0f;
+  }
+  std::vector<float> init_buffer = {-5.0f};
+  std::vector<float> dst_buffer(GetShapeElementCount(dst_shape));
+  std::vector<float> expected_dst(dst_buffer.size());
+
+  IREE_EXPECT_OK(PoolingMax::ExecuteReference<float>(
+      src_buffer, init_buffer, absl::MakeSpan(expected_dst), src_shape,
+      dst_shape, window_sizes, strides, pad_low));
+  IREE_EXPECT_OK(PoolingMax::Execute<float>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape, dst_shape,
+      window_sizes, strides, pad_low));
+  EXPECT_EQ(expected_dst, dst_buffer);
+}
+
+TEST(PoolingSum, ChannelsMatchReference) {
+  Shape src_shape = {5, 5, 9};
+  Shape dst_shape = {5, 5, 9};
+  Shape window_sizes = {3, 3, 1};
+  Shape strides = {1, 1, 1};
+  Shape pad_low = {1, 1, 0};
+  std::vector<int32_t> src_buffer =
+      MakeIota<int32_t>(GetShapeElementCount(src_shape));
+  std::vector<int32_t> init_buffer = {1};
+  std::vector<int32_t> dst_buffer(GetShapeElementCount(dst_shape));
+  std::vector<int32_t> expected_dst(dst_buffer.size());
+
+  IREE_EXPECT_OK(PoolingSum::ExecuteReference<int32_t>(
+      src_buffer, init_buffer, absl::MakeSpan(expected_dst), src_shape,
+      dst_shape, window_sizes, strides, pad_low));
+  IREE_EXPECT_OK(PoolingSum::Execute<int32_t>(
+      src_buffer, init_buffer, absl::MakeSpan(dst_buffer), src_shape, dst_shape,
+      window_sizes, strides, pad_low));
+  EXPECT_EQ(expected_dst, dst_buffer);
+}
+
+// Returns inputs covering the normal range, the extremes and special values.
+std::vector<float> MakeUnaryTestValues() {
+  std::vector<float> values;
+  for (int i = -2000; i <= 2000; ++i) {
+    values.push_back(i * 0.05f);
+  }
+  for (int i = -38; i <= 38; ++i) {
+    values.push_back(std::pow(10.0f, static_cast<float>(i)));
+  }
+  const float special_values[] = {
+      0.0f,
+      -0.0f,
+      88.7f,
+      -87.5f,
+      -104.0f,
+      1e-40f,
+      -1.0f,
+      std::numeric_limits<float>::infinity(),
+      -std::numeric_limits<float>::infinity(),
+      std::numeric_limits<float>::quiet_NaN(),
+  };
+  values.insert(values.end(), std::begin(special_values),
+                std::end(special_values));
+  return values;
+}
+
+// Expects |actual| to be within a few ulp of |expected|. Denormal results may
+// be flushed to zero.
+void ExpectNearUlp(float expected, float actual, float input) {
+  if (std::isnan(expected)) {
+    EXPECT_TRUE(std::isnan(actual)) << "input " << input;
+  } else if (std::isinf(expected) || expected == 0.0f) {
+    EXPECT_EQ(expected, actual) << "input " << input;
+  } else if (std::abs(expected) < std::numeric_limits<float>::min()) {
+    EXPECT_NEAR(expected, actual, std::numeric_limits<float>::min())
+        << "input " << input;
+  } else {
+    EXPECT_NEAR(expected, actual, std::abs(expected) * 1e-6f)
+        << "input " << input;
+  }
+}
+
+TEST(SimdKernels, UnaryMatchesReference) {
+  auto src_buffer = MakeUnaryTestValues();
+  std::vector<float> expected_dst(src_buffer.size());
+  std::vector<float> dst_buffer(src_buffer.size());
+  for (auto isa : {simd::Isa::kSse41, simd::Isa::kAvx2, simd::Isa::kAvx512,
+                   simd::Isa::kNeon}) {
+    const simd::Kernels* kernels = simd::GetKernels(isa);
+    if (!kernels) continue;
+    SCOPED_TRACE(kernels->name);
+
+    IREE_EXPECT_OK(
+        Exp::ExecuteReference<float>(src_buffer, absl::MakeSpan(expected_dst)));
+    kernels->exp_f32(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      ExpectNearUlp(expected_dst[i], dst_buffer[i], src_buffer[i]);
+    }
+
+    IREE_EXPECT_OK(
+        Log::ExecuteReference<float>(src_buffer, absl::MakeSpan(expected_dst)));
+    kernels->log_f32(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      ExpectNearUlp(expected_dst[i], dst_buffer[i], src_buffer[i]);
+    }
+
+    IREE_EXPECT_OK(Tanh::ExecuteReference<float>(
+        src_buffer, absl::MakeSpan(expected_dst)));
+    kernels->tanh_f32(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      ExpectNearUlp(expected_dst[i], dst_buffer[i], src_buffer[i]);
+    }
+
+    IREE_EXPECT_OK(Rsqrt::ExecuteReference<float>(
+        src_buffer, absl::MakeSpan(expected_dst)));
+    kernels->rsqrt_f32(src_buffer.data(), dst_buffer.data(), dst_buffer.size());
+    for (size_t i = 0; i < dst_buffer.size(); ++i) {
+      ExpectNearUlp(expected_dst[i], dst_buffer[i], src_buffer[i]);
+    }
+  }
+}
+
+TEST(SimdKernels, ReductionsMatchReference) {
+  // Odd lengths exercise the partial vector tails.
+  std::vector<int32_t> int_src(1037);
+  std::vector<float> float_src(int_src.size());
+  for (size_t i = 0; i < int_src.size(); ++i) {
+    int_src[i] = static_cast<int32_t>(i * 2654435761u);
+    float_src[i] = static_cast<float>(i % 97) - 48.5f;
+  }
+  for (auto isa : {simd::Isa::kSse41, simd::Isa::kAvx2, simd::Isa::kAvx512,
+                   simd::Isa::kNeon}) {
+    const simd::Kernels* kernels = simd::GetKernels(isa);
+    if (!kernels) continue;
+    SCOPED_TRACE(kernels->name);
+    for (size_t count : {0, 1, 7, 64, 1037}) {
+      int32_t int_sum = 5, int_min = 5, int_max = 5;
+      float float_sum = 0.5f, float_min = 0.5f, float_max = 0.5f;
+      for (size_t i = 0; i < count; ++i) {
+        int_sum = static_cast<int32_t>(static_cast<uint32_t>(int_sum) +
+                                       static_cast<uint32_t>(int_src[i]));
+        int_min = std::min(int_min, int_src[i]);
+        int_max = std::max(int_max, int_src[i]);
+        float_sum += float_src[i];
+        float_min = std::min(float_min, float_src[i]);
+        float_max = std::max(float_max, float_src[i]);
+      }
+      EXPECT_EQ(int_sum, kernels->reduce_sum_i32(int_src.data(), count, 5));
+      EXPECT_EQ(int_min, kernels->reduce_min_i32(int_src.data(), count, 5));
+      EXPECT_EQ(int_max, kernels->reduce_max_i32(int_src.data(), count, 5));
+      // The float values are exactly representable so the sum is exact.
+      EXPECT_EQ(float_sum,
+                kernels->reduce_sum_f32(float_src.data(), count, 0.5f));
+      EXPECT_EQ(float_min,
+                kernels->reduce_min_f32(float_src.data(), count, 0.5f));
+      EXPECT_EQ(float_max,
+                kernels->reduce_max_f32(float_src.data(), count, 0.5f));
+    }
+  }
+}
+
+TEST(SimdKernels, TransposeMatchesReference) {
+  // Strides larger than the matrix and sizes that are not multiples of any
+  // tile size.
+  const size_t rows = 19, cols = 13, src_stride = 21, dst_stride = 23;
+  std::vector<uint32_t> src(rows * src_stride);
+  for (size_t i = 0; i < src.size(); ++i) src[i] = static_cast<uint32_t>(i);
+  std::vector<uint32_t> expected(cols * dst_stride);
+  for (size_t row = 0; row < rows; ++row) {
+    for (size_t col = 0; col < cols; ++col) {
+      expected[col * dst_stride + row] = src[row * src_stride + col];
+    }
+  }
+  for (auto isa : {simd::Isa::kSse41, simd::Isa::kAvx2, simd::Isa::kAvx512,
+                   simd::Isa::kNeon}) {
+    const simd::Kernels* kernels = simd::GetKernels(isa);
+    if (!kernels) continue;
+    SCOPED_TRACE(kernels->name);
+    std::vector<uint32_t> dst(expected.size());
+    kernels->transpose_x32(src.data(), src_stride, dst.data(), dst_stride,
+                           rows, cols);
+    EXPECT_EQ(expected, dst);
+  }
+}
+
 TEST(Conv2d, NoDilation) {
   Shape input_shape = {4, 5, 2};
   Shape filter_shape = {3, 2, 2, 1};
@@ -493,8 +815,10 @@ TEST(Conv2d, NoDilation) {
   }
   std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), 0.0f);
 
+  RuntimeState runtime_state;
   IREE_EXPECT_OK(Conv2D::Execute<float>(
-      input_buffer, input_shape, filter_buffer, filter_shape,
+      runtime_state.mat_mul_state.get(), input_buffer, input_shape,
+      filter_buffer, filter_shape,
       absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h, pad_w,
       lhs_dilation, rhs_dilation, 1));
 
@@ -526,8 +850,10 @@ TEST(Conv2d, DepthwiseConv) {
   }
   std::vector<float> dst_buffer(GetShapeElementCount(dst_shape), 0.0f);
 
+  RuntimeState runtime_state;
   IREE_EXPECT_OK(Conv2D::Execute<float>(
-      input_buffer, input_shape, filter_buffer, filter_shape,
+      runtime_state.mat_mul_state.get(), input_buffer, input_shape,
+      filter_buffer, filter_shape,
       absl::MakeSpan(dst_buffer), dst_shape, strides, pad_h, pad_w,
       lhs_dilation, rhs_dilation, 2));
 
@@ -536,6 +862,509 @@ TEST(Conv2d, DepthwiseConv) {
   }
 }
 
+// Convolution attributes shared by all Conv2D implementations.
+struct Conv2DParams {
+  Shape input_shape;
+  Shape filter_shape;
+  Shape dst_shape;
+  Shape strides = {1, 1};
+  Shape pad_h = {0, 0};
+  Shape pad_w = {0, 0};
+  Shape lhs_dilation = {1, 1};
+  Shape rhs_dilation = {1, 1};
+  int32_t groups = 1;
+};
+
+// Compares the result of |impl| against the reference implementation. Inputs
+// are filled with small non-uniform values so that transposed or misaligned
+// indexing is caught. |impl| is run on a dirty destination to verify that it
+// is fully overwritten.
+template <typename ImplFn>
+void ExpectConv2DMatchesReference(const Conv2DParams& p, ImplFn impl) {
+  std::vector<float> input_buffer(GetShapeElementCount(p.input_shape));
+  for (int i = 0; i < input_buffer.size(); ++i) {
+    input_buffer[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  std::vector<float> filter_buffer(GetShapeElementCount(p.filter_shape));
+  for (int i = 0; i < filter_buffer.size(); ++i) {
+    filter_buffer[i] = static_cast<float>(i % 5) * 0.5f - 1.0f;
+  }
+
+  std::vector<float> expected_dst(GetShapeElementCount(p.dst_shape));
+  IREE_ASSERT_OK(Conv2D::ExecuteReference<float>(
+      input_buffer, p.input_shape, filter_buffer, p.filter_shape,
+      absl::MakeSpan(expected_dst), p.dst_shape, p.strides, p.pad_h, p.pad_w,
+      p.lhs_dilation, p.rhs_dilation, p.groups));
+
+  std::vector<float> dst_buffer(expected_dst.size(), 123.0f);
+  IREE_ASSERT_OK(impl(absl::MakeConstSpan(input_buffer),
+                      absl::MakeConstSpan(filter_buffer),
+                      absl::MakeSpan(dst_buffer)));
+  for (int i = 0; i < dst_buffer.size(); ++i) {
+    EXPECT_NEAR(expected_dst[i], dst_buffer[i], kEpsilon) << "element " << i;
+  }
+}
+
+// Returns a functor running the im2col implementation with |p|.
+auto MakeIm2ColImpl(RuntimeState* runtime_state, const Conv2DParams& p) {
+  return [runtime_state, &p](absl::Span<const float> input_buffer,
+                             absl::Span<const float> filter_buffer,
+                             absl::Span<float> dst_buffer) {
+    return Conv2D::ExecuteIm2Col<float>(
+        runtime_state->mat_mul_state.get(), input_buffer, p.input_shape,
+        filter_buffer, p.filter_shape, dst_buffer, p.dst_shape, p.strides,
+        p.pad_h, p.pad_w, p.lhs_dilation, p.rhs_dilation, p.groups);
+  };
+}
+
+// Returns a functor running the depthwise implementation with |p|.
+auto MakeDepthwiseImpl(const Conv2DParams& p) {
+  return [&p](absl::Span<const float> input_buffer,
+              absl::Span<const float> filter_buffer,
+              absl::Span<float> dst_buffer) {
+    return Conv2D::ExecuteDepthwise<float>(
+        input_buffer, p.input_shape, filter_buffer, p.filter_shape, dst_buffer,
+        p.dst_shape, p.strides, p.pad_h, p.pad_w, p.lhs_dilation,
+        p.rhs_dilation, p.groups);
+  };
+}
+
+TEST(Conv2d, Im2ColPointwise) {
+  Conv2DParams p;
+  p.input_shape = {3, 4, 5};
+  p.filter_shape = {1, 1, 5, 6};
+  p.dst_shape = {3, 4, 6};
+  RuntimeState runtime_state;
+  ExpectConv2DMatchesReference(p, MakeIm2ColImpl(&runtime_state, p));
+}
+
+TEST(Conv2d, Im2ColStridedPadded) {
+  Conv2DParams p;
+  p.input_shape = {7, 6, 3};
+  p.filter_shape = {3, 3, 3, 4};
+  p.dst_shape = {4, 3, 4};
+  p.strides = {2, 2};
+  p.pad_h = {1, 1};
+  p.pad_w = {1, 0};
+  RuntimeState runtime_state;
+  ExpectConv2DMatchesReference(p, MakeIm2ColImpl(&runtime_state, p));
+}
+
+TEST(Conv2d, Im2ColRhsDilation) {
+  Conv2DParams p;
+  p.input_shape = {6, 6, 2};
+  p.filter_shape = {2, 3, 2, 3};
+  p.dst_shape = {4, 2, 3};
+  p.rhs_dilation = {2, 2};
+  RuntimeState runtime_state;
+  ExpectConv2DMatchesReference(p, MakeIm2ColImpl(&runtime_state, p));
+}
+
+TEST(Conv2d, Im2ColGrouped) {
+  Conv2DParams p;
+  p.input_shape = {5, 4, 4};
+  p.filter_shape = {2, 2, 4, 3};
+  p.dst_shape = {4, 3, 6};
+  p.groups = 2;
+  RuntimeState runtime_state;
+  ExpectConv2DMatchesReference(p, MakeIm2ColImpl(&runtime_state, p));
+}
+
+TEST(Conv2d, DepthwisePadded) {
+  Conv2DParams p;
+  p.input_shape = {5, 5, 3};
+  p.filter_shape = {3, 3, 3, 1};
+  p.dst_shape = {5, 5, 3};
+  p.pad_h = {1, 1};
+  p.pad_w = {1, 1};
+  p.groups = 3;
+  ExpectConv2DMatchesReference(p, MakeDepthwiseImpl(p));
+}
+
+TEST(Conv2d, DepthwiseMultiplierStrided) {
+  Conv2DParams p;
+  p.input_shape = {6, 5, 2};
+  p.filter_shape = {2, 2, 2, 3};
+  p.dst_shape = {3, 2, 6};
+  p.strides = {2, 2};
+  p.groups = 2;
+  ExpectConv2DMatchesReference(p, MakeDepthwiseImpl(p));
+}
+
+// lhs dilation is only supported by the reference implementation.
+TEST(Conv2d, LhsDilationFallback) {
+  Conv2DParams p;
+  p.input_shape = {3, 3, 2};
+  p.filter_shape = {2, 2, 2, 2};
+  p.dst_shape = {4, 4, 2};
+  p.lhs_dilation = {2, 2};
+  RuntimeState runtime_state;
+  ExpectConv2DMatchesReference(
+      p, [&](absl::Span<const float> input_buffer,
+             absl::Span<const float> filter_buffer,
+             absl::Span<float> dst_buffer) {
+        return Conv2D::Execute<float>(
+            runtime_state.mat_mul_state.get(), input_buffer, p.input_shape,
+            filter_buffer, p.filter_shape, dst_buffer, p.dst_shape, p.strides,
+            p.pad_h, p.pad_w, p.lhs_dilation, p.rhs_dilation, p.groups);
+      });
+}
+
+// Computes the DFT of each row of |length| elements in double precision.
+void NaiveDft(bool inverse, int32_t length, const std::vector<float>& real_src,
+              const std::vector<float>& imag_src, std::vector<float>* real_dst,
+              std::vector<float>* imag_dst) {
+  const double kPi = 3.14159265358979323846;
+  real_dst->resize(real_src.size());
+  imag_dst->resize(imag_src.size());
+  for (size_t offset = 0; offset < real_src.size(); offset += length) {
+    for (int32_t k = 0; k < length; ++k) {
+      double sum_re = 0.0;
+      double sum_im = 0.0;
+      for (int32_t n = 0; n < length; ++n) {
+        double angle = (inverse ? 2.0 : -2.0) * kPi *
+                       ((static_cast<int64_t>(n) * k) % length) / length;
+        sum_re += real_src[offset + n] * std::cos(angle) -
+                  imag_src[offset + n] * std::sin(angle);
+        sum_im += real_src[offset + n] * std::sin(angle) +
+                  imag_src[offset + n] * std::cos(angle);
+      }
+      if (inverse) {
+        sum_re /= length;
+        sum_im /= length;
+      }
+      (*real_dst)[offset + k] = static_cast<float>(sum_re);
+      (*imag_dst)[offset + k] = static_cast<float>(sum_im);
+    }
+  }
+}
+
+// Runs Fft (or Ifft) on a batch of 3 rows and compares with the naive DFT.
+void ExpectFftMatchesDft(Fft::RuntimeState* runtime_state, bool inverse,
+                         int32_t length) {
+  Shape shape = {3, length};
+  const size_t element_count = GetShapeElementCount(shape);
+  std::vector<float> real_src(element_count);
+  std::vector<float> imag_src(element_count);
+  for (size_t i = 0; i < element_count; ++i) {
+    real_src[i] = static_cast<float>(i % 11) * 0.25f - 1.0f;
+    imag_src[i] = static_cast<float>(i % 5) * 0.5f - 0.75f;
+  }
+  std::vector<float> expected_real;
+  std::vector<float> expected_imag;
+  NaiveDft(inverse, length, real_src, imag_src, &expected_real,
+           &expected_imag);
+
+  std::vector<float> real_dst(element_count);
+  std::vector<float> imag_dst(element_count);
+  if (inverse) {
+    IREE_ASSERT_OK(Ifft::Execute<float>(
+        runtime_state, real_src, imag_src, absl::MakeSpan(real_dst),
+        absl::MakeSpan(imag_dst), shape, shape));
+  } else {
+    IREE_ASSERT_OK(Fft::Execute<float>(
+        runtime_state, real_src, imag_src, absl::MakeSpan(real_dst),
+        absl::MakeSpan(imag_dst), shape, shape));
+  }
+
+  // Error grows with the magnitude of the sums.
+  const float tolerance = 1e-4f * length;
+  for (size_t i = 0; i < element_count; ++i) {
+    EXPECT_NEAR(expected_real[i], real_dst[i], tolerance)
+        << "length " << length << " element " << i;
+    EXPECT_NEAR(expected_imag[i], imag_dst[i], tolerance)
+        << "length " << length << " element " << i;
+  }
+}
+
+TEST(Fft, PowerOfTwo) {
+  auto runtime_state = Fft::CreateRuntimeState();
+  for (int32_t length : {1, 2, 4, 8, 32, 128, 512}) {
+    ExpectFftMatchesDft(runtime_state.get(), /*inverse=*/false, length);
+  }
+}
+
+TEST(Fft, MixedRadix) {
+  auto runtime_state = Fft::CreateRuntimeState();
+  for (int32_t length : {3, 5, 6, 7, 12, 15, 30, 49, 100, 210}) {
+    ExpectFftMatchesDft(runtime_state.get(), /*inverse=*/false, length);
+  }
+}
+
+TEST(Fft, Inverse) {
+  auto runtime_state = Fft::CreateRuntimeState();
+  for (int32_t length : {1, 8, 12, 64, 90}) {
+    ExpectFftMatchesDft(runtime_state.get(), /*inverse=*/true, length);
+  }
+}
+
+TEST(Fft, RoundTrip) {
+  auto runtime_state = Fft::CreateRuntimeState();
+  Shape shape = {2, 2, 48};
+  const size_t element_count = GetShapeElementCount(shape);
+  std::vector<float> real_src(element_count);
+  std::vector<float> imag_src(element_count);
+  for (size_t i = 0; i < element_count; ++i) {
+    real_src[i] = static_cast<float>(i % 13);
+    imag_src[i] = -static_cast<float>(i % 3);
+  }
+  std::vector<float> real_freq(element_count);
+  std::vector<float> imag_freq(element_count);
+  IREE_ASSERT_OK(Fft::Execute<float>(runtime_state.get(), real_src, imag_src,
+                                     absl::MakeSpan(real_freq),
+                                     absl::MakeSpan(imag_freq), shape, shape));
+  std::vector<float> real_dst(element_count);
+  std::vector<float> imag_dst(element_count);
+  IREE_ASSERT_OK(Ifft::Execute<float>(
+      runtime_state.get(), real_freq, imag_freq, absl::MakeSpan(real_dst),
+      absl::MakeSpan(imag_dst), shape, shape));
+  for (size_t i = 0; i < element_count; ++i) {
+    EXPECT_NEAR(real_src[i], real_dst[i], kEpsilon * 10);
+    EXPECT_NEAR(imag_src[i], imag_dst[i], kEpsilon * 10);
+  }
+}
+
+TEST(Fft, MismatchedShapes) {
+  auto runtime_state = Fft::CreateRuntimeState();
+  Shape real_shape = {4};
+  Shape imag_shape = {2, 2};
+  std::vector<float> src(4);
+  std::vector<float> real_dst(4);
+  std::vector<float> imag_dst(4);
+  EXPECT_TRUE(IsInvalidArgument(Fft::Execute<float>(
+      runtime_state.get(), src, src, absl::MakeSpan(real_dst),
+      absl::MakeSpan(imag_dst), real_shape, imag_shape)));
+}
+
+// Returns |row_count| rows of |row_length| values with many duplicates.
+template <typename T>
+std::vector<T> MakeSortInput(int row_count, int row_length) {
+  std::vector<T> values(row_count * row_length);
+  uint32_t seed = 12345;
+  for (auto& value : values) {
+    seed = seed * 1103515245u + 12345u;
+    value = static_cast<T>(static_cast<int32_t>((seed >> 16) % 201) - 100);
+  }
+  return values;
+}
+
+// Returns a row of |length| floats where every 7th element is a NaN of
+// alternating sign.
+std::vector<float> MakeSortNaNInput(int row_length) {
+  auto values = MakeSortInput<float>(1, row_length);
+  for (size_t i = 0; i < values.size(); i += 7) {
+    values[i] = std::copysign(std::numeric_limits<float>::quiet_NaN(),
+                              (i % 2) ? 1.0f : -1.0f);
+  }
+  return values;
+}
+
+template <typename T>
+void ExpectSortMatchesReference(const std::vector<T>& src, Shape shape) {
+  std::vector<int32_t> expected(src.size());
+  std::vector<int32_t> actual(src.size());
+  IREE_EXPECT_OK(
+      Sort::ExecuteReference<T>(src, absl::MakeSpan(expected), shape));
+  IREE_EXPECT_OK(Sort::Execute<T>(src, absl::MakeSpan(actual), shape));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(Sort, Small) {
+  Shape shape = {2, 4};
+  std::vector<float> src = {3.0f, 1.0f, 2.0f, 1.0f, -1.0f, 0.0f, -2.0f, 5.0f};
+  std::vector<int32_t> expected = {1, 3, 2, 0, 2, 0, 1, 3};
+  std::vector<int32_t> dst(src.size());
+  IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape));
+  EXPECT_EQ(expected, dst);
+}
+
+// NaNs are ordered by their sign bit on both the std::stable_sort path (short
+// rows) and the radix sort path (long rows).
+TEST(Sort, NaN) {
+  const float kNaN = std::numeric_limits<float>::quiet_NaN();
+  const float kInf = std::numeric_limits<float>::infinity();
+  std::vector<float> src = {kNaN, 1.0f, -kNaN, kInf, -kInf, kNaN, 0.0f, -kNaN};
+  std::vector<int32_t> expected = {2, 7, 4, 6, 1, 3, 0, 5};
+  std::vector<int32_t> dst(src.size());
+  Shape shape = {static_cast<int32_t>(src.size())};
+  IREE_EXPECT_OK(Sort::Execute<float>(src, absl::MakeSpan(dst), shape));
+  EXPECT_EQ(expected, dst);
+  IREE_EXPECT_OK(
+      Sort::ExecuteReference<float>(src, absl::MakeSpan(dst), shape));
+  EXPECT_EQ(expected, dst);
+
+  auto long_src = MakeSortNaNInput(1000);
+  Shape long_shape = {1, 1000};
+  ExpectSortMatchesReference(long_src, long_shape);
+  std::vector<int32_t> long_dst(long_src.size());
+  IREE_EXPECT_OK(
+      Sort::Execute<float>(long_src, absl::MakeSpan(long_dst), long_shape));
+  EXPECT_TRUE(std::isnan(long_src[long_dst.front()]));
+  EXPECT_TRUE(std::signbit(long_src[long_dst.front()]));
+  EXPECT_TRUE(std::isnan(long_src[long_dst.back()]));
+  EXPECT_FALSE(std::signbit(long_src[long_dst.back()]));
+}
+
+TEST(Sort, RadixMatchesReference) {
+  Shape shape = {3, 1000};
+  ExpectSortMatchesReference(MakeSortInput<int8_t>(3, 1000), shape);
+  ExpectSortMatchesReference(MakeSortInput<int16_t>(3, 1000), shape);
+  ExpectSortMatchesReference(MakeSortInput<int32_t>(3, 1000), shape);
+
+  auto src = MakeSortInput<float>(3, 1000);
+  src[7] = -0.0f;
+  src[11] = std::numeric_limits<float>::infinity();
+  src[13] = -std::numeric_limits<float>::infinity();
+  src[17] = 0.25f;
+  src[19] = -0.25f;
+  ExpectSortMatchesReference(src, shape);
+}
+
+TEST(Sort, ManyRowsMatchReference) {
+  ExpectSortMatchesReference(MakeSortInput<int32_t>(256, 300), {256, 300});
+  ExpectSortMatchesReference(MakeSortInput<float>(1024, 64), {1024, 64});
+}
+
+template <typename T>
+void ExpectTopKMatchesSort(const std::vector<T>& src, int32_t row_length,
+                           int32_t k, TopK::Order order) {
+  int32_t row_count = static_cast<int32_t>(src.size()) / row_length;
+  // Negating the values sorts them in descending order with the same
+  // tie-breaking.
+  std::vector<T> sort_src = src;
+  if (order == TopK::Order::kDescending) {
+    for (auto& value : sort_src) value = -value;
+  }
+  std::vector<int32_t> sorted(src.size());
+  IREE_ASSERT_OK(Sort::ExecuteReference<T>(sort_src, absl::MakeSpan(sorted),
+                                           Shape{row_count, row_length}));
+  std::vector<int32_t> expected;
+  for (int32_t row = 0; row < row_count; ++row) {
+    expected.insert(expected.end(), sorted.begin() + row * row_length,
+                    sorted.begin() + row * row_length + k);
+  }
+  std::vector<int32_t> actual(row_count * k);
+  IREE_ASSERT_OK(TopK::Execute<T>(src, absl::MakeSpan(actual),
+                                  Shape{row_count, row_length},
+                                  Shape{row_count, k}, order));
+  EXPECT_EQ(expected, actual);
+}
+
+TEST(TopK, Largest) {
+  auto src = MakeSortInput<float>(4, 2000);
+  ExpectTopKMatchesSort(src, 2000, 1, TopK::Order::kDescending);
+  ExpectTopKMatchesSort(src, 2000, 10, TopK::Order::kDescending);
+  ExpectTopKMatchesSort(src, 2000, 500, TopK::Order::kDescending);
+  ExpectTopKMatchesSort(src, 2000, 2000, TopK::Order::kDescending);
+}
+
+TEST(TopK, Smallest) {
+  auto src = MakeSortInput<int32_t>(4, 2000);
+  ExpectTopKMatchesSort(src, 2000, 3, TopK::Order::kAscending);
+  ExpectTopKMatchesSort(src, 2000, 1000, TopK::Order::kAscending);
+  ExpectTopKMatchesSort(MakeSortInput<int8_t>(2, 16), 16, 4,
+                        TopK::Order::kAscending);
+}
+
+TEST(TopK, NaN) {
+  auto src = MakeSortNaNInput(1000);
+  ExpectTopKMatchesSort(src, 1000, 10, TopK::Order::kAscending);
+  ExpectTopKMatchesSort(src, 1000, 500, TopK::Order::kAscending);
+  ExpectTopKMatchesSort(src, 1000, 10, TopK::Order::kDescending);
+}
+
+TEST(TopK, InvalidK) {
+  std::vector<float> src(8);
+  std::vector<int32_t> dst(10);
+  EXPECT_TRUE(IsInvalidArgument(
+      TopK::Execute<float>(src, absl::MakeSpan(dst), Shape{2, 4}, Shape{2, 5},
+                           TopK::Order::kAscending)));
+}
+
+// Builds a fused program from a list of {opcode, a, b, c} instructions.
+std::vector<int32_t> MakeFusedProgram(
+    int32_t input_count, std::vector<std::array<int32_t, 4>> instructions) {
+  std::vector<int32_t> program = {input_count,
+                                  static_cast<int32_t>(instructions.size())};
+  for (const auto& instruction : instructions) {
+    program.insert(program.end(), instruction.begin(), instruction.end());
+  }
+  return program;
+}
+
+int32_t FloatBits(float value) {
+  int32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+TEST(FusedElementwise, TanhAffine) {
+  using Opcode = FusedElementwise::Opcode;
+  // tanh(2 * x + 0.5), spanning several blocks with a partial tail.
+  auto program = MakeFusedProgram(
+      1, {
+             {static_cast<int32_t>(Opcode::kConstant), FloatBits(2.0f), 0, 0},
+             {static_cast<int32_t>(Opcode::kMul), 1, 0, 0},
+             {static_cast<int32_t>(Opcode::kConstant), FloatBits(0.5f), 0, 0},
+             {static_cast<int32_t>(Opcode::kAdd), 2, 3, 0},
+             {static_cast<int32_t>(Opcode::kTanh), 4, 0, 0},
+         });
+  const int element_count = FusedElementwise::kBlockSize * 2 + 7;
+  std::vector<float> src(element_count);
+  for (int i = 0; i < element_count; ++i) {
+    src[i] = (i - element_count / 2) * 0.01f;
+  }
+  std::vector<absl::Span<const float>> srcs = {src};
+  std::vector<float> dst(element_count);
+  IREE_EXPECT_OK(FusedElementwise::Execute<float>(program, srcs,
+                                                  absl::MakeSpan(dst)));
+  for (int i = 0; i < element_count; ++i) {
+    EXPECT_NEAR(std::tanh(2.0f * src[i] + 0.5f), dst[i], kEpsilon);
+  }
+}
+
+TEST(FusedElementwise, MultipleInputs) {
+  using Opcode = FusedElementwise::Opcode;
+  // clamp(0, a * b - a, 6)
+  auto program = MakeFusedProgram(
+      2, {
+             {static_cast<int32_t>(Opcode::kMul), 0, 1, 0},
+             {static_cast<int32_t>(Opcode::kSub), 2, 0, 0},
+             {static_cast<int32_t>(Opcode::kConstant), FloatBits(0.0f), 0, 0},
+             {static_cast<int32_t>(Opcode::kConstant), FloatBits(6.0f), 0, 0},
+             {static_cast<int32_t>(Opcode::kClamp), 4, 3, 5},
+         });
+  std::vector<float> a = {-1.0f, 0.5f, 2.0f, 3.0f};
+  std::vector<float> b = {1.0f, 4.0f, 2.5f, 5.0f};
+  std::vector<absl::Span<const float>> srcs = {a, b};
+  std::vector<float> dst(4);
+  IREE_EXPECT_OK(FusedElementwise::Execute<float>(program, srcs,
+                                                  absl::MakeSpan(dst)));
+  std::vector<float> expected_dst = {0.0f, 1.5f, 3.0f, 6.0f};
+  EXPECT_EQ(expected_dst, dst);
+}
+
+TEST(FusedElementwise, InvalidProgram) {
+  using Opcode = FusedElementwise::Opcode;
+  std::vector<float> src(4);
+  std::vector<absl::Span<const float>> srcs = {src};
+  std::vector<float> dst(4);
+  // Forward register reference.
+  auto forward_program =
+      MakeFusedProgram(1, {{static_cast<int32_t>(Opcode::kNeg), 1, 0, 0}});
+  EXPECT_TRUE(IsInvalidArgument(FusedElementwise::Execute<float>(
+      forward_program, srcs, absl::MakeSpan(dst))));
+  // Unknown opcode.
+  auto opcode_program = MakeFusedProgram(1, {{999, 0, 0, 0}});
+  EXPECT_TRUE(IsInvalidArgument(FusedElementwise::Execute<float>(
+      opcode_program, srcs, absl::MakeSpan(dst))));
+  // Input count mismatch.
+  auto input_program =
+      MakeFusedProgram(2, {{static_cast<int32_t>(Opcode::kAdd), 0, 1, 0}});
+  EXPECT_TRUE(IsInvalidArgument(FusedElementwise::Execute<float>(
+      input_program, srcs, absl::MakeSpan(dst))));
+}
+
 }  // namespace
 }  // namespace kernels
 }  // namespace vmla
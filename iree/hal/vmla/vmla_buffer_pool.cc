@@ -0,0 +1,197 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/vmla_buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+constexpr int BufferPool::kMinSizeClassLog2;
+constexpr int BufferPool::kMaxSizeClassLog2;
+constexpr int BufferPool::kSizeClassCount;
+constexpr iree_host_size_t BufferPool::kDefaultMaxRetainedBytes;
+
+namespace {
+
+constexpr int32_t kUnpooled = -1;
+
+// Prefixes each block to record how to return it on free. Sized to preserve
+// the 16 byte alignment of the underlying allocation.
+struct alignas(16) BlockHeader {
+  // Usable bytes following the header.
+  iree_host_size_t capacity;
+  // Size class index or kUnpooled if the block bypasses the free lists.
+  int32_t size_class;
+};
+
+// Returns the size class for |byte_length| or kUnpooled if too large.
+int32_t SelectSizeClass(iree_host_size_t byte_length) {
+  int log2 = BufferPool::kMinSizeClassLog2;
+  while ((iree_host_size_t{1} << log2) < byte_length) {
+    if (++log2 > BufferPool::kMaxSizeClassLog2) return kUnpooled;
+  }
+  return log2 - BufferPool::kMinSizeClassLog2;
+}
+
+void* GetBlockData(BlockHeader* header) {
+  return reinterpret_cast<uint8_t*>(header) + sizeof(BlockHeader);
+}
+
+BlockHeader* GetBlockHeader(void* data) {
+  return reinterpret_cast<BlockHeader*>(reinterpret_cast<uint8_t*>(data) -
+                                        sizeof(BlockHeader));
+}
+
+}  // namespace
+
+BufferPool::BufferPool(iree_allocator_t block_allocator,
+                       iree_host_size_t max_retained_bytes)
+    : block_allocator_(block_allocator),
+      max_retained_bytes_(max_retained_bytes) {}
+
+BufferPool::~BufferPool() { Trim(); }
+
+iree_allocator_t BufferPool::allocator() {
+  iree_allocator_t allocator;
+  allocator.self = this;
+  allocator.alloc = +[](void* self, iree_allocation_mode_t mode,
+                        iree_host_size_t byte_length, void** out_ptr) {
+    return reinterpret_cast<BufferPool*>(self)->Allocate(mode, byte_length,
+                                                         out_ptr);
+  };
+  allocator.free = +[](void* self, void* ptr) {
+    reinterpret_cast<BufferPool*>(self)->Free(ptr);
+  };
+  return allocator;
+}
+
+BufferPool::Stats BufferPool::stats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+iree_status_t BufferPool::AllocateBlock(iree_host_size_t byte_length,
+                                        void** out_ptr) {
+  int32_t size_class = SelectSizeClass(byte_length);
+  if (size_class != kUnpooled) {
+    absl::MutexLock lock(&mutex_);
+    auto& free_list = free_lists_[size_class];
+    if (!free_list.empty()) {
+      auto* header = reinterpret_cast<BlockHeader*>(free_list.back());
+      free_list.pop_back();
+      stats_.retained_bytes -= header->capacity;
+      ++stats_.recycled_allocation_count;
+      stats_.recycled_allocation_bytes += header->capacity;
+      IREE_TRACE_PLOT_VALUE_I64("vmla.pool.recycled_bytes",
+                                stats_.recycled_allocation_bytes);
+      *out_ptr = GetBlockData(header);
+      return iree_ok_status();
+    }
+  }
+
+  // Allocate a new block outside of the lock so that other threads can keep
+  // recycling blocks while we wait on the underlying allocator.
+  iree_host_size_t capacity =
+      size_class != kUnpooled
+          ? iree_host_size_t{1} << (size_class + kMinSizeClassLog2)
+          : byte_length;
+  void* ptr = nullptr;
+  // Zeroing is handled by the caller based on the requested mode.
+  iree_status_t status = block_allocator_.alloc(
+      block_allocator_.self, static_cast<iree_allocation_mode_t>(0),
+      sizeof(BlockHeader) + capacity, &ptr);
+  if (!iree_status_is_ok(status)) return status;
+  auto* header = reinterpret_cast<BlockHeader*>(ptr);
+  header->capacity = capacity;
+  header->size_class = size_class;
+  {
+    absl::MutexLock lock(&mutex_);
+    ++stats_.fresh_allocation_count;
+    stats_.fresh_allocation_bytes += capacity;
+    IREE_TRACE_PLOT_VALUE_I64("vmla.pool.fresh_bytes",
+                              stats_.fresh_allocation_bytes);
+  }
+  *out_ptr = GetBlockData(header);
+  return iree_ok_status();
+}
+
+iree_status_t BufferPool::Allocate(iree_allocation_mode_t mode,
+                                   iree_host_size_t byte_length,
+                                   void** out_ptr) {
+  void* existing_ptr = (mode & IREE_ALLOCATION_MODE_TRY_REUSE_EXISTING)
+                           ? *out_ptr
+                           : nullptr;
+  iree_host_size_t existing_capacity = 0;
+  if (existing_ptr) {
+    existing_capacity = GetBlockHeader(existing_ptr)->capacity;
+    if (existing_capacity >= byte_length) {
+      // The existing block is large enough to be reused as-is.
+      return iree_ok_status();
+    }
+  }
+
+  void* ptr = nullptr;
+  iree_status_t status = AllocateBlock(byte_length, &ptr);
+  if (!iree_status_is_ok(status)) return status;
+  if (existing_ptr) {
+    std::memcpy(ptr, existing_ptr, existing_capacity);
+    Free(existing_ptr);
+  }
+  if (mode & IREE_ALLOCATION_MODE_ZERO_CONTENTS) {
+    std::memset(reinterpret_cast<uint8_t*>(ptr) + existing_capacity, 0,
+                byte_length - existing_capacity);
+  }
+  *out_ptr = ptr;
+  return iree_ok_status();
+}
+
+void BufferPool::Free(void* ptr) {
+  if (!ptr) return;
+  auto* header = GetBlockHeader(ptr);
+  if (header->size_class != kUnpooled) {
+    absl::MutexLock lock(&mutex_);
+    if (stats_.retained_bytes + header->capacity <= max_retained_bytes_) {
+      free_lists_[header->size_class].push_back(header);
+      stats_.retained_bytes += header->capacity;
+      return;
+    }
+  }
+  block_allocator_.free(block_allocator_.self, header);
+}
+
+void BufferPool::Trim() {
+  IREE_TRACE_SCOPE0("BufferPool::Trim");
+  std::array<std::vector<void*>, kSizeClassCount> free_lists;
+  {
+    absl::MutexLock lock(&mutex_);
+    std::swap(free_lists, free_lists_);
+    stats_.retained_bytes = 0;
+  }
+  for (auto& free_list : free_lists) {
+    for (void* header : free_list) {
+      block_allocator_.free(block_allocator_.self, header);
+    }
+  }
+}
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,111 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_HAL_VMLA_VMLA_BUFFER_POOL_H_
+#define IREE_HAL_VMLA_VMLA_BUFFER_POOL_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "iree/base/api.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+
+// A size-class free-list pool for transient VMLA buffer allocations.
+//
+// Executables allocate the same set of intermediate buffers for every tile
+// they process and release them before the tile completes. Recycling the
+// blocks avoids a malloc/free pair per intermediate per tile. Requests are
+// rounded up to a power-of-two size class and freed blocks are kept on a
+// per-class free list until |max_retained_bytes| is reached, after which they
+// are returned to the underlying allocator. Requests larger than the largest
+// size class bypass the pool.
+//
+// A single pool is shared by all contexts using the VMLA module within a device
+// so that |max_retained_bytes| bounds the retention of the device as a whole
+// instead of growing with the number of threads dispatching tiles.
+//
+// All blocks allocated from the pool must be freed before it is destroyed.
+//
+// Thread-safe.
+class BufferPool final {
+ public:
+  struct Stats {
+    // Allocations that required a new block from the underlying allocator.
+    int64_t fresh_allocation_count = 0;
+    int64_t fresh_allocation_bytes = 0;
+    // Allocations satisfied with a block from a free list.
+    int64_t recycled_allocation_count = 0;
+    int64_t recycled_allocation_bytes = 0;
+    // Bytes currently held on free lists.
+    int64_t retained_bytes = 0;
+  };
+
+  // Smallest and largest pooled block sizes (log2).
+  static constexpr int kMinSizeClassLog2 = 6;
+  static constexpr int kMaxSizeClassLog2 = 24;
+  static constexpr int kSizeClassCount =
+      kMaxSizeClassLog2 - kMinSizeClassLog2 + 1;
+
+  static constexpr iree_host_size_t kDefaultMaxRetainedBytes = 64 * 1024 * 1024;
+
+  explicit BufferPool(
+      iree_allocator_t block_allocator,
+      iree_host_size_t max_retained_bytes = kDefaultMaxRetainedBytes);
+  ~BufferPool();
+
+  BufferPool(const BufferPool&) = delete;
+  BufferPool& operator=(const BufferPool&) = delete;
+
+  // Returns an allocator that routes allocations through the pool.
+  // The allocator is only valid for the lifetime of the pool.
+  iree_allocator_t allocator();
+
+  // Allocates a block of at least |byte_length| bytes.
+  // Follows the iree_allocator_t alloc contract for |mode|.
+  iree_status_t Allocate(iree_allocation_mode_t mode,
+                         iree_host_size_t byte_length, void** out_ptr);
+
+  // Frees a block previously allocated from the pool.
+  void Free(void* ptr);
+
+  // Returns all retained blocks to the underlying allocator.
+  void Trim();
+
+  // Returns a snapshot of the pool statistics.
+  Stats stats() const;
+
+ private:
+  iree_status_t AllocateBlock(iree_host_size_t byte_length, void** out_ptr);
+
+  iree_allocator_t block_allocator_;
+  iree_host_size_t max_retained_bytes_;
+
+  mutable absl::Mutex mutex_;
+  // Free blocks (pointing at their headers) per size class.
+  std::array<std::vector<void*>, kSizeClassCount> free_lists_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_HAL_VMLA_VMLA_BUFFER_POOL_H_
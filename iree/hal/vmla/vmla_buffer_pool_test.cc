@@ -0,0 +1,164 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/vmla_buffer_pool.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "iree/testing/gtest.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+TEST(BufferPoolTest, RecyclesSameSizeClass) {
+  BufferPool pool(iree_allocator_system());
+  auto allocator = pool.allocator();
+
+  void* ptr = nullptr;
+  ASSERT_TRUE(iree_status_is_ok(iree_allocator_malloc(allocator, 100, &ptr)));
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(ptr) % 16);
+  std::memset(ptr, 0xCD, 100);
+  iree_allocator_free(allocator, ptr);
+  EXPECT_EQ(1, pool.stats().fresh_allocation_count);
+  EXPECT_EQ(128, pool.stats().fresh_allocation_bytes);
+  EXPECT_EQ(128, pool.stats().retained_bytes);
+
+  // A request in the same size class reuses the block and is zeroed.
+  void* recycled_ptr = nullptr;
+  ASSERT_TRUE(iree_status_is_ok(
+      iree_allocator_malloc(allocator, 120, &recycled_ptr)));
+  EXPECT_EQ(ptr, recycled_ptr);
+  for (int i = 0; i < 120; ++i) {
+    ASSERT_EQ(0, reinterpret_cast<uint8_t*>(recycled_ptr)[i]);
+  }
+  EXPECT_EQ(1, pool.stats().fresh_allocation_count);
+  EXPECT_EQ(1, pool.stats().recycled_allocation_count);
+  EXPECT_EQ(128, pool.stats().recycled_allocation_bytes);
+  EXPECT_EQ(0, pool.stats().retained_bytes);
+  iree_allocator_free(allocator, recycled_ptr);
+}
+
+TEST(BufferPoolTest, DistinctSizeClasses) {
+  BufferPool pool(iree_allocator_system());
+  auto allocator = pool.allocator();
+
+  void* small_ptr = nullptr;
+  ASSERT_TRUE(
+      iree_status_is_ok(iree_allocator_malloc(allocator, 16, &small_ptr)));
+  iree_allocator_free(allocator, small_ptr);
+
+  void* large_ptr = nullptr;
+  ASSERT_TRUE(
+      iree_status_is_ok(iree_allocator_malloc(allocator, 4096, &large_ptr)));
+  EXPECT_NE(small_ptr, large_ptr);
+  iree_allocator_free(allocator, large_ptr);
+  EXPECT_EQ(2, pool.stats().fresh_allocation_count);
+  EXPECT_EQ(0, pool.stats().recycled_allocation_count);
+  EXPECT_EQ(64 + 4096, pool.stats().retained_bytes);
+
+  pool.Trim();
+  EXPECT_EQ(0, pool.stats().retained_bytes);
+}
+
+TEST(BufferPoolTest, RetentionLimit) {
+  BufferPool pool(iree_allocator_system(), /*max_retained_bytes=*/256);
+  auto allocator = pool.allocator();
+
+  void* ptrs[3] = {nullptr};
+  for (auto& ptr : ptrs) {
+    ASSERT_TRUE(iree_status_is_ok(iree_allocator_malloc(allocator, 128, &ptr)));
+  }
+  for (auto* ptr : ptrs) {
+    iree_allocator_free(allocator, ptr);
+  }
+  EXPECT_EQ(256, pool.stats().retained_bytes);
+}
+
+TEST(BufferPoolTest, OversizedAllocationsBypassPool) {
+  BufferPool pool(iree_allocator_system());
+  auto allocator = pool.allocator();
+
+  iree_host_size_t byte_length =
+      (iree_host_size_t{1} << BufferPool::kMaxSizeClassLog2) + 1;
+  void* ptr = nullptr;
+  ASSERT_TRUE(
+      iree_status_is_ok(iree_allocator_malloc(allocator, byte_length, &ptr)));
+  iree_allocator_free(allocator, ptr);
+  EXPECT_EQ(0, pool.stats().retained_bytes);
+}
+
+TEST(BufferPoolTest, Realloc) {
+  BufferPool pool(iree_allocator_system());
+  auto allocator = pool.allocator();
+
+  void* ptr = nullptr;
+  ASSERT_TRUE(iree_status_is_ok(iree_allocator_malloc(allocator, 8, &ptr)));
+  std::memset(ptr, 0xAB, 8);
+  void* original_ptr = ptr;
+  // Fits within the original 64 byte block.
+  ASSERT_TRUE(iree_status_is_ok(iree_allocator_realloc(allocator, 64, &ptr)));
+  EXPECT_EQ(original_ptr, ptr);
+  // Requires a larger block; contents are preserved.
+  ASSERT_TRUE(iree_status_is_ok(iree_allocator_realloc(allocator, 256, &ptr)));
+  EXPECT_NE(original_ptr, ptr);
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_EQ(0xAB, reinterpret_cast<uint8_t*>(ptr)[i]);
+  }
+  iree_allocator_free(allocator, ptr);
+}
+
+// Tests that threads sharing a pool recycle each other's blocks and that the
+// retention limit applies to the pool as a whole.
+TEST(BufferPoolTest, ConcurrentAllocations) {
+  constexpr int kThreadCount = 8;
+  constexpr int kIterationCount = 1000;
+  BufferPool pool(iree_allocator_system(), /*max_retained_bytes=*/4 * 1024);
+  auto allocator = pool.allocator();
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([allocator, i]() {
+      for (int j = 0; j < kIterationCount; ++j) {
+        void* ptrs[2] = {nullptr};
+        for (auto& ptr : ptrs) {
+          ASSERT_TRUE(iree_status_is_ok(
+              iree_allocator_malloc(allocator, 64 << (j % 4), &ptr)));
+          std::memset(ptr, i, 64);
+        }
+        for (auto* ptr : ptrs) {
+          ASSERT_EQ(i, reinterpret_cast<uint8_t*>(ptr)[63]);
+          iree_allocator_free(allocator, ptr);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = pool.stats();
+  EXPECT_EQ(kThreadCount * kIterationCount * 2,
+            stats.fresh_allocation_count + stats.recycled_allocation_count);
+  EXPECT_GT(stats.recycled_allocation_count, 0);
+  EXPECT_LE(stats.retained_bytes, 4 * 1024);
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
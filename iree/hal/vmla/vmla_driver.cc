@@ -43,7 +43,7 @@ DeviceInfo GetDefaultDeviceInfo() {
 }  // namespace
 
 // static
-StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
+StatusOr<ref_ptr<Driver>> VMLADriver::Create(Options options) {
   IREE_TRACE_SCOPE0("VMLADriver::Create");
 
   // NOTE: we could use our own allocator here to hide these from any default
@@ -60,12 +60,15 @@ StatusOr<ref_ptr<Driver>> VMLADriver::Create() {
   IREE_RETURN_IF_ERROR(ModuleCreate(iree_allocator_system(), &vmla_module))
       << "VMLA shared module creation failed";
 
-  return make_ref<VMLADriver>(instance, vmla_module);
+  return make_ref<VMLADriver>(instance, vmla_module, options);
 }
 
 VMLADriver::VMLADriver(iree_vm_instance_t* instance,
-                       iree_vm_module_t* vmla_module)
-    : Driver("vmla"), instance_(instance), vmla_module_(vmla_module) {}
+                       iree_vm_module_t* vmla_module, Options options)
+    : Driver("vmla"),
+      instance_(instance),
+      vmla_module_(vmla_module),
+      options_(options) {}
 
 VMLADriver::~VMLADriver() {
   IREE_TRACE_SCOPE0("VMLADriver::dtor");
@@ -84,7 +87,10 @@ StatusOr<ref_ptr<Device>> VMLADriver::CreateDefaultDevice() {
 }
 
 StatusOr<ref_ptr<Device>> VMLADriver::CreateDevice(DriverDeviceID device_id) {
-  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>();
+  // Executables run concurrent tiles in separate VM contexts so tiles can be
+  // distributed across workers.
+  auto scheduling_model = std::make_unique<host::SerialSchedulingModel>(
+      options_.dispatch_worker_count);
   auto device =
       make_ref<VMLADevice>(GetDefaultDeviceInfo(), std::move(scheduling_model),
                            instance_, vmla_module_);
@@ -25,9 +25,16 @@ namespace vmla {
 
 class VMLADriver final : public Driver {
  public:
-  static StatusOr<ref_ptr<Driver>> Create();
+  struct Options {
+    // Number of threads used to process the tiles of each dispatch in addition
+    // to the thread executing the command buffer. 0 processes tiles serially.
+    int dispatch_worker_count = 0;
+  };
 
-  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module);
+  static StatusOr<ref_ptr<Driver>> Create(Options options);
+
+  VMLADriver(iree_vm_instance_t* instance, iree_vm_module_t* vmla_module,
+             Options options);
   ~VMLADriver() override;
 
   StatusOr<std::vector<DeviceInfo>> EnumerateAvailableDevices() override;
@@ -39,6 +46,7 @@ class VMLADriver final : public Driver {
  private:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_module_t* vmla_module_ = nullptr;
+  Options options_;
 };
 
 }  // namespace vmla
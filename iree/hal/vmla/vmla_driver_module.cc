@@ -14,17 +14,31 @@
 
 #include <memory>
 
+#include "absl/flags/flag.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/hal/driver_registry.h"
+#include "iree/hal/host/grid_executor.h"
 #include "iree/hal/vmla/vmla_driver.h"
 
+ABSL_FLAG(int, vmla_worker_count, -1,
+          "Number of worker threads used to process dispatch tiles. "
+          "-1 uses one worker per additional hardware thread and 0 processes "
+          "all tiles on the queue thread.");
+
 namespace iree {
 namespace hal {
 namespace vmla {
 namespace {
 
-StatusOr<ref_ptr<Driver>> CreateVMLADriver() { return VMLADriver::Create(); }
+StatusOr<ref_ptr<Driver>> CreateVMLADriver() {
+  VMLADriver::Options options;
+  options.dispatch_worker_count = absl::GetFlag(FLAGS_vmla_worker_count);
+  if (options.dispatch_worker_count < 0) {
+    options.dispatch_worker_count = host::GridExecutor::GetDefaultWorkerCount();
+  }
+  return VMLADriver::Create(options);
+}
 
 }  // namespace
 }  // namespace vmla
@@ -14,20 +14,38 @@
 
 #include "iree/hal/vmla/vmla_executable.h"
 
+#include <cstddef>
+#include <string>
+
+#include "absl/memory/memory.h"
+
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/host/host_buffer.h"
 #include "iree/hal/vmla/vmla_module.h"
 #include "iree/schemas/vmla_executable_def_generated.h"
 #include "iree/vm/bytecode_module.h"
-#include "iree/vm/invocation.h"
-#include "iree/vm/list.h"
 #include "iree/vm/module.h"
+#include "iree/vm/stack.h"
 
 namespace iree {
 namespace hal {
 namespace vmla {
 
+namespace {
+
+// Argument buffer matching the `riii` calling convention of entry functions.
+// Refs are moved into the callee registers when the call begins.
+struct DispatchArguments {
+  iree_vm_ref_t interface;
+  int32_t workgroup_xyz[3];
+};
+static_assert(offsetof(DispatchArguments, workgroup_xyz) ==
+                  sizeof(iree_vm_ref_t),
+              "arguments must be packed as defined by the VM cconv");
+
+}  // namespace
+
 // static
 StatusOr<ref_ptr<VMLAExecutable>> VMLAExecutable::Load(
     iree_vm_instance_t* instance, iree_vm_module_t* vmla_module,
@@ -53,8 +71,20 @@ VMLAExecutable::VMLAExecutable(ExecutableSpec spec, bool allow_aliasing_data)
 
 VMLAExecutable::~VMLAExecutable() {
   IREE_TRACE_SCOPE0("VMLAExecutable::dtor");
-  iree_vm_context_release(context_);
+  {
+    absl::MutexLock lock(&worker_mutex_);
+    idle_worker_contexts_.clear();
+    worker_contexts_.clear();
+  }
   context_ = nullptr;
+  iree_vm_module_release(bytecode_module_);
+  iree_vm_module_release(vmla_module_);
+  iree_vm_instance_release(instance_);
+}
+
+VMLAExecutable::WorkerContext::~WorkerContext() {
+  if (stack) iree_vm_stack_free(stack);
+  iree_vm_context_release(context);
 }
 
 Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
@@ -77,34 +107,93 @@ Status VMLAExecutable::Initialize(iree_vm_instance_t* instance,
            << "Failed getting root from flatbuffer data";
   }
 
+  instance_ = instance;
+  iree_vm_instance_retain(instance_);
+  vmla_module_ = vmla_module;
+  iree_vm_module_retain(vmla_module_);
+
   // Load bytecode module from the executable spec.
-  iree_vm_module_t* bytecode_module = nullptr;
   IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_create(
       iree_const_byte_span_t{reinterpret_cast<const uint8_t*>(
                                  executable_def->bytecode_module()->data()),
                              executable_def->bytecode_module()->size()},
-      iree_allocator_null(), iree_allocator_system(), &bytecode_module))
+      iree_allocator_null(), iree_allocator_system(), &bytecode_module_))
       << "Failed to load executable bytecode module";
 
   entry_functions_.resize(
-      iree_vm_module_signature(bytecode_module).export_function_count);
+      iree_vm_module_signature(bytecode_module_).export_function_count);
   for (int i = 0; i < entry_functions_.size(); ++i) {
     IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_ordinal(
-        bytecode_module, IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
+        bytecode_module_, IREE_VM_FUNCTION_LINKAGE_EXPORT, i,
         &entry_functions_[i], nullptr));
+
+    // Tiles are dispatched by calling directly into the module with a fixed
+    // argument layout so the signature must match exactly.
+    auto signature = iree_vm_function_signature(&entry_functions_[i]);
+    iree_string_view_t cconv_arguments = iree_string_view_empty();
+    iree_string_view_t cconv_results = iree_string_view_empty();
+    IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
+        &signature, &cconv_arguments, &cconv_results));
+    if (!iree_string_view_equal(cconv_arguments,
+                                iree_make_cstring_view("riii")) ||
+        !iree_string_view_is_empty(cconv_results)) {
+      auto name = iree_vm_function_name(&entry_functions_[i]);
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Entry point " << std::string(name.data, name.size)
+             << " must take (interface, x, y, z) and return no results";
+    }
+  }
+
+  // Create the first context now so that import resolution failures are
+  // reported during load. Note that each executable here has its own contexts
+  // (and thus its own vmla.interface instances).
+  IREE_ASSIGN_OR_RETURN(auto worker_context, CreateWorkerContext());
+  context_ = worker_context->context;
+  absl::MutexLock lock(&worker_mutex_);
+  idle_worker_contexts_.push_back(worker_context.get());
+  worker_contexts_.push_back(std::move(worker_context));
+  return OkStatus();
+}
+
+StatusOr<std::unique_ptr<VMLAExecutable::WorkerContext>>
+VMLAExecutable::CreateWorkerContext() {
+  IREE_TRACE_SCOPE0("VMLAExecutable::CreateWorkerContext");
+  auto worker_context = absl::make_unique<WorkerContext>();
+  std::array<iree_vm_module_t*, 2> modules = {vmla_module_, bytecode_module_};
+  IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+      instance_, modules.data(), modules.size(), iree_allocator_system(),
+      &worker_context->context))
+      << "Failed resolving imports for executable module";
+  IREE_RETURN_IF_ERROR(iree_vm_stack_allocate(
+      iree_vm_context_state_resolver(worker_context->context),
+      iree_allocator_system(), &worker_context->stack));
+  return std::move(worker_context);
+}
+
+StatusOr<VMLAExecutable::WorkerContext*>
+VMLAExecutable::AcquireWorkerContext() {
+  {
+    absl::MutexLock lock(&worker_mutex_);
+    if (!idle_worker_contexts_.empty()) {
+      auto* worker_context = idle_worker_contexts_.back();
+      idle_worker_contexts_.pop_back();
+      return worker_context;
+    }
   }
 
-  // Create context and initialize shared state. Note that each executable here
-  // has its own context (and thus its own vmla.interface instance).
-  std::array<iree_vm_module_t*, 2> modules = {vmla_module, bytecode_module};
-  auto result = StatusBuilder(iree_vm_context_create_with_modules(
-                                  instance, modules.data(), modules.size(),
-                                  iree_allocator_system(), &context_),
-                              IREE_LOC)
-                << "Failed resolving imports for executable module";
-  iree_vm_module_release(bytecode_module);
-
-  return std::move(result);
+  // All contexts are in use by other threads; create another outside of the
+  // lock. The number of contexts is bounded by the peak number of threads
+  // dispatching tiles concurrently.
+  IREE_ASSIGN_OR_RETURN(auto worker_context, CreateWorkerContext());
+  auto* worker_context_ptr = worker_context.get();
+  absl::MutexLock lock(&worker_mutex_);
+  worker_contexts_.push_back(std::move(worker_context));
+  return worker_context_ptr;
+}
+
+void VMLAExecutable::ReleaseWorkerContext(WorkerContext* worker_context) {
+  absl::MutexLock lock(&worker_mutex_);
+  idle_worker_contexts_.push_back(worker_context);
 }
 
 struct VMLADispatchState : public HostExecutable::DispatchState {
@@ -112,9 +201,9 @@ struct VMLADispatchState : public HostExecutable::DispatchState {
   ~VMLADispatchState() override { iree_vm_ref_release(&interface_ref); }
 
   iree_vm_function_t function;
+  // Shared by all tiles in the dispatch and only read while they execute.
   Interface interface;
   iree_vm_ref_t interface_ref;
-  iree_host_size_t input_list_size = 0;
 };
 
 StatusOr<ref_ptr<HostExecutable::DispatchState>>
@@ -128,8 +217,6 @@ VMLAExecutable::PrepareDispatch(const DispatchParams& params) {
 
   auto dispatch_state = make_ref<VMLADispatchState>();
   dispatch_state->function = entry_functions_[params.entry_point];
-  dispatch_state->input_list_size = iree_vm_list_storage_size(
-      /*element_type=*/nullptr, /*interface*/ 1 + /*workgroup_xyz[3]*/ 3);
 
   auto* interface = &dispatch_state->interface;
   IREE_RETURN_IF_ERROR(interface->SetConstants(params.push_constants->values));
@@ -160,27 +247,43 @@ Status VMLAExecutable::DispatchTile(DispatchState* state,
   IREE_TRACE_SCOPE_DYNAMIC(
       iree_vm_function_name(&dispatch_state->function).data);
 
-  auto* input_list_storage = alloca(dispatch_state->input_list_size);
-  iree_vm_list_t* input_list = nullptr;
-  IREE_RETURN_IF_ERROR(iree_vm_list_initialize(
-      iree_make_byte_span(input_list_storage, dispatch_state->input_list_size),
-      /*element_type=*/nullptr,
-      /*interface*/ 1 + /*workgroup_xyz[3]*/ 3, &input_list));
-  iree_vm_list_push_ref_retain(input_list, &dispatch_state->interface_ref);
+  // Tiles may be dispatched concurrently and each thread executes within its
+  // own context so that module state is never shared.
+  IREE_ASSIGN_OR_RETURN(auto* worker_context, AcquireWorkerContext());
+
+  // Entry functions were verified to be `riii` with no results during
+  // initialization so we can populate the argument buffer directly.
+  DispatchArguments arguments = {};
+  iree_vm_ref_retain(&dispatch_state->interface_ref, &arguments.interface);
   for (int i = 0; i < workgroup_xyz.size(); ++i) {
-    iree_vm_value_t value = iree_vm_value_make_i32(workgroup_xyz[i]);
-    iree_vm_list_push_value(input_list, &value);
+    arguments.workgroup_xyz[i] = static_cast<int32_t>(workgroup_xyz[i]);
   }
 
-  // TODO(benvanik): switch to direct calling to avoid the invoke overhead.
-  auto status =
-      Status(iree_vm_invoke(context(), dispatch_state->function,
-                            /*policy=*/nullptr, input_list,
-                            /*outputs=*/nullptr, iree_allocator_system()));
-
-  iree_vm_list_deinitialize(input_list);
+  iree_vm_function_call_t call;
+  call.function = dispatch_state->function;
+  call.arguments = iree_make_byte_span(&arguments, sizeof(arguments));
+  call.results = iree_make_byte_span(nullptr, 0);
 
-  return status;
+  auto* module = call.function.module;
+  auto* stack = worker_context->stack;
+  iree_vm_execution_result_t result;
+  iree_status_t status =
+      module->begin_call(module->self, stack, &call, &result);
+  while (iree_status_is_ok(status) &&
+         result.state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    status = module->resume_call(module->self, stack, &result);
+  }
+  if (!iree_status_is_ok(status)) {
+    // The interface may not have been moved into the callee if the call failed
+    // early and any frames left behind must be popped before the stack is
+    // reused by the next tile.
+    iree_vm_ref_release(&arguments.interface);
+    while (iree_vm_stack_current_frame(stack)) {
+      iree_vm_stack_function_leave(stack);
+    }
+  }
+  ReleaseWorkerContext(worker_context);
+  return Status(status);
 }
 
 }  // namespace vmla
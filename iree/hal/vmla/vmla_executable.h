@@ -15,9 +15,12 @@
 #ifndef IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 #define IREE_HAL_VMLA_VMLA_EXECUTABLE_H_
 
+#include <memory>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/span.h"
 #include "iree/base/status.h"
 #include "iree/hal/executable_spec.h"
@@ -25,6 +28,7 @@
 #include "iree/vm/context.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/module.h"
+#include "iree/vm/stack.h"
 
 namespace iree {
 namespace hal {
@@ -50,6 +54,8 @@ class VMLAExecutable final : public HostExecutable {
   }
 
   // VM context containing the loaded executable module.
+  // Additional contexts are created on demand when tiles are dispatched
+  // concurrently; see AcquireWorkerContext.
   iree_vm_context_t* context() const { return context_; }
 
   // Entry point functions in export order.
@@ -63,14 +69,47 @@ class VMLAExecutable final : public HostExecutable {
                       std::array<uint32_t, 3> workgroup_xyz) override;
 
  private:
+  // A VM context and the stack used to execute tiles within it.
+  // Each context has its own module state and must only be used by one thread
+  // at a time. The VMLA buffer pool is shared by the module states of all
+  // contexts so that transient buffer retention does not scale with the number
+  // of workers.
+  struct WorkerContext {
+    ~WorkerContext();
+
+    iree_vm_context_t* context = nullptr;
+    iree_vm_stack_t* stack = nullptr;
+  };
+
   Status Initialize(iree_vm_instance_t* instance,
                     iree_vm_module_t* vmla_module);
 
+  // Creates a new context with the executable modules registered.
+  StatusOr<std::unique_ptr<WorkerContext>> CreateWorkerContext();
+
+  // Acquires a context for exclusive use by the calling thread, creating one
+  // if all existing contexts are in use by other threads.
+  StatusOr<WorkerContext*> AcquireWorkerContext();
+
+  // Returns a context acquired with AcquireWorkerContext for reuse.
+  void ReleaseWorkerContext(WorkerContext* worker_context);
+
   ExecutableSpec spec_;
   std::vector<uint8_t> cloned_executable_data_;
 
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* vmla_module_ = nullptr;
+  iree_vm_module_t* bytecode_module_ = nullptr;
+
+  // Context of the first worker, used for queries and serial dispatch.
   iree_vm_context_t* context_ = nullptr;
   absl::InlinedVector<iree_vm_function_t, 4> entry_functions_;
+
+  absl::Mutex worker_mutex_;
+  std::vector<std::unique_ptr<WorkerContext>> worker_contexts_
+      ABSL_GUARDED_BY(worker_mutex_);
+  std::vector<WorkerContext*> idle_worker_contexts_
+      ABSL_GUARDED_BY(worker_mutex_);
 };
 
 }  // namespace vmla
@@ -0,0 +1,143 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/hal/vmla/vmla_executable.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "iree/base/status.h"
+#include "iree/hal/heap_buffer.h"
+#include "iree/hal/vmla/vmla_executable_test_module.h"
+#include "iree/hal/vmla/vmla_module.h"
+#include "iree/schemas/vmla_executable_def_generated.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/api.h"
+
+namespace iree {
+namespace hal {
+namespace vmla {
+namespace {
+
+class VMLAExecutableTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() { IREE_CHECK_OK(ModuleRegisterTypes()); }
+
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_vm_instance_create(iree_allocator_system(), &instance_));
+    IREE_ASSERT_OK(ModuleCreate(iree_allocator_system(), &vmla_module_));
+
+    // Wrap the bytecode module in an executable definition as the compiler
+    // does when serializing VMLA executables.
+    const auto* module_file_toc = vmla_executable_test_module_create();
+    ::flatbuffers::FlatBufferBuilder fbb;
+    iree::VMLAExecutableDefT executable_def;
+    executable_def.bytecode_module.resize(module_file_toc->size);
+    std::memcpy(executable_def.bytecode_module.data(), module_file_toc->data,
+                module_file_toc->size);
+    iree::FinishVMLAExecutableDefBuffer(
+        fbb, iree::VMLAExecutableDef::Pack(fbb, &executable_def));
+    executable_data_.resize(fbb.GetSize());
+    std::memcpy(executable_data_.data(), fbb.GetBufferPointer(),
+                executable_data_.size());
+  }
+
+  void TearDown() override {
+    iree_vm_module_release(vmla_module_);
+    iree_vm_instance_release(instance_);
+  }
+
+  StatusOr<ref_ptr<VMLAExecutable>> LoadExecutable() {
+    ExecutableSpec spec;
+    spec.executable_data = absl::MakeConstSpan(executable_data_);
+    return VMLAExecutable::Load(instance_, vmla_module_, spec,
+                                /*allow_aliasing_data=*/false);
+  }
+
+  iree_vm_instance_t* instance_ = nullptr;
+  iree_vm_module_t* vmla_module_ = nullptr;
+  std::vector<uint8_t> executable_data_;
+};
+
+// Dispatches all tiles of a single dispatch from several threads at once and
+// verifies that every tile produced its result. Repeated so that later
+// dispatches reuse the contexts (and pooled buffers) of earlier ones.
+TEST_F(VMLAExecutableTest, ConcurrentDispatch) {
+  constexpr int kThreadCount = 8;
+  constexpr int kTileCount = 1024;
+  IREE_ASSERT_OK_AND_ASSIGN(auto executable, LoadExecutable());
+
+  std::vector<int32_t> src_data(kTileCount);
+  for (int i = 0; i < kTileCount; ++i) {
+    src_data[i] = i * 3 + 1;
+  }
+  auto src_buffer = HeapBuffer::WrapMutable(
+      MemoryType::kHostLocal, MemoryAccess::kAll, BufferUsage::kAll,
+      absl::MakeSpan(src_data));
+
+  for (int iteration = 0; iteration < 4; ++iteration) {
+    std::vector<int32_t> dst_data(kTileCount, 0);
+    auto dst_buffer = HeapBuffer::WrapMutable(
+        MemoryType::kHostLocal, MemoryAccess::kAll, BufferUsage::kAll,
+        absl::MakeSpan(dst_data));
+
+    PushConstantBlock push_constants = {};
+    DescriptorSet::Binding bindings[2];
+    bindings[0].binding = 0;
+    bindings[0].buffer = src_buffer.get();
+    bindings[1].binding = 1;
+    bindings[1].buffer = dst_buffer.get();
+    absl::Span<const DescriptorSet::Binding> set_bindings[1] = {
+        absl::MakeConstSpan(bindings)};
+    HostExecutable::DispatchParams params;
+    params.entry_point = 0;
+    params.workgroup_count = {kTileCount, 1, 1};
+    params.push_constants = &push_constants;
+    params.set_bindings = absl::MakeConstSpan(set_bindings);
+    IREE_ASSERT_OK_AND_ASSIGN(auto dispatch_state,
+                              executable->PrepareDispatch(params));
+
+    // Threads interleave their tiles so that all of them are active at once.
+    std::vector<std::thread> threads;
+    std::vector<Status> thread_statuses(kThreadCount);
+    for (int i = 0; i < kThreadCount; ++i) {
+      threads.emplace_back([&, i]() {
+        for (uint32_t x = i; x < kTileCount; x += kThreadCount) {
+          auto status =
+              executable->DispatchTile(dispatch_state.get(), {x, 0, 0});
+          if (!status.ok()) {
+            thread_statuses[i] = std::move(status);
+            return;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (auto& status : thread_statuses) {
+      IREE_EXPECT_OK(status);
+    }
+    EXPECT_EQ(src_data, dst_data);
+  }
+}
+
+}  // namespace
+}  // namespace vmla
+}  // namespace hal
+}  // namespace iree
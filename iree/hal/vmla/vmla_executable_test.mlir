@@ -0,0 +1,21 @@
+// Executable module used by vmla_executable_test.
+// Each tile copies the element at its x coordinate from binding 0 to binding 1
+// through a transient buffer allocated from the VMLA buffer pool.
+vm.module @vmla_executable_test {
+  vm.export @copy_tile
+  vm.func @copy_tile(%interface : !vm.ref<!vmla.interface>, %x : i32, %y : i32, %z : i32) {
+    %zero = vm.const.i32.zero : i32
+    %c1 = vm.const.i32 1 : i32
+    %c4 = vm.const.i32 4 : i32
+    %offset = vm.mul.i32 %x, %c4 : i32
+    %src = vm.call @vmla.interface.binding(%interface, %zero, %zero) : (!vm.ref<!vmla.interface>, i32, i32) -> !vm.ref<!vmla.buffer>
+    %dst = vm.call @vmla.interface.binding(%interface, %zero, %c1) : (!vm.ref<!vmla.interface>, i32, i32) -> !vm.ref<!vmla.buffer>
+    %scratch = vm.call @vmla.buffer.alloc(%c4) : (i32) -> !vm.ref<!vmla.buffer>
+    vm.call @vmla.buffer.copy(%src, %offset, %scratch, %zero, %c4) : (!vm.ref<!vmla.buffer>, i32, !vm.ref<!vmla.buffer>, i32, i32) -> ()
+    vm.call @vmla.buffer.copy(%scratch, %zero, %dst, %offset, %c4) : (!vm.ref<!vmla.buffer>, i32, !vm.ref<!vmla.buffer>, i32, i32) -> ()
+    vm.return
+  }
+  vm.import @vmla.interface.binding(%interface : !vm.ref<!vmla.interface>, %set : i32, %binding : i32) -> !vm.ref<!vmla.buffer>
+  vm.import @vmla.buffer.alloc(%byte_length : i32) -> !vm.ref<!vmla.buffer>
+  vm.import @vmla.buffer.copy(%src : !vm.ref<!vmla.buffer>, %src_byte_offset : i32, %dst : !vm.ref<!vmla.buffer>, %dst_byte_offset : i32, %byte_length : i32)
+}
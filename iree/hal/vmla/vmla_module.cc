@@ -16,9 +16,11 @@
 
 #include <cstdint>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/types/span.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/vmla/op_kernels.h"
+#include "iree/hal/vmla/vmla_buffer_pool.h"
 #include "iree/vm/module_abi_packing.h"
 
 //===----------------------------------------------------------------------===//
@@ -185,12 +187,18 @@ namespace {
 // one or more times per executable used within a device. Any state here can be
 // treated as workgroup-local memory.
 //
+// Transient buffers allocated by the executable are recycled through a pool so
+// that repeated tiles reuse the same blocks instead of hitting the system
+// allocator for every intermediate.
+//
 // Thread-compatible.
 class VMLAModuleState final {
  public:
-  VMLAModuleState(iree_allocator_t allocator,
+  VMLAModuleState(iree_allocator_t allocator, BufferPool* buffer_pool,
                   kernels::RuntimeState* kernel_state)
-      : allocator_(allocator), kernel_state_(kernel_state) {}
+      : allocator_(allocator),
+        buffer_pool_(buffer_pool),
+        kernel_state_(kernel_state) {}
 
   ~VMLAModuleState() = default;
 
@@ -230,12 +238,13 @@ class VMLAModuleState final {
 
   StatusOr<vm::ref<Buffer>> BufferAlloc(iree_vmla_size_t byte_length) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferAlloc");
-    return Buffer::Allocate(byte_length, allocator_);
+    return Buffer::Allocate(byte_length, buffer_pool_->allocator());
   }
 
   StatusOr<vm::ref<Buffer>> BufferClone(const vm::ref<Buffer>& src) {
     IREE_TRACE_SCOPE0("VMLAModuleState::BufferClone");
-    IREE_ASSIGN_OR_RETURN(auto dst, Buffer::Allocate(src->size(), allocator_));
+    IREE_ASSIGN_OR_RETURN(
+        auto dst, Buffer::Allocate(src->size(), buffer_pool_->allocator()));
     std::memcpy(dst->data(), src->data(), dst->size());
     return std::move(dst);
   }
@@ -642,12 +651,12 @@ class VMLAModuleState final {
   IREE_VMLA_UNARY_OP(CeilF32, kernels::Ceil, float);
   IREE_VMLA_UNARY_OP(RoundF32, kernels::Round, float);
 
-#define IREE_VMLA_SORT_OP(name, type)                                        \
-  Status name(const vm::ref<Buffer>& src, iree_vmla_shape_t src_shape,       \
-              const vm::ref<Buffer>& dst) {                                  \
-    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                            \
-    return kernels::Sort::Execute<type>(src->As<type>(), dst->As<int32_t>(), \
-                                        src_shape);                          \
+#define IREE_VMLA_SORT_OP(name, type)                                   \
+  Status name(const vm::ref<Buffer>& src, iree_vmla_shape_t src_shape,  \
+              const vm::ref<Buffer>& dst) {                             \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                       \
+    return kernels::Sort::Execute<type>(src->As<type>(),                \
+                                        dst->As<int32_t>(), src_shape); \
   }
 
   IREE_VMLA_SORT_OP(SortI8, int8_t);
@@ -655,6 +664,21 @@ class VMLAModuleState final {
   IREE_VMLA_SORT_OP(SortI32, int32_t);
   IREE_VMLA_SORT_OP(SortF32, float);
 
+#define IREE_VMLA_TOPK_OP(name, type)                                         \
+  Status name(const vm::ref<Buffer>& src, iree_vmla_shape_t src_shape,        \
+              const vm::ref<Buffer>& dst, iree_vmla_shape_t dst_shape,        \
+              int32_t order) {                                                \
+    IREE_TRACE_SCOPE0("VMLAModuleState::" #name);                             \
+    return kernels::TopK::Execute<type>(                                      \
+        src->As<type>(), dst->As<int32_t>(), src_shape, dst_shape,            \
+        static_cast<kernels::TopK::Order>(order));                            \
+  }
+
+  IREE_VMLA_TOPK_OP(TopKI8, int8_t);
+  IREE_VMLA_TOPK_OP(TopKI16, int16_t);
+  IREE_VMLA_TOPK_OP(TopKI32, int32_t);
+  IREE_VMLA_TOPK_OP(TopKF32, float);
+
   Status FftF32(const vm::ref<Buffer>& real_src,
                 iree_vmla_shape_t real_src_shape,
                 const vm::ref<Buffer>& imag_src,
@@ -663,8 +687,23 @@ class VMLAModuleState final {
                 const vm::ref<Buffer>& imag_dst) {
     IREE_TRACE_SCOPE0("VMLAModuleState::FftF32");
     IREE_RETURN_IF_ERROR(kernels::Fft::Execute<float>(
-        real_src->As<float>(), imag_src->As<float>(), real_dst->As<float>(),
-        imag_dst->As<float>(), real_src_shape, imag_src_shape));
+        kernel_state_->fft_state.get(), real_src->As<float>(),
+        imag_src->As<float>(), real_dst->As<float>(), imag_dst->As<float>(),
+        real_src_shape, imag_src_shape));
+    return OkStatus();
+  }
+
+  Status IfftF32(const vm::ref<Buffer>& real_src,
+                 iree_vmla_shape_t real_src_shape,
+                 const vm::ref<Buffer>& imag_src,
+                 iree_vmla_shape_t imag_src_shape,
+                 const vm::ref<Buffer>& real_dst,
+                 const vm::ref<Buffer>& imag_dst) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::IfftF32");
+    IREE_RETURN_IF_ERROR(kernels::Ifft::Execute<float>(
+        kernel_state_->fft_state.get(), real_src->As<float>(),
+        imag_src->As<float>(), real_dst->As<float>(), imag_dst->As<float>(),
+        real_src_shape, imag_src_shape));
     return OkStatus();
   }
 
@@ -691,6 +730,31 @@ class VMLAModuleState final {
   IREE_VMLA_CONVERSION_OP(ConvertF32I16, float, int16_t);
   IREE_VMLA_CONVERSION_OP(ConvertF32I32, float, int32_t);
 
+  //===--------------------------------------------------------------------===//
+  // VMLA Ops: fused elementwise
+  //===--------------------------------------------------------------------===//
+
+  Status FusedElementwiseF32(const vm::ref<iree_vm_ro_byte_buffer_t>& program,
+                             absl::Span<const vm::ref<Buffer>> srcs,
+                             const vm::ref<Buffer>& dst) {
+    IREE_TRACE_SCOPE0("VMLAModuleState::FusedElementwiseF32");
+    if (program->data.data_length % sizeof(int32_t) != 0) {
+      return InvalidArgumentErrorBuilder(IREE_LOC)
+             << "Fused program length " << program->data.data_length
+             << " is not a multiple of the word size";
+    }
+    auto program_words = absl::MakeConstSpan(
+        reinterpret_cast<const int32_t*>(program->data.data),
+        program->data.data_length / sizeof(int32_t));
+    absl::InlinedVector<absl::Span<const float>, 8> src_buffers;
+    src_buffers.reserve(srcs.size());
+    for (const auto& src : srcs) {
+      src_buffers.push_back(src->As<float>());
+    }
+    return kernels::FusedElementwise::Execute<float>(
+        program_words, src_buffers, dst->As<float>());
+  }
+
   //===--------------------------------------------------------------------===//
   // VMLA Ops: Convolution
   //===--------------------------------------------------------------------===//
@@ -733,7 +797,8 @@ class VMLAModuleState final {
       auto output_example =
           absl::MakeSpan(raw_dst_data + i * output_stride, output_stride);
       IREE_RETURN_IF_ERROR(kernels::Conv2D::Execute(
-          input_example, input_example_shape, filter_buffer, filter_shape_4d,
+          kernel_state_->mat_mul_state.get(), input_example,
+          input_example_shape, filter_buffer, filter_shape_4d,
           output_example, output_example_shape, window_strides_2d, pad_h, pad_w,
           lhs_dilation.subspan(0, 2), rhs_dilation.subspan(0, 2),
           feature_group_count));
@@ -842,10 +907,15 @@ class VMLAModuleState final {
  private:
   iree_allocator_t allocator_;
 
-  // NOTE: kernel state must be externally synchronized as it is shared across
-  // all contexts using the VMLA module. This is fine in our current design as
-  // we only ever execute a single context at a time but if we start to allow
-  // concurrency across contexts we'll need to introduce locks.
+  // NOTE: the buffer pool is shared across all contexts using the VMLA module
+  // so that blocks are recycled across worker contexts and retention is bounded
+  // per device. All buffers are released before the module is destroyed as
+  // contexts retain the modules they have loaded.
+  BufferPool* buffer_pool_ = nullptr;
+
+  // NOTE: kernel state is shared across all contexts using the VMLA module and
+  // executables run tiles in separate contexts concurrently. Kernel runtime
+  // state must be internally synchronized.
   kernels::RuntimeState* kernel_state_ = nullptr;
 };
 
@@ -1000,7 +1070,12 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("sort.i16", &VMLAModuleState::SortI16),
     vm::MakeNativeFunction("sort.i32", &VMLAModuleState::SortI32),
     vm::MakeNativeFunction("sort.f32", &VMLAModuleState::SortF32),
+    vm::MakeNativeFunction("topk.i8", &VMLAModuleState::TopKI8),
+    vm::MakeNativeFunction("topk.i16", &VMLAModuleState::TopKI16),
+    vm::MakeNativeFunction("topk.i32", &VMLAModuleState::TopKI32),
+    vm::MakeNativeFunction("topk.f32", &VMLAModuleState::TopKF32),
     vm::MakeNativeFunction("fft.f32", &VMLAModuleState::FftF32),
+    vm::MakeNativeFunction("ifft.f32", &VMLAModuleState::IfftF32),
     vm::MakeNativeFunction("finite.f32", &VMLAModuleState::FiniteF32),
 
     vm::MakeNativeFunction("convert.i8.i16", &VMLAModuleState::ConvertI8I16),
@@ -1016,6 +1091,9 @@ static const vm::NativeFunction<VMLAModuleState> kVMLAModuleFunctions[] = {
     vm::MakeNativeFunction("convert.f32.i16", &VMLAModuleState::ConvertF32I16),
     vm::MakeNativeFunction("convert.f32.i32", &VMLAModuleState::ConvertF32I32),
 
+    vm::MakeNativeFunction("fused.elementwise.f32",
+                           &VMLAModuleState::FusedElementwiseF32),
+
     vm::MakeNativeFunction("reduce.sum.i8", &VMLAModuleState::ReduceSumI8),
     vm::MakeNativeFunction("reduce.sum.i16", &VMLAModuleState::ReduceSumI16),
     vm::MakeNativeFunction("reduce.sum.i32", &VMLAModuleState::ReduceSumI32),
@@ -1058,7 +1136,8 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
  public:
   explicit VMLAModule(iree_allocator_t allocator)
       : vm::NativeModule<VMLAModuleState>(
-            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)) {}
+            "vmla", allocator, absl::MakeConstSpan(kVMLAModuleFunctions)),
+        buffer_pool_(allocator) {}
   ~VMLAModule() = default;
 
   Status Initialize() {
@@ -1069,13 +1148,16 @@ class VMLAModule final : public vm::NativeModule<VMLAModuleState> {
   StatusOr<std::unique_ptr<VMLAModuleState>> CreateState(
       iree_allocator_t allocator) override {
     IREE_TRACE_SCOPE0("VMLAModule::CreateState");
-    auto state = std::make_unique<VMLAModuleState>(allocator, &kernel_state_);
+    auto state = std::make_unique<VMLAModuleState>(allocator, &buffer_pool_,
+                                                   &kernel_state_);
     return state;
   }
 
  private:
   // NOTE: shared across all contexts with the VMLA module loaded. See
-  // VMLAModuleState::kernel_state_ for more information.
+  // VMLAModuleState::buffer_pool_ and VMLAModuleState::kernel_state_ for more
+  // information.
+  BufferPool buffer_pool_;
   kernels::RuntimeState kernel_state_;
 };
 
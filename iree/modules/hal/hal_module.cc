@@ -133,18 +133,25 @@ class HALModuleState final {
 
   Status ExSubmitAndWait(
       const vm::ref<iree_hal_device_t>& device,
-      const vm::ref<iree_hal_command_buffer_t>& command_buffer) {
+      absl::Span<const vm::ref<iree_hal_command_buffer_t>> command_buffers) {
     IREE_TRACE_SCOPE0("HALModuleState::ExSubmitAndWait");
 
     vm::ref<iree_hal_semaphore_t> semaphore;
     IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(
         device.get(), 0ull, iree_allocator_system(), &semaphore));
 
+    // Command buffers are submitted in order and the execution barriers they
+    // contain apply across the whole batch as if it were one command buffer.
+    absl::InlinedVector<iree_hal_command_buffer_t*, 4> command_buffer_ptrs(
+        command_buffers.size());
+    for (int i = 0; i < command_buffers.size(); ++i) {
+      command_buffer_ptrs[i] = command_buffers[i].get();
+    }
+
     iree_hal_submission_batch_t batch;
     memset(&batch, 0, sizeof(batch));
-    batch.command_buffer_count = 1;
-    iree_hal_command_buffer_t* command_buffer_ptrs[] = {command_buffer.get()};
-    batch.command_buffers = command_buffer_ptrs;
+    batch.command_buffer_count = command_buffer_ptrs.size();
+    batch.command_buffers = command_buffer_ptrs.data();
     batch.signal_semaphores.count = 1;
     iree_hal_semaphore_t* semaphore_ptrs[] = {semaphore.get()};
     batch.signal_semaphores.semaphores = semaphore_ptrs;
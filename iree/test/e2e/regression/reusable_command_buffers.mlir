@@ -0,0 +1,16 @@
+// Compares streams recorded on every invocation with streams recorded once
+// through -iree-hal-reusable-command-buffers. Run the iree-benchmark-module
+// commands below by hand to compare the BM_add_mul timings of both paths.
+// RUN: iree-run-mlir -export-all -iree-hal-target-backends=vmla -function-input="1024xf32=1" -function-input="1024xf32=2" %s | IreeFileCheck %s
+// RUN: iree-run-mlir -export-all -iree-hal-target-backends=vmla -iree-hal-reusable-command-buffers -function-input="1024xf32=1" -function-input="1024xf32=2" %s | IreeFileCheck %s
+// RUN: iree-translate --iree-hal-target-backends=vmla -iree-mlir-to-vm-bytecode-module %s | iree-benchmark-module --driver=vmla --entry_function=add_mul --function_inputs='1024xf32=1, 1024xf32=2' | IreeFileCheck --check-prefix=BENCHMARK %s
+// RUN: iree-translate --iree-hal-target-backends=vmla -iree-hal-reusable-command-buffers -iree-mlir-to-vm-bytecode-module %s | iree-benchmark-module --driver=vmla --entry_function=add_mul --function_inputs='1024xf32=1, 1024xf32=2' | IreeFileCheck --check-prefix=BENCHMARK %s
+
+// CHECK-LABEL: EXEC @add_mul
+// CHECK: 1024xf32=6 6 6 6
+// BENCHMARK-LABEL: BM_add_mul
+func @add_mul(%arg0: tensor<1024xf32>, %arg1: tensor<1024xf32>) -> tensor<1024xf32> attributes { iree.module.export } {
+  %0 = mhlo.add %arg0, %arg1 : tensor<1024xf32>
+  %1 = mhlo.multiply %0, %arg1 : tensor<1024xf32>
+  return %1 : tensor<1024xf32>
+}
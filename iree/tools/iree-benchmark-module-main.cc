@@ -12,16 +12,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
+#include <iostream>
+
 #include "absl/flags/flag.h"
 #include "absl/flags/internal/parse.h"
 #include "absl/flags/usage.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "benchmark/benchmark.h"
 #include "iree/base/file_io.h"
 #include "iree/base/init.h"
 #include "iree/base/status.h"
 #include "iree/base/tracing.h"
 #include "iree/modules/hal/hal_module.h"
+#include "iree/tools/utils/load_generator.h"
 #include "iree/tools/utils/vm_util.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode_module.h"
@@ -53,9 +59,47 @@ ABSL_FLAG(std::string, function_inputs_file, "",
           "Provides a file for input shapes and optional values (see "
           "ParseToVariantListFromFile in vm_util.h for details)");
 
+ABSL_FLAG(int, load_concurrency, 0,
+          "Runs in load-generator mode with the given number of concurrent "
+          "callers instead of registering benchmark loops. Reports latency "
+          "percentiles and throughput for each benchmarked function.");
+
+ABSL_FLAG(bool, load_shared_context, false,
+          "Whether all load-generator callers share a single VM context. VM "
+          "contexts are not thread-safe so calls on the shared context are "
+          "serialized and the mode measures contention on a single context. "
+          "By default each caller has its own context sharing the same device "
+          "and loaded modules.");
+
+ABSL_FLAG(double, load_qps, 0.0,
+          "Fixed aggregate arrival rate in calls per second across all "
+          "load-generator callers. Latencies are measured from the scheduled "
+          "arrival time. When 0 each caller issues its next call as soon as "
+          "the previous one completes (closed-loop).");
+
+ABSL_FLAG(double, load_duration_seconds, 10.0,
+          "Duration in seconds to generate load for each function.");
+
+ABSL_FLAG(int, load_warmup_calls, 1,
+          "Unmeasured calls each load-generator caller makes before "
+          "measurement begins.");
+
 namespace iree {
 namespace {
 
+// Invokes |function| once with |inputs| and discards the results.
+Status InvokeFunction(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_list_t* inputs,
+    const std::vector<RawSignatureParser::Description>& output_descs) {
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(/*element_type=*/nullptr,
+                                           output_descs.size(),
+                                           iree_allocator_system(), &outputs));
+  return iree_vm_invoke(context, function, /*policy=*/nullptr, inputs,
+                        outputs.get(), iree_allocator_system());
+}
+
 static void BenchmarkFunction(
     const std::string& benchmark_name, iree_vm_context_t* context,
     iree_vm_function_t function, iree_vm_list_t* inputs,
@@ -68,12 +112,7 @@ static void BenchmarkFunction(
   for (auto _ : state) {
     IREE_TRACE_SCOPE0("BenchmarkIteration");
     IREE_TRACE_FRAME_MARK_NAMED("Iteration");
-    vm::ref<iree_vm_list_t> outputs;
-    IREE_CHECK_OK(iree_vm_list_create(/*element_type=*/nullptr,
-                                      output_descs.size(),
-                                      iree_allocator_system(), &outputs));
-    IREE_CHECK_OK(iree_vm_invoke(context, function, /*policy=*/nullptr, inputs,
-                                 outputs.get(), iree_allocator_system()));
+    IREE_CHECK_OK(InvokeFunction(context, function, inputs, output_descs));
   }
 }
 
@@ -135,7 +174,7 @@ class IREEBenchmark {
     IREE_TRACE_SCOPE0("IREEBenchmark::dtor");
 
     // Order matters.
-    inputs_.reset();
+    functions_.clear();
     iree_vm_module_release(hal_module_);
     iree_vm_module_release(input_module_);
     iree_hal_device_release(device_);
@@ -145,21 +184,119 @@ class IREEBenchmark {
 
   Status Register() {
     IREE_TRACE_SCOPE0("IREEBenchmark::Register");
+    IREE_RETURN_IF_ERROR(PrepareFunctions());
+    for (auto& function : functions_) {
+      RegisterModuleBenchmarks(function.name, context_, function.function,
+                               function.inputs.get(), function.output_descs);
+    }
+    return iree::OkStatus();
+  }
+
+  // Runs each function under concurrent load and prints a latency summary.
+  Status RunLoad() {
+    IREE_TRACE_SCOPE0("IREEBenchmark::RunLoad");
+    IREE_RETURN_IF_ERROR(PrepareFunctions());
+
+    LoadGeneratorOptions options;
+    options.concurrency = absl::GetFlag(FLAGS_load_concurrency);
+    options.target_qps = absl::GetFlag(FLAGS_load_qps);
+    options.duration_seconds = absl::GetFlag(FLAGS_load_duration_seconds);
+    options.warmup_calls = absl::GetFlag(FLAGS_load_warmup_calls);
+    bool shared_context = absl::GetFlag(FLAGS_load_shared_context);
+    absl::Mutex shared_context_mutex;
+
+    // Each caller gets its own context (and thus its own module state) unless
+    // sharing was requested. The device and loaded modules are always shared.
+    std::vector<iree_vm_context_t*> caller_contexts(
+        std::max(options.concurrency, 0), nullptr);
+    Status status;
+    for (auto& caller_context : caller_contexts) {
+      if (shared_context) {
+        iree_vm_context_retain(context_);
+        caller_context = context_;
+        continue;
+      }
+      std::array<iree_vm_module_t*, 2> modules = {hal_module_, input_module_};
+      status = iree_vm_context_create_with_modules(
+          instance_, modules.data(), modules.size(), iree_allocator_system(),
+          &caller_context);
+      if (!status.ok()) break;
+    }
+
+    std::string arrival = options.target_qps > 0.0
+                              ? std::to_string(options.target_qps) + " calls/s"
+                              : "closed-loop";
+    for (auto& function : functions_) {
+      if (!status.ok()) break;
+      IREE_TRACE_SCOPE_DYNAMIC(function.name.c_str());
+
+      // Each caller gets its own copy of the inputs (with their own buffers)
+      // so that functions that modify or alias their arguments cannot race
+      // with other callers.
+      std::vector<vm::ref<iree_vm_list_t>> caller_inputs(
+          caller_contexts.size());
+      for (auto& inputs : caller_inputs) {
+        if (function.input_descs.empty()) continue;
+        auto inputs_or = ParseInputs(function.input_descs);
+        if (!inputs_or.ok()) {
+          status = std::move(inputs_or).status();
+          break;
+        }
+        inputs = std::move(inputs_or).value();
+      }
+      if (!status.ok()) break;
+
+      auto summary_or = RunLoadGenerator(options, [&](int caller_index) {
+        // Contexts must be externally synchronized; a shared context admits
+        // only one caller at a time.
+        absl::MutexLockMaybe lock(shared_context ? &shared_context_mutex
+                                                 : nullptr);
+        return InvokeFunction(caller_contexts[caller_index], function.function,
+                              caller_inputs[caller_index].get(),
+                              function.output_descs);
+      });
+      if (!summary_or.ok()) {
+        status = std::move(summary_or).status();
+        break;
+      }
+      std::cout << "LOAD_" << function.name
+                << ": callers=" << options.concurrency
+                << (shared_context ? " shared_context" : "")
+                << " arrival=" << arrival << "\n"
+                << summary_or.value() << std::endl;
+    }
 
+    for (auto* caller_context : caller_contexts) {
+      iree_vm_context_release(caller_context);
+    }
+    return status;
+  }
+
+ private:
+  struct FunctionInfo {
+    std::string name;
+    iree_vm_function_t function;
+    std::vector<RawSignatureParser::Description> input_descs;
+    // Inputs used by the benchmark library loops on the main thread.
+    vm::ref<iree_vm_list_t> inputs;
+    std::vector<RawSignatureParser::Description> output_descs;
+  };
+
+  // Initializes the runtime and gathers the functions to benchmark.
+  Status PrepareFunctions() {
     if (!instance_ || !device_ || !hal_module_ || !context_ || !input_module_) {
       IREE_RETURN_IF_ERROR(Init());
     }
 
     auto function_name = absl::GetFlag(FLAGS_entry_function);
     if (!function_name.empty()) {
-      IREE_RETURN_IF_ERROR(RegisterSpecificFunction(function_name));
+      IREE_RETURN_IF_ERROR(AddSpecificFunction(function_name));
     } else {
-      IREE_RETURN_IF_ERROR(RegisterAllExportedFunctions());
+      IREE_RETURN_IF_ERROR(AddAllExportedFunctions());
     }
     return iree::OkStatus();
   }
 
- private:
   Status Init() {
     IREE_TRACE_SCOPE0("IREEBenchmark::Init");
     IREE_TRACE_FRAME_MARK_BEGIN_NAMED("init");
@@ -187,8 +324,8 @@ class IREEBenchmark {
     return iree::OkStatus();
   }
 
-  Status RegisterSpecificFunction(const std::string& function_name) {
-    IREE_TRACE_SCOPE0("IREEBenchmark::RegisterSpecificFunction");
+  Status AddSpecificFunction(const std::string& function_name) {
+    IREE_TRACE_SCOPE0("IREEBenchmark::AddSpecificFunction");
 
     iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(input_module_->lookup_function(
@@ -199,27 +336,29 @@ class IREEBenchmark {
 
     // Construct inputs.
     IREE_ASSIGN_OR_RETURN(auto input_descs, ParseInputSignature(function));
-    if (!absl::GetFlag(FLAGS_function_inputs_file).empty()) {
-      IREE_ASSIGN_OR_RETURN(inputs_,
-                            ParseToVariantListFromFile(
-                                input_descs, iree_hal_device_allocator(device_),
-                                absl::GetFlag(FLAGS_function_inputs_file)));
-    } else {
-      IREE_ASSIGN_OR_RETURN(
-          inputs_,
-          ParseToVariantList(input_descs, iree_hal_device_allocator(device_),
-                             absl::GetFlag(FLAGS_function_inputs)));
-    }
+    IREE_ASSIGN_OR_RETURN(auto inputs, ParseInputs(input_descs));
 
     // Creates output singnature.
     IREE_ASSIGN_OR_RETURN(auto output_descs, ParseOutputSignature(function));
-    RegisterModuleBenchmarks(function_name, context_, function, inputs_.get(),
-                             output_descs);
+    functions_.push_back({function_name, function, std::move(input_descs),
+                          std::move(inputs), std::move(output_descs)});
     return iree::OkStatus();
   }
 
-  Status RegisterAllExportedFunctions() {
-    IREE_TRACE_SCOPE0("IREEBenchmark::RegisterAllExportedFunctions");
+  // Parses the inputs from flags into a new list with newly allocated buffers.
+  StatusOr<vm::ref<iree_vm_list_t>> ParseInputs(
+      const std::vector<RawSignatureParser::Description>& input_descs) {
+    if (!absl::GetFlag(FLAGS_function_inputs_file).empty()) {
+      return ParseToVariantListFromFile(
+          input_descs, iree_hal_device_allocator(device_),
+          absl::GetFlag(FLAGS_function_inputs_file));
+    }
+    return ParseToVariantList(input_descs, iree_hal_device_allocator(device_),
+                              absl::GetFlag(FLAGS_function_inputs));
+  }
+
+  Status AddAllExportedFunctions() {
+    IREE_TRACE_SCOPE0("IREEBenchmark::AddAllExportedFunctions");
     iree_vm_function_t function;
     iree_vm_module_signature_t signature =
         input_module_->signature(input_module_->self);
@@ -238,8 +377,8 @@ class IREEBenchmark {
                << "'";
       }
       IREE_ASSIGN_OR_RETURN(auto output_descs, ParseOutputSignature(function));
-      iree::RegisterModuleBenchmarks(function_name, context_, function,
-                                     /*inputs=*/nullptr, output_descs);
+      functions_.push_back({function_name, function, std::move(input_descs),
+                            /*inputs=*/{}, std::move(output_descs)});
     }
     return iree::OkStatus();
   }
@@ -250,7 +389,7 @@ class IREEBenchmark {
   iree_vm_module_t* hal_module_;
   iree_vm_context_t* context_;
   iree_vm_module_t* input_module_;
-  iree::vm::ref<iree_vm_list_t> inputs_;
+  std::vector<FunctionInfo> functions_;
 };
 }  // namespace
 }  // namespace iree
@@ -276,6 +415,11 @@ int main(int argc, char** argv) {
       "    [--function_inputs=2xi32=1 2,1x2xf32=2 1 | \n"
       "     --function_inputs_file=file_with_function_inputs]\n"
       "    [--driver=vmla]\n"
+      "    [--load_concurrency=N [--load_shared_context]\n"
+      "     [--load_qps=<calls/s>] [--load_duration_seconds=10]\n"
+      "     [--load_warmup_calls=1]]\n"
+      "      Runs concurrent callers and reports latency percentiles\n"
+      "      instead of running the benchmark library loops\n"
       "\n\n"
       "  Optional flags from third_party/benchmark/src/benchmark.cc:\n"
       "    [--benchmark_list_tests={true|false}]\n"
@@ -298,6 +442,14 @@ int main(int argc, char** argv) {
   iree::InitializeEnvironment(&argc, &argv);
 
   iree::IREEBenchmark iree_benchmark;
+  if (absl::GetFlag(FLAGS_load_concurrency) > 0) {
+    auto status = iree_benchmark.RunLoad();
+    if (!status.ok()) {
+      std::cout << status << std::endl;
+      return static_cast<int>(status.code());
+    }
+    return 0;
+  }
   auto status = iree_benchmark.Register();
   if (!status.ok()) {
     std::cout << status << std::endl;
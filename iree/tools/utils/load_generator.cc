@@ -0,0 +1,200 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/tools/utils/load_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#include "iree/base/tracing.h"
+
+namespace iree {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+int64_t ToNanoseconds(Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+// Returns the nearest-rank |percentile| (in [0, 1]) of |sorted_values|.
+int64_t NearestRankPercentile(const std::vector<int64_t>& sorted_values,
+                              double percentile) {
+  if (sorted_values.empty()) return 0;
+  size_t rank = static_cast<size_t>(
+      std::ceil(percentile * static_cast<double>(sorted_values.size())));
+  rank = std::min(std::max(rank, size_t{1}), sorted_values.size());
+  return sorted_values[rank - 1];
+}
+
+struct CallerResult {
+  std::vector<int64_t> latencies_ns;
+  Clock::time_point last_completion_time;
+  Status status;
+};
+
+}  // namespace
+
+LatencySummary SummarizeLatencies(std::vector<int64_t>* latencies_ns,
+                                  int64_t wall_time_ns) {
+  LatencySummary summary;
+  summary.call_count = static_cast<int64_t>(latencies_ns->size());
+  summary.wall_time_ns = wall_time_ns;
+  if (latencies_ns->empty()) return summary;
+
+  std::sort(latencies_ns->begin(), latencies_ns->end());
+  if (wall_time_ns > 0) {
+    summary.throughput_qps =
+        static_cast<double>(summary.call_count) * 1e9 / wall_time_ns;
+  }
+  long double total_ns = 0;
+  for (int64_t latency_ns : *latencies_ns) total_ns += latency_ns;
+  summary.mean_ns = static_cast<int64_t>(total_ns / summary.call_count);
+  summary.p50_ns = NearestRankPercentile(*latencies_ns, 0.50);
+  summary.p90_ns = NearestRankPercentile(*latencies_ns, 0.90);
+  summary.p99_ns = NearestRankPercentile(*latencies_ns, 0.99);
+  summary.p999_ns = NearestRankPercentile(*latencies_ns, 0.999);
+  summary.max_ns = latencies_ns->back();
+  return summary;
+}
+
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary) {
+  auto ms = [](int64_t ns) { return static_cast<double>(ns) / 1e6; };
+  std::ios_base::fmtflags flags = os.flags();
+  os << std::fixed << std::setprecision(3);
+  os << "calls: " << summary.call_count << " in "
+     << static_cast<double>(summary.wall_time_ns) / 1e9 << " s ("
+     << summary.throughput_qps << " calls/s)\n";
+  os << "latency (ms): mean=" << ms(summary.mean_ns)
+     << " p50=" << ms(summary.p50_ns) << " p90=" << ms(summary.p90_ns)
+     << " p99=" << ms(summary.p99_ns) << " p99.9=" << ms(summary.p999_ns)
+     << " max=" << ms(summary.max_ns) << "\n";
+  os.flags(flags);
+  return os;
+}
+
+StatusOr<LatencySummary> RunLoadGenerator(const LoadGeneratorOptions& options,
+                                          const LoadGeneratorCallFn& call_fn) {
+  IREE_TRACE_SCOPE0("RunLoadGenerator");
+  if (options.concurrency < 1) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Load generator concurrency must be >= 1; got "
+           << options.concurrency;
+  } else if (options.target_qps < 0.0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Load generator target QPS must be >= 0; got "
+           << options.target_qps;
+  } else if (options.duration_seconds <= 0.0) {
+    return InvalidArgumentErrorBuilder(IREE_LOC)
+           << "Load generator duration must be > 0; got "
+           << options.duration_seconds;
+  }
+
+  const int concurrency = options.concurrency;
+  const auto duration = std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(options.duration_seconds));
+  // Interval between arrivals across all callers; 0 for closed-loop.
+  const double arrival_interval_ns =
+      options.target_qps > 0.0 ? 1e9 / options.target_qps : 0.0;
+
+  // All callers warm up and then wait for the start time to be published so
+  // that measurement begins at the same time for all of them.
+  std::mutex start_mutex;
+  std::condition_variable start_cv;
+  int ready_count = 0;
+  bool started = false;
+  Clock::time_point start_time;
+  std::atomic<bool> stop{false};
+
+  std::vector<CallerResult> results(concurrency);
+  auto caller_main = [&](int caller_index) {
+    CallerResult& result = results[caller_index];
+    for (int i = 0; i < options.warmup_calls && result.status.ok(); ++i) {
+      result.status = call_fn(caller_index);
+    }
+    if (!result.status.ok()) stop = true;
+    {
+      std::unique_lock<std::mutex> lock(start_mutex);
+      ++ready_count;
+      start_cv.notify_all();
+      start_cv.wait(lock, [&] { return started; });
+    }
+    const Clock::time_point end_time = start_time + duration;
+
+    for (int64_t k = 0; !stop.load(std::memory_order_relaxed); ++k) {
+      Clock::time_point issue_time;
+      if (arrival_interval_ns > 0.0) {
+        // Interleave the schedule across callers so that arrivals are evenly
+        // spaced in aggregate.
+        issue_time =
+            start_time + std::chrono::duration_cast<Clock::duration>(
+                             std::chrono::duration<double, std::nano>(
+                                 (k * concurrency + caller_index) *
+                                 arrival_interval_ns));
+        if (issue_time >= end_time) break;
+        std::this_thread::sleep_until(issue_time);
+      } else {
+        issue_time = Clock::now();
+        if (issue_time >= end_time) break;
+      }
+      result.status = call_fn(caller_index);
+      if (!result.status.ok()) {
+        stop = true;
+        break;
+      }
+      result.last_completion_time = Clock::now();
+      result.latencies_ns.push_back(
+          ToNanoseconds(result.last_completion_time - issue_time));
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  for (int i = 0; i < concurrency; ++i) {
+    threads.emplace_back(caller_main, i);
+  }
+  {
+    std::unique_lock<std::mutex> lock(start_mutex);
+    start_cv.wait(lock, [&] { return ready_count == concurrency; });
+    start_time = Clock::now();
+    started = true;
+    start_cv.notify_all();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  std::vector<int64_t> latencies_ns;
+  Clock::time_point last_completion_time = start_time;
+  for (auto& result : results) {
+    IREE_RETURN_IF_ERROR(std::move(result.status));
+    latencies_ns.insert(latencies_ns.end(), result.latencies_ns.begin(),
+                        result.latencies_ns.end());
+    if (!result.latencies_ns.empty()) {
+      last_completion_time =
+          std::max(last_completion_time, result.last_completion_time);
+    }
+  }
+  return SummarizeLatencies(&latencies_ns,
+                            ToNanoseconds(last_completion_time - start_time));
+}
+
+}  // namespace iree
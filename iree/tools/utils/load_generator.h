@@ -0,0 +1,89 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef IREE_TOOLS_UTILS_LOAD_GENERATOR_H_
+#define IREE_TOOLS_UTILS_LOAD_GENERATOR_H_
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "iree/base/status.h"
+
+namespace iree {
+
+struct LoadGeneratorOptions {
+  // Number of concurrent callers, each on its own thread.
+  int concurrency = 1;
+
+  // Target aggregate arrival rate in calls per second across all callers.
+  // When 0 the load is closed-loop: each caller issues its next call as soon as
+  // the previous one completes.
+  double target_qps = 0.0;
+
+  // Wall time in seconds to issue calls for after warmup. Calls in flight when
+  // the time elapses are allowed to complete and are included in the results.
+  double duration_seconds = 10.0;
+
+  // Calls each caller makes before measurement begins. These are used to
+  // populate caches and lazily-initialized state and are not recorded.
+  int warmup_calls = 1;
+};
+
+// Summary statistics of the call latencies recorded by a load generator run.
+struct LatencySummary {
+  // Total number of measured calls across all callers.
+  int64_t call_count = 0;
+  // Wall time from the first scheduled call to the last completion.
+  int64_t wall_time_ns = 0;
+  // Achieved throughput in calls per second.
+  double throughput_qps = 0.0;
+
+  int64_t mean_ns = 0;
+  int64_t p50_ns = 0;
+  int64_t p90_ns = 0;
+  int64_t p99_ns = 0;
+  int64_t p999_ns = 0;
+  int64_t max_ns = 0;
+};
+
+// Summarizes |latencies_ns| using nearest-rank percentiles.
+// |latencies_ns| is sorted in-place.
+LatencySummary SummarizeLatencies(std::vector<int64_t>* latencies_ns,
+                                  int64_t wall_time_ns);
+
+// Prints |summary| in a human-readable form with times in milliseconds.
+std::ostream& operator<<(std::ostream& os, const LatencySummary& summary);
+
+// Issues a call made by the caller with the given index in [0, concurrency).
+// Calls from the same caller are never concurrent with each other.
+using LoadGeneratorCallFn = std::function<Status(int caller_index)>;
+
+// Issues calls to |call_fn| from |options.concurrency| threads until the
+// configured duration has elapsed and returns the latency summary.
+//
+// With a fixed arrival rate calls are scheduled evenly across callers and
+// latency is measured from the time the call was scheduled to be issued rather
+// than when it actually was. This includes any queuing delay in the reported
+// latencies when callers cannot keep up with the arrival rate instead of
+// silently lowering the offered load.
+//
+// Stops all callers and returns the error if any call fails.
+StatusOr<LatencySummary> RunLoadGenerator(const LoadGeneratorOptions& options,
+                                          const LoadGeneratorCallFn& call_fn);
+
+}  // namespace iree
+
+#endif  // IREE_TOOLS_UTILS_LOAD_GENERATOR_H_
@@ -0,0 +1,118 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "iree/tools/utils/load_generator.h"
+
+#include <atomic>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace {
+
+TEST(LoadGeneratorTest, SummarizeEmpty) {
+  std::vector<int64_t> latencies_ns;
+  auto summary = SummarizeLatencies(&latencies_ns, 1000);
+  EXPECT_EQ(0, summary.call_count);
+  EXPECT_EQ(0, summary.p50_ns);
+  EXPECT_EQ(0.0, summary.throughput_qps);
+}
+
+TEST(LoadGeneratorTest, SummarizePercentiles) {
+  // 1..1000 in reverse order to ensure the summary sorts.
+  std::vector<int64_t> latencies_ns;
+  for (int64_t i = 1000; i >= 1; --i) latencies_ns.push_back(i);
+  auto summary =
+      SummarizeLatencies(&latencies_ns, /*wall_time_ns=*/2000000000);
+  EXPECT_EQ(1000, summary.call_count);
+  EXPECT_EQ(500, summary.mean_ns);
+  EXPECT_EQ(500, summary.p50_ns);
+  EXPECT_EQ(900, summary.p90_ns);
+  EXPECT_EQ(990, summary.p99_ns);
+  EXPECT_EQ(999, summary.p999_ns);
+  EXPECT_EQ(1000, summary.max_ns);
+  EXPECT_DOUBLE_EQ(500.0, summary.throughput_qps);
+}
+
+TEST(LoadGeneratorTest, SummarizeSingleValue) {
+  std::vector<int64_t> latencies_ns = {42};
+  auto summary = SummarizeLatencies(&latencies_ns, 42);
+  EXPECT_EQ(42, summary.p50_ns);
+  EXPECT_EQ(42, summary.p999_ns);
+  EXPECT_EQ(42, summary.max_ns);
+}
+
+TEST(LoadGeneratorTest, InvalidOptions) {
+  LoadGeneratorOptions options;
+  options.concurrency = 0;
+  EXPECT_THAT(RunLoadGenerator(options, [](int) { return OkStatus(); }),
+              testing::status::StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST(LoadGeneratorTest, ClosedLoop) {
+  LoadGeneratorOptions options;
+  options.concurrency = 4;
+  options.duration_seconds = 0.05;
+  options.warmup_calls = 2;
+  std::atomic<int> seen_callers{0};
+  std::atomic<int64_t> call_count{0};
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto summary, RunLoadGenerator(options, [&](int caller_index) {
+        EXPECT_GE(caller_index, 0);
+        EXPECT_LT(caller_index, options.concurrency);
+        seen_callers.fetch_or(1 << caller_index);
+        ++call_count;
+        return OkStatus();
+      }));
+  EXPECT_EQ(0xF, seen_callers.load());
+  EXPECT_GT(summary.call_count, 0);
+  // Warmup calls are not recorded.
+  EXPECT_EQ(call_count.load() - options.concurrency * options.warmup_calls,
+            summary.call_count);
+  EXPECT_LE(summary.p50_ns, summary.p99_ns);
+  EXPECT_LE(summary.p99_ns, summary.max_ns);
+}
+
+TEST(LoadGeneratorTest, FixedRate) {
+  LoadGeneratorOptions options;
+  options.concurrency = 2;
+  options.target_qps = 200.0;
+  options.duration_seconds = 0.1;
+  options.warmup_calls = 0;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      auto summary,
+      RunLoadGenerator(options, [](int caller_index) { return OkStatus(); }));
+  // Arrivals are scheduled at 5ms intervals within the 100ms window.
+  EXPECT_EQ(20, summary.call_count);
+}
+
+TEST(LoadGeneratorTest, CallFailure) {
+  LoadGeneratorOptions options;
+  options.concurrency = 2;
+  options.duration_seconds = 10.0;
+  std::atomic<int> call_count{0};
+  EXPECT_THAT(RunLoadGenerator(options,
+                               [&](int caller_index) -> Status {
+                                 if (++call_count > 8) {
+                                   return UnavailableErrorBuilder(IREE_LOC)
+                                          << "failed";
+                                 }
+                                 return OkStatus();
+                               }),
+              testing::status::StatusIs(StatusCode::kUnavailable));
+}
+
+}  // namespace
+}  // namespace iree
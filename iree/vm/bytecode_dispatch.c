@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
 #include <string.h>
 
 #include "iree/base/tracing.h"
@@ -34,6 +35,35 @@ static inline uint32_t iree_math_round_up_to_pow2_u32(uint32_t n) {
   return n;
 }
 
+// Converts a floating-point value to an integer by truncating toward zero.
+// Values outside of the integer range saturate to the nearest representable
+// value and NaN converts to 0. This matches the compiler constant folding of
+// the vm.cast.f*.*i32 ops and avoids the undefined behavior of a C cast.
+static inline int32_t iree_math_f32_to_si32_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 2147483648.0f) return INT32_MAX;
+  if (value <= -2147483648.0f) return INT32_MIN;
+  return (int32_t)value;
+}
+static inline uint32_t iree_math_f32_to_ui32_sat(float value) {
+  if (value != value) return 0;
+  if (value >= 4294967296.0f) return UINT32_MAX;
+  if (value <= -1.0f) return 0;
+  return (uint32_t)value;
+}
+static inline int32_t iree_math_f64_to_si32_sat(double value) {
+  if (value != value) return 0;
+  if (value >= 2147483648.0) return INT32_MAX;
+  if (value <= -2147483649.0) return INT32_MIN;
+  return (int32_t)value;
+}
+static inline uint32_t iree_math_f64_to_ui32_sat(double value) {
+  if (value != value) return 0;
+  if (value >= 4294967296.0) return UINT32_MAX;
+  if (value <= -1.0) return 0;
+  return (uint32_t)value;
+}
+
 //===----------------------------------------------------------------------===//
 // Register remapping utilities
 //===----------------------------------------------------------------------===//
@@ -44,22 +74,23 @@ static inline uint32_t iree_math_round_up_to_pow2_u32(uint32_t n) {
 //
 // This assumes that the remapping list is properly ordered such that there are
 // no swapping hazards (such as 0->1,1->0). The register allocator in the
-// compiler should ensure this is the case when it can occur.
+// compiler should ensure this is the case when it can occur. As the i32 and ref
+// register banks are disjoint the two lists can be processed independently.
 static void iree_vm_bytecode_dispatch_remap_branch_registers(
     const iree_vm_registers_t regs,
-    const iree_vm_register_remap_list_t* IREE_RESTRICT remap_list) {
-  for (int i = 0; i < remap_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = remap_list->pairs[i].src_reg;
-    uint16_t dst_reg = remap_list->pairs[i].dst_reg;
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
-                                 &regs.ref[src_reg & regs.ref_mask],
-                                 &regs.ref[dst_reg & regs.ref_mask]);
-    } else {
-      regs.i32[dst_reg & regs.i32_mask] = regs.i32[src_reg & regs.i32_mask];
-    }
+    const iree_vm_register_remap_list_t* IREE_RESTRICT i32_remap_list,
+    const iree_vm_register_remap_list_t* IREE_RESTRICT ref_remap_list) {
+  for (int i = 0; i < i32_remap_list->size; ++i) {
+    uint16_t src_reg = i32_remap_list->pairs[i].src_reg;
+    uint16_t dst_reg = i32_remap_list->pairs[i].dst_reg;
+    regs.i32[VM_RegI32(dst_reg)] = regs.i32[VM_RegI32(src_reg)];
+  }
+  for (int i = 0; i < ref_remap_list->size; ++i) {
+    uint16_t src_reg = ref_remap_list->pairs[i].src_reg;
+    uint16_t dst_reg = ref_remap_list->pairs[i].dst_reg;
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &regs.ref[VM_RegRef(src_reg)],
+                               &regs.ref[VM_RegRef(dst_reg)]);
   }
 }
 
@@ -68,13 +99,11 @@ static void iree_vm_bytecode_dispatch_remap_branch_registers(
 // memory consumption if used effectively prior to yields/waits.
 static void iree_vm_bytecode_dispatch_discard_registers(
     const iree_vm_registers_t regs,
-    const iree_vm_register_list_t* IREE_RESTRICT reg_list) {
-  for (int i = 0; i < reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    uint16_t reg = reg_list->registers[i];
-    if ((reg & (IREE_REF_REGISTER_TYPE_BIT | IREE_REF_REGISTER_MOVE_BIT)) ==
-        (IREE_REF_REGISTER_TYPE_BIT | IREE_REF_REGISTER_MOVE_BIT)) {
-      iree_vm_ref_release(&regs.ref[reg & regs.ref_mask]);
+    const iree_vm_register_list_t* IREE_RESTRICT ref_reg_list) {
+  for (int i = 0; i < ref_reg_list->size; ++i) {
+    uint16_t reg = ref_reg_list->registers[i];
+    if (reg & IREE_REF_REGISTER_MOVE_BIT) {
+      iree_vm_ref_release(&regs.ref[VM_RegRef(reg)]);
     }
   }
 }
@@ -214,13 +243,15 @@ static iree_status_t iree_vm_bytecode_external_enter(
   const uint8_t* p = arguments.data;
   for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32: {
         uint16_t dst_reg = i32_reg++;
         memcpy(&callee_registers.i32[dst_reg & callee_registers.i32_mask], p,
                sizeof(int32_t));
         p += sizeof(int32_t);
       } break;
-      case IREE_VM_CCONV_TYPE_INT64: {
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64: {
         uint16_t dst_reg = i32_reg;
         i32_reg += 2;
         memcpy(&callee_registers.i32[dst_reg & callee_registers.i32_mask], p,
@@ -241,26 +272,33 @@ static iree_status_t iree_vm_bytecode_external_enter(
 }
 
 // Leaves an internal bytecode stack frame and returns to an external caller.
-// Registers will be marshaled from the |src_reg_list| to the |results| buffer.
+// Registers will be marshaled from the |src_i32_reg_list| and
+// |src_ref_reg_list| to the |results| buffer.
 //
 // Note that callers are expected to have matched our expectations for
 // |results| and we don't validate that here.
 static iree_status_t iree_vm_bytecode_external_leave(
     iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame,
     const iree_vm_registers_t* IREE_RESTRICT callee_registers,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
     iree_string_view_t cconv_results, iree_byte_span_t results) {
   // Marshal results from registers to the ABI results buffer.
   uint8_t* p = results.data;
+  int i32_reg_i = 0;
+  int ref_reg_i = 0;
   for (iree_host_size_t i = 0; i < cconv_results.size; ++i) {
-    uint16_t src_reg = src_reg_list->registers[i];
     switch (cconv_results.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32: {
+        uint16_t src_reg = src_i32_reg_list->registers[i32_reg_i++];
         memcpy(p, &callee_registers->i32[src_reg & callee_registers->i32_mask],
                sizeof(int32_t));
         p += sizeof(int32_t);
       } break;
-      case IREE_VM_CCONV_TYPE_INT64: {
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64: {
+        uint16_t src_reg = src_i32_reg_list->registers[i32_reg_i++];
         memcpy(
             p,
             &callee_registers->i32[src_reg & (callee_registers->i32_mask & ~1)],
@@ -268,6 +306,7 @@ static iree_status_t iree_vm_bytecode_external_leave(
         p += sizeof(int64_t);
       } break;
       case IREE_VM_CCONV_TYPE_REF: {
+        uint16_t src_reg = src_ref_reg_list->registers[ref_reg_i++];
         iree_vm_ref_move(
             &callee_registers->ref[src_reg & callee_registers->ref_mask],
             (iree_vm_ref_t*)p);
@@ -281,19 +320,23 @@ static iree_status_t iree_vm_bytecode_external_leave(
 }
 
 // Enters an internal bytecode stack frame from a parent bytecode frame.
-// Registers in |src_reg_list| will be marshaled into the callee frame and the
-// |dst_reg_list| will be stashed for use when leaving the frame.
+// Registers in |src_i32_reg_list| and |src_ref_reg_list| will be marshaled into
+// the callee frame and the |dst_i32_reg_list| and |dst_ref_reg_list| will be
+// stashed for use when leaving the frame.
 static iree_status_t iree_vm_bytecode_internal_enter(
     iree_vm_stack_t* stack, iree_vm_module_t* module, int32_t function_ordinal,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
-    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_ref_reg_list,
     iree_vm_stack_frame_t** out_callee_frame,
     iree_vm_registers_t* out_callee_registers) {
-  // Stash the destination register list for result values on the caller.
+  // Stash the destination register lists for result values on the caller.
   iree_vm_bytecode_frame_storage_t* caller_storage =
       (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
           iree_vm_stack_current_frame(stack));
-  caller_storage->return_registers = dst_reg_list;
+  caller_storage->return_i32_registers = dst_i32_reg_list;
+  caller_storage->return_ref_registers = dst_ref_reg_list;
 
   // NOTE: after this call the caller registers may be invalid and need to be
   // requeried.
@@ -312,70 +355,71 @@ static iree_status_t iree_vm_bytecode_internal_enter(
   iree_vm_registers_t src_regs =
       iree_vm_bytecode_get_register_storage(iree_vm_stack_parent_frame(stack));
   iree_vm_registers_t* dst_regs = out_callee_registers;
-  int i32_reg_offset = 0;
-  int ref_reg_offset = 0;
-  for (int i = 0; i < src_reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = src_reg_list->registers[i];
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      uint16_t dst_reg = ref_reg_offset++;
-      memset(&dst_regs->ref[dst_reg & dst_regs->ref_mask], 0,
-             sizeof(iree_vm_ref_t));
-      iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
-                                 &src_regs.ref[src_reg & src_regs.ref_mask],
-                                 &dst_regs->ref[dst_reg & dst_regs->ref_mask]);
-    } else {
-      uint16_t dst_reg = i32_reg_offset++;
-      dst_regs->i32[dst_reg & dst_regs->i32_mask] =
-          src_regs.i32[src_reg & src_regs.i32_mask];
-    }
+  for (int i = 0; i < src_i32_reg_list->size; ++i) {
+    uint16_t src_reg = src_i32_reg_list->registers[i];
+    dst_regs->i32[i & dst_regs->i32_mask] =
+        src_regs.i32[src_reg & src_regs.i32_mask];
+  }
+  for (int i = 0; i < src_ref_reg_list->size; ++i) {
+    uint16_t src_reg = src_ref_reg_list->registers[i];
+    iree_vm_ref_t* dst_ref = &dst_regs->ref[i & dst_regs->ref_mask];
+    memset(dst_ref, 0, sizeof(*dst_ref));
+    iree_vm_ref_retain_or_move(src_reg & IREE_REF_REGISTER_MOVE_BIT,
+                               &src_regs.ref[src_reg & src_regs.ref_mask],
+                               dst_ref);
   }
 
   return iree_ok_status();
 }
 
 // Leaves an internal bytecode stack frame and returns to the parent bytecode
-// frame. |src_reg_list| registers will be marshaled into the dst_reg_list
-// provided by the caller frame when entering.
+// frame. |src_i32_reg_list| and |src_ref_reg_list| registers will be marshaled
+// into the destination register lists provided by the caller frame when
+// entering.
 static iree_status_t iree_vm_bytecode_internal_leave(
     iree_vm_stack_t* stack, iree_vm_stack_frame_t* callee_frame,
     const iree_vm_registers_t callee_registers,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers) {
   // Remaps registers from source to destination across frames.
   // Registers from the |src_regs| will be copied/moved to |dst_regs| with the
-  // mappings provided by |src_reg_list| and |dst_reg_list|. It's assumed that
-  // the mappings are matching by type and - in the case that they aren't -
-  // things will get weird (but not crash).
+  // mappings provided by the source and destination register lists of each
+  // bank. It's assumed that the mappings are matching by type and - in the
+  // case that they aren't - things will get weird (but not crash).
   *out_caller_frame = iree_vm_stack_parent_frame(stack);
   iree_vm_bytecode_frame_storage_t* caller_storage =
       (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
           *out_caller_frame);
-  const iree_vm_register_list_t* dst_reg_list =
-      caller_storage->return_registers;
-  VMCHECK(src_reg_list->size <= dst_reg_list->size);
-  if (IREE_UNLIKELY(src_reg_list->size > dst_reg_list->size)) {
+  const iree_vm_register_list_t* dst_i32_reg_list =
+      caller_storage->return_i32_registers;
+  const iree_vm_register_list_t* dst_ref_reg_list =
+      caller_storage->return_ref_registers;
+  VMCHECK(src_i32_reg_list->size <= dst_i32_reg_list->size);
+  VMCHECK(src_ref_reg_list->size <= dst_ref_reg_list->size);
+  if (IREE_UNLIKELY(VM_UNVERIFIED(src_i32_reg_list->size >
+                                  dst_i32_reg_list->size)) ||
+      IREE_UNLIKELY(VM_UNVERIFIED(src_ref_reg_list->size >
+                                  dst_ref_reg_list->size))) {
     return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                             "src/dst reg count mismatch on internal return");
   }
   iree_vm_registers_t caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
-  for (int i = 0; i < src_reg_list->size; ++i) {
-    // TODO(benvanik): change encoding to avoid this branching.
-    // Could write two arrays: one for prims and one for refs.
-    uint16_t src_reg = src_reg_list->registers[i];
-    uint16_t dst_reg = dst_reg_list->registers[i];
-    if (src_reg & IREE_REF_REGISTER_TYPE_BIT) {
-      iree_vm_ref_retain_or_move(
-          src_reg & IREE_REF_REGISTER_MOVE_BIT,
-          &callee_registers.ref[src_reg & callee_registers.ref_mask],
-          &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
-    } else {
-      caller_registers.i32[dst_reg & caller_registers.i32_mask] =
-          callee_registers.i32[src_reg & callee_registers.i32_mask];
-    }
+  for (int i = 0; i < src_i32_reg_list->size; ++i) {
+    uint16_t src_reg = src_i32_reg_list->registers[i];
+    uint16_t dst_reg = dst_i32_reg_list->registers[i];
+    caller_registers.i32[dst_reg & caller_registers.i32_mask] =
+        callee_registers.i32[src_reg & callee_registers.i32_mask];
+  }
+  for (int i = 0; i < src_ref_reg_list->size; ++i) {
+    uint16_t src_reg = src_ref_reg_list->registers[i];
+    uint16_t dst_reg = dst_ref_reg_list->registers[i];
+    iree_vm_ref_retain_or_move(
+        src_reg & IREE_REF_REGISTER_MOVE_BIT,
+        &callee_registers.ref[src_reg & callee_registers.ref_mask],
+        &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
   }
 
   // Leave and deallocate bytecode stack frame.
@@ -384,32 +428,39 @@ static iree_status_t iree_vm_bytecode_internal_leave(
 }
 
 // Populates an import call arguments
+// Registers are consumed in order from |src_i32_reg_list| or |src_ref_reg_list|
+// based on the type of each argument in the calling convention.
 static void iree_vm_bytecode_populate_import_cconv_arguments(
     iree_string_view_t cconv_arguments,
     const iree_vm_registers_t caller_registers,
     const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
     iree_byte_span_t storage) {
   uint8_t* IREE_RESTRICT p = storage.data;
-  for (iree_host_size_t i = 0, seg_i = 0, reg_i = 0; i < cconv_arguments.size;
+  iree_host_size_t i32_reg_i = 0;
+  iree_host_size_t ref_reg_i = 0;
+  for (iree_host_size_t i = 0, seg_i = 0; i < cconv_arguments.size;
        ++i, ++seg_i) {
     switch (cconv_arguments.data[i]) {
-      case IREE_VM_CCONV_TYPE_INT32: {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32: {
         memcpy(p,
-               &caller_registers.i32[src_reg_list->registers[reg_i++] &
+               &caller_registers.i32[src_i32_reg_list->registers[i32_reg_i++] &
                                      caller_registers.i32_mask],
                sizeof(int32_t));
         p += sizeof(int32_t);
       } break;
-      case IREE_VM_CCONV_TYPE_INT64: {
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64: {
         memcpy(p,
-               &caller_registers.i32[src_reg_list->registers[reg_i++] &
+               &caller_registers.i32[src_i32_reg_list->registers[i32_reg_i++] &
                                      (caller_registers.i32_mask & ~1)],
                sizeof(int64_t));
         p += sizeof(int64_t);
       } break;
       case IREE_VM_CCONV_TYPE_REF: {
-        uint16_t src_reg = src_reg_list->registers[reg_i++];
+        uint16_t src_reg = src_ref_reg_list->registers[ref_reg_i++];
         iree_vm_ref_retain_or_move(
             src_reg & IREE_REF_REGISTER_MOVE_BIT,
             &caller_registers.ref[src_reg & caller_registers.ref_mask],
@@ -437,22 +488,26 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
                ++i) {
             // TODO(benvanik): share with switch above.
             switch (cconv_arguments.data[i]) {
-              case IREE_VM_CCONV_TYPE_INT32: {
+              case IREE_VM_CCONV_TYPE_INT32:
+              case IREE_VM_CCONV_TYPE_F32: {
                 memcpy(p,
-                       &caller_registers.i32[src_reg_list->registers[reg_i++] &
-                                             caller_registers.i32_mask],
+                       &caller_registers
+                            .i32[src_i32_reg_list->registers[i32_reg_i++] &
+                                 caller_registers.i32_mask],
                        sizeof(int32_t));
                 p += sizeof(int32_t);
               } break;
-              case IREE_VM_CCONV_TYPE_INT64: {
+              case IREE_VM_CCONV_TYPE_INT64:
+              case IREE_VM_CCONV_TYPE_F64: {
                 memcpy(p,
-                       &caller_registers.i32[src_reg_list->registers[reg_i++] &
-                                             (caller_registers.i32_mask & ~1)],
+                       &caller_registers
+                            .i32[src_i32_reg_list->registers[i32_reg_i++] &
+                                 (caller_registers.i32_mask & ~1)],
                        sizeof(int64_t));
                 p += sizeof(int64_t);
               } break;
               case IREE_VM_CCONV_TYPE_REF: {
-                uint16_t src_reg = src_reg_list->registers[reg_i++];
+                uint16_t src_reg = src_ref_reg_list->registers[ref_reg_i++];
                 iree_vm_ref_retain_or_move(
                     src_reg & IREE_REF_REGISTER_MOVE_BIT,
                     &caller_registers.ref[src_reg & caller_registers.ref_mask],
@@ -467,11 +522,13 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   }
 }
 
-// Issues a populated import call and marshals the results into |dst_reg_list|.
+// Issues a populated import call and marshals the results into
+// |dst_i32_reg_list| and |dst_ref_reg_list|.
 static iree_status_t iree_vm_bytecode_issue_import_call(
     iree_vm_stack_t* stack, const iree_vm_function_call_t call,
     iree_string_view_t cconv_results,
-    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_ref_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
@@ -487,32 +544,49 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
   // NOTE: we don't support yielding within imported functions right now so it's
   // safe to assume the stack is still valid here. If the called function can
   // yield then we'll need to requery all pointers here.
+  if (IREE_UNLIKELY(out_result->state != IREE_VM_EXECUTION_STATE_COMPLETED)) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "yielding from within imported functions is not "
+                            "supported");
+  }
   *out_caller_frame = iree_vm_stack_current_frame(stack);
   *out_caller_registers =
       iree_vm_bytecode_get_register_storage(*out_caller_frame);
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
+  // Results beyond those the caller has registers for are ignored.
   uint8_t* IREE_RESTRICT p = call.results.data;
-  for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
-       ++i) {
-    uint16_t dst_reg = dst_reg_list->registers[i];
+  iree_host_size_t i32_reg_i = 0;
+  iree_host_size_t ref_reg_i = 0;
+  for (iree_host_size_t i = 0; i < cconv_results.size; ++i) {
     switch (cconv_results.data[i]) {
       case IREE_VM_CCONV_TYPE_INT32:
-        memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask], p,
-               sizeof(int32_t));
+      case IREE_VM_CCONV_TYPE_F32:
+        if (i32_reg_i < dst_i32_reg_list->size) {
+          uint16_t dst_reg = dst_i32_reg_list->registers[i32_reg_i++];
+          memcpy(&caller_registers.i32[dst_reg & caller_registers.i32_mask], p,
+                 sizeof(int32_t));
+        }
         p += sizeof(int32_t);
         break;
       case IREE_VM_CCONV_TYPE_INT64:
-        memcpy(
-            &caller_registers.i32[dst_reg & (caller_registers.i32_mask & ~1)],
-            p, sizeof(int64_t));
+      case IREE_VM_CCONV_TYPE_F64:
+        if (i32_reg_i < dst_i32_reg_list->size) {
+          uint16_t dst_reg = dst_i32_reg_list->registers[i32_reg_i++];
+          memcpy(
+              &caller_registers.i32[dst_reg & (caller_registers.i32_mask & ~1)],
+              p, sizeof(int64_t));
+        }
         p += sizeof(int64_t);
         break;
       case IREE_VM_CCONV_TYPE_REF:
-        iree_vm_ref_move(
-            (iree_vm_ref_t*)p,
-            &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
+        if (ref_reg_i < dst_ref_reg_list->size) {
+          uint16_t dst_reg = dst_ref_reg_list->registers[ref_reg_i++];
+          iree_vm_ref_move(
+              (iree_vm_ref_t*)p,
+              &caller_registers.ref[dst_reg & caller_registers.ref_mask]);
+        }
         p += sizeof(iree_vm_ref_t);
         break;
     }
@@ -522,19 +596,22 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
 }
 
 // Calls an imported function from another module.
-// Marshals the |src_reg_list| registers into ABI storage and results into
-// |dst_reg_list|.
+// Marshals the |src_i32_reg_list| and |src_ref_reg_list| registers into ABI
+// storage and results into |dst_i32_reg_list| and |dst_ref_reg_list|.
 static iree_status_t iree_vm_bytecode_call_import(
     iree_vm_stack_t* stack, const iree_vm_bytecode_module_state_t* module_state,
     uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
-    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_ref_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
   // Prepare |call| by looking up the import information.
   import_ordinal &= 0x7FFFFFFFu;
-  if (IREE_UNLIKELY(import_ordinal >= module_state->import_count)) {
+  if (IREE_UNLIKELY(
+          VM_UNVERIFIED(import_ordinal >= module_state->import_count))) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "import ordinal out of range");
   }
@@ -551,32 +628,37 @@ static iree_status_t iree_vm_bytecode_call_import(
   memset(call.arguments.data, 0, call.arguments.data_length);
   iree_vm_bytecode_populate_import_cconv_arguments(
       import->arguments, caller_registers,
-      /*segment_size_list=*/NULL, src_reg_list, call.arguments);
+      /*segment_size_list=*/NULL, src_i32_reg_list, src_ref_reg_list,
+      call.arguments);
 
   // Issue the call and handle results.
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import->results, dst_i32_reg_list, dst_ref_reg_list,
+      out_caller_frame, out_caller_registers, out_result);
 }
 
 // Calls a variadic imported function from another module.
-// Marshals the |src_reg_list| registers into ABI storage and results into
-// |dst_reg_list|. |segment_size_list| contains the counts within each segment.
+// Marshals the |src_i32_reg_list| and |src_ref_reg_list| registers into ABI
+// storage and results into |dst_i32_reg_list| and |dst_ref_reg_list|.
+// |segment_size_list| contains the counts within each segment.
 static iree_status_t iree_vm_bytecode_call_import_variadic(
     iree_vm_stack_t* stack, const iree_vm_bytecode_module_state_t* module_state,
     uint32_t import_ordinal, const iree_vm_registers_t caller_registers,
     const iree_vm_register_list_t* IREE_RESTRICT segment_size_list,
-    const iree_vm_register_list_t* IREE_RESTRICT src_reg_list,
-    const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT src_ref_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_i32_reg_list,
+    const iree_vm_register_list_t* IREE_RESTRICT dst_ref_reg_list,
     iree_vm_stack_frame_t** out_caller_frame,
     iree_vm_registers_t* out_caller_registers,
     iree_vm_execution_result_t* out_result) {
   // Prepare |call| by looking up the import information.
   import_ordinal &= 0x7FFFFFFFu;
-  if (IREE_UNLIKELY(import_ordinal >= module_state->import_count)) {
+  if (IREE_UNLIKELY(
+          VM_UNVERIFIED(import_ordinal >= module_state->import_count))) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "import ordinal out of range");
   }
@@ -596,41 +678,37 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
 
   // Marshal inputs from registers to the ABI arguments buffer.
   iree_vm_bytecode_populate_import_cconv_arguments(
-      import->arguments, caller_registers, segment_size_list, src_reg_list,
-      call.arguments);
+      import->arguments, caller_registers, segment_size_list, src_i32_reg_list,
+      src_ref_reg_list, call.arguments);
 
   // Issue the call and handle results.
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
-                                            out_caller_registers, out_result);
+  return iree_vm_bytecode_issue_import_call(
+      stack, call, import->results, dst_i32_reg_list, dst_ref_reg_list,
+      out_caller_frame, out_caller_registers, out_result);
 }
 
 //===----------------------------------------------------------------------===//
 // Main interpreter dispatch routine
 //===----------------------------------------------------------------------===//
 
-iree_status_t iree_vm_bytecode_dispatch(
+// Executes bytecode starting at the |current_frame| (which must be the top of
+// the stack) until the entry frame at |entry_frame_depth| returns or a yield
+// occurs. |cconv_results| and |results| describe the external caller's results
+// buffer that the entry frame will populate upon return.
+static iree_status_t iree_vm_bytecode_dispatch(
     iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
-    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
-    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+    iree_vm_stack_frame_t* current_frame, iree_vm_registers_t regs,
+    const int32_t entry_frame_depth, iree_string_view_t cconv_results,
+    iree_byte_span_t results, iree_vm_execution_result_t* out_result) {
   memset(out_result, 0, sizeof(*out_result));
 
   // When required emit the dispatch tables here referencing the labels we are
   // defining below.
   DEFINE_DISPATCH_TABLES();
 
-  // Enter function (as this is the initial call).
-  // The callee's return will take care of storing the output registers when it
-  // actually does return, either immediately or in the future via a resume.
-  iree_vm_stack_frame_t* current_frame = NULL;
-  iree_vm_registers_t regs;
-  IREE_RETURN_IF_ERROR(
-      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
-                                      call->arguments, &current_frame, &regs));
-
   // Primary dispatch state. This is our 'native stack frame' and really
   // just enough to make dereferencing common addresses (like the current
   // offset) faster. You can think of this like CPU state (like PC).
@@ -645,7 +723,6 @@ iree_status_t iree_vm_bytecode_dispatch(
       module->function_descriptor_table[current_frame->function.ordinal]
           .bytecode_offset;
   iree_vm_source_offset_t pc = current_frame->pc;
-  const int32_t entry_frame_depth = current_frame->depth;
 
   BEGIN_DISPATCH_CORE() {
     //===------------------------------------------------------------------===//
@@ -654,8 +731,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, GlobalLoadI32, {
       uint32_t byte_offset = VM_DecGlobalAttr("global");
-      if (IREE_UNLIKELY(byte_offset >=
-                        module_state->rwdata_storage.data_length)) {
+      if (IREE_UNLIKELY(VM_UNVERIFIED(
+              byte_offset >= module_state->rwdata_storage.data_length))) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
@@ -669,8 +746,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, GlobalStoreI32, {
       uint32_t byte_offset = VM_DecGlobalAttr("global");
-      if (IREE_UNLIKELY(byte_offset >=
-                        module_state->rwdata_storage.data_length)) {
+      if (IREE_UNLIKELY(VM_UNVERIFIED(
+              byte_offset >= module_state->rwdata_storage.data_length))) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
@@ -714,7 +791,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, GlobalLoadRef, {
       uint32_t global = VM_DecGlobalAttr("global");
-      if (IREE_UNLIKELY(global >= module_state->global_ref_count)) {
+      if (IREE_UNLIKELY(
+              VM_UNVERIFIED(global >= module_state->global_ref_count))) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "global ref ordinal out of range: %d (table=%zu)", global,
@@ -730,7 +808,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, GlobalStoreRef, {
       uint32_t global = VM_DecGlobalAttr("global");
-      if (IREE_UNLIKELY(global >= module_state->global_ref_count)) {
+      if (IREE_UNLIKELY(
+              VM_UNVERIFIED(global >= module_state->global_ref_count))) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "global ref ordinal out of range: %d (table=%zu)", global,
@@ -745,7 +824,8 @@ iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, GlobalLoadIndirectRef, {
-      uint32_t global = VM_DecGlobalAttr("global");
+      // The ordinal comes from a register and cannot be verified at load time.
+      uint32_t global = VM_DecOperandRegI32("global");
       if (IREE_UNLIKELY(global >= module_state->global_ref_count)) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
@@ -761,7 +841,8 @@ iree_status_t iree_vm_bytecode_dispatch(
     });
 
     DISPATCH_OP(CORE, GlobalStoreIndirectRef, {
-      uint32_t global = VM_DecGlobalAttr("global");
+      // The ordinal comes from a register and cannot be verified at load time.
+      uint32_t global = VM_DecOperandRegI32("global");
       if (IREE_UNLIKELY(global >= module_state->global_ref_count)) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
@@ -780,11 +861,12 @@ iree_status_t iree_vm_bytecode_dispatch(
     // Constants
     //===------------------------------------------------------------------===//
 
-    DISPATCH_OP(CORE, ConstI32, {
-      int32_t value = VM_DecIntAttr32("value");
-      int32_t* result = VM_DecResultRegI32("result");
-      *result = value;
-    });
+#define DISPATCH_BODY_CORE_CONST_I32()            \
+  int32_t value = VM_DecIntAttr32("value");       \
+  int32_t* result = VM_DecResultRegI32("result"); \
+  *result = value;
+
+    DISPATCH_OP(CORE, ConstI32, { DISPATCH_BODY_CORE_CONST_I32(); });
 
     DISPATCH_OP(CORE, ConstI32Zero, {
       int32_t* result = VM_DecResultRegI32("result");
@@ -799,7 +881,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
     DISPATCH_OP(CORE, ConstRefRodata, {
       uint32_t rodata_ordinal = VM_DecRodataAttr("rodata");
-      if (IREE_UNLIKELY(rodata_ordinal >= module_state->rodata_ref_count)) {
+      if (IREE_UNLIKELY(VM_UNVERIFIED(rodata_ordinal >=
+                                       module_state->rodata_ref_count))) {
         return iree_make_status(
             IREE_STATUS_OUT_OF_RANGE,
             "rodata ref ordinal out of range: %d (table=%zu)", rodata_ordinal,
@@ -957,7 +1040,7 @@ iree_status_t iree_vm_bytecode_dispatch(
           VM_DecVariadicOperands("values");
       int32_t* result = VM_DecResultRegI32("result");
       if (index >= 0 && index < value_reg_list->size) {
-        *result = regs.i32[value_reg_list->registers[index] & regs.i32_mask];
+        *result = regs.i32[VM_RegI32(value_reg_list->registers[index])];
       } else {
         *result = default_value;
       }
@@ -977,7 +1060,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         bool is_move =
             value_reg_list->registers[index] & IREE_REF_REGISTER_MOVE_BIT;
         iree_vm_ref_t* new_value =
-            &regs.ref[value_reg_list->registers[index] & regs.ref_mask];
+            &regs.ref[VM_RegRef(value_reg_list->registers[index])];
         IREE_RETURN_IF_ERROR(iree_vm_ref_retain_or_move_checked(
             is_move, new_value, type_def->ref_type, result));
       } else {
@@ -997,13 +1080,15 @@ iree_status_t iree_vm_bytecode_dispatch(
     *result = (int32_t)(op((type)operand));               \
   });
 
+#define DISPATCH_BODY_CORE_BINARY_ALU_I32(type, op) \
+  int32_t lhs = VM_DecOperandRegI32("lhs");         \
+  int32_t rhs = VM_DecOperandRegI32("rhs");         \
+  int32_t* result = VM_DecResultRegI32("result");   \
+  *result = (int32_t)(((type)lhs)op((type)rhs));
+
 #define DISPATCH_OP_CORE_BINARY_ALU_I32(op_name, type, op) \
-  DISPATCH_OP(CORE, op_name, {                             \
-    int32_t lhs = VM_DecOperandRegI32("lhs");              \
-    int32_t rhs = VM_DecOperandRegI32("rhs");              \
-    int32_t* result = VM_DecResultRegI32("result");        \
-    *result = (int32_t)(((type)lhs)op((type)rhs));         \
-  });
+  DISPATCH_OP(CORE, op_name,                               \
+              { DISPATCH_BODY_CORE_BINARY_ALU_I32(type, op); });
 
     DISPATCH_OP_CORE_BINARY_ALU_I32(AddI32, int32_t, +);
     DISPATCH_OP_CORE_BINARY_ALU_I32(SubI32, int32_t, -);
@@ -1055,23 +1140,27 @@ iree_status_t iree_vm_bytecode_dispatch(
     // Comparison ops
     //===------------------------------------------------------------------===//
 
+#define DISPATCH_BODY_CORE_CMP_I32(type, op)          \
+  int32_t lhs = VM_DecOperandRegI32("lhs");           \
+  int32_t rhs = VM_DecOperandRegI32("rhs");           \
+  int32_t* result = VM_DecResultRegI32("result");     \
+  int32_t value = (((type)lhs)op((type)rhs)) ? 1 : 0; \
+  *result = value;
+
+#define DISPATCH_BODY_CORE_CMP_NZ_I32()             \
+  int32_t operand = VM_DecOperandRegI32("operand"); \
+  int32_t* result = VM_DecResultRegI32("result");   \
+  int32_t value = (operand != 0) ? 1 : 0;           \
+  *result = value;
+
 #define DISPATCH_OP_CORE_CMP_I32(op_name, type, op) \
-  DISPATCH_OP(CORE, op_name, {                      \
-    int32_t lhs = VM_DecOperandRegI32("lhs");       \
-    int32_t rhs = VM_DecOperandRegI32("rhs");       \
-    int32_t* result = VM_DecResultRegI32("result"); \
-    *result = (((type)lhs)op((type)rhs)) ? 1 : 0;   \
-  });
+  DISPATCH_OP(CORE, op_name, { DISPATCH_BODY_CORE_CMP_I32(type, op); });
 
     DISPATCH_OP_CORE_CMP_I32(CmpEQI32, int32_t, ==);
     DISPATCH_OP_CORE_CMP_I32(CmpNEI32, int32_t, !=);
     DISPATCH_OP_CORE_CMP_I32(CmpLTI32S, int32_t, <);
     DISPATCH_OP_CORE_CMP_I32(CmpLTI32U, uint32_t, <);
-    DISPATCH_OP(CORE, CmpNZI32, {
-      int32_t operand = VM_DecOperandRegI32("operand");
-      int32_t* result = VM_DecResultRegI32("result");
-      *result = (operand != 0) ? 1 : 0;
-    });
+    DISPATCH_OP(CORE, CmpNZI32, { DISPATCH_BODY_CORE_CMP_NZ_I32(); });
 
     DISPATCH_OP(CORE, CmpEQRef, {
       bool lhs_is_move;
@@ -1105,37 +1194,54 @@ iree_status_t iree_vm_bytecode_dispatch(
     // Control flow
     //===------------------------------------------------------------------===//
 
-    DISPATCH_OP(CORE, Branch, {
-      int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
-          VM_DecBranchOperands("operands");
-      pc = block_pc;
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
-    });
+#define DISPATCH_BODY_CORE_BRANCH()                                      \
+  int32_t block_pc = VM_DecBranchTarget("dest");                         \
+  const iree_vm_register_remap_list_t* i32_remap_list =                  \
+      VM_DecBranchOperands("operands");                                  \
+  const iree_vm_register_remap_list_t* ref_remap_list =                  \
+      VM_DecBranchOperands("operands");                                  \
+  pc = block_pc;                                                         \
+  iree_vm_bytecode_dispatch_remap_branch_registers(regs, i32_remap_list, \
+                                                   ref_remap_list);
+
+// Decodes the remainder of a CondBranch following its condition operand.
+#define DISPATCH_BODY_CORE_COND_BRANCH(condition)             \
+  int32_t true_block_pc = VM_DecBranchTarget("true_dest");    \
+  const iree_vm_register_remap_list_t* true_i32_remap_list =  \
+      VM_DecBranchOperands("true_operands");                  \
+  const iree_vm_register_remap_list_t* true_ref_remap_list =  \
+      VM_DecBranchOperands("true_operands");                  \
+  int32_t false_block_pc = VM_DecBranchTarget("false_dest");  \
+  const iree_vm_register_remap_list_t* false_i32_remap_list = \
+      VM_DecBranchOperands("false_operands");                 \
+  const iree_vm_register_remap_list_t* false_ref_remap_list = \
+      VM_DecBranchOperands("false_operands");                 \
+  if (condition) {                                            \
+    pc = true_block_pc;                                       \
+    iree_vm_bytecode_dispatch_remap_branch_registers(         \
+        regs, true_i32_remap_list, true_ref_remap_list);      \
+  } else {                                                    \
+    pc = false_block_pc;                                      \
+    iree_vm_bytecode_dispatch_remap_branch_registers(         \
+        regs, false_i32_remap_list, false_ref_remap_list);    \
+  }
+
+    DISPATCH_OP(CORE, Branch, { DISPATCH_BODY_CORE_BRANCH(); });
 
     DISPATCH_OP(CORE, CondBranch, {
       int32_t condition = VM_DecOperandRegI32("condition");
-      int32_t true_block_pc = VM_DecBranchTarget("true_dest");
-      const iree_vm_register_remap_list_t* true_remap_list =
-          VM_DecBranchOperands("true_operands");
-      int32_t false_block_pc = VM_DecBranchTarget("false_dest");
-      const iree_vm_register_remap_list_t* false_remap_list =
-          VM_DecBranchOperands("false_operands");
-      if (condition) {
-        pc = true_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs, true_remap_list);
-      } else {
-        pc = false_block_pc;
-        iree_vm_bytecode_dispatch_remap_branch_registers(regs,
-                                                         false_remap_list);
-      }
+      DISPATCH_BODY_CORE_COND_BRANCH(condition);
     });
 
     DISPATCH_OP(CORE, Call, {
       int32_t function_ordinal = VM_DecFuncAttr("callee");
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_list_t* src_i32_reg_list =
+          VM_DecVariadicOperands("operands");
+      const iree_vm_register_list_t* src_ref_reg_list =
           VM_DecVariadicOperands("operands");
-      const iree_vm_register_list_t* dst_reg_list =
+      const iree_vm_register_list_t* dst_i32_reg_list =
+          VM_DecVariadicResults("results");
+      const iree_vm_register_list_t* dst_ref_reg_list =
           VM_DecVariadicResults("results");
       current_frame->pc = pc;
 
@@ -1145,14 +1251,16 @@ iree_status_t iree_vm_bytecode_dispatch(
       if (is_import) {
         // Call import (and possible yield).
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import(
-            stack, module_state, function_ordinal, regs, src_reg_list,
-            dst_reg_list, &current_frame, &regs, out_result));
+            stack, module_state, function_ordinal, regs, src_i32_reg_list,
+            src_ref_reg_list, dst_i32_reg_list, dst_ref_reg_list,
+            &current_frame, &regs, out_result));
       } else {
         // Switch execution to the target function and continue running in the
         // bytecode dispatcher.
         IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_enter(
             stack, current_frame->function.module, function_ordinal,
-            src_reg_list, dst_reg_list, &current_frame, &regs));
+            src_i32_reg_list, src_ref_reg_list, dst_i32_reg_list,
+            dst_ref_reg_list, &current_frame, &regs));
         bytecode_data =
             module->bytecode_data.data +
             module->function_descriptor_table[function_ordinal].bytecode_offset;
@@ -1166,16 +1274,20 @@ iree_status_t iree_vm_bytecode_dispatch(
       int32_t function_ordinal = VM_DecFuncAttr("callee");
       const iree_vm_register_list_t* segment_size_list =
           VM_DecVariadicOperands("segment_sizes");
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_list_t* src_i32_reg_list =
           VM_DecVariadicOperands("operands");
-      const iree_vm_register_list_t* dst_reg_list =
+      const iree_vm_register_list_t* src_ref_reg_list =
+          VM_DecVariadicOperands("operands");
+      const iree_vm_register_list_t* dst_i32_reg_list =
+          VM_DecVariadicResults("results");
+      const iree_vm_register_list_t* dst_ref_reg_list =
           VM_DecVariadicResults("results");
       current_frame->pc = pc;
 
       // NOTE: we assume validation has ensured these functions exist.
       // TODO(benvanik): something more clever than just a high bit?
       int is_import = (function_ordinal & 0x80000000u) != 0;
-      if (IREE_UNLIKELY(!is_import)) {
+      if (IREE_UNLIKELY(VM_UNVERIFIED(!is_import))) {
         // Variadic calls are currently only supported for import functions.
         return iree_make_status(
             IREE_STATUS_FAILED_PRECONDITION,
@@ -1185,24 +1297,28 @@ iree_status_t iree_vm_bytecode_dispatch(
       // Call import (and possible yield).
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_call_import_variadic(
           stack, module_state, function_ordinal, regs, segment_size_list,
-          src_reg_list, dst_reg_list, &current_frame, &regs, out_result));
+          src_i32_reg_list, src_ref_reg_list, dst_i32_reg_list,
+          dst_ref_reg_list, &current_frame, &regs, out_result));
     });
 
     DISPATCH_OP(CORE, Return, {
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_list_t* src_i32_reg_list =
+          VM_DecVariadicOperands("operands");
+      const iree_vm_register_list_t* src_ref_reg_list =
           VM_DecVariadicOperands("operands");
       current_frame->pc = pc;
 
       if (current_frame->depth <= entry_frame_depth) {
         // Return from the top-level entry frame - return back to call().
-        return iree_vm_bytecode_external_leave(stack, current_frame, &regs,
-                                               src_reg_list, cconv_results,
-                                               call->results);
+        return iree_vm_bytecode_external_leave(
+            stack, current_frame, &regs, src_i32_reg_list, src_ref_reg_list,
+            cconv_results, results);
       }
 
       // Store results into the caller frame and pop back to the parent.
       IREE_RETURN_IF_ERROR(iree_vm_bytecode_internal_leave(
-          stack, current_frame, regs, src_reg_list, &current_frame, &regs));
+          stack, current_frame, regs, src_i32_reg_list, src_ref_reg_list,
+          &current_frame, &regs));
 
       // Reset dispatch state so we can continue executing in the caller.
       bytecode_data =
@@ -1227,7 +1343,17 @@ iree_status_t iree_vm_bytecode_dispatch(
     //===------------------------------------------------------------------===//
 
     DISPATCH_OP(CORE, Yield, {
-      // TODO(benvanik): yield with execution results.
+      // Stash the dispatch state in the frame so that we can pick up where we
+      // left off when resumed. All other state (registers, caller frames, etc)
+      // is already on the stack and remains there until resumed.
+      current_frame->pc = pc;
+      iree_vm_bytecode_frame_storage_t* yield_storage =
+          (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+              current_frame);
+      yield_storage->yield_entry_frame_depth = entry_frame_depth;
+      yield_storage->yield_cconv_results = cconv_results;
+      yield_storage->yield_results = results;
+      out_result->state = IREE_VM_EXECUTION_STATE_YIELDED;
       return iree_ok_status();
     });
 
@@ -1238,27 +1364,36 @@ iree_status_t iree_vm_bytecode_dispatch(
     DISPATCH_OP(CORE, Trace, {
       iree_string_view_t event_name;
       VM_DecStrAttr("event_name", &event_name);
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_list_t* src_i32_reg_list =
+          VM_DecVariadicOperands("operands");
+      const iree_vm_register_list_t* src_ref_reg_list =
           VM_DecVariadicOperands("operands");
       // TODO(benvanik): trace (if enabled).
-      iree_vm_bytecode_dispatch_discard_registers(regs, src_reg_list);
+      (void)src_i32_reg_list;
+      iree_vm_bytecode_dispatch_discard_registers(regs, src_ref_reg_list);
     });
 
     DISPATCH_OP(CORE, Print, {
       iree_string_view_t event_name;
       VM_DecStrAttr("event_name", &event_name);
-      const iree_vm_register_list_t* src_reg_list =
+      const iree_vm_register_list_t* src_i32_reg_list =
+          VM_DecVariadicOperands("operands");
+      const iree_vm_register_list_t* src_ref_reg_list =
           VM_DecVariadicOperands("operands");
       // TODO(benvanik): print.
-      iree_vm_bytecode_dispatch_discard_registers(regs, src_reg_list);
+      (void)src_i32_reg_list;
+      iree_vm_bytecode_dispatch_discard_registers(regs, src_ref_reg_list);
     });
 
     DISPATCH_OP(CORE, Break, {
       // TODO(benvanik): break unconditionally.
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      const iree_vm_register_remap_list_t* i32_remap_list =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      const iree_vm_register_remap_list_t* ref_remap_list =
+          VM_DecBranchOperands("operands");
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, i32_remap_list,
+                                                       ref_remap_list);
       pc = block_pc;
     });
 
@@ -1268,12 +1403,57 @@ iree_status_t iree_vm_bytecode_dispatch(
         // TODO(benvanik): cond break.
       }
       int32_t block_pc = VM_DecBranchTarget("dest");
-      const iree_vm_register_remap_list_t* remap_list =
+      const iree_vm_register_remap_list_t* i32_remap_list =
+          VM_DecBranchOperands("operands");
+      const iree_vm_register_remap_list_t* ref_remap_list =
           VM_DecBranchOperands("operands");
-      iree_vm_bytecode_dispatch_remap_branch_registers(regs, remap_list);
+      iree_vm_bytecode_dispatch_remap_branch_registers(regs, i32_remap_list,
+                                                       ref_remap_list);
       pc = block_pc;
     });
 
+    //===------------------------------------------------------------------===//
+    // Superinstructions
+    //===------------------------------------------------------------------===//
+    // Instruction pairs fused by iree_vm_bytecode_module_verify_bytecode when
+    // the module was loaded. Each handler executes the first instruction,
+    // skips the opcode of the second, and then executes the second inline
+    // without going back through the dispatch table. The second instruction
+    // is otherwise unchanged so that branches targeting it still work.
+
+#define DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(op_name, type, op) \
+  DISPATCH_OP(CORE, op_name##CondBranch, {                      \
+    DISPATCH_BODY_CORE_CMP_I32(type, op);                       \
+    VM_SkipOpcode(CondBranch);                                  \
+    VM_SkipOperandReg("condition");                             \
+    DISPATCH_BODY_CORE_COND_BRANCH(value);                      \
+  });
+
+    // Only fused when the condition is the result of the comparison; the
+    // compared value is used directly instead of reloading the register.
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpEQI32, int32_t, ==);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpNEI32, int32_t, !=);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpLTI32S, int32_t, <);
+    DISPATCH_OP_CORE_CMP_I32_COND_BRANCH(CmpLTI32U, uint32_t, <);
+    DISPATCH_OP(CORE, CmpNZI32CondBranch, {
+      DISPATCH_BODY_CORE_CMP_NZ_I32();
+      VM_SkipOpcode(CondBranch);
+      VM_SkipOperandReg("condition");
+      DISPATCH_BODY_CORE_COND_BRANCH(value);
+    });
+
+    DISPATCH_OP(CORE, ConstI32AddI32, {
+      { DISPATCH_BODY_CORE_CONST_I32(); }
+      VM_SkipOpcode(AddI32);
+      { DISPATCH_BODY_CORE_BINARY_ALU_I32(int32_t, +); }
+    });
+
+    DISPATCH_OP(CORE, AddI32Branch, {
+      DISPATCH_BODY_CORE_BINARY_ALU_I32(int32_t, +);
+      VM_SkipOpcode(Branch);
+      DISPATCH_BODY_CORE_BRANCH();
+    });
+
     //===------------------------------------------------------------------===//
     // Extension trampolines
     //===------------------------------------------------------------------===//
@@ -1286,8 +1466,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
       DISPATCH_OP(EXT_I64, GlobalLoadI64, {
         uint32_t byte_offset = VM_DecGlobalAttr("global");
-        if (IREE_UNLIKELY(byte_offset >=
-                          module_state->rwdata_storage.data_length)) {
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
           return iree_make_status(
               IREE_STATUS_OUT_OF_RANGE,
               "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
@@ -1301,8 +1481,8 @@ iree_status_t iree_vm_bytecode_dispatch(
 
       DISPATCH_OP(EXT_I64, GlobalStoreI64, {
         uint32_t byte_offset = VM_DecGlobalAttr("global");
-        if (IREE_UNLIKELY(byte_offset >=
-                          module_state->rwdata_storage.data_length)) {
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
           return iree_make_status(
               IREE_STATUS_OUT_OF_RANGE,
               "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
@@ -1375,7 +1555,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         iree_vm_value_t value;
         IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
             list, index, IREE_VM_VALUE_TYPE_I64, &value));
-        *result = value.i32;
+        *result = value.i64;
       });
 
       DISPATCH_OP(EXT_I64, ListSetI64, {
@@ -1411,7 +1591,7 @@ iree_status_t iree_vm_bytecode_dispatch(
         int64_t* result = VM_DecResultRegI64("result");
         if (index >= 0 && index < value_reg_list->size) {
           *result =
-              regs.i32[value_reg_list->registers[index] & (regs.i32_mask & ~1)];
+              regs.i32[VM_RegI64(value_reg_list->registers[index])];
         } else {
           *result = default_value;
         }
@@ -1506,14 +1686,507 @@ iree_status_t iree_vm_bytecode_dispatch(
     }
     END_DISPATCH_PREFIX();
 
-    DISPATCH_OP(CORE, PrefixExtF32,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+    BEGIN_DISPATCH_PREFIX(PrefixExtF32, EXT_F32) {
+#if IREE_VM_EXT_F32_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF32: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, GlobalLoadF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreF32, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalLoadIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float* value = VM_DecResultRegF32("value");
+        const float* global_ptr =
+            (const float*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F32, GlobalStoreIndirectF32, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        float value = VM_DecOperandRegF32("value");
+        float* global_ptr =
+            (float*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ConstF32, {
+        float value = VM_DecFloatAttr32("value");
+        float* result = VM_DecResultRegF32("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F32, ConstF32Zero, {
+        float* result = VM_DecResultRegF32("result");
+        *result = 0;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, ListGetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float* result = VM_DecResultRegF32("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F32, &value));
+        *result = value.f32;
+      });
+
+      DISPATCH_OP(EXT_F32, ListSetF32, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        float raw_value = VM_DecOperandRegF32("value");
+        iree_vm_value_t value = iree_vm_value_make_f32(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Conditional assignment
+      //===----------------------------------------------------------------===//
 
-    DISPATCH_OP(CORE, PrefixExtF64,
-                { return iree_make_status(IREE_STATUS_UNIMPLEMENTED); });
+      DISPATCH_OP(EXT_F32, SelectF32, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        float true_value = VM_DecOperandRegF32("true_value");
+        float false_value = VM_DecOperandRegF32("false_value");
+        float* result = VM_DecResultRegF32("result");
+        *result = condition ? true_value : false_value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F32_UNARY_ALU_F32(op_name, op) \
+  DISPATCH_OP(EXT_F32, op_name, {                      \
+    float operand = VM_DecOperandRegF32("operand");    \
+    float* result = VM_DecResultRegF32("result");      \
+    *result = op(operand);                             \
+  });
+
+#define DISPATCH_OP_EXT_F32_BINARY_ALU_F32(op_name, op) \
+  DISPATCH_OP(EXT_F32, op_name, {                       \
+    float lhs = VM_DecOperandRegF32("lhs");             \
+    float rhs = VM_DecOperandRegF32("rhs");             \
+    float* result = VM_DecResultRegF32("result");       \
+    *result = lhs op rhs;                               \
+  });
+
+#define DISPATCH_OP_EXT_F32_BINARY_FN_F32(op_name, fn) \
+  DISPATCH_OP(EXT_F32, op_name, {                      \
+    float lhs = VM_DecOperandRegF32("lhs");            \
+    float rhs = VM_DecOperandRegF32("rhs");            \
+    float* result = VM_DecResultRegF32("result");      \
+    *result = fn(lhs, rhs);                            \
+  });
+
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(AddF32, +);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(SubF32, -);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(MulF32, *);
+      DISPATCH_OP_EXT_F32_BINARY_ALU_F32(DivF32, /);
+      DISPATCH_OP_EXT_F32_BINARY_FN_F32(RemF32, fmodf);
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(AbsF32, fabsf);
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(NegF32, -);
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(CeilF32, ceilf);
+      DISPATCH_OP_EXT_F32_UNARY_ALU_F32(FloorF32, floorf);
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F32, CastSI32F32, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = (float)operand;
+      });
+
+      DISPATCH_OP(EXT_F32, CastUI32F32, {
+        uint32_t operand = (uint32_t)VM_DecOperandRegI32("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = (float)operand;
+      });
+
+      DISPATCH_OP(EXT_F32, CastF32SI32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = iree_math_f32_to_si32_sat(operand);
+      });
+
+      DISPATCH_OP(EXT_F32, CastF32UI32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = (int32_t)iree_math_f32_to_ui32_sat(operand);
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF32: Comparison ops
+      //===----------------------------------------------------------------===//
+
+      // Ordered (.o) comparisons are false if either operand is NaN and
+      // unordered (.u) comparisons are true if either operand is NaN. The
+      // expressions are chosen such that C comparison semantics match without
+      // needing an explicit isnan check on the common path.
+#define DISPATCH_OP_EXT_F32_CMP_F32(op_name, expr)  \
+  DISPATCH_OP(EXT_F32, op_name, {                   \
+    float lhs = VM_DecOperandRegF32("lhs");         \
+    float rhs = VM_DecOperandRegF32("rhs");         \
+    int32_t* result = VM_DecResultRegI32("result"); \
+    *result = (expr) ? 1 : 0;                       \
+  });
+
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32O, lhs == rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpEQF32U, !(lhs < rhs || lhs > rhs));
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32O, lhs < rhs || lhs > rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpNEF32U, lhs != rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32O, lhs < rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTF32U, !(lhs >= rhs));
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32O, lhs <= rhs);
+      DISPATCH_OP_EXT_F32_CMP_F32(CmpLTEF32U, !(lhs > rhs));
+      DISPATCH_OP(EXT_F32, CmpNaNF32, {
+        float operand = VM_DecOperandRegF32("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = isnan(operand) ? 1 : 0;
+      });
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F32_ENABLE
+    }
+    END_DISPATCH_PREFIX();
+
+    BEGIN_DISPATCH_PREFIX(PrefixExtF64, EXT_F64) {
+#if IREE_VM_EXT_F64_ENABLE
+      //===----------------------------------------------------------------===//
+      // ExtF64: Globals
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, GlobalLoadF64, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double* value = VM_DecResultRegF64("value");
+        const double* global_ptr =
+            (const double*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalStoreF64, {
+        uint32_t byte_offset = VM_DecGlobalAttr("global");
+        if (IREE_UNLIKELY(VM_UNVERIFIED(
+                byte_offset >= module_state->rwdata_storage.data_length))) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double value = VM_DecOperandRegF64("value");
+        double* global_ptr =
+            (double*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalLoadIndirectF64, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double* value = VM_DecResultRegF64("value");
+        const double* global_ptr =
+            (const double*)(module_state->rwdata_storage.data + byte_offset);
+        *value = *global_ptr;
+      });
+
+      DISPATCH_OP(EXT_F64, GlobalStoreIndirectF64, {
+        uint32_t byte_offset = VM_DecOperandRegI32("global");
+        if (IREE_UNLIKELY(byte_offset >=
+                          module_state->rwdata_storage.data_length)) {
+          return iree_make_status(
+              IREE_STATUS_OUT_OF_RANGE,
+              "global byte_offset out of range: %d (rwdata=%zu)", byte_offset,
+              module_state->rwdata_storage.data_length);
+        }
+        double value = VM_DecOperandRegF64("value");
+        double* global_ptr =
+            (double*)(module_state->rwdata_storage.data + byte_offset);
+        *global_ptr = value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Constants
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, ConstF64, {
+        double value = VM_DecFloatAttr64("value");
+        double* result = VM_DecResultRegF64("result");
+        *result = value;
+      });
+
+      DISPATCH_OP(EXT_F64, ConstF64Zero, {
+        double* result = VM_DecResultRegF64("result");
+        *result = 0;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Lists
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, ListGetF64, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        double* result = VM_DecResultRegF64("result");
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            list, index, IREE_VM_VALUE_TYPE_F64, &value));
+        *result = value.f64;
+      });
+
+      DISPATCH_OP(EXT_F64, ListSetF64, {
+        bool list_is_move;
+        iree_vm_ref_t* list_ref = VM_DecOperandRegRef("list", &list_is_move);
+        iree_vm_list_t* list = iree_vm_list_deref(list_ref);
+        if (IREE_UNLIKELY(!list)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT, "list is null");
+        }
+        uint32_t index = VM_DecOperandRegI32("index");
+        double raw_value = VM_DecOperandRegF64("value");
+        iree_vm_value_t value = iree_vm_value_make_f64(raw_value);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, index, &value));
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Conditional assignment
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, SelectF64, {
+        int32_t condition = VM_DecOperandRegI32("condition");
+        double true_value = VM_DecOperandRegF64("true_value");
+        double false_value = VM_DecOperandRegF64("false_value");
+        double* result = VM_DecResultRegF64("result");
+        *result = condition ? true_value : false_value;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Native floating-point arithmetic
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F64_UNARY_ALU_F64(op_name, op) \
+  DISPATCH_OP(EXT_F64, op_name, {                      \
+    double operand = VM_DecOperandRegF64("operand");   \
+    double* result = VM_DecResultRegF64("result");     \
+    *result = op(operand);                             \
+  });
+
+#define DISPATCH_OP_EXT_F64_BINARY_ALU_F64(op_name, op) \
+  DISPATCH_OP(EXT_F64, op_name, {                       \
+    double lhs = VM_DecOperandRegF64("lhs");            \
+    double rhs = VM_DecOperandRegF64("rhs");            \
+    double* result = VM_DecResultRegF64("result");      \
+    *result = lhs op rhs;                               \
+  });
+
+#define DISPATCH_OP_EXT_F64_BINARY_FN_F64(op_name, fn) \
+  DISPATCH_OP(EXT_F64, op_name, {                      \
+    double lhs = VM_DecOperandRegF64("lhs");           \
+    double rhs = VM_DecOperandRegF64("rhs");           \
+    double* result = VM_DecResultRegF64("result");     \
+    *result = fn(lhs, rhs);                            \
+  });
+
+      DISPATCH_OP_EXT_F64_BINARY_ALU_F64(AddF64, +);
+      DISPATCH_OP_EXT_F64_BINARY_ALU_F64(SubF64, -);
+      DISPATCH_OP_EXT_F64_BINARY_ALU_F64(MulF64, *);
+      DISPATCH_OP_EXT_F64_BINARY_ALU_F64(DivF64, /);
+      DISPATCH_OP_EXT_F64_BINARY_FN_F64(RemF64, fmod);
+      DISPATCH_OP_EXT_F64_UNARY_ALU_F64(AbsF64, fabs);
+      DISPATCH_OP_EXT_F64_UNARY_ALU_F64(NegF64, -);
+      DISPATCH_OP_EXT_F64_UNARY_ALU_F64(CeilF64, ceil);
+      DISPATCH_OP_EXT_F64_UNARY_ALU_F64(FloorF64, floor);
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Casting and type conversion/emulation
+      //===----------------------------------------------------------------===//
+
+      DISPATCH_OP(EXT_F64, CastSI32F64, {
+        int32_t operand = VM_DecOperandRegI32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = (double)operand;
+      });
+
+      DISPATCH_OP(EXT_F64, CastUI32F64, {
+        uint32_t operand = (uint32_t)VM_DecOperandRegI32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = (double)operand;
+      });
+
+      DISPATCH_OP(EXT_F64, CastF64SI32, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = iree_math_f64_to_si32_sat(operand);
+      });
+
+      DISPATCH_OP(EXT_F64, CastF64UI32, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = (int32_t)iree_math_f64_to_ui32_sat(operand);
+      });
+
+      DISPATCH_OP(EXT_F64, TruncF64F32, {
+        double operand = VM_DecOperandRegF64("operand");
+        float* result = VM_DecResultRegF32("result");
+        *result = (float)operand;
+      });
+
+      DISPATCH_OP(EXT_F64, ExtF32F64, {
+        float operand = VM_DecOperandRegF32("operand");
+        double* result = VM_DecResultRegF64("result");
+        *result = (double)operand;
+      });
+
+      //===----------------------------------------------------------------===//
+      // ExtF64: Comparison ops
+      //===----------------------------------------------------------------===//
+
+#define DISPATCH_OP_EXT_F64_CMP_F64(op_name, expr)  \
+  DISPATCH_OP(EXT_F64, op_name, {                   \
+    double lhs = VM_DecOperandRegF64("lhs");        \
+    double rhs = VM_DecOperandRegF64("rhs");        \
+    int32_t* result = VM_DecResultRegI32("result"); \
+    *result = (expr) ? 1 : 0;                       \
+  });
+
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpEQF64O, lhs == rhs);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpEQF64U, !(lhs < rhs || lhs > rhs));
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpNEF64O, lhs < rhs || lhs > rhs);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpNEF64U, lhs != rhs);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTF64O, lhs < rhs);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTF64U, !(lhs >= rhs));
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTEF64O, lhs <= rhs);
+      DISPATCH_OP_EXT_F64_CMP_F64(CmpLTEF64U, !(lhs > rhs));
+      DISPATCH_OP(EXT_F64, CmpNaNF64, {
+        double operand = VM_DecOperandRegF64("operand");
+        int32_t* result = VM_DecResultRegI32("result");
+        *result = isnan(operand) ? 1 : 0;
+      });
+#else
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED);
+#endif  // IREE_VM_EXT_F64_ENABLE
+    }
+    END_DISPATCH_PREFIX();
 
     // NOLINTNEXTLINE(misc-static-assert)
     DISPATCH_UNHANDLED_CORE();
   }
   END_DISPATCH_CORE();
 }
+
+iree_status_t iree_vm_bytecode_dispatch_begin(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result) {
+  // Enter function (as this is the initial call).
+  // The callee's return will take care of storing the output registers when it
+  // actually does return, either immediately or in the future via a resume.
+  iree_vm_stack_frame_t* current_frame = NULL;
+  iree_vm_registers_t regs;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_external_enter(stack, call->function, cconv_arguments,
+                                      call->arguments, &current_frame, &regs));
+  return iree_vm_bytecode_dispatch(stack, module, current_frame, regs,
+                                   current_frame->depth, cconv_results,
+                                   call->results, out_result);
+}
+
+iree_status_t iree_vm_bytecode_dispatch_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    iree_vm_execution_result_t* out_result) {
+  iree_vm_stack_frame_t* current_frame = iree_vm_stack_current_frame(stack);
+  if (IREE_UNLIKELY(!current_frame) ||
+      IREE_UNLIKELY(current_frame->function.module != &module->interface)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "no yielded frame from this module on the stack");
+  }
+
+  // Restore the dispatch state stashed by the yield. The pc already points at
+  // the instruction following the yield.
+  const iree_vm_bytecode_frame_storage_t* yield_storage =
+      (const iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(
+          current_frame);
+  iree_vm_registers_t regs =
+      iree_vm_bytecode_get_register_storage(current_frame);
+  return iree_vm_bytecode_dispatch(
+      stack, module, current_frame, regs,
+      yield_storage->yield_entry_frame_depth,
+      yield_storage->yield_cconv_results, yield_storage->yield_results,
+      out_result);
+}
@@ -18,13 +18,18 @@
 // avoid defining the IR inline here so that we can run this test on platforms
 // that we can't run the full MLIR compiler stack on.
 
+#include <set>
+
 #include "absl/strings/match.h"
 #include "absl/strings/str_replace.h"
 #include "iree/base/logging.h"
 #include "iree/base/status.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
 #include "iree/vm/builtin_types.h"
 #include "iree/vm/bytecode_module.h"
+#include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_table.h"
 #include "iree/vm/context.h"
 #include "iree/vm/instance.h"
 #include "iree/vm/invocation.h"
@@ -117,6 +122,32 @@ class VMBytecodeDispatchTest
                           /*outputs=*/nullptr, iree_allocator_system());
   }
 
+  // Runs the function through the iree_vm_invocation_t API, resuming it each
+  // time it yields until it completes. The number of yields is returned in
+  // |out_yield_count|.
+  iree_status_t RunFunctionAsync(absl::string_view function_name,
+                                 int* out_yield_count) {
+    iree_vm_function_t function;
+    IREE_CHECK_OK(bytecode_module_->lookup_function(
+        bytecode_module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+        iree_string_view_t{function_name.data(), function_name.size()},
+        &function))
+        << "Exported function '" << function_name << "' not found";
+
+    iree_vm_invocation_t* invocation = nullptr;
+    IREE_RETURN_IF_ERROR(iree_vm_invocation_create(
+        context_, function, /*policy=*/nullptr, /*inputs=*/nullptr,
+        iree_allocator_system(), &invocation));
+    *out_yield_count = 0;
+    iree_status_t status = iree_vm_invocation_query_status(invocation);
+    while (iree_status_is_unavailable(status)) {
+      ++*out_yield_count;
+      status = iree_vm_invocation_resume(invocation);
+    }
+    iree_vm_invocation_release(invocation);
+    return status;
+  }
+
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
   iree_vm_module_t* bytecode_module_ = nullptr;
@@ -143,8 +174,102 @@ TEST_P(VMBytecodeDispatchTest, Check) {
   }
 }
 
+TEST_P(VMBytecodeDispatchTest, CheckResumable) {
+  const auto& test_params = GetParam();
+  bool expect_failure = absl::StartsWith(test_params.function_name, "fail_");
+  bool expect_yield = absl::StrContains(test_params.function_name, "yield");
+
+  int yield_count = 0;
+  iree::Status result =
+      RunFunctionAsync(test_params.function_name, &yield_count);
+  if (expect_failure) {
+    EXPECT_FALSE(result.ok()) << "Function expected failure but succeeded";
+  } else {
+    EXPECT_TRUE(result.ok())
+        << "Function expected success but failed with error: "
+        << result.ToString();
+  }
+  EXPECT_EQ(expect_yield, yield_count > 0);
+}
+
 INSTANTIATE_TEST_SUITE_P(VMIRFunctions, VMBytecodeDispatchTest,
                          ::testing::ValuesIn(GetModuleTestParams()),
                          ::testing::PrintToStringParamName());
 
+// Checks that the compiler output for the control flow tests has its
+// comparison/branch and add/branch pairs fused when loaded. Only the module's
+// copy of the bytecode is rewritten and each rewritten byte must be the opcode
+// of the first instruction of a pair replaced with the matching fused opcode.
+TEST(VMBytecodeSuperinstructionTest, FormedOnLoad) {
+#if !IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+  GTEST_SKIP() << "Superinstructions are disabled";
+#else
+  IREE_CHECK_OK(iree_vm_register_builtin_types());
+
+  const iree::FileToc* module_file = nullptr;
+  auto* module_file_toc = iree::vm::test::all_bytecode_modules_cc_create();
+  for (size_t i = 0; i < iree::vm::test::all_bytecode_modules_cc_size(); ++i) {
+    if (absl::string_view(module_file_toc[i].name) ==
+        "control_flow_ops.module") {
+      module_file = &module_file_toc[i];
+    }
+  }
+  ASSERT_NE(module_file, nullptr);
+
+  iree_vm_module_t* module = nullptr;
+  IREE_ASSERT_OK(iree_vm_bytecode_module_create(
+      iree_const_byte_span_t{
+          reinterpret_cast<const uint8_t*>(module_file->data),
+          module_file->size},
+      iree_allocator_null(), iree_allocator_system(), &module));
+  auto* bytecode_module = static_cast<iree_vm_bytecode_module_t*>(module->self);
+
+  flatbuffers_uint8_vec_t embedded_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(bytecode_module->def);
+  ASSERT_EQ(flatbuffers_uint8_vec_len(embedded_data),
+            bytecode_module->bytecode_data.data_length);
+  ASSERT_NE(embedded_data, bytecode_module->bytecode_data.data);
+
+  static const struct {
+    uint8_t opcode;
+    uint8_t fused_opcode;
+  } kSuperinstructions[] = {
+      {IREE_VM_OP_CORE_CmpEQI32, IREE_VM_OP_CORE_CmpEQI32CondBranch},
+      {IREE_VM_OP_CORE_CmpNEI32, IREE_VM_OP_CORE_CmpNEI32CondBranch},
+      {IREE_VM_OP_CORE_CmpLTI32S, IREE_VM_OP_CORE_CmpLTI32SCondBranch},
+      {IREE_VM_OP_CORE_CmpLTI32U, IREE_VM_OP_CORE_CmpLTI32UCondBranch},
+      {IREE_VM_OP_CORE_CmpNZI32, IREE_VM_OP_CORE_CmpNZI32CondBranch},
+      {IREE_VM_OP_CORE_ConstI32, IREE_VM_OP_CORE_ConstI32AddI32},
+      {IREE_VM_OP_CORE_AddI32, IREE_VM_OP_CORE_AddI32Branch},
+  };
+  std::set<uint8_t> formed_opcodes;
+  for (size_t i = 0; i < bytecode_module->bytecode_data.data_length; ++i) {
+    uint8_t opcode = embedded_data[i];
+    uint8_t fused_opcode = bytecode_module->bytecode_data.data[i];
+    if (opcode == fused_opcode) continue;
+    bool is_superinstruction = false;
+    for (const auto& superinstruction : kSuperinstructions) {
+      if (superinstruction.fused_opcode == fused_opcode) {
+        EXPECT_EQ(superinstruction.opcode, opcode) << "at offset " << i;
+        is_superinstruction = true;
+      }
+    }
+    EXPECT_TRUE(is_superinstruction)
+        << "unexpected rewrite of " << static_cast<int>(opcode) << " to "
+        << static_cast<int>(fused_opcode) << " at offset " << i;
+    formed_opcodes.insert(fused_opcode);
+  }
+  iree_vm_module_release(module);
+
+  // @test_cond_br_cmp branches on each comparison and @test_cond_br_countdown
+  // ends its loop body with an increment.
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_CmpEQI32CondBranch));
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_CmpNEI32CondBranch));
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_CmpLTI32SCondBranch));
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_CmpLTI32UCondBranch));
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_CmpNZI32CondBranch));
+  EXPECT_TRUE(formed_opcodes.count(IREE_VM_OP_CORE_AddI32Branch));
+#endif  // IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+}
+
 }  // namespace
@@ -25,8 +25,8 @@
 
 // TODO(benvanik): make a compiler setting.
 #define IREE_VM_EXT_I64_ENABLE 1
-#define IREE_VM_EXT_F32_ENABLE 0
-#define IREE_VM_EXT_F64_ENABLE 0
+#define IREE_VM_EXT_F32_ENABLE 1
+#define IREE_VM_EXT_F64_ENABLE 1
 
 //===----------------------------------------------------------------------===//
 // Shared data structures
@@ -34,16 +34,23 @@
 //
 // Register bounds checking
 // ------------------------
-// All accesses into the register lists are truncated to the valid range for the
-// typed bank. This allows us to directly use the register ordinals from the
-// bytecode without needing to perform any validation at load-time or run-time.
-// The worst that can happen is that the bytecode program being executed doesn't
-// work as intended - which, with a working compiler, shouldn't happen. Though
-// there are cases where the runtime produces the register values and may know
-// that they are in range it's a good habit to always mask the ordinal by the
-// type-specific mask so that it's not possible for out of bounds accesses to
-// sneak in. The iree_vm_registers_t struct is often kept in cache and the
-// masking is cheap relative to any other validation we could be performing.
+// When IREE_VM_BYTECODE_VERIFICATION_ENABLE is set all function bytecode is
+// verified when the module is loaded (see bytecode_verifier.c): every register
+// ordinal is checked against the function's register counts, i64 registers are
+// checked for alignment, and branch targets and module table ordinals are
+// checked to be in range. The dispatch loop can then use the register ordinals
+// from the bytecode directly without any per-instruction validation.
+//
+// Without verification all accesses into the register lists are truncated to
+// the valid range for the typed bank. The worst that can happen is that the
+// bytecode program being executed doesn't work as intended - which, with a
+// working compiler, shouldn't happen. Registers produced by the runtime (such
+// as call arguments and results) are always masked as they are not covered by
+// the verifier. Values read from registers and used as offsets or ordinals
+// (such as the indirect global ops) are always checked at runtime as their
+// contents are unknown at load time.
+//
+// The VM_Reg* and VM_UNVERIFIED macros select between the two modes.
 //
 // Alternative register widths
 // ---------------------------
@@ -91,9 +98,10 @@ typedef struct {
 // NOTE: we cannot store pointers to the stack in here as the stack may be
 // reallocated.
 typedef struct {
-  // Pointer to a register list within the stack frame where return registers
-  // will be stored by callees upon return.
-  const iree_vm_register_list_t* return_registers;
+  // Pointers to the i32 and ref register lists within the bytecode where
+  // return registers will be stored by callees upon return.
+  const iree_vm_register_list_t* return_i32_registers;
+  const iree_vm_register_list_t* return_ref_registers;
 
   // Counts of each register type rounded up to the next power of two.
   iree_host_size_t i32_register_count;
@@ -102,11 +110,24 @@ typedef struct {
   // Relative byte offsets from the head of this struct.
   iree_host_size_t i32_register_offset;
   iree_host_size_t ref_register_offset;
+
+  // Dispatch state of the invocation that was live when this frame yielded.
+  // Only valid on the top-most frame of a yielded invocation and used to
+  // restore the state upon resume. |yield_results| points at the external
+  // caller's results buffer, which the caller keeps alive until completion.
+  int32_t yield_entry_frame_depth;
+  iree_string_view_t yield_cconv_results;
+  iree_byte_span_t yield_results;
 } iree_vm_bytecode_frame_storage_t;
 
 // Interleaved src-dst register sets for branch register remapping.
 // This structure is an overlay for the bytecode that is serialized in a
 // matching format.
+//
+// Branch operands as well as call/return operands and results are encoded as
+// two consecutive lists: one with i32 registers followed by one with ref
+// registers. This lets the dispatch loop process each register bank without
+// checking the type of every register.
 typedef struct {
   uint16_t size;
   struct pair {
@@ -119,10 +140,24 @@ static_assert(iree_alignof(iree_vm_register_remap_list_t) == 2,
 static_assert(offsetof(iree_vm_register_remap_list_t, pairs) == 2,
               "Expect no padding in the struct");
 
+// Register ordinal accessors and checks elided for verified bytecode.
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+#define VM_RegI32(ordinal) (ordinal)
+#define VM_RegI64(ordinal) (ordinal)
+#define VM_RegRef(ordinal) ((ordinal)&IREE_REF_REGISTER_MASK)
+// Evaluates to false as |cond| has already been checked by the verifier.
+#define VM_UNVERIFIED(cond) 0
+#else
+#define VM_RegI32(ordinal) ((ordinal)&regs.i32_mask)
+#define VM_RegI64(ordinal) ((ordinal) & (regs.i32_mask & ~1))
+#define VM_RegRef(ordinal) ((ordinal)&regs.ref_mask)
+#define VM_UNVERIFIED(cond) (cond)
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
 // Maps a type ID to a type def with clamping for out of bounds values.
 static inline const iree_vm_type_def_t* iree_vm_map_type(
     iree_vm_bytecode_module_t* module, int32_t type_id) {
-  type_id = type_id >= module->type_count ? 0 : type_id;
+  type_id = VM_UNVERIFIED(type_id >= module->type_count) ? 0 : type_id;
   return &module->type_table[type_id];
 }
 
@@ -191,6 +226,21 @@ static const int kRegSize = sizeof(uint16_t);
       ((uint64_t)bytecode_data[pc + 7 + (i)] << 56)
 #endif  // IREE_ENDIANNESS_LITTLE
 
+// Floating-point values are encoded as their IEEE bit patterns and are
+// reinterpreted after being read as integers to share the endianness handling.
+static inline float iree_vm_bits_as_f32(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+static inline double iree_vm_bits_as_f64(uint64_t bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+#define OP_F32(i) iree_vm_bits_as_f32(OP_I32(i))
+#define OP_F64(i) iree_vm_bits_as_f64(OP_I64(i))
+
 //===----------------------------------------------------------------------===//
 // Utilities matching the tablegen op encoding scheme
 //===----------------------------------------------------------------------===//
@@ -219,6 +269,12 @@ static const int kRegSize = sizeof(uint16_t);
 #define VM_DecTypeOf(name) VM_DecType(name)
 #define VM_DecIntAttr32(name) VM_DecConstI32(name)
 #define VM_DecIntAttr64(name) VM_DecConstI64(name)
+#define VM_DecFloatAttr32(name) \
+  OP_F32(0);                    \
+  pc += 4;
+#define VM_DecFloatAttr64(name) \
+  OP_F64(0);                    \
+  pc += 8;
 #define VM_DecStrAttr(name, out_str)                     \
   (out_str)->size = (iree_host_size_t)OP_I16(0);         \
   (out_str)->data = (const char*)&bytecode_data[pc + 2]; \
@@ -229,32 +285,50 @@ static const int kRegSize = sizeof(uint16_t);
   pc +=                                                                       \
       kRegSize + ((const iree_vm_register_list_t*)&bytecode_data[pc])->size * \
                      2 * kRegSize;
-#define VM_DecOperandRegI32(name)      \
-  regs.i32[OP_I16(0) & regs.i32_mask]; \
+#define VM_DecOperandRegI32(name) \
+  regs.i32[VM_RegI32(OP_I16(0))]; \
+  pc += kRegSize;
+#define VM_DecOperandRegI64(name)               \
+  *((int64_t*)&regs.i32[VM_RegI64(OP_I16(0))]); \
   pc += kRegSize;
-#define VM_DecOperandRegI64(name)                           \
-  *((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
+#define VM_DecOperandRegF32(name)             \
+  *((float*)&regs.i32[VM_RegI32(OP_I16(0))]); \
+  pc += kRegSize;
+#define VM_DecOperandRegF64(name)              \
+  *((double*)&regs.i32[VM_RegI64(OP_I16(0))]); \
   pc += kRegSize;
 #define VM_DecOperandRegRef(name, out_is_move)             \
-  &regs.ref[OP_I16(0) & regs.ref_mask];                    \
+  &regs.ref[VM_RegRef(OP_I16(0))];                         \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
   pc += kRegSize;
 #define VM_DecVariadicOperands(name)                  \
   (const iree_vm_register_list_t*)&bytecode_data[pc]; \
   pc += kRegSize +                                    \
         ((const iree_vm_register_list_t*)&bytecode_data[pc])->size * kRegSize;
-#define VM_DecResultRegI32(name)        \
-  &regs.i32[OP_I16(0) & regs.i32_mask]; \
+#define VM_DecResultRegI32(name)   \
+  &regs.i32[VM_RegI32(OP_I16(0))]; \
+  pc += kRegSize;
+#define VM_DecResultRegI64(name)               \
+  ((int64_t*)&regs.i32[VM_RegI64(OP_I16(0))]); \
   pc += kRegSize;
-#define VM_DecResultRegI64(name)                           \
-  ((int64_t*)&regs.i32[OP_I16(0) & (regs.i32_mask & ~1)]); \
+#define VM_DecResultRegF32(name)             \
+  ((float*)&regs.i32[VM_RegI32(OP_I16(0))]); \
+  pc += kRegSize;
+#define VM_DecResultRegF64(name)              \
+  ((double*)&regs.i32[VM_RegI64(OP_I16(0))]); \
   pc += kRegSize;
 #define VM_DecResultRegRef(name, out_is_move)              \
-  &regs.ref[OP_I16(0) & regs.ref_mask];                    \
+  &regs.ref[VM_RegRef(OP_I16(0))];                         \
   *(out_is_move) = OP_I16(0) & IREE_REF_REGISTER_MOVE_BIT; \
   pc += kRegSize;
 #define VM_DecVariadicResults(name) VM_DecVariadicOperands(name)
 
+// Skips values whose contents are known to the handler. Superinstructions use
+// these to step over the opcode of the fused instruction and any operands
+// they have already read.
+#define VM_SkipOpcode(opcode) ++pc;
+#define VM_SkipOperandReg(name) pc += kRegSize;
+
 //===----------------------------------------------------------------------===//
 // Dispatch table structure
 //===----------------------------------------------------------------------===//
@@ -299,9 +373,29 @@ static const int kRegSize = sizeof(uint16_t);
 #define DEFINE_DISPATCH_TABLE_EXT_I64()
 #endif  // IREE_VM_EXT_I64_ENABLE
 
-#define DEFINE_DISPATCH_TABLES() \
-  DEFINE_DISPATCH_TABLE_CORE();  \
-  DEFINE_DISPATCH_TABLE_EXT_I64();
+#if IREE_VM_EXT_F32_ENABLE
+#define DECLARE_DISPATCH_EXT_F32_OPC(ordinal, name) &&_dispatch_EXT_F32_##name,
+#define DEFINE_DISPATCH_TABLE_EXT_F32()                                       \
+  static const void* kDispatchTable_EXT_F32[256] = {IREE_VM_OP_EXT_F32_TABLE( \
+      DECLARE_DISPATCH_EXT_F32_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#else
+#define DEFINE_DISPATCH_TABLE_EXT_F32()
+#endif  // IREE_VM_EXT_F32_ENABLE
+
+#if IREE_VM_EXT_F64_ENABLE
+#define DECLARE_DISPATCH_EXT_F64_OPC(ordinal, name) &&_dispatch_EXT_F64_##name,
+#define DEFINE_DISPATCH_TABLE_EXT_F64()                                       \
+  static const void* kDispatchTable_EXT_F64[256] = {IREE_VM_OP_EXT_F64_TABLE( \
+      DECLARE_DISPATCH_EXT_F64_OPC, DECLARE_DISPATCH_EXT_RSV)};
+#else
+#define DEFINE_DISPATCH_TABLE_EXT_F64()
+#endif  // IREE_VM_EXT_F64_ENABLE
+
+#define DEFINE_DISPATCH_TABLES()   \
+  DEFINE_DISPATCH_TABLE_CORE();    \
+  DEFINE_DISPATCH_TABLE_EXT_I64(); \
+  DEFINE_DISPATCH_TABLE_EXT_F32(); \
+  DEFINE_DISPATCH_TABLE_EXT_F64();
 
 #define DISPATCH_UNHANDLED_CORE()                                           \
   _dispatch_unhandled : {                                                   \
@@ -56,6 +56,12 @@ static iree_vm_type_def_t iree_vm_bytecode_module_resolve_type(
   } else if (iree_vm_flatbuffer_strcmp(full_name,
                                        iree_make_cstring_view("i64")) == 0) {
     result.value_type = IREE_VM_VALUE_TYPE_I64;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f32")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F32;
+  } else if (iree_vm_flatbuffer_strcmp(full_name,
+                                       iree_make_cstring_view("f64")) == 0) {
+    result.value_type = IREE_VM_VALUE_TYPE_F64;
   } else if (full_name[0] == '!') {
     // Note that we drop the ! prefix:
     iree_string_view_t type_name = {full_name + 1,
@@ -244,8 +250,6 @@ static iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
           IREE_STATUS_INVALID_ARGUMENT,
           "functions[%zu] descriptor register count out of range", i);
     }
-
-    // TODO(benvanik): run bytecode verifier on contents.
   }
 
   return iree_ok_status();
@@ -255,6 +259,9 @@ static void iree_vm_bytecode_module_destroy(void* self) {
   iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_allocator_free(module->allocator, module->fused_bytecode_data.data);
+  module->fused_bytecode_data = iree_make_byte_span(NULL, 0);
+
   iree_allocator_free(module->flatbuffer_allocator,
                       (void*)module->flatbuffer_data.data);
   module->flatbuffer_data = iree_make_const_byte_span(NULL, 0);
@@ -710,12 +717,28 @@ static iree_status_t iree_vm_bytecode_module_begin_call(
 
   // Jump into the dispatch routine to execute bytecode until the function
   // either returns (synchronous) or yields (asynchronous).
-  iree_status_t status = iree_vm_bytecode_dispatch(
+  iree_status_t status = iree_vm_bytecode_dispatch_begin(
       stack, module, call, cconv_arguments, cconv_results, out_result);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_status_t iree_vm_bytecode_module_resume_call(
+    void* self, iree_vm_stack_t* stack,
+    iree_vm_execution_result_t* out_result) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_ASSERT_ARGUMENT(out_result);
+  memset(out_result, 0, sizeof(iree_vm_execution_result_t));
+
+  // The yielded frame stashed everything needed to continue; we just need to
+  // jump back into the dispatch routine.
+  iree_vm_bytecode_module_t* module = (iree_vm_bytecode_module_t*)self;
+  iree_status_t status =
+      iree_vm_bytecode_dispatch_resume(stack, module, out_result);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
     iree_const_byte_span_t flatbuffer_data,
     iree_allocator_t flatbuffer_allocator, iree_allocator_t allocator,
@@ -744,15 +767,48 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
         "'" iree_vm_BytecodeModuleDef_file_identifier "' not found");
   }
 
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+  iree_host_size_t bytecode_length = flatbuffers_uint8_vec_len(bytecode_data);
+
+  // Superinstructions are formed in a copy of the bytecode as the flatbuffer
+  // may be in read-only memory and shared with other modules.
+  iree_byte_span_t fused_bytecode_data = iree_make_byte_span(NULL, 0);
+#if IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+  if (bytecode_length > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(allocator, bytecode_length,
+                                  (void**)&fused_bytecode_data.data));
+    fused_bytecode_data.data_length = bytecode_length;
+    memcpy(fused_bytecode_data.data, bytecode_data, bytecode_length);
+  }
+#endif  // IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  IREE_TRACE_ZONE_BEGIN_NAMED(z2, "iree_vm_bytecode_module_bytecode_verify");
+  status = iree_vm_bytecode_module_verify_bytecode(
+      module_def, fused_bytecode_data, allocator);
+  IREE_TRACE_ZONE_END(z2);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator, fused_bytecode_data.data);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
   iree_vm_TypeDef_vec_t type_defs = iree_vm_BytecodeModuleDef_types(module_def);
   size_t type_table_size =
       iree_vm_TypeDef_vec_len(type_defs) * sizeof(iree_vm_type_def_t);
 
   iree_vm_bytecode_module_t* module = NULL;
-  IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(
-              allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
-              (void**)&module));
+  status = iree_allocator_malloc(
+      allocator, sizeof(iree_vm_bytecode_module_t) + type_table_size,
+      (void**)&module);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(allocator, fused_bytecode_data.data);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
   module->allocator = allocator;
 
   iree_vm_FunctionDescriptor_vec_t function_descriptors =
@@ -761,10 +817,12 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
       iree_vm_FunctionDescriptor_vec_len(function_descriptors);
   module->function_descriptor_table = function_descriptors;
 
-  flatbuffers_uint8_vec_t bytecode_data =
-      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
-  module->bytecode_data = iree_make_const_byte_span(
-      bytecode_data, flatbuffers_uint8_vec_len(bytecode_data));
+  module->fused_bytecode_data = fused_bytecode_data;
+  module->bytecode_data =
+      fused_bytecode_data.data
+          ? iree_make_const_byte_span(fused_bytecode_data.data,
+                                      fused_bytecode_data.data_length)
+          : iree_make_const_byte_span(bytecode_data, bytecode_length);
 
   module->flatbuffer_data = flatbuffer_data;
   module->flatbuffer_allocator = flatbuffer_allocator;
@@ -776,6 +834,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   iree_status_t resolve_status =
       iree_vm_bytecode_module_resolve_types(type_defs, module->type_table);
   if (!iree_status_is_ok(resolve_status)) {
+    iree_allocator_free(allocator, fused_bytecode_data.data);
     iree_allocator_free(allocator, module);
     IREE_TRACE_ZONE_END(z0);
     return resolve_status;
@@ -791,6 +850,7 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_bytecode_module_create(
   module->interface.free_state = iree_vm_bytecode_module_free_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
+  module->interface.resume_call = iree_vm_bytecode_module_resume_call;
   module->interface.get_function_reflection_attr =
       iree_vm_bytecode_module_get_function_reflection_attr;
 
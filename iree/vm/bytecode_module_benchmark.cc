@@ -309,4 +309,50 @@ static void BM_LoopSumBytecode(benchmark::State& state) {
 }
 BENCHMARK(BM_LoopSumBytecode)->Arg(100000);
 
+// Compare against a build with IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE=0 to
+// measure the dispatch overhead removed by superinstructions.
+static void BM_LoopCountBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_count",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopCountBytecode)->Arg(100000);
+
+static void BM_LoopRemapBytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_remap",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopRemapBytecode)->Arg(100000);
+
+static void BM_LoopSumF32Reference(benchmark::State& state) {
+  static auto work = +[](float x) {
+    benchmark::DoNotOptimize(x);
+    return x * 0.5f + 1.0f;
+  };
+  static auto loop = +[](int count) {
+    float acc = 0.0f;
+    for (int i = 0; i < count; ++i) {
+      benchmark::DoNotOptimize(acc = work(acc));
+    }
+    return static_cast<int>(acc);
+  };
+  while (state.KeepRunningBatch(state.range(0))) {
+    int ret = loop(state.range(0));
+    benchmark::DoNotOptimize(ret);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_LoopSumF32Reference)->Arg(100000);
+
+static void BM_LoopSumF32Bytecode(benchmark::State& state) {
+  IREE_CHECK_OK(RunFunction(state, "bytecode_module_benchmark.loop_sum_f32",
+                            {static_cast<int32_t>(state.range(0))},
+                            /*result_count=*/1,
+                            /*batch_size=*/state.range(0)));
+}
+BENCHMARK(BM_LoopSumF32Bytecode)->Arg(100000);
+
 }  // namespace
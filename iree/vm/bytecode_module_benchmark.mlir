@@ -76,4 +76,60 @@ vm.module @bytecode_module_benchmark {
   ^loop_exit(%ie : i32):
     vm.return %ie : i32
   }
+
+  // Measures the cost of a loop made up only of fusable instruction pairs: the
+  // exit comparison feeding its branch and the increment feeding the backedge
+  // each run as a single superinstruction when enabled.
+  vm.export @loop_count
+  vm.func @loop_count(%count : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    vm.br ^loop(%i0 : i32)
+  ^loop(%i : i32):
+    %cmp = vm.cmp.lt.i32.s %i, %count : i32
+    vm.cond_br %cmp, ^loop_body, ^loop_exit
+  ^loop_body:
+    %in = vm.add.i32 %i, %c1 : i32
+    vm.br ^loop(%in : i32)
+  ^loop_exit:
+    vm.return %i : i32
+  }
+
+  // Measures the cost of a loop that carries a mix of i32 and ref values across
+  // the backedge. Swapping the values each iteration forces the branch to remap
+  // registers in both banks.
+  vm.export @loop_remap
+  vm.func @loop_remap(%count : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    %list0 = vm.list.alloc %c1 : (i32) -> !vm.list<i32>
+    %list1 = vm.list.alloc %c1 : (i32) -> !vm.list<i32>
+    vm.br ^loop(%i0, %i0, %c1, %list0, %list1 : i32, i32, i32, !vm.list<i32>, !vm.list<i32>)
+  ^loop(%i : i32, %a : i32, %b : i32, %l0 : !vm.list<i32>, %l1 : !vm.list<i32>):
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %b, %a, %l1, %l0 : i32, i32, i32, !vm.list<i32>, !vm.list<i32>), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.return %ie : i32
+  }
+
+  // Measures the cost of a loop performing f32 arithmetic each iteration.
+  vm.export @loop_sum_f32
+  vm.func @loop_sum_f32(%count : i32) -> i32 {
+    %c1 = vm.const.i32 1 : i32
+    %i0 = vm.const.i32.zero : i32
+    %scale = vm.const.f32 0.5 : f32
+    %bias = vm.const.f32 1.0 : f32
+    %acc0 = vm.const.f32.zero : f32
+    vm.br ^loop(%i0, %acc0 : i32, f32)
+  ^loop(%i : i32, %acc : f32):
+    %acc_scaled = vm.mul.f32 %acc, %scale : f32
+    %accn = vm.add.f32 %acc_scaled, %bias : f32
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %count : i32
+    vm.cond_br %cmp, ^loop(%in, %accn : i32, f32), ^loop_exit(%accn : f32)
+  ^loop_exit(%acce : f32):
+    %result = vm.cast.f32.si32 %acce : f32 -> i32
+    vm.return %result : i32
+  }
 }
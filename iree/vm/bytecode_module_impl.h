@@ -40,6 +40,29 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Verifies all function bytecode when a module is loaded. This allows the
+// dispatch loop to trust register ordinals, branch targets, and module-level
+// ordinals instead of masking and checking them on every instruction.
+// Disabling verification retains the per-instruction masking so that
+// malformed bytecode cannot escape the register storage.
+#if !defined(IREE_VM_BYTECODE_VERIFICATION_ENABLE)
+#define IREE_VM_BYTECODE_VERIFICATION_ENABLE 1
+#endif  // !IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
+// Rewrites common instruction pairs (such as a comparison followed by a
+// conditional branch on its result) into superinstructions when a module is
+// loaded so that they execute with a single dispatch. This requires a writable
+// copy of the module bytecode and relies on the instruction boundaries found
+// during verification.
+#if !defined(IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE)
+#define IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE \
+  IREE_VM_BYTECODE_VERIFICATION_ENABLE
+#endif  // !IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+#if IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE && \
+    !IREE_VM_BYTECODE_VERIFICATION_ENABLE
+#error "IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE requires verification"
+#endif  // IREE_VM_BYTECODE_SUPERINSTRUCTIONS_ENABLE
+
 #define VMMAX(a, b) (((a) > (b)) ? (a) : (b))
 #define VMMIN(a, b) (((a) < (b)) ? (a) : (b))
 
@@ -67,9 +90,14 @@ typedef struct {
   iree_host_size_t function_descriptor_count;
   const iree_vm_FunctionDescriptor_t* function_descriptor_table;
 
-  // A pointer to the bytecode data embedded within the module.
+  // A pointer to the bytecode data executed by the dispatch loop. This is
+  // either embedded within the module or |fused_bytecode_data|.
   iree_const_byte_span_t bytecode_data;
 
+  // Copy of the embedded bytecode data with superinstructions formed, if
+  // enabled. Allocated from |allocator|.
+  iree_byte_span_t fused_bytecode_data;
+
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
 
@@ -133,15 +161,32 @@ typedef struct {
   iree_allocator_t allocator;
 } iree_vm_bytecode_module_state_t;
 
-// Begins (or resumes) execution of the current frame and continues until
-// either a yield or return. |out_result| will contain the result status for
-// continuation, if needed.
-iree_status_t iree_vm_bytecode_dispatch(iree_vm_stack_t* stack,
-                                        iree_vm_bytecode_module_t* module,
-                                        const iree_vm_function_call_t* call,
-                                        iree_string_view_t cconv_arguments,
-                                        iree_string_view_t cconv_results,
-                                        iree_vm_execution_result_t* out_result);
+// Verifies the bytecode of all internal functions in |module_def|, including
+// operand encodings, register bounds, branch targets, ordinals referencing
+// module tables, and calling convention consistency of calls and returns.
+// The flatbuffer must have already been verified.
+//
+// If |fused_bytecode_data| is not empty it must contain a copy of the module
+// bytecode data and will have superinstructions formed in each function once
+// the function has been verified. Superinstruction opcodes are never valid in
+// the module bytecode itself.
+iree_status_t iree_vm_bytecode_module_verify_bytecode(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_byte_span_t fused_bytecode_data, iree_allocator_t allocator);
+
+// Begins execution of |call| and continues until either a yield or return.
+// |out_result| will contain the result status for continuation, if needed.
+iree_status_t iree_vm_bytecode_dispatch_begin(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    const iree_vm_function_call_t* call, iree_string_view_t cconv_arguments,
+    iree_string_view_t cconv_results, iree_vm_execution_result_t* out_result);
+
+// Resumes execution of the yielded frame at the top of |stack| and continues
+// until either a yield or return. |out_result| will contain the result status
+// for continuation, if needed.
+iree_status_t iree_vm_bytecode_dispatch_resume(
+    iree_vm_stack_t* stack, iree_vm_bytecode_module_t* module,
+    iree_vm_execution_result_t* out_result);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -15,13 +15,351 @@
 // Tests for bytecode_module.cc implementations.
 // This means mostly just flatbuffer verification, module interface functions,
 // etc. bytecode_dispatch_test.cc covers actual dispatch.
+//
+// The modules here are built by hand instead of by the compiler so that they
+// can contain bytecode the compiler would never produce.
 
 #include "iree/vm/bytecode_module.h"
 
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "flatbuffers/flatbuffers.h"
+#include "iree/base/status.h"
+#include "iree/schemas/bytecode_module_def_generated.h"
 #include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/builtin_types.h"
+#include "iree/vm/bytecode_op_table.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
 
+namespace iree {
+namespace vm {
 namespace {
 
-// TODO(benvanik): bytecode_module_test.cc for flatbuffer/module implementation.
+using ::iree::testing::status::StatusIs;
+
+// Matches IREE_REF_REGISTER_TYPE_BIT in bytecode_module_impl.h.
+constexpr uint16_t kRefRegisterTypeBit = 0x8000;
+
+// Appends little-endian encoded bytecode values.
+class BytecodeBuilder {
+ public:
+  BytecodeBuilder& Op(uint8_t opcode) {
+    data_.push_back(opcode);
+    return *this;
+  }
+  BytecodeBuilder& I16(uint16_t value) {
+    data_.push_back(value & 0xFF);
+    data_.push_back((value >> 8) & 0xFF);
+    return *this;
+  }
+  BytecodeBuilder& I32(uint32_t value) {
+    I16(value & 0xFFFF);
+    return I16(value >> 16);
+  }
+  BytecodeBuilder& Reg(uint16_t ordinal) { return I16(ordinal); }
+  // An empty register list or branch remap list.
+  BytecodeBuilder& EmptyList() { return I16(0); }
+
+  // vm.const.i32 |value| -> |result|
+  BytecodeBuilder& ConstI32(uint32_t value, uint16_t result) {
+    return Op(IREE_VM_OP_CORE_ConstI32).I32(value).Reg(result);
+  }
+  // vm.add.i32 |lhs|, |rhs| -> |result|
+  BytecodeBuilder& AddI32(uint16_t lhs, uint16_t rhs, uint16_t result) {
+    return Op(IREE_VM_OP_CORE_AddI32).Reg(lhs).Reg(rhs).Reg(result);
+  }
+  // vm.br to |target| without any operands.
+  BytecodeBuilder& Branch(uint32_t target) {
+    return Op(IREE_VM_OP_CORE_Branch).I32(target).EmptyList().EmptyList();
+  }
+  // vm.cond_br on |condition| to |true_target| or |false_target|.
+  BytecodeBuilder& CondBranch(uint16_t condition, uint32_t true_target,
+                              uint32_t false_target) {
+    return Op(IREE_VM_OP_CORE_CondBranch)
+        .Reg(condition)
+        .I32(true_target)
+        .EmptyList()
+        .EmptyList()
+        .I32(false_target)
+        .EmptyList()
+        .EmptyList();
+  }
+  // vm.return without any results.
+  BytecodeBuilder& Return() {
+    return Op(IREE_VM_OP_CORE_Return).EmptyList().EmptyList();
+  }
+
+  std::vector<uint8_t> Build() const { return data_; }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+// Owns a module flatbuffer with a single exported `()->()` function `fn`.
+class TestModule {
+ public:
+  TestModule(std::vector<uint8_t> bytecode, int16_t i32_register_count,
+             int16_t ref_register_count) {
+    BytecodeModuleDefT module_def;
+    module_def.name = "test";
+
+    auto type_def = std::make_unique<TypeDefT>();
+    type_def->full_name = "!vm.list<?>";
+    module_def.types.push_back(std::move(type_def));
+
+    auto function_def = std::make_unique<InternalFunctionDefT>();
+    function_def->local_name = "fn";
+    function_def->signature = std::make_unique<FunctionSignatureDefT>();
+    module_def.internal_functions.push_back(std::move(function_def));
+    auto export_def = std::make_unique<ExportFunctionDefT>();
+    export_def->local_name = "fn";
+    export_def->signature = std::make_unique<FunctionSignatureDefT>();
+    export_def->internal_ordinal = 0;
+    module_def.exported_functions.push_back(std::move(export_def));
+
+    module_def.module_state = std::make_unique<ModuleStateDefT>();
+    module_def.module_state->global_ref_count = 1;
+
+    module_def.function_descriptors.push_back(FunctionDescriptor(
+        /*bytecode_offset=*/0,
+        /*bytecode_length=*/static_cast<int32_t>(bytecode.size()),
+        i32_register_count, ref_register_count));
+    module_def.bytecode_data = std::move(bytecode);
+
+    ::flatbuffers::FlatBufferBuilder fbb;
+    FinishBytecodeModuleDefBuffer(fbb,
+                                  BytecodeModuleDef::Pack(fbb, &module_def));
+    data_.assign(fbb.GetBufferPointer(),
+                 fbb.GetBufferPointer() + fbb.GetSize());
+  }
+
+  iree_const_byte_span_t data() const {
+    return iree_const_byte_span_t{data_.data(), data_.size()};
+  }
+
+ private:
+  std::vector<uint8_t> data_;
+};
+
+class BytecodeModuleTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    IREE_CHECK_OK(iree_vm_register_builtin_types());
+  }
+
+  void TearDown() override { iree_vm_module_release(module_); }
+
+  // Creates |module_| from |test_module|, which must outlive the module.
+  Status CreateModule(const TestModule& test_module) {
+    return iree_vm_bytecode_module_create(test_module.data(),
+                                          iree_allocator_null(),
+                                          iree_allocator_system(), &module_);
+  }
+
+  // Invokes the exported `fn` of |module_| in a new context.
+  Status InvokeModule() {
+    iree_vm_instance_t* instance = nullptr;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_instance_create(iree_allocator_system(), &instance));
+    iree_vm_context_t* context = nullptr;
+    iree_status_t status = iree_vm_context_create_with_modules(
+        instance, &module_, 1, iree_allocator_system(), &context);
+    iree_vm_function_t function;
+    if (iree_status_is_ok(status)) {
+      status = module_->lookup_function(
+          module_->self, IREE_VM_FUNCTION_LINKAGE_EXPORT,
+          iree_make_cstring_view("fn"), &function);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_vm_invoke(context, function, /*policy=*/nullptr,
+                              /*inputs=*/nullptr, /*outputs=*/nullptr,
+                              iree_allocator_system());
+    }
+    iree_vm_context_release(context);
+    iree_vm_instance_release(instance);
+    return status;
+  }
+
+  iree_vm_module_t* module_ = nullptr;
+};
+
+TEST_F(BytecodeModuleTest, ValidBytecode) {
+  TestModule test_module(
+      BytecodeBuilder().ConstI32(1, 0).AddI32(0, 0, 1).Return().Build(),
+      /*i32_register_count=*/2, /*ref_register_count=*/0);
+  IREE_ASSERT_OK(CreateModule(test_module));
+  IREE_EXPECT_OK(InvokeModule());
+}
+
+TEST_F(BytecodeModuleTest, TruncatedInstruction) {
+  std::vector<uint8_t> bytecode = BytecodeBuilder().Return().Build();
+  bytecode.pop_back();
+  TestModule test_module(std::move(bytecode), 0, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, ReservedOpcode) {
+#define IREE_VM_TEST_IGNORE_OPC(opcode, name)
+#define IREE_VM_TEST_RESERVED_OPC(opcode) opcode,
+  const uint8_t kReservedOpcodes[] = {IREE_VM_OP_CORE_TABLE(
+      IREE_VM_TEST_IGNORE_OPC, IREE_VM_TEST_RESERVED_OPC)};
+#undef IREE_VM_TEST_IGNORE_OPC
+#undef IREE_VM_TEST_RESERVED_OPC
+  for (uint8_t opcode : kReservedOpcodes) {
+    TestModule test_module(BytecodeBuilder().Op(opcode).Return().Build(), 0,
+                           0);
+    EXPECT_THAT(CreateModule(test_module),
+                StatusIs(StatusCode::kInvalidArgument))
+        << "opcode " << static_cast<int>(opcode);
+  }
+}
+
+// Superinstructions are formed by the runtime when a module is loaded and are
+// never valid in the module bytecode itself.
+TEST_F(BytecodeModuleTest, SuperinstructionOpcode) {
+  const uint8_t kSuperinstructionOpcodes[] = {
+      IREE_VM_OP_CORE_CmpEQI32CondBranch,  IREE_VM_OP_CORE_CmpNEI32CondBranch,
+      IREE_VM_OP_CORE_CmpLTI32SCondBranch, IREE_VM_OP_CORE_CmpLTI32UCondBranch,
+      IREE_VM_OP_CORE_CmpNZI32CondBranch,  IREE_VM_OP_CORE_ConstI32AddI32,
+      IREE_VM_OP_CORE_AddI32Branch,
+  };
+  for (uint8_t opcode : kSuperinstructionOpcodes) {
+    // Replaces the vm.const.i32 opcode so that the pair is otherwise exactly
+    // what the runtime would have fused.
+    std::vector<uint8_t> bytecode =
+        BytecodeBuilder().ConstI32(1, 0).AddI32(0, 0, 1).Return().Build();
+    bytecode[0] = opcode;
+    TestModule test_module(std::move(bytecode), 2, 0);
+    EXPECT_THAT(CreateModule(test_module),
+                StatusIs(StatusCode::kInvalidArgument))
+        << "opcode " << static_cast<int>(opcode);
+  }
+}
+
+TEST_F(BytecodeModuleTest, MissingTerminator) {
+  TestModule test_module(BytecodeBuilder().ConstI32(1, 0).Build(), 1, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, BranchTargetOutOfRange) {
+  TestModule test_module(BytecodeBuilder().Branch(0x1000).Build(), 0, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, NegativeBranchTarget) {
+  TestModule test_module(BytecodeBuilder().Branch(0xFFFFFFFFu).Build(), 0, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, BranchTargetInsideInstruction) {
+  // Offset 1 is the immediate of the vm.const.i32 at offset 0.
+  TestModule test_module(
+      BytecodeBuilder().ConstI32(0, 0).CondBranch(0, 1, 0).Build(), 1, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, I32RegisterOutOfRange) {
+  TestModule test_module(BytecodeBuilder().ConstI32(1, 4).Return().Build(),
+                         /*i32_register_count=*/4, 0);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, RefRegisterForI32Operand) {
+  TestModule test_module(
+      BytecodeBuilder().ConstI32(1, kRefRegisterTypeBit | 0).Return().Build(),
+      1, 1);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, RefRegisterOutOfRange) {
+  TestModule test_module(BytecodeBuilder()
+                             .ConstI32(0, 0)
+                             .Op(IREE_VM_OP_CORE_GlobalLoadIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/0)
+                             .Reg(kRefRegisterTypeBit | 1)
+                             .Return()
+                             .Build(),
+                         1, /*ref_register_count=*/1);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(BytecodeModuleTest, TypeOrdinalOutOfRange) {
+  TestModule test_module(BytecodeBuilder()
+                             .ConstI32(0, 0)
+                             .Op(IREE_VM_OP_CORE_GlobalLoadIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/1)
+                             .Reg(kRefRegisterTypeBit | 0)
+                             .Return()
+                             .Build(),
+                         1, 1);
+  EXPECT_THAT(CreateModule(test_module),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Indirect global ordinals come from registers and can only be checked when
+// the op executes.
+TEST_F(BytecodeModuleTest, LoadIndirectRefOutOfRange) {
+  TestModule test_module(BytecodeBuilder()
+                             .ConstI32(/*global=*/1, 0)
+                             .Op(IREE_VM_OP_CORE_GlobalLoadIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/0)
+                             .Reg(kRefRegisterTypeBit | 0)
+                             .Return()
+                             .Build(),
+                         1, 1);
+  IREE_ASSERT_OK(CreateModule(test_module));
+  EXPECT_THAT(InvokeModule(), StatusIs(StatusCode::kOutOfRange));
+}
+
+TEST_F(BytecodeModuleTest, StoreIndirectRefOutOfRange) {
+  TestModule test_module(BytecodeBuilder()
+                             .ConstI32(/*global=*/0x7FFFFFFF, 0)
+                             .Op(IREE_VM_OP_CORE_GlobalStoreIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/0)
+                             .Reg(kRefRegisterTypeBit | 0)
+                             .Return()
+                             .Build(),
+                         1, 1);
+  IREE_ASSERT_OK(CreateModule(test_module));
+  EXPECT_THAT(InvokeModule(), StatusIs(StatusCode::kOutOfRange));
+}
+
+TEST_F(BytecodeModuleTest, LoadStoreIndirectRefInRange) {
+  TestModule test_module(BytecodeBuilder()
+                             .ConstI32(/*global=*/0, 0)
+                             .Op(IREE_VM_OP_CORE_GlobalStoreIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/0)
+                             .Reg(kRefRegisterTypeBit | 0)
+                             .Op(IREE_VM_OP_CORE_GlobalLoadIndirectRef)
+                             .Reg(0)
+                             .I32(/*type=*/0)
+                             .Reg(kRefRegisterTypeBit | 0)
+                             .Return()
+                             .Build(),
+                         1, 1);
+  IREE_ASSERT_OK(CreateModule(test_module));
+  IREE_EXPECT_OK(InvokeModule());
+}
 
 }  // namespace
+}  // namespace vm
+}  // namespace iree
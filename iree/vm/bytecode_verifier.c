@@ -0,0 +1,870 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/bytecode_module_impl.h"
+#include "iree/vm/bytecode_op_table.h"
+
+//===----------------------------------------------------------------------===//
+// Operand encoding tables
+//===----------------------------------------------------------------------===//
+// Each opcode maps to a string describing the values that follow it in the
+// bytecode as generated from the VM_Enc* statements in VMBase.td. See
+// VMOpTableGen.cpp for the format. Opcodes without an encoding are reserved
+// and invalid in bytecode.
+
+#define IREE_VM_OP_ENCODING(opcode, name, encoding) [opcode] = encoding,
+static const char* const iree_vm_op_core_encodings[256] = {
+    IREE_VM_OP_CORE_ENCODING_TABLE(IREE_VM_OP_ENCODING)};
+static const char* const iree_vm_op_ext_i64_encodings[256] = {
+    IREE_VM_OP_EXT_I64_ENCODING_TABLE(IREE_VM_OP_ENCODING)};
+static const char* const iree_vm_op_ext_f32_encodings[256] = {
+    IREE_VM_OP_EXT_F32_ENCODING_TABLE(IREE_VM_OP_ENCODING)};
+static const char* const iree_vm_op_ext_f64_encodings[256] = {
+    IREE_VM_OP_EXT_F64_ENCODING_TABLE(IREE_VM_OP_ENCODING)};
+#undef IREE_VM_OP_ENCODING
+
+//===----------------------------------------------------------------------===//
+// Verifier state
+//===----------------------------------------------------------------------===//
+
+typedef struct {
+  // Module-level ordinal ranges.
+  iree_vm_ImportFunctionDef_vec_t imported_functions;
+  iree_vm_InternalFunctionDef_vec_t internal_functions;
+  iree_host_size_t import_count;
+  iree_host_size_t function_count;
+  iree_host_size_t type_count;
+  iree_host_size_t rodata_count;
+  iree_host_size_t global_bytes_capacity;
+  iree_host_size_t global_ref_count;
+
+  // Function currently being verified.
+  iree_host_size_t function_ordinal;
+  const uint8_t* bytecode_data;
+  iree_host_size_t bytecode_length;
+  iree_host_size_t i32_register_count;
+  iree_host_size_t ref_register_count;
+  iree_string_view_t cconv_results;
+
+  // Bitmap with one bit per byte of the function bytecode that is set if an
+  // instruction begins at that offset.
+  uint8_t* instruction_starts;
+
+  // Writable copy of the function bytecode that fused instructions are
+  // written to or NULL if superinstructions are not being formed.
+  uint8_t* fused_bytecode_data;
+} iree_vm_bytecode_verifier_t;
+
+// Values decoded from an instruction that are checked against each other once
+// all operands have been verified.
+typedef struct {
+  // Function ordinal (`f`), if any.
+  uint32_t function;
+  // Start of the last integer array (`a`), if any.
+  const uint8_t* int_array;
+  // Start of each pair of split register lists (`V`), if any.
+  iree_host_size_t split_list_count;
+  const uint8_t* split_lists[2];
+} iree_vm_bytecode_operands_t;
+
+static inline uint16_t iree_vm_bytecode_read_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t iree_vm_bytecode_read_u32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+//===----------------------------------------------------------------------===//
+// Operand verification
+//===----------------------------------------------------------------------===//
+
+// Ensures |size| bytes are available at |pc| within the function bytecode.
+static iree_status_t iree_vm_bytecode_verify_available(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc,
+    iree_host_size_t pc, iree_host_size_t size) {
+  if (IREE_UNLIKELY(pc > v->bytecode_length ||
+                    v->bytecode_length - pc < size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu]@%zu: instruction truncated",
+                            v->function_ordinal, op_pc);
+  }
+  return iree_ok_status();
+}
+
+// Verifies that |reg| is a valid register of |kind| (`i`, `I`, `r`, or `*`).
+// i64 registers span two i32 registers and must be aligned to an even ordinal.
+static iree_status_t iree_vm_bytecode_verify_register(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc, uint16_t reg,
+    char kind) {
+  if (kind == '*') {
+    kind = (reg & IREE_REF_REGISTER_TYPE_BIT) ? 'r' : 'i';
+  }
+  switch (kind) {
+    case 'i':
+    case 'I': {
+      if (IREE_UNLIKELY(reg & IREE_REF_REGISTER_TYPE_BIT)) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "functions[%zu]@%zu: expected i32 register, "
+                                "got ref register %04X",
+                                v->function_ordinal, op_pc, reg);
+      }
+      iree_host_size_t register_span = kind == 'I' ? 2 : 1;
+      if (IREE_UNLIKELY(kind == 'I' && (reg & 1))) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "functions[%zu]@%zu: i64 register %u unaligned",
+                                v->function_ordinal, op_pc, reg);
+      }
+      if (IREE_UNLIKELY(reg + register_span > v->i32_register_count)) {
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "functions[%zu]@%zu: i32 register %u out of range (%zu)",
+            v->function_ordinal, op_pc, reg, v->i32_register_count);
+      }
+      return iree_ok_status();
+    }
+    case 'r': {
+      if (IREE_UNLIKELY(!(reg & IREE_REF_REGISTER_TYPE_BIT))) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "functions[%zu]@%zu: expected ref register, "
+                                "got i32 register %u",
+                                v->function_ordinal, op_pc, reg);
+      }
+      if (IREE_UNLIKELY((reg & IREE_REF_REGISTER_MASK) >=
+                        v->ref_register_count)) {
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "functions[%zu]@%zu: ref register %u out of range (%zu)",
+            v->function_ordinal, op_pc, reg & IREE_REF_REGISTER_MASK,
+            v->ref_register_count);
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_INTERNAL,
+                              "unknown register kind '%c'", kind);
+  }
+}
+
+// Verifies a register list at |pc| with registers of |kind| and advances |pc|
+// past it.
+static iree_status_t iree_vm_bytecode_verify_register_list(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc, char kind,
+    iree_host_size_t* pc) {
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verify_available(v, op_pc, *pc, sizeof(uint16_t)));
+  uint16_t count = iree_vm_bytecode_read_u16(v->bytecode_data + *pc);
+  *pc += sizeof(uint16_t);
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_available(
+      v, op_pc, *pc, count * sizeof(uint16_t)));
+  for (uint16_t i = 0; i < count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_register(
+        v, op_pc, iree_vm_bytecode_read_u16(v->bytecode_data + *pc), kind));
+    *pc += sizeof(uint16_t);
+  }
+  return iree_ok_status();
+}
+
+// Verifies a branch register remap list at |pc| with src-dst register pairs of
+// |kind| and advances |pc| past it.
+static iree_status_t iree_vm_bytecode_verify_remap_list(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc, char kind,
+    iree_host_size_t* pc) {
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verify_available(v, op_pc, *pc, sizeof(uint16_t)));
+  uint16_t count = iree_vm_bytecode_read_u16(v->bytecode_data + *pc);
+  *pc += sizeof(uint16_t);
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_available(
+      v, op_pc, *pc, count * 2 * sizeof(uint16_t)));
+  for (uint16_t i = 0; i < count * 2; ++i) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_register(
+        v, op_pc, iree_vm_bytecode_read_u16(v->bytecode_data + *pc), kind));
+    *pc += sizeof(uint16_t);
+  }
+  return iree_ok_status();
+}
+
+// Verifies the operands described by |encoding| starting at |pc| and advances
+// |pc| past them. Branch targets are only checked if |check_branch_targets| is
+// set as all instruction starts must be known first.
+static iree_status_t iree_vm_bytecode_verify_operands(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc,
+    const char* encoding, bool check_branch_targets, iree_host_size_t* pc,
+    iree_vm_bytecode_operands_t* out_operands) {
+  const uint8_t* bytecode_data = v->bytecode_data;
+  for (const char* e = encoding; *e; ++e) {
+    switch (*e) {
+      case 'f': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 4));
+        uint32_t function = iree_vm_bytecode_read_u32(bytecode_data + *pc);
+        *pc += 4;
+        bool is_import = (function & 0x80000000u) != 0;
+        uint32_t ordinal = function & 0x7FFFFFFFu;
+        if (IREE_UNLIKELY(ordinal >= (is_import ? v->import_count
+                                                : v->function_count))) {
+          return iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "functions[%zu]@%zu: %s function ordinal %u out of range",
+              v->function_ordinal, op_pc, is_import ? "import" : "internal",
+              ordinal);
+        }
+        out_operands->function = function;
+      } break;
+      case 'G':
+      case 'H': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 4));
+        uint32_t byte_offset = iree_vm_bytecode_read_u32(bytecode_data + *pc);
+        *pc += 4;
+        iree_host_size_t byte_width = *e == 'H' ? 8 : 4;
+        if (IREE_UNLIKELY(byte_offset > v->global_bytes_capacity ||
+                          v->global_bytes_capacity - byte_offset <
+                              byte_width)) {
+          return iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "functions[%zu]@%zu: global byte_offset out of range: %u "
+              "(rwdata=%zu)",
+              v->function_ordinal, op_pc, byte_offset,
+              v->global_bytes_capacity);
+        }
+      } break;
+      case 'g':
+      case 'd':
+      case 't': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 4));
+        uint32_t ordinal = iree_vm_bytecode_read_u32(bytecode_data + *pc);
+        *pc += 4;
+        iree_host_size_t limit = *e == 'g'   ? v->global_ref_count
+                                 : *e == 'd' ? v->rodata_count
+                                             : v->type_count;
+        if (IREE_UNLIKELY(ordinal >= limit)) {
+          return iree_make_status(
+              IREE_STATUS_INVALID_ARGUMENT,
+              "functions[%zu]@%zu: %s ordinal %u out of range (%zu)",
+              v->function_ordinal, op_pc,
+              *e == 'g' ? "global" : *e == 'd' ? "rodata" : "type", ordinal,
+              limit);
+        }
+      } break;
+      case '1':
+      case '2':
+      case '4':
+      case '8': {
+        iree_host_size_t size = *e - '0';
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, size));
+        *pc += size;
+      } break;
+      case 'a': {
+        iree_host_size_t element_size = *(++e) - '0';
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 2));
+        out_operands->int_array = bytecode_data + *pc;
+        uint16_t count = iree_vm_bytecode_read_u16(bytecode_data + *pc);
+        *pc += 2;
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_available(
+            v, op_pc, *pc, count * element_size));
+        *pc += count * element_size;
+      } break;
+      case 's': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 2));
+        uint16_t length = iree_vm_bytecode_read_u16(bytecode_data + *pc);
+        *pc += 2;
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, length));
+        *pc += length;
+      } break;
+      case 'b': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 4));
+        int32_t target =
+            (int32_t)iree_vm_bytecode_read_u32(bytecode_data + *pc);
+        *pc += 4;
+        if (check_branch_targets &&
+            (IREE_UNLIKELY(target < 0) ||
+             IREE_UNLIKELY((iree_host_size_t)target >= v->bytecode_length) ||
+             IREE_UNLIKELY(!(v->instruction_starts[target / 8] &
+                             (1u << (target % 8)))))) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "functions[%zu]@%zu: branch target %d is "
+                                  "not the start of an instruction",
+                                  v->function_ordinal, op_pc, target);
+        }
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_remap_list(v, op_pc, 'i', pc));
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_remap_list(v, op_pc, 'r', pc));
+      } break;
+      case 'i':
+      case 'I':
+      case 'r': {
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_available(v, op_pc, *pc, 2));
+        IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_register(
+            v, op_pc, iree_vm_bytecode_read_u16(bytecode_data + *pc), *e));
+        *pc += 2;
+      } break;
+      case 'v': {
+        char kind = *(++e);
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_register_list(v, op_pc, kind, pc));
+      } break;
+      case 'V': {
+        if (out_operands->split_list_count <
+            IREE_ARRAYSIZE(out_operands->split_lists)) {
+          out_operands->split_lists[out_operands->split_list_count++] =
+              bytecode_data + *pc;
+        }
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_register_list(v, op_pc, 'i', pc));
+        IREE_RETURN_IF_ERROR(
+            iree_vm_bytecode_verify_register_list(v, op_pc, 'r', pc));
+      } break;
+      default:
+        return iree_make_status(IREE_STATUS_INTERNAL,
+                                "unknown operand encoding '%c'", *e);
+    }
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Calling convention verification
+//===----------------------------------------------------------------------===//
+
+// Returns the argument and result fragments of the cconv of |signature_def|.
+static iree_status_t iree_vm_bytecode_get_cconv_fragments(
+    iree_vm_FunctionSignatureDef_table_t signature_def,
+    iree_string_view_t* out_arguments, iree_string_view_t* out_results) {
+  iree_vm_function_signature_t signature;
+  memset(&signature, 0, sizeof(signature));
+  flatbuffers_string_t calling_convention =
+      signature_def
+          ? iree_vm_FunctionSignatureDef_calling_convention(signature_def)
+          : NULL;
+  if (calling_convention) {
+    signature.calling_convention = iree_make_string_view(
+        calling_convention, flatbuffers_string_len(calling_convention));
+  }
+  return iree_vm_function_call_get_cconv_fragments(&signature, out_arguments,
+                                                   out_results);
+}
+
+// Returns the argument and result cconv fragments of the callee |function| as
+// encoded in the bytecode (with the high bit set for imports).
+static iree_status_t iree_vm_bytecode_get_callee_cconv_fragments(
+    const iree_vm_bytecode_verifier_t* v, uint32_t function,
+    iree_string_view_t* out_arguments, iree_string_view_t* out_results) {
+  uint32_t ordinal = function & 0x7FFFFFFFu;
+  iree_vm_FunctionSignatureDef_table_t signature_def =
+      (function & 0x80000000u)
+          ? iree_vm_ImportFunctionDef_signature(
+                iree_vm_ImportFunctionDef_vec_at(v->imported_functions,
+                                                 ordinal))
+          : iree_vm_InternalFunctionDef_signature(
+                iree_vm_InternalFunctionDef_vec_at(v->internal_functions,
+                                                   ordinal));
+  return iree_vm_bytecode_get_cconv_fragments(signature_def, out_arguments,
+                                              out_results);
+}
+
+// Verifies that the split i32/ref register lists at |split_lists| match the
+// value types of the non-variadic |cconv| fragment 1:1.
+static iree_status_t iree_vm_bytecode_verify_cconv_registers(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc,
+    iree_string_view_t cconv, const uint8_t* split_lists) {
+  uint16_t i32_count = iree_vm_bytecode_read_u16(split_lists);
+  const uint8_t* i32_registers = split_lists + sizeof(uint16_t);
+  const uint8_t* ref_list = i32_registers + i32_count * sizeof(uint16_t);
+  uint16_t ref_count = iree_vm_bytecode_read_u16(ref_list);
+  uint16_t i32_i = 0;
+  uint16_t ref_i = 0;
+  for (iree_host_size_t i = 0; i < cconv.size; ++i) {
+    switch (cconv.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32:
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64: {
+        if (i32_i < i32_count) {
+          char kind = (cconv.data[i] == IREE_VM_CCONV_TYPE_INT64 ||
+                       cconv.data[i] == IREE_VM_CCONV_TYPE_F64)
+                          ? 'I'
+                          : 'i';
+          IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_register(
+              v, op_pc,
+              iree_vm_bytecode_read_u16(i32_registers +
+                                        i32_i * sizeof(uint16_t)),
+              kind));
+        }
+        ++i32_i;
+      } break;
+      case IREE_VM_CCONV_TYPE_REF:
+        // Ref list types were verified when decoding the split lists.
+        ++ref_i;
+        break;
+      default:
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "functions[%zu]@%zu: unsupported cconv type '%c' in '%.*s'",
+            v->function_ordinal, op_pc, cconv.data[i], (int)cconv.size,
+            cconv.data);
+    }
+  }
+  if (IREE_UNLIKELY(i32_i != i32_count) || IREE_UNLIKELY(ref_i != ref_count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu]@%zu: register lists (%u i32, %u "
+                            "ref) do not match cconv '%.*s'",
+                            v->function_ordinal, op_pc, i32_count, ref_count,
+                            (int)cconv.size, cconv.data);
+  }
+  return iree_ok_status();
+}
+
+// Verifies that the split i32/ref register lists at |split_lists| contain the
+// number of values required by the variadic |cconv| fragment when expanded
+// with the per-argument |segment_sizes| array.
+static iree_status_t iree_vm_bytecode_verify_variadic_cconv_registers(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc,
+    iree_string_view_t cconv, const uint8_t* segment_sizes,
+    const uint8_t* split_lists) {
+  uint16_t segment_count =
+      segment_sizes ? iree_vm_bytecode_read_u16(segment_sizes) : 0;
+  iree_host_size_t i32_required = 0;
+  iree_host_size_t ref_required = 0;
+  // NOTE: segments are indexed by cconv character to match
+  // iree_vm_bytecode_populate_import_cconv_arguments.
+  for (iree_host_size_t i = 0, seg_i = 0; i < cconv.size; ++i, ++seg_i) {
+    switch (cconv.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32:
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64:
+        ++i32_required;
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        ++ref_required;
+        break;
+      case IREE_VM_CCONV_TYPE_SPAN_START: {
+        if (IREE_UNLIKELY(seg_i >= segment_count)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "functions[%zu]@%zu: variadic argument "
+                                  "missing segment size",
+                                  v->function_ordinal, op_pc);
+        }
+        int16_t span_count = (int16_t)iree_vm_bytecode_read_u16(
+            segment_sizes + sizeof(uint16_t) + seg_i * sizeof(uint16_t));
+        if (IREE_UNLIKELY(span_count < 0)) {
+          return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "functions[%zu]@%zu: negative variadic "
+                                  "segment size",
+                                  v->function_ordinal, op_pc);
+        }
+        iree_host_size_t span_i32_count = 0;
+        iree_host_size_t span_ref_count = 0;
+        for (++i; i < cconv.size &&
+                  cconv.data[i] != IREE_VM_CCONV_TYPE_SPAN_END;
+             ++i) {
+          if (cconv.data[i] == IREE_VM_CCONV_TYPE_REF) {
+            ++span_ref_count;
+          } else {
+            ++span_i32_count;
+          }
+        }
+        i32_required += span_i32_count * span_count;
+        ref_required += span_ref_count * span_count;
+      } break;
+      default:
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "functions[%zu]@%zu: unsupported cconv type '%c' in '%.*s'",
+            v->function_ordinal, op_pc, cconv.data[i], (int)cconv.size,
+            cconv.data);
+    }
+  }
+  uint16_t i32_count = iree_vm_bytecode_read_u16(split_lists);
+  uint16_t ref_count = iree_vm_bytecode_read_u16(
+      split_lists + sizeof(uint16_t) + i32_count * sizeof(uint16_t));
+  if (IREE_UNLIKELY(i32_count != i32_required) ||
+      IREE_UNLIKELY(ref_count != ref_required)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu]@%zu: register lists (%u i32, %u "
+                            "ref) do not match variadic cconv '%.*s'",
+                            v->function_ordinal, op_pc, i32_count, ref_count,
+                            (int)cconv.size, cconv.data);
+  }
+  return iree_ok_status();
+}
+
+// Verifies that call and return register lists match the cconv of the callee
+// or current function.
+static iree_status_t iree_vm_bytecode_verify_call_operands(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t op_pc,
+    uint8_t opcode, const iree_vm_bytecode_operands_t* operands) {
+  iree_host_size_t expected_split_list_count =
+      opcode == IREE_VM_OP_CORE_Return ? 1 : 2;
+  if (IREE_UNLIKELY(operands->split_list_count != expected_split_list_count)) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "op table encoding mismatch for opcode %02X",
+                            opcode);
+  }
+  if (opcode == IREE_VM_OP_CORE_Return) {
+    return iree_vm_bytecode_verify_cconv_registers(
+        v, op_pc, v->cconv_results, operands->split_lists[0]);
+  }
+
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_get_callee_cconv_fragments(
+      v, operands->function, &cconv_arguments, &cconv_results));
+  bool is_variadic = iree_vm_function_call_is_variadic_cconv(cconv_arguments);
+  if (opcode == IREE_VM_OP_CORE_CallVariadic) {
+    // Variadic calls are currently only supported for import functions.
+    if (IREE_UNLIKELY(!(operands->function & 0x80000000u))) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "functions[%zu]@%zu: variadic calls only "
+                              "supported for import callees",
+                              v->function_ordinal, op_pc);
+    }
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_variadic_cconv_registers(
+        v, op_pc, cconv_arguments, operands->int_array,
+        operands->split_lists[0]));
+  } else if (IREE_UNLIKELY(is_variadic)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu]@%zu: variadic callee requires a "
+                            "variadic call",
+                            v->function_ordinal, op_pc);
+  } else {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_cconv_registers(
+        v, op_pc, cconv_arguments, operands->split_lists[0]));
+  }
+  return iree_vm_bytecode_verify_cconv_registers(v, op_pc, cconv_results,
+                                                 operands->split_lists[1]);
+}
+
+//===----------------------------------------------------------------------===//
+// Superinstruction formation
+//===----------------------------------------------------------------------===//
+
+// Returns the offset of the instruction following the one at |pc| or the
+// bytecode length if it is the last instruction.
+static iree_host_size_t iree_vm_bytecode_next_instruction(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t pc) {
+  do {
+    ++pc;
+  } while (pc < v->bytecode_length &&
+           !(v->instruction_starts[pc / 8] & (1u << (pc % 8))));
+  return pc;
+}
+
+// Returns the superinstruction that executes the instruction at |pc| followed
+// by the one at |next_pc| or 0 if the pair cannot be fused.
+static uint8_t iree_vm_bytecode_select_superinstruction(
+    const iree_vm_bytecode_verifier_t* v, iree_host_size_t pc,
+    iree_host_size_t next_pc) {
+  const uint8_t* bytecode_data = v->bytecode_data;
+  uint8_t superinstruction = 0;
+  switch (bytecode_data[next_pc]) {
+    case IREE_VM_OP_CORE_CondBranch:
+      switch (bytecode_data[pc]) {
+        case IREE_VM_OP_CORE_CmpEQI32:
+          superinstruction = IREE_VM_OP_CORE_CmpEQI32CondBranch;
+          break;
+        case IREE_VM_OP_CORE_CmpNEI32:
+          superinstruction = IREE_VM_OP_CORE_CmpNEI32CondBranch;
+          break;
+        case IREE_VM_OP_CORE_CmpLTI32S:
+          superinstruction = IREE_VM_OP_CORE_CmpLTI32SCondBranch;
+          break;
+        case IREE_VM_OP_CORE_CmpLTI32U:
+          superinstruction = IREE_VM_OP_CORE_CmpLTI32UCondBranch;
+          break;
+        case IREE_VM_OP_CORE_CmpNZI32:
+          superinstruction = IREE_VM_OP_CORE_CmpNZI32CondBranch;
+          break;
+        default:
+          return 0;
+      }
+      // The fused handler branches on the comparison result directly so the
+      // condition must be the result register (the last comparison operand).
+      if (iree_vm_bytecode_read_u16(bytecode_data + next_pc - 2) !=
+          iree_vm_bytecode_read_u16(bytecode_data + next_pc + 1)) {
+        return 0;
+      }
+      return superinstruction;
+    case IREE_VM_OP_CORE_AddI32:
+      return bytecode_data[pc] == IREE_VM_OP_CORE_ConstI32
+                 ? IREE_VM_OP_CORE_ConstI32AddI32
+                 : 0;
+    case IREE_VM_OP_CORE_Branch:
+      return bytecode_data[pc] == IREE_VM_OP_CORE_AddI32
+                 ? IREE_VM_OP_CORE_AddI32Branch
+                 : 0;
+    default:
+      return 0;
+  }
+}
+
+// Rewrites the opcodes of fusable instruction pairs in the verified function
+// into superinstructions. Only the opcode of the first instruction is changed
+// so instruction offsets (and any branches to the second instruction) remain
+// valid. Pairs are formed greedily from the start of the function and never
+// overlap.
+static void iree_vm_bytecode_form_superinstructions(
+    const iree_vm_bytecode_verifier_t* v) {
+  iree_host_size_t pc = 0;
+  while (pc < v->bytecode_length) {
+    iree_host_size_t next_pc = iree_vm_bytecode_next_instruction(v, pc);
+    if (next_pc >= v->bytecode_length) break;
+    uint8_t superinstruction =
+        iree_vm_bytecode_select_superinstruction(v, pc, next_pc);
+    if (superinstruction) {
+      v->fused_bytecode_data[pc] = superinstruction;
+      pc = iree_vm_bytecode_next_instruction(v, next_pc);
+    } else {
+      pc = next_pc;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Function verification
+//===----------------------------------------------------------------------===//
+
+// Verifies the instruction at |pc| and advances |pc| past it.
+// |out_opcode| receives the core opcode (which may be an extension prefix).
+static iree_status_t iree_vm_bytecode_verify_instruction(
+    const iree_vm_bytecode_verifier_t* v, bool check_branch_targets,
+    iree_host_size_t* pc, uint8_t* out_opcode) {
+  iree_host_size_t op_pc = *pc;
+  uint8_t opcode = v->bytecode_data[(*pc)++];
+  *out_opcode = opcode;
+
+  const char* const* ext_encodings = NULL;
+  switch (opcode) {
+    case IREE_VM_OP_CORE_PrefixExtI64:
+      ext_encodings = iree_vm_op_ext_i64_encodings;
+      break;
+    case IREE_VM_OP_CORE_PrefixExtF32:
+      ext_encodings = iree_vm_op_ext_f32_encodings;
+      break;
+    case IREE_VM_OP_CORE_PrefixExtF64:
+      ext_encodings = iree_vm_op_ext_f64_encodings;
+      break;
+    default:
+      break;
+  }
+  const char* encoding = iree_vm_op_core_encodings[opcode];
+  uint8_t ext_opcode = 0;
+  if (ext_encodings) {
+    IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_available(v, op_pc, *pc, 1));
+    ext_opcode = v->bytecode_data[(*pc)++];
+    encoding = ext_encodings[ext_opcode];
+  }
+  if (IREE_UNLIKELY(!encoding)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu]@%zu: invalid opcode %02X %02X",
+                            v->function_ordinal, op_pc, opcode, ext_opcode);
+  }
+
+  iree_vm_bytecode_operands_t operands;
+  memset(&operands, 0, sizeof(operands));
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_operands(
+      v, op_pc, encoding, check_branch_targets, pc, &operands));
+
+  switch (opcode) {
+    case IREE_VM_OP_CORE_Call:
+    case IREE_VM_OP_CORE_CallVariadic:
+    case IREE_VM_OP_CORE_Return:
+      return iree_vm_bytecode_verify_call_operands(v, op_pc, opcode,
+                                                   &operands);
+    default:
+      return iree_ok_status();
+  }
+}
+
+// Verifies all instructions in the current function.
+// Must be called once with |check_branch_targets| false to populate the
+// instruction start bitmap prior to being called with it true.
+static iree_status_t iree_vm_bytecode_verify_instructions(
+    iree_vm_bytecode_verifier_t* v, bool check_branch_targets) {
+  iree_host_size_t pc = 0;
+  uint8_t opcode = 0;
+  while (pc < v->bytecode_length) {
+    if (!check_branch_targets) {
+      v->instruction_starts[pc / 8] |= (uint8_t)(1u << (pc % 8));
+    }
+    IREE_RETURN_IF_ERROR(
+        iree_vm_bytecode_verify_instruction(v, check_branch_targets, &pc,
+                                            &opcode));
+  }
+
+  // Execution must never run off the end of the function.
+  switch (opcode) {
+    case IREE_VM_OP_CORE_Return:
+    case IREE_VM_OP_CORE_Branch:
+    case IREE_VM_OP_CORE_CondBranch:
+    case IREE_VM_OP_CORE_Fail:
+    case IREE_VM_OP_CORE_Break:
+    case IREE_VM_OP_CORE_CondBreak:
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "functions[%zu] does not end in a terminator",
+                              v->function_ordinal);
+  }
+}
+
+// Verifies that the function arguments fit within its registers as they are
+// assigned by iree_vm_bytecode_external_enter and internal_enter.
+static iree_status_t iree_vm_bytecode_verify_function_arguments(
+    const iree_vm_bytecode_verifier_t* v, iree_string_view_t cconv_arguments) {
+  iree_host_size_t i32_count = 0;
+  iree_host_size_t ref_count = 0;
+  for (iree_host_size_t i = 0; i < cconv_arguments.size; ++i) {
+    switch (cconv_arguments.data[i]) {
+      case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32:
+        i32_count += 1;
+        break;
+      case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64:
+        i32_count += 2;
+        break;
+      case IREE_VM_CCONV_TYPE_REF:
+        ref_count += 1;
+        break;
+      default:
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "functions[%zu] unsupported cconv argument type '%c'",
+            v->function_ordinal, cconv_arguments.data[i]);
+    }
+  }
+  if (IREE_UNLIKELY(i32_count > v->i32_register_count) ||
+      IREE_UNLIKELY(ref_count > v->ref_register_count)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu] arguments exceed register counts",
+                            v->function_ordinal);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_vm_bytecode_verify_function(
+    iree_vm_bytecode_verifier_t* v,
+    iree_vm_FunctionDescriptor_vec_t function_descriptors,
+    flatbuffers_uint8_vec_t bytecode_data, uint8_t* fused_bytecode_data,
+    iree_host_size_t function_ordinal) {
+  const iree_vm_FunctionDescriptor_t* function_descriptor =
+      iree_vm_FunctionDescriptor_vec_at(function_descriptors, function_ordinal);
+  v->function_ordinal = function_ordinal;
+  if (function_descriptor->bytecode_length <= 0 ||
+      function_descriptor->i32_register_count < 0 ||
+      function_descriptor->ref_register_count < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "functions[%zu] descriptor invalid",
+                            function_ordinal);
+  }
+  v->bytecode_data = bytecode_data + function_descriptor->bytecode_offset;
+  v->fused_bytecode_data =
+      fused_bytecode_data
+          ? fused_bytecode_data + function_descriptor->bytecode_offset
+          : NULL;
+  v->bytecode_length = function_descriptor->bytecode_length;
+  v->i32_register_count = function_descriptor->i32_register_count;
+  v->ref_register_count = function_descriptor->ref_register_count;
+
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_get_cconv_fragments(
+      iree_vm_InternalFunctionDef_signature(iree_vm_InternalFunctionDef_vec_at(
+          v->internal_functions, function_ordinal)),
+      &cconv_arguments, &v->cconv_results));
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verify_function_arguments(v, cconv_arguments));
+
+  memset(v->instruction_starts, 0, (v->bytecode_length + 7) / 8);
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_verify_instructions(
+      v, /*check_branch_targets=*/false));
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_verify_instructions(v, /*check_branch_targets=*/true));
+
+  if (v->fused_bytecode_data) {
+    iree_vm_bytecode_form_superinstructions(v);
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_vm_bytecode_module_verify_bytecode(
+    iree_vm_BytecodeModuleDef_table_t module_def,
+    iree_byte_span_t fused_bytecode_data, iree_allocator_t allocator) {
+  iree_vm_bytecode_verifier_t verifier;
+  memset(&verifier, 0, sizeof(verifier));
+  verifier.imported_functions =
+      iree_vm_BytecodeModuleDef_imported_functions(module_def);
+  verifier.internal_functions =
+      iree_vm_BytecodeModuleDef_internal_functions(module_def);
+  verifier.import_count =
+      iree_vm_ImportFunctionDef_vec_len(verifier.imported_functions);
+  verifier.function_count =
+      iree_vm_InternalFunctionDef_vec_len(verifier.internal_functions);
+  verifier.type_count =
+      iree_vm_TypeDef_vec_len(iree_vm_BytecodeModuleDef_types(module_def));
+  verifier.rodata_count = iree_vm_RodataSegmentDef_vec_len(
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def));
+  iree_vm_ModuleStateDef_table_t module_state =
+      iree_vm_BytecodeModuleDef_module_state(module_def);
+  if (module_state) {
+    int32_t global_bytes_capacity =
+        iree_vm_ModuleStateDef_global_bytes_capacity(module_state);
+    int32_t global_ref_count =
+        iree_vm_ModuleStateDef_global_ref_count(module_state);
+    verifier.global_bytes_capacity = VMMAX(0, global_bytes_capacity);
+    verifier.global_ref_count = VMMAX(0, global_ref_count);
+  }
+
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+
+  // Share a single instruction start bitmap sized for the largest function.
+  iree_host_size_t max_bytecode_length = 0;
+  for (iree_host_size_t i = 0; i < verifier.function_count; ++i) {
+    int32_t bytecode_length =
+        iree_vm_FunctionDescriptor_vec_at(function_descriptors, i)
+            ->bytecode_length;
+    max_bytecode_length = VMMAX(max_bytecode_length,
+                                (iree_host_size_t)VMMAX(0, bytecode_length));
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, (max_bytecode_length + 7) / 8 + 1,
+                            (void**)&verifier.instruction_starts));
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < verifier.function_count; ++i) {
+    status = iree_vm_bytecode_verify_function(
+        &verifier, function_descriptors, bytecode_data,
+        fused_bytecode_data.data_length ? fused_bytecode_data.data : NULL, i);
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  iree_allocator_free(allocator, verifier.instruction_starts);
+  return status;
+}
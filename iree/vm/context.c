@@ -58,10 +58,14 @@ static iree_status_t iree_vm_context_run_function(
     return status;
   }
 
+  // Initializers are expected to be short so any yields are resumed
+  // immediately such that the context is fully initialized upon return.
   iree_vm_execution_result_t result;
   status = module->begin_call(module->self, stack, &call, &result);
-
-  // TODO(benvanik): ensure completed synchronously.
+  while (iree_status_is_ok(status) &&
+         result.state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    status = module->resume_call(module->self, stack, &result);
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -15,7 +15,9 @@
 #include "iree/vm/invocation.h"
 
 #include "iree/base/api.h"
+#include "iree/base/atomics.h"
 #include "iree/base/tracing.h"
+#include "iree/vm/stack.h"
 
 // Marshals caller arguments from the variant list to the ABI convention.
 static iree_status_t iree_vm_invoke_marshal_inputs(
@@ -55,6 +57,20 @@ static iree_status_t iree_vm_invoke_marshal_inputs(
         memcpy(p, &value.i64, sizeof(int64_t));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_F32: {
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            inputs, arg_i, IREE_VM_VALUE_TYPE_F32, &value));
+        memcpy(p, &value.f32, sizeof(float));
+        p += sizeof(float);
+      } break;
+      case IREE_VM_CCONV_TYPE_F64: {
+        iree_vm_value_t value;
+        IREE_RETURN_IF_ERROR(iree_vm_list_get_value_as(
+            inputs, arg_i, IREE_VM_VALUE_TYPE_F64, &value));
+        memcpy(p, &value.f64, sizeof(double));
+        p += sizeof(double);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         // TODO(benvanik): see if we can't remove this retain by instead relying
         // on the caller still owning the list.
@@ -99,6 +115,16 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
         IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
         p += sizeof(int64_t);
       } break;
+      case IREE_VM_CCONV_TYPE_F32: {
+        iree_vm_value_t value = iree_vm_value_make_f32(*(float*)p);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
+        p += sizeof(float);
+      } break;
+      case IREE_VM_CCONV_TYPE_F64: {
+        iree_vm_value_t value = iree_vm_value_make_f64(*(double*)p);
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_value(outputs, arg_i, &value));
+        p += sizeof(double);
+      } break;
       case IREE_VM_CCONV_TYPE_REF: {
         IREE_RETURN_IF_ERROR(
             iree_vm_list_set_ref_move(outputs, arg_i, (iree_vm_ref_t*)p));
@@ -109,7 +135,20 @@ static iree_status_t iree_vm_invoke_marshal_outputs(
   return iree_ok_status();
 }
 
-// TODO(benvanik): implement this as an iree_vm_invocation_t sequence.
+// Drives |call| on |stack| to completion by resuming each time it yields.
+// Synchronous invocations treat yields as scheduling points only; there is no
+// other work to interleave with so we just continue execution.
+static iree_status_t iree_vm_invoke_call_to_completion(
+    iree_vm_stack_t* stack, iree_vm_function_call_t* call) {
+  iree_vm_module_t* module = call->function.module;
+  iree_vm_execution_result_t result;
+  IREE_RETURN_IF_ERROR(module->begin_call(module->self, stack, call, &result));
+  while (result.state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    IREE_RETURN_IF_ERROR(module->resume_call(module->self, stack, &result));
+  }
+  return iree_ok_status();
+}
+
 static iree_status_t iree_vm_invoke_within(
     iree_vm_context_t* context, iree_vm_stack_t* stack,
     iree_vm_function_t function, const iree_vm_invocation_policy_t* policy,
@@ -142,16 +181,14 @@ static iree_status_t iree_vm_invoke_within(
   results.data = iree_alloca(results.data_length);
   memset(results.data, 0, results.data_length);
 
-  // Perform execution. Note that for synchronous execution we expect this to
-  // complete without yielding.
+  // Perform execution. The function may yield any number of times and we
+  // resume it in place until it completes.
   iree_vm_function_call_t call;
   memset(&call, 0, sizeof(call));
   call.function = function;
   call.arguments = arguments;
   call.results = results;
-  iree_vm_execution_result_t result;
-  iree_status_t status =
-      function.module->begin_call(function.module->self, stack, &call, &result);
+  iree_status_t status = iree_vm_invoke_call_to_completion(stack, &call);
   if (!iree_status_is_ok(status)) {
     iree_vm_function_call_release(&call, &signature);
     return status;
@@ -180,3 +217,227 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// iree_vm_invocation_t
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invocation {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  iree_string_view_t cconv_results;
+
+  // Heap-allocated stack holding the frames of the in-flight invocation.
+  // Retained across yields and freed as soon as the invocation completes.
+  iree_vm_stack_t* stack;
+
+  // Result buffer populated by the callee upon completion. Stored inline after
+  // the invocation struct as it must remain valid across yields.
+  iree_byte_span_t results;
+
+  // IREE_STATUS_UNAVAILABLE while in-flight and otherwise the final status.
+  iree_status_t status;
+
+  // Marshaled outputs of the function, valid only if it completed successfully.
+  iree_vm_list_t* outputs;
+};
+
+static bool iree_vm_invocation_is_pending(iree_vm_invocation_t* invocation) {
+  return iree_status_code(invocation->status) == IREE_STATUS_UNAVAILABLE;
+}
+
+// Transitions |invocation| to its final |status| and drops the stack.
+static void iree_vm_invocation_complete(iree_vm_invocation_t* invocation,
+                                        iree_status_t status) {
+  if (invocation->stack) {
+    // Any frames still on the stack (from failures or aborts) are popped and
+    // their registers released here.
+    iree_vm_stack_free(invocation->stack);
+    invocation->stack = NULL;
+  }
+  invocation->status = status;
+}
+
+// Handles the result of a begin_call or resume_call on |invocation|.
+static void iree_vm_invocation_handle_result(
+    iree_vm_invocation_t* invocation, iree_status_t status,
+    const iree_vm_execution_result_t* result) {
+  if (iree_status_is_ok(status) &&
+      result->state == IREE_VM_EXECUTION_STATE_YIELDED) {
+    // Still in-flight; the stack is preserved until the next resume.
+    return;
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_invoke_marshal_outputs(
+        invocation->cconv_results, invocation->results, invocation->outputs);
+  }
+  iree_vm_invocation_complete(invocation, status);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
+    iree_allocator_t allocator, iree_vm_invocation_t** out_invocation) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invocation);
+  *out_invocation = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+  iree_byte_span_t arguments = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_arguments, /*segment_size_list=*/NULL,
+              &arguments.data_length));
+  iree_host_size_t results_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_compute_cconv_fragment_size(
+              cconv_results, /*segment_size_list=*/NULL, &results_size));
+
+  iree_vm_invocation_t* invocation = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, sizeof(*invocation) + results_size,
+                                (void**)&invocation));
+  memset(invocation, 0, sizeof(*invocation) + results_size);
+  iree_atomic_ref_count_init(&invocation->ref_count);
+  invocation->allocator = allocator;
+  invocation->context = context;
+  iree_vm_context_retain(context);
+  invocation->function = function;
+  invocation->cconv_results = cconv_results;
+  invocation->results =
+      iree_make_byte_span((uint8_t*)invocation + sizeof(*invocation),
+                          results_size);
+  invocation->status = iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+
+  iree_status_t status = iree_vm_list_create(
+      /*element_type=*/NULL, cconv_results.size, allocator,
+      &invocation->outputs);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_stack_allocate(iree_vm_context_state_resolver(context),
+                                    allocator, &invocation->stack);
+  }
+
+  // Arguments are only needed until the callee has consumed them in
+  // begin_call and can live on the host stack.
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.results = invocation->results;
+  if (iree_status_is_ok(status)) {
+    arguments.data = iree_alloca(arguments.data_length);
+    memset(arguments.data, 0, arguments.data_length);
+    call.arguments = arguments;
+    status = iree_vm_invoke_marshal_inputs(
+        cconv_arguments, (iree_vm_list_t*)inputs, arguments);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_vm_function_call_release(&call, &signature);
+    iree_vm_invocation_release(invocation);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Run until the first yield (or completion). Failures during execution are
+  // reported through the invocation status as they would be on resume.
+  iree_vm_execution_result_t result;
+  status = function.module->begin_call(function.module->self,
+                                       invocation->stack, &call, &result);
+  if (!iree_status_is_ok(status)) {
+    iree_vm_function_call_release(&call, &signature);
+  }
+  iree_vm_invocation_handle_result(invocation, status, &result);
+
+  *out_invocation = invocation;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_retain(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  iree_atomic_ref_count_inc(&invocation->ref_count);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_release(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (iree_atomic_ref_count_dec(&invocation->ref_count) == 1) {
+    iree_vm_invocation_abort(invocation);
+    iree_status_ignore(invocation->status);
+    iree_vm_list_release(invocation->outputs);
+    iree_vm_context_release(invocation->context);
+    iree_allocator_free(invocation->allocator, invocation);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_query_status(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (iree_vm_invocation_is_pending(invocation)) {
+    return iree_status_from_code(IREE_STATUS_UNAVAILABLE);
+  }
+  return iree_status_clone(invocation->status);
+}
+
+IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
+iree_vm_invocation_output(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  return iree_status_is_ok(invocation->status) ? invocation->outputs : NULL;
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (!iree_vm_invocation_is_pending(invocation)) {
+    return iree_vm_invocation_query_status(invocation);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_module_t* module = invocation->function.module;
+  iree_vm_execution_result_t result;
+  iree_status_t status =
+      module->resume_call(module->self, invocation->stack, &result);
+  iree_vm_invocation_handle_result(invocation, status, &result);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_await(
+    iree_vm_invocation_t* invocation, iree_time_t deadline) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // There is no other work to wait on besides the invocation itself so we
+  // resume it on the calling thread. Each yield gives us a chance to check the
+  // deadline.
+  while (iree_vm_invocation_is_pending(invocation)) {
+    iree_status_ignore(iree_vm_invocation_resume(invocation));
+    if (iree_vm_invocation_is_pending(invocation) &&
+        iree_time_now() >= deadline) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                              "deadline elapsed before invocation completed");
+    }
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_vm_invocation_query_status(invocation);
+}
+
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_abort(iree_vm_invocation_t* invocation) {
+  IREE_ASSERT_ARGUMENT(invocation);
+  if (iree_vm_invocation_is_pending(invocation)) {
+    iree_vm_invocation_complete(invocation,
+                                iree_status_from_code(IREE_STATUS_ABORTED));
+  }
+  return iree_ok_status();
+}
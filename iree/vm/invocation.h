@@ -47,7 +47,20 @@ IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invoke(
     const iree_vm_invocation_policy_t* policy, iree_vm_list_t* inputs,
     iree_vm_list_t* outputs, iree_allocator_t allocator);
 
-// TODO(benvanik): document and implement.
+// Creates an invocation of |function| and begins executing it on the calling
+// thread. Execution continues until the function completes or yields (such as
+// when waiting on an asynchronous operation); the invocation can then be
+// resumed with iree_vm_invocation_resume or iree_vm_invocation_await. This
+// allows a single thread to multiplex any number of in-flight invocations.
+//
+// Execution failures are reported via iree_vm_invocation_query_status and only
+// errors preparing the invocation are returned from this function.
+//
+// |policy| is currently ignored.
+//
+// |inputs| is used to pass values and objects into the target function and must
+// match the signature defined by the compiled function. List ownership remains
+// with the caller.
 IREE_API_EXPORT iree_status_t IREE_API_CALL iree_vm_invocation_create(
     iree_vm_context_t* context, iree_vm_function_t function,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
@@ -80,6 +93,15 @@ iree_vm_invocation_query_status(iree_vm_invocation_t* invocation);
 IREE_API_EXPORT const iree_vm_list_t* IREE_API_CALL
 iree_vm_invocation_output(iree_vm_invocation_t* invocation);
 
+// Resumes execution of a yielded |invocation| on the calling thread until it
+// yields again or completes. Invocations must not be resumed from multiple
+// threads concurrently.
+//
+// Returns the same result as iree_vm_invocation_query_status after resuming,
+// with IREE_STATUS_UNAVAILABLE indicating that the invocation yielded again.
+IREE_API_EXPORT iree_status_t IREE_API_CALL
+iree_vm_invocation_resume(iree_vm_invocation_t* invocation);
+
 // Blocks the caller until the invocation completes (successfully or otherwise).
 //
 // Returns IREE_STATUS_DEADLINE_EXCEEDED if |deadline| elapses before the
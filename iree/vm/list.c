@@ -17,12 +17,14 @@
 #include "iree/base/alignment.h"
 
 // Size of each iree_vm_value_type_t in bytes.
-static const iree_host_size_t kValueTypeSizes[5] = {
+static const iree_host_size_t kValueTypeSizes[7] = {
     0,  // IREE_VM_VALUE_TYPE_NONE
     1,  // IREE_VM_VALUE_TYPE_I8
     2,  // IREE_VM_VALUE_TYPE_I16
     4,  // IREE_VM_VALUE_TYPE_I32
     8,  // IREE_VM_VALUE_TYPE_I64
+    4,  // IREE_VM_VALUE_TYPE_F32
+    8,  // IREE_VM_VALUE_TYPE_F64
 };
 static_assert(IREE_VM_VALUE_TYPE_COUNT ==
                   (sizeof(kValueTypeSizes) / sizeof(kValueTypeSizes[0])),
@@ -276,6 +278,12 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i8;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i8;
+          return;
+        case IREE_VM_VALUE_TYPE_F64:
+          out_value->f64 = (double)source_value->i8;
+          return;
         default:
           return;
       }
@@ -290,6 +298,12 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i16;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i16;
+          return;
+        case IREE_VM_VALUE_TYPE_F64:
+          out_value->f64 = (double)source_value->i16;
+          return;
         default:
           return;
       }
@@ -304,6 +318,12 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I64:
           out_value->i64 = (int64_t)source_value->i32;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i32;
+          return;
+        case IREE_VM_VALUE_TYPE_F64:
+          out_value->f64 = (double)source_value->i32;
+          return;
         default:
           return;
       }
@@ -318,6 +338,52 @@ static void iree_vm_list_convert_value_type(
         case IREE_VM_VALUE_TYPE_I32:
           out_value->i32 = (int32_t)source_value->i64;
           return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->i64;
+          return;
+        case IREE_VM_VALUE_TYPE_F64:
+          out_value->f64 = (double)source_value->i64;
+          return;
+        default:
+          return;
+      }
+    case IREE_VM_VALUE_TYPE_F32:
+      switch (target_value_type) {
+        case IREE_VM_VALUE_TYPE_I8:
+          out_value->i8 = (int8_t)source_value->f32;
+          return;
+        case IREE_VM_VALUE_TYPE_I16:
+          out_value->i16 = (int16_t)source_value->f32;
+          return;
+        case IREE_VM_VALUE_TYPE_I32:
+          out_value->i32 = (int32_t)source_value->f32;
+          return;
+        case IREE_VM_VALUE_TYPE_I64:
+          out_value->i64 = (int64_t)source_value->f32;
+          return;
+        case IREE_VM_VALUE_TYPE_F64:
+          out_value->f64 = (double)source_value->f32;
+          return;
+        default:
+          return;
+      }
+    case IREE_VM_VALUE_TYPE_F64:
+      switch (target_value_type) {
+        case IREE_VM_VALUE_TYPE_I8:
+          out_value->i8 = (int8_t)source_value->f64;
+          return;
+        case IREE_VM_VALUE_TYPE_I16:
+          out_value->i16 = (int16_t)source_value->f64;
+          return;
+        case IREE_VM_VALUE_TYPE_I32:
+          out_value->i32 = (int32_t)source_value->f64;
+          return;
+        case IREE_VM_VALUE_TYPE_I64:
+          out_value->i64 = (int64_t)source_value->f64;
+          return;
+        case IREE_VM_VALUE_TYPE_F32:
+          out_value->f32 = (float)source_value->f64;
+          return;
         default:
           return;
       }
@@ -58,9 +58,11 @@ iree_vm_function_call_compute_cconv_fragment_size(
        ++i, ++seg_i) {
     switch (cconv_fragment.data[i]) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32:
         required_size += sizeof(int32_t);
         break;
       case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64:
         required_size += sizeof(int64_t);
         break;
       case IREE_VM_CCONV_TYPE_REF:
@@ -81,9 +83,11 @@ iree_vm_function_call_compute_cconv_fragment_size(
              ++i) {
           switch (cconv_fragment.data[i]) {
             case IREE_VM_CCONV_TYPE_INT32:
+            case IREE_VM_CCONV_TYPE_F32:
               span_size += sizeof(int32_t);
               break;
             case IREE_VM_CCONV_TYPE_INT64:
+            case IREE_VM_CCONV_TYPE_F64:
               span_size += sizeof(int64_t);
               break;
             case IREE_VM_CCONV_TYPE_REF:
@@ -124,9 +128,11 @@ iree_vm_function_call_release(iree_vm_function_call_t* call,
     }
     switch (c) {
       case IREE_VM_CCONV_TYPE_INT32:
+      case IREE_VM_CCONV_TYPE_F32:
         p += sizeof(int32_t);
         break;
       case IREE_VM_CCONV_TYPE_INT64:
+      case IREE_VM_CCONV_TYPE_F64:
         p += sizeof(int64_t);
         break;
       case IREE_VM_CCONV_TYPE_REF:
@@ -103,11 +103,13 @@ typedef struct {
   // - Zero or more arguments:
   //   - 'i': int32_t integer (i32)
   //   - 'I': int64_t integer (i64)
+  //   - 'f': float (f32)
+  //   - 'F': double (f64)
   //   - 'r': ref-counted type pointer (!vm.ref<?>)
   //   - '[' ... ']': variadic list of flattened tuples of a specified type
   // - EOL or '.'
   // - Zero or more results:
-  //   - 'i' or 'I'
+  //   - 'i', 'I', 'f', or 'F'
   //   - 'r'
   //
   // Examples:
@@ -204,6 +206,8 @@ typedef struct {
 
 #define IREE_VM_CCONV_TYPE_INT32 'i'
 #define IREE_VM_CCONV_TYPE_INT64 'I'
+#define IREE_VM_CCONV_TYPE_F32 'f'
+#define IREE_VM_CCONV_TYPE_F64 'F'
 #define IREE_VM_CCONV_TYPE_REF 'r'
 #define IREE_VM_CCONV_TYPE_SPAN_START '['
 #define IREE_VM_CCONV_TYPE_SPAN_END ']'
@@ -245,14 +249,23 @@ IREE_API_EXPORT void IREE_API_CALL
 iree_vm_function_call_release(iree_vm_function_call_t* call,
                               const iree_vm_function_signature_t* signature);
 
+// Describes how execution of a call left the stack upon returning to the
+// caller of begin_call/resume_call.
+enum iree_vm_execution_state_e {
+  // The call completed and its results have been written to the call results
+  // buffer. The stack contains no frames from the call.
+  IREE_VM_EXECUTION_STATE_COMPLETED = 0,
+  // The call yielded (such as via the vm.yield op) and its frames remain on
+  // the stack. resume_call must be used to continue execution and the call
+  // arguments/results buffers must remain valid until it completes.
+  IREE_VM_EXECUTION_STATE_YIELDED = 1,
+};
+typedef uint32_t iree_vm_execution_state_t;
+
 // Results of an iree_vm_module_execute request.
 typedef struct {
-  // TODO(benvanik): yield information.
-  // Yield modes:
-  // - yield (yield instruction)
-  // - await (with 1+ wait handles)
-  // - break
-  int reserved;
+  // Whether the call completed or yielded and requires resumption.
+  iree_vm_execution_state_t state;
 } iree_vm_execution_result_t;
 
 // Defines an interface that can be used to reflect and execute functions on a
@@ -308,12 +321,16 @@ typedef struct iree_vm_module {
 
   // Begins a function call with the given |call| arguments.
   // Execution may yield in the case of asynchronous code and require one or
-  // more calls to the resume method to complete.
+  // more calls to the resume method to complete. When |out_result| indicates
+  // IREE_VM_EXECUTION_STATE_YIELDED the |call| results buffer must remain
+  // valid as it will be populated when the call eventually completes.
   iree_status_t(IREE_API_PTR* begin_call)(
       void* self, iree_vm_stack_t* stack, const iree_vm_function_call_t* call,
       iree_vm_execution_result_t* out_result);
 
   // Resumes execution of a previously-yielded call.
+  // The top of |stack| must be the frame that yielded. Execution continues
+  // until the call yields again or completes as with begin_call.
   iree_status_t(IREE_API_PTR* resume_call)(
       void* self, iree_vm_stack_t* stack,
       iree_vm_execution_result_t* out_result);
@@ -0,0 +1,201 @@
+vm.module @arithmetic_ops_f32 {
+
+  //===--------------------------------------------------------------------===//
+  // F32 Arithmetic
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_f32
+  vm.func @test_add_f32() {
+    %c1 = vm.const.f32 1.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 2.25 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.add.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 3.75 : f32
+    vm.check.eq %v, %c3, "1.5+2.25=3.75" : f32
+    vm.return
+  }
+
+  vm.export @test_sub_f32
+  vm.func @test_sub_f32() {
+    %c1 = vm.const.f32 3.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -2.5 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.sub.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 5.5 : f32
+    vm.check.eq %v, %c3, "3.0-(-2.5)=5.5" : f32
+    vm.return
+  }
+
+  vm.export @test_mul_f32
+  vm.func @test_mul_f32() {
+    %c1 = vm.const.f32 2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 -4.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.mul.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -10.0 : f32
+    vm.check.eq %v, %c3, "2.5*-4.0=-10.0" : f32
+    vm.return
+  }
+
+  vm.export @test_div_f32
+  vm.func @test_div_f32() {
+    %c1 = vm.const.f32 -10.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 4.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.div.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -2.5 : f32
+    vm.check.eq %v, %c3, "-10.0/4.0=-2.5" : f32
+    vm.return
+  }
+
+  vm.export @test_rem_f32
+  vm.func @test_rem_f32() {
+    %c1 = vm.const.f32 -10.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %c2 = vm.const.f32 4.0 : f32
+    %c2dno = iree.do_not_optimize(%c2) : f32
+    %v = vm.rem.f32 %c1dno, %c2dno : f32
+    %c3 = vm.const.f32 -2.5 : f32
+    vm.check.eq %v, %c3, "-10.5%4.0=-2.5" : f32
+    vm.return
+  }
+
+  vm.export @test_abs_f32
+  vm.func @test_abs_f32() {
+    %c1 = vm.const.f32 -2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.abs.f32 %c1dno : f32
+    %c2 = vm.const.f32 2.5 : f32
+    vm.check.eq %v, %c2, "abs(-2.5)=2.5" : f32
+    vm.return
+  }
+
+  vm.export @test_neg_f32
+  vm.func @test_neg_f32() {
+    %c1 = vm.const.f32 2.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.neg.f32 %c1dno : f32
+    %c2 = vm.const.f32 -2.5 : f32
+    vm.check.eq %v, %c2, "neg(2.5)=-2.5" : f32
+    vm.return
+  }
+
+  vm.export @test_ceil_f32
+  vm.func @test_ceil_f32() {
+    %c1 = vm.const.f32 1.25 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.ceil.f32 %c1dno : f32
+    %c2 = vm.const.f32 2.0 : f32
+    vm.check.eq %v, %c2, "ceil(1.25)=2.0" : f32
+    vm.return
+  }
+
+  vm.export @test_floor_f32
+  vm.func @test_floor_f32() {
+    %c1 = vm.const.f32 -1.25 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.floor.f32 %c1dno : f32
+    %c2 = vm.const.f32 -2.0 : f32
+    vm.check.eq %v, %c2, "floor(-1.25)=-2.0" : f32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F32 Conversions
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cast_si32_f32
+  vm.func @test_cast_si32_f32() {
+    %c1 = vm.const.i32 -3 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.si32.f32 %c1dno : i32 -> f32
+    %c2 = vm.const.f32 -3.0 : f32
+    vm.check.eq %v, %c2, "cast.si32.f32(-3)=-3.0" : f32
+    vm.return
+  }
+
+  vm.export @test_cast_ui32_f32
+  vm.func @test_cast_ui32_f32() {
+    %c1 = vm.const.i32 4294967295 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.ui32.f32 %c1dno : i32 -> f32
+    %c2 = vm.const.f32 4294967295.0 : f32
+    vm.check.eq %v, %c2, "cast.ui32.f32(UINT_MAX)=4294967295.0" : f32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32
+  vm.func @test_cast_f32_si32() {
+    %c1 = vm.const.f32 -2.75 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -2 : i32
+    vm.check.eq %v, %c2, "cast.f32.si32(-2.75)=-2" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32
+  vm.func @test_cast_f32_ui32() {
+    %c1 = vm.const.f32 3000000000.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 3000000000 : i32
+    vm.check.eq %v, %c2, "cast.f32.ui32(3000000000.5)=3000000000" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_nan
+  vm.func @test_cast_f32_si32_nan() {
+    %c1 = vm.const.f32 0x7FC00000 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 0 : i32
+    vm.check.eq %v, %c2, "cast.f32.si32(nan)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_big
+  vm.func @test_cast_f32_si32_big() {
+    %c1 = vm.const.f32 3.0e+10 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 2147483647 : i32
+    vm.check.eq %v, %c2, "cast.f32.si32(3e10)=INT_MAX" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_si32_small
+  vm.func @test_cast_f32_si32_small() {
+    %c1 = vm.const.f32 -3.0e+10 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.si32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -2147483648 : i32
+    vm.check.eq %v, %c2, "cast.f32.si32(-3e10)=INT_MIN" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32_neg
+  vm.func @test_cast_f32_ui32_neg() {
+    %c1 = vm.const.f32 -5.0 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 0 : i32
+    vm.check.eq %v, %c2, "cast.f32.ui32(-5.0)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f32_ui32_big
+  vm.func @test_cast_f32_ui32_big() {
+    %c1 = vm.const.f32 1.0e+10 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.cast.f32.ui32 %c1dno : f32 -> i32
+    %c2 = vm.const.i32 -1 : i32
+    vm.check.eq %v, %c2, "cast.f32.ui32(1e10)=UINT_MAX" : i32
+    vm.return
+  }
+
+}
@@ -0,0 +1,221 @@
+vm.module @arithmetic_ops_f64 {
+
+  //===--------------------------------------------------------------------===//
+  // F64 Arithmetic
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_add_f64
+  vm.func @test_add_f64() {
+    %c1 = vm.const.f64 1.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 2.25 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    %v = vm.add.f64 %c1dno, %c2dno : f64
+    %c3 = vm.const.f64 3.75 : f64
+    vm.check.eq %v, %c3, "1.5+2.25=3.75" : f64
+    vm.return
+  }
+
+  vm.export @test_sub_f64
+  vm.func @test_sub_f64() {
+    %c1 = vm.const.f64 3.0 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 -2.5 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    %v = vm.sub.f64 %c1dno, %c2dno : f64
+    %c3 = vm.const.f64 5.5 : f64
+    vm.check.eq %v, %c3, "3.0-(-2.5)=5.5" : f64
+    vm.return
+  }
+
+  vm.export @test_mul_f64
+  vm.func @test_mul_f64() {
+    %c1 = vm.const.f64 2.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 -4.0 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    %v = vm.mul.f64 %c1dno, %c2dno : f64
+    %c3 = vm.const.f64 -10.0 : f64
+    vm.check.eq %v, %c3, "2.5*-4.0=-10.0" : f64
+    vm.return
+  }
+
+  vm.export @test_div_f64
+  vm.func @test_div_f64() {
+    %c1 = vm.const.f64 -10.0 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 4.0 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    %v = vm.div.f64 %c1dno, %c2dno : f64
+    %c3 = vm.const.f64 -2.5 : f64
+    vm.check.eq %v, %c3, "-10.0/4.0=-2.5" : f64
+    vm.return
+  }
+
+  vm.export @test_rem_f64
+  vm.func @test_rem_f64() {
+    %c1 = vm.const.f64 -10.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %c2 = vm.const.f64 4.0 : f64
+    %c2dno = iree.do_not_optimize(%c2) : f64
+    %v = vm.rem.f64 %c1dno, %c2dno : f64
+    %c3 = vm.const.f64 -2.5 : f64
+    vm.check.eq %v, %c3, "-10.5%4.0=-2.5" : f64
+    vm.return
+  }
+
+  vm.export @test_abs_f64
+  vm.func @test_abs_f64() {
+    %c1 = vm.const.f64 -2.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.abs.f64 %c1dno : f64
+    %c2 = vm.const.f64 2.5 : f64
+    vm.check.eq %v, %c2, "abs(-2.5)=2.5" : f64
+    vm.return
+  }
+
+  vm.export @test_neg_f64
+  vm.func @test_neg_f64() {
+    %c1 = vm.const.f64 2.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.neg.f64 %c1dno : f64
+    %c2 = vm.const.f64 -2.5 : f64
+    vm.check.eq %v, %c2, "neg(2.5)=-2.5" : f64
+    vm.return
+  }
+
+  vm.export @test_ceil_f64
+  vm.func @test_ceil_f64() {
+    %c1 = vm.const.f64 1.25 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.ceil.f64 %c1dno : f64
+    %c2 = vm.const.f64 2.0 : f64
+    vm.check.eq %v, %c2, "ceil(1.25)=2.0" : f64
+    vm.return
+  }
+
+  vm.export @test_floor_f64
+  vm.func @test_floor_f64() {
+    %c1 = vm.const.f64 -1.25 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.floor.f64 %c1dno : f64
+    %c2 = vm.const.f64 -2.0 : f64
+    vm.check.eq %v, %c2, "floor(-1.25)=-2.0" : f64
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // F64 Conversions
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cast_si32_f64
+  vm.func @test_cast_si32_f64() {
+    %c1 = vm.const.i32 -3 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.si32.f64 %c1dno : i32 -> f64
+    %c2 = vm.const.f64 -3.0 : f64
+    vm.check.eq %v, %c2, "cast.si32.f64(-3)=-3.0" : f64
+    vm.return
+  }
+
+  vm.export @test_cast_ui32_f64
+  vm.func @test_cast_ui32_f64() {
+    %c1 = vm.const.i32 4294967295 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %v = vm.cast.ui32.f64 %c1dno : i32 -> f64
+    %c2 = vm.const.f64 4294967295.0 : f64
+    vm.check.eq %v, %c2, "cast.ui32.f64(UINT_MAX)=4294967295.0" : f64
+    vm.return
+  }
+
+  vm.export @test_cast_f64_si32
+  vm.func @test_cast_f64_si32() {
+    %c1 = vm.const.f64 -2.75 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.si32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 -2 : i32
+    vm.check.eq %v, %c2, "cast.f64.si32(-2.75)=-2" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_ui32
+  vm.func @test_cast_f64_ui32() {
+    %c1 = vm.const.f64 3000000000.5 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.ui32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 3000000000 : i32
+    vm.check.eq %v, %c2, "cast.f64.ui32(3000000000.5)=3000000000" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_si32_nan
+  vm.func @test_cast_f64_si32_nan() {
+    %c1 = vm.const.f64 0x7FF8000000000000 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.si32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 0 : i32
+    vm.check.eq %v, %c2, "cast.f64.si32(nan)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_si32_big
+  vm.func @test_cast_f64_si32_big() {
+    %c1 = vm.const.f64 3.0e+10 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.si32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 2147483647 : i32
+    vm.check.eq %v, %c2, "cast.f64.si32(3e10)=INT_MAX" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_si32_small
+  vm.func @test_cast_f64_si32_small() {
+    %c1 = vm.const.f64 -3.0e+10 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.si32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 -2147483648 : i32
+    vm.check.eq %v, %c2, "cast.f64.si32(-3e10)=INT_MIN" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_ui32_neg
+  vm.func @test_cast_f64_ui32_neg() {
+    %c1 = vm.const.f64 -5.0 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.ui32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 0 : i32
+    vm.check.eq %v, %c2, "cast.f64.ui32(-5.0)=0" : i32
+    vm.return
+  }
+
+  vm.export @test_cast_f64_ui32_big
+  vm.func @test_cast_f64_ui32_big() {
+    %c1 = vm.const.f64 1.0e+10 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.cast.f64.ui32 %c1dno : f64 -> i32
+    %c2 = vm.const.i32 -1 : i32
+    vm.check.eq %v, %c2, "cast.f64.ui32(1e10)=UINT_MAX" : i32
+    vm.return
+  }
+
+  vm.export @test_trunc_f64_f32
+  vm.func @test_trunc_f64_f32() {
+    %c1 = vm.const.f64 0.25 : f64
+    %c1dno = iree.do_not_optimize(%c1) : f64
+    %v = vm.trunc.f64.f32 %c1dno : f64 -> f32
+    %c2 = vm.const.f32 0.25 : f32
+    vm.check.eq %v, %c2, "trunc.f64.f32(0.25)=0.25" : f32
+    vm.return
+  }
+
+  vm.export @test_ext_f32_f64
+  vm.func @test_ext_f32_f64() {
+    %c1 = vm.const.f32 -0.5 : f32
+    %c1dno = iree.do_not_optimize(%c1) : f32
+    %v = vm.ext.f32.f64 %c1dno : f32 -> f64
+    %c2 = vm.const.f64 -0.5 : f64
+    vm.check.eq %v, %c2, "ext.f32.f64(-0.5)=-0.5" : f64
+    vm.return
+  }
+
+}
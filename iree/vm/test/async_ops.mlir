@@ -0,0 +1,54 @@
+vm.module @async_ops {
+
+  //===--------------------------------------------------------------------===//
+  // vm.yield
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_yield_sequence
+  vm.func @test_yield_sequence() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    vm.yield
+    %c2 = vm.const.i32 2 : i32
+    %v = vm.add.i32 %c1dno, %c1dno : i32
+    vm.yield
+    vm.check.eq %v, %c2, "registers must be preserved across yields" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_loop
+  vm.func @test_yield_loop() {
+    %c1 = vm.const.i32 1 : i32
+    %c4 = vm.const.i32 4 : i32
+    %c4dno = iree.do_not_optimize(%c4) : i32
+    %i0 = vm.const.i32.zero : i32
+    vm.br ^loop(%i0 : i32)
+  ^loop(%i : i32):
+    vm.yield
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %c4dno : i32
+    vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    vm.check.eq %ie, %c4, "expected 4 iterations" : i32
+    vm.return
+  }
+
+  vm.export @test_yield_nested_call
+  vm.func @test_yield_nested_call() {
+    %c3 = vm.const.i32 3 : i32
+    %c3dno = iree.do_not_optimize(%c3) : i32
+    %c6 = vm.const.i32 6 : i32
+    %v = vm.call @yield_and_double(%c3dno) : (i32) -> i32
+    vm.yield
+    vm.check.eq %v, %c6, "results must be returned across yields" : i32
+    vm.return
+  }
+
+  vm.func @yield_and_double(%arg0 : i32) -> i32 {
+    vm.yield
+    %0 = vm.add.i32 %arg0, %arg0 : i32
+    vm.yield
+    vm.return %0 : i32
+  }
+
+}
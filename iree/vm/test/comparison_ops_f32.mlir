@@ -0,0 +1,507 @@
+vm.module @comparison_ops_f32 {
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.eq.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_eq_f32_o_0
+  vm.func @test_cmp_eq_f32_o_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 == 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f32_o_1
+  vm.func @test_cmp_eq_f32_o_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 == 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f32_o_2
+  vm.func @test_cmp_eq_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan == 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.eq.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_eq_f32_u_0
+  vm.func @test_cmp_eq_f32_u_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 == 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f32_u_1
+  vm.func @test_cmp_eq_f32_u_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 == 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f32_u_2
+  vm.func @test_cmp_eq_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.eq.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan == 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.ne.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_ne_f32_o_0
+  vm.func @test_cmp_ne_f32_o_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 != 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f32_o_1
+  vm.func @test_cmp_ne_f32_o_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 != 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f32_o_2
+  vm.func @test_cmp_ne_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan != 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.ne.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_ne_f32_u_0
+  vm.func @test_cmp_ne_f32_u_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 != 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f32_u_1
+  vm.func @test_cmp_ne_f32_u_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 != 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f32_u_2
+  vm.func @test_cmp_ne_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.ne.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan != 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lt.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f32_o_0
+  vm.func @test_cmp_lt_f32_o_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 < 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f32_o_1
+  vm.func @test_cmp_lt_f32_o_1() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 < 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f32_o_2
+  vm.func @test_cmp_lt_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan < 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lt.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f32_u_0
+  vm.func @test_cmp_lt_f32_u_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 < 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f32_u_1
+  vm.func @test_cmp_lt_f32_u_1() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 < 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f32_u_2
+  vm.func @test_cmp_lt_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan < 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lte.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lte_f32_o_0
+  vm.func @test_cmp_lte_f32_o_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f32_o_1
+  vm.func @test_cmp_lte_f32_o_1() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f32_o_2
+  vm.func @test_cmp_lte_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lte.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lte_f32_u_0
+  vm.func @test_cmp_lte_f32_u_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f32_u_1
+  vm.func @test_cmp_lte_f32_u_1() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f32_u_2
+  vm.func @test_cmp_lte_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.lte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gt.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gt_f32_o_0
+  vm.func @test_cmp_gt_f32_o_0() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "2.0 > 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f32_o_1
+  vm.func @test_cmp_gt_f32_o_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 > 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f32_o_2
+  vm.func @test_cmp_gt_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan > 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gt.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gt_f32_u_0
+  vm.func @test_cmp_gt_f32_u_0() {
+    %lhs = vm.const.f32 2.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "2.0 > 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f32_u_1
+  vm.func @test_cmp_gt_f32_u_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 > 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f32_u_2
+  vm.func @test_cmp_gt_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gt.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan > 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gte.f32.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gte_f32_o_0
+  vm.func @test_cmp_gte_f32_o_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32_o_1
+  vm.func @test_cmp_gte_f32_o_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32_o_2
+  vm.func @test_cmp_gte_f32_o_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.o %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan >= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gte.f32.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gte_f32_u_0
+  vm.func @test_cmp_gte_f32_u_0() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32_u_1
+  vm.func @test_cmp_gte_f32_u_1() {
+    %lhs = vm.const.f32 1.0 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 2.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f32_u_2
+  vm.func @test_cmp_gte_f32_u_2() {
+    %lhs = vm.const.f32 0x7FC00000 : f32
+    %lhs_dno = iree.do_not_optimize(%lhs) : f32
+    %rhs = vm.const.f32 1.0 : f32
+    %rhs_dno = iree.do_not_optimize(%rhs) : f32
+    %actual = vm.cmp.gte.f32.u %lhs_dno, %rhs_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan >= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.nan.f32
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_nan_f32_0
+  vm.func @test_cmp_nan_f32_0() {
+    %operand = vm.const.f32 0x7FC00000 : f32
+    %operand_dno = iree.do_not_optimize(%operand) : f32
+    %actual = vm.cmp.nan.f32 %operand_dno : f32
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "isnan(nan)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nan_f32_1
+  vm.func @test_cmp_nan_f32_1() {
+    %operand = vm.const.f32 1.0 : f32
+    %operand_dno = iree.do_not_optimize(%operand) : f32
+    %actual = vm.cmp.nan.f32 %operand_dno : f32
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "isnan(1.0)" : i32
+    vm.return
+  }
+
+}
@@ -0,0 +1,507 @@
+vm.module @comparison_ops_f64 {
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.eq.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_eq_f64_o_0
+  vm.func @test_cmp_eq_f64_o_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 == 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f64_o_1
+  vm.func @test_cmp_eq_f64_o_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 == 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f64_o_2
+  vm.func @test_cmp_eq_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan == 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.eq.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_eq_f64_u_0
+  vm.func @test_cmp_eq_f64_u_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 == 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f64_u_1
+  vm.func @test_cmp_eq_f64_u_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 == 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_eq_f64_u_2
+  vm.func @test_cmp_eq_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.eq.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan == 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.ne.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_ne_f64_o_0
+  vm.func @test_cmp_ne_f64_o_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 != 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f64_o_1
+  vm.func @test_cmp_ne_f64_o_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 != 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f64_o_2
+  vm.func @test_cmp_ne_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan != 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.ne.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_ne_f64_u_0
+  vm.func @test_cmp_ne_f64_u_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 != 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f64_u_1
+  vm.func @test_cmp_ne_f64_u_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 != 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_ne_f64_u_2
+  vm.func @test_cmp_ne_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.ne.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan != 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lt.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f64_o_0
+  vm.func @test_cmp_lt_f64_o_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 < 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f64_o_1
+  vm.func @test_cmp_lt_f64_o_1() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 < 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f64_o_2
+  vm.func @test_cmp_lt_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan < 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lt.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lt_f64_u_0
+  vm.func @test_cmp_lt_f64_u_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 < 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f64_u_1
+  vm.func @test_cmp_lt_f64_u_1() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 < 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_f64_u_2
+  vm.func @test_cmp_lt_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan < 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lte.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lte_f64_o_0
+  vm.func @test_cmp_lte_f64_o_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f64_o_1
+  vm.func @test_cmp_lte_f64_o_1() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f64_o_2
+  vm.func @test_cmp_lte_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan <= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.lte.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_lte_f64_u_0
+  vm.func @test_cmp_lte_f64_u_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f64_u_1
+  vm.func @test_cmp_lte_f64_u_1() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "2.0 <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lte_f64_u_2
+  vm.func @test_cmp_lte_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.lte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan <= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gt.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gt_f64_o_0
+  vm.func @test_cmp_gt_f64_o_0() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "2.0 > 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f64_o_1
+  vm.func @test_cmp_gt_f64_o_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 > 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f64_o_2
+  vm.func @test_cmp_gt_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan > 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gt.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gt_f64_u_0
+  vm.func @test_cmp_gt_f64_u_0() {
+    %lhs = vm.const.f64 2.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "2.0 > 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f64_u_1
+  vm.func @test_cmp_gt_f64_u_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 > 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gt_f64_u_2
+  vm.func @test_cmp_gt_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gt.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan > 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gte.f64.o
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gte_f64_o_0
+  vm.func @test_cmp_gte_f64_o_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f64_o_1
+  vm.func @test_cmp_gte_f64_o_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 2.0 (ordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f64_o_2
+  vm.func @test_cmp_gte_f64_o_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.o %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "nan >= 1.0 (ordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.gte.f64.u
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_gte_f64_u_0
+  vm.func @test_cmp_gte_f64_u_0() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f64_u_1
+  vm.func @test_cmp_gte_f64_u_1() {
+    %lhs = vm.const.f64 1.0 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 2.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "1.0 >= 2.0 (unordered)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_gte_f64_u_2
+  vm.func @test_cmp_gte_f64_u_2() {
+    %lhs = vm.const.f64 0x7FF8000000000000 : f64
+    %lhs_dno = iree.do_not_optimize(%lhs) : f64
+    %rhs = vm.const.f64 1.0 : f64
+    %rhs_dno = iree.do_not_optimize(%rhs) : f64
+    %actual = vm.cmp.gte.f64.u %lhs_dno, %rhs_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "nan >= 1.0 (unordered)" : i32
+    vm.return
+  }
+
+  //===--------------------------------------------------------------------===//
+  // vm.cmp.nan.f64
+  //===--------------------------------------------------------------------===//
+
+  vm.export @test_cmp_nan_f64_0
+  vm.func @test_cmp_nan_f64_0() {
+    %operand = vm.const.f64 0x7FF8000000000000 : f64
+    %operand_dno = iree.do_not_optimize(%operand) : f64
+    %actual = vm.cmp.nan.f64 %operand_dno : f64
+    %expected = vm.const.i32 1 : i32
+    vm.check.eq %actual, %expected, "isnan(nan)" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nan_f64_1
+  vm.func @test_cmp_nan_f64_1() {
+    %operand = vm.const.f64 1.0 : f64
+    %operand_dno = iree.do_not_optimize(%operand) : f64
+    %actual = vm.cmp.nan.f64 %operand_dno : f64
+    %expected = vm.const.i32 0 : i32
+    vm.check.eq %actual, %expected, "isnan(1.0)" : i32
+    vm.return
+  }
+
+}
@@ -19,6 +19,75 @@ vm.module @control_flow_ops {
     vm.fail %code, "error!"
   }
 
+  //===--------------------------------------------------------------------===//
+  // vm.br / vm.cond_br
+  //===--------------------------------------------------------------------===//
+  // Comparisons feeding a branch and loop increments are fused into
+  // superinstructions by the runtime and should behave the same as the
+  // individual instructions.
+
+  vm.export @test_cond_br_loop
+  vm.func @test_cond_br_loop() {
+    %c0 = vm.const.i32 0 : i32
+    %c5 = vm.const.i32 5 : i32
+    %c5dno = iree.do_not_optimize(%c5) : i32
+    vm.br ^loop(%c0, %c0 : i32, i32)
+  ^loop(%i : i32, %sum : i32):
+    %sumn = vm.add.i32 %sum, %i : i32
+    %c1 = vm.const.i32 1 : i32
+    %in = vm.add.i32 %i, %c1 : i32
+    %cmp = vm.cmp.lt.i32.s %in, %c5dno : i32
+    vm.cond_br %cmp, ^loop(%in, %sumn : i32, i32), ^exit(%sumn : i32)
+  ^exit(%result : i32):
+    %c10 = vm.const.i32 10 : i32
+    vm.check.eq %result, %c10, "0+1+2+3+4=10" : i32
+    vm.return
+  }
+
+  vm.export @test_cond_br_countdown
+  vm.func @test_cond_br_countdown() {
+    %c0 = vm.const.i32 0 : i32
+    %c4 = vm.const.i32 4 : i32
+    %c4dno = iree.do_not_optimize(%c4) : i32
+    vm.br ^loop(%c4dno, %c0 : i32, i32)
+  ^loop(%i : i32, %count : i32):
+    %nz = vm.cmp.nz.i32 %i : i32
+    vm.cond_br %nz, ^body, ^exit
+  ^body:
+    %cn1 = vm.const.i32 -1 : i32
+    %in = vm.add.i32 %i, %cn1 : i32
+    %c1 = vm.const.i32 1 : i32
+    %countn = vm.add.i32 %count, %c1 : i32
+    vm.br ^loop(%in, %countn : i32, i32)
+  ^exit:
+    vm.check.eq %count, %c4, "4 iterations" : i32
+    vm.return
+  }
+
+  vm.export @test_cond_br_cmp
+  vm.func @test_cond_br_cmp() {
+    %c1 = vm.const.i32 1 : i32
+    %c1dno = iree.do_not_optimize(%c1) : i32
+    %cn1 = vm.const.i32 -1 : i32
+    %cn1dno = iree.do_not_optimize(%cn1) : i32
+    %eq = vm.cmp.eq.i32 %c1dno, %c1dno : i32
+    vm.cond_br %eq, ^ne, ^fail
+  ^ne:
+    %ne = vm.cmp.ne.i32 %c1dno, %cn1dno : i32
+    vm.cond_br %ne, ^lt_s, ^fail
+  ^lt_s:
+    %lt_s = vm.cmp.lt.i32.s %c1dno, %cn1dno : i32
+    vm.cond_br %lt_s, ^fail, ^lt_u
+  ^lt_u:
+    %lt_u = vm.cmp.lt.i32.u %c1dno, %cn1dno : i32
+    vm.cond_br %lt_u, ^done, ^fail
+  ^done:
+    vm.return
+  ^fail:
+    %code = vm.const.i32 9 : i32
+    vm.fail %code, "unexpected branch"
+  }
+
   //===--------------------------------------------------------------------===//
   // vm.check.*
   //===--------------------------------------------------------------------===//
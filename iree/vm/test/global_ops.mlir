@@ -0,0 +1,46 @@
+vm.module @global_ops {
+
+  //===--------------------------------------------------------------------===//
+  // global.i32
+  //===--------------------------------------------------------------------===//
+
+  vm.global.i32 @c42 42 : i32
+  vm.global.i32 @g0 mutable 0 : i32
+  vm.global.i32 @g1 mutable 0 : i32
+  vm.global.i32 @g2 mutable 0 : i32
+
+  vm.export @test_global_load_i32
+  vm.func @test_global_load_i32() {
+    %actual = vm.global.load.i32 @c42 : i32
+    %expected = vm.const.i32 42 : i32
+    vm.check.eq %actual, %expected, "@c42 != 42" : i32
+    vm.return
+  }
+
+  vm.export @test_global_store_i32
+  vm.func @test_global_store_i32() {
+    %c17 = vm.const.i32 17 : i32
+    vm.global.store.i32 %c17, @g0 : i32
+    %actual = vm.global.load.i32 @g0 : i32
+    vm.check.eq %actual, %c17, "@g0 != 17" : i32
+    vm.return
+  }
+
+  vm.export @test_global_store_indirect_i32
+  vm.func @test_global_store_indirect_i32() {
+    %addr = vm.global.address @g1 : !iree.ptr<i32>
+    %addr_dno = iree.do_not_optimize(%addr) : !iree.ptr<i32>
+    %c17 = vm.const.i32 17 : i32
+    vm.global.store.indirect.i32 %c17, %addr_dno : i32 -> !iree.ptr<i32>
+    %actual = vm.global.load.i32 @g1 : i32
+    vm.check.eq %actual, %c17, "@g1 != 17" : i32
+    %loaded = vm.global.load.indirect.i32 %addr_dno : !iree.ptr<i32> -> i32
+    vm.check.eq %loaded, %c17, "*@g1 != 17" : i32
+    // The store must only touch the 4 bytes of @g1 and not its neighbor.
+    %neighbor = vm.global.load.i32 @g2 : i32
+    %c0 = vm.const.i32 0 : i32
+    vm.check.eq %neighbor, %c0, "@g2 != 0" : i32
+    vm.return
+  }
+
+}